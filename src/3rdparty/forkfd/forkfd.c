@@ -48,6 +48,9 @@
 #  if (defined(__GLIBC__) && (__GLIBC__ << 16) + __GLIBC_MINOR__ >= 0x209) || defined(__BIONIC__)
 #    define HAVE_PIPE2    1
 #  endif
+#  include <sched.h>
+#  include <sys/mman.h>
+#  define HAVE_CLONE_VFORK  1
 #endif
 
 #if _POSIX_VERSION-0 >= 200809L || _XOPEN_VERSION-0 >= 500
@@ -610,6 +613,147 @@ err_free:
     freeInfo(header, info);
     return -1;
 }
+
+#ifdef HAVE_CLONE_VFORK
+#  ifndef MAP_STACK
+#    define MAP_STACK 0
+#  endif
+#  define VFORK_CHILD_STACK_SIZE   (64 * 1024)
+
+typedef struct vfork_child_args
+{
+    int (*childFn)(void *);
+    void *token;
+    const sigset_t *oldmask;
+    int death_pipe[2];
+} VforkChildArgs;
+
+static int vfork_child_start(void *arg)
+{
+    VforkChildArgs *args = (VforkChildArgs *)arg;
+    struct sigaction sa;
+    int sig;
+    int ret;
+
+    /* We share the parent's memory until we exec or exit, so none of the
+     * parent's signal handlers may run here. All signals are blocked; reset
+     * the caught ones to their default action before unblocking. Ignored
+     * signals stay ignored, as they would across execve(2).
+     */
+    for (sig = 1; sig < _NSIG; ++sig) {
+        if (sigaction(sig, NULL, &sa) == -1)
+            continue;
+        if (sa.sa_handler == SIG_IGN || sa.sa_handler == SIG_DFL)
+            continue;
+        memset(&sa, 0, sizeof sa);
+        sa.sa_handler = SIG_DFL;
+        sigaction(sig, &sa, NULL);
+    }
+    pthread_sigmask(SIG_SETMASK, args->oldmask, NULL);
+
+    EINTR_LOOP(ret, close(args->death_pipe[0]));
+    EINTR_LOOP(ret, close(args->death_pipe[1]));
+    _exit(args->childFn(args->token));
+    return -1;
+}
+#endif
+
+/**
+ * @brief vforkfd starts a child process without copying the parent's memory
+ * @return a file descriptor, or -1 in case of failure
+ *
+ * vforkfd() works like forkfd(), except that it does not return in the child
+ * process. Instead, the child calls @a childFn with @a token and exits with
+ * its return value if it returns. The @a flags parameter and the returned
+ * file descriptor are the same as for forkfd().
+ *
+ * On Linux, the child is created with clone(2) and CLONE_VM | CLONE_VFORK:
+ * it shares the parent's address space, so creating it does not need to copy
+ * the parent's page tables, and the calling thread is suspended until the
+ * child calls execve(2) or exits. Therefore @a childFn must only call
+ * async-signal-safe functions, must not allocate memory and should finish
+ * with execve(2) or _exit(2). Any memory it writes to is seen by the parent
+ * when vforkfd() returns, which can be used to pass back error information.
+ *
+ * On other systems, vforkfd() uses forkfd() and calls @a childFn in the
+ * forked child.
+ */
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token)
+{
+#ifdef HAVE_CLONE_VFORK
+    Header *header;
+    ProcessInfo *info;
+    siginfo_t si;
+    pid_t pid;
+    VforkChildArgs args;
+    sigset_t allsignals;
+    sigset_t oldmask;
+    void *stack;
+    int clone_errno;
+
+    (void) pthread_once(&forkfd_initialization, forkfd_initialize);
+
+    info = allocateInfo(&header);
+    if (info == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    /* create the pipe before we clone */
+    if (create_pipe(args.death_pipe, flags) == -1)
+        goto err_free; /* failed to create the pipes, pass errno */
+
+    stack = mmap(NULL, VFORK_CHILD_STACK_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED)
+        goto err_close;
+
+    args.childFn = childFn;
+    args.token = token;
+    args.oldmask = &oldmask;
+
+    sigfillset(&allsignals);
+    pthread_sigmask(SIG_SETMASK, &allsignals, &oldmask);
+    pid = clone(vfork_child_start, (char *)stack + VFORK_CHILD_STACK_SIZE,
+                CLONE_VM | CLONE_VFORK | SIGCHLD, &args);
+    clone_errno = errno;
+    pthread_sigmask(SIG_SETMASK, &oldmask, NULL);
+    munmap(stack, VFORK_CHILD_STACK_SIZE);
+
+    if (pid == -1) {
+        errno = clone_errno;
+        goto err_close; /* failed to clone, pass errno */
+    }
+    if (ppid)
+        *ppid = pid;
+
+    /* The child has already exec'ed or exited by the time clone() returns.
+     * Store its PID and check if it has exited, as spawnfd() does.
+     */
+    info->deathPipe = args.death_pipe[1];
+    ffd_atomic_store(&info->pid, pid, FFD_ATOMIC_RELEASE);
+
+    if (tryReaping(pid, &si))
+        notifyAndFreeInfo(header, info, &si);
+
+    return args.death_pipe[0];
+
+err_close:
+    clone_errno = errno;
+    close(args.death_pipe[0]);
+    close(args.death_pipe[1]);
+    errno = clone_errno;
+err_free:
+    /* free the info pointer */
+    freeInfo(header, info);
+    return -1;
+#else
+    int fd = forkfd(flags, ppid);
+    if (fd == FFD_CHILD_PROCESS)
+        _exit(childFn(token));
+    return fd;
+#endif
+}
 #endif // FORKFD_NO_FORKFD
 
 #if defined(_POSIX_SPAWN) && !defined(FORKFD_NO_SPAWNFD)
@@ -42,6 +42,7 @@ extern "C" {
 #define FFD_CHILD_PROCESS (-2)
 
 int forkfd(int flags, pid_t *ppid);
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token);
 
 #ifdef _POSIX_SPAWN
 /* only for spawnfd: */
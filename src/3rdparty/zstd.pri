@@ -0,0 +1,39 @@
+# Bundled Zstandard. Only the decoder is built, unless the project sets
+# CONFIG += zstd_compress.
+
+DEFINES += ZSTD_DISABLE_ASM ZSTD_NO_TRACE ZSTDLIB_VISIBLE= ZSTDERRORLIB_VISIBLE=
+INCLUDEPATH += $$PWD/zstd
+
+SOURCES += \
+    $$PWD/zstd/common/debug.c \
+    $$PWD/zstd/common/entropy_common.c \
+    $$PWD/zstd/common/error_private.c \
+    $$PWD/zstd/common/fse_decompress.c \
+    $$PWD/zstd/common/xxhash.c \
+    $$PWD/zstd/common/zstd_common.c \
+    $$PWD/zstd/decompress/huf_decompress.c \
+    $$PWD/zstd/decompress/zstd_ddict.c \
+    $$PWD/zstd/decompress/zstd_decompress.c \
+    $$PWD/zstd/decompress/zstd_decompress_block.c
+
+zstd_compress {
+    SOURCES += \
+        $$PWD/zstd/common/pool.c \
+        $$PWD/zstd/common/threading.c \
+        $$PWD/zstd/compress/fse_compress.c \
+        $$PWD/zstd/compress/hist.c \
+        $$PWD/zstd/compress/huf_compress.c \
+        $$PWD/zstd/compress/zstd_compress.c \
+        $$PWD/zstd/compress/zstd_compress_literals.c \
+        $$PWD/zstd/compress/zstd_compress_sequences.c \
+        $$PWD/zstd/compress/zstd_compress_superblock.c \
+        $$PWD/zstd/compress/zstd_double_fast.c \
+        $$PWD/zstd/compress/zstd_fast.c \
+        $$PWD/zstd/compress/zstd_lazy.c \
+        $$PWD/zstd/compress/zstd_ldm.c \
+        $$PWD/zstd/compress/zstd_opt.c \
+        $$PWD/zstd/compress/zstd_preSplit.c \
+        $$PWD/zstd/compress/zstdmt_compress.c
+}
+
+TR_EXCLUDE += $$PWD/*
@@ -133,6 +133,270 @@ static inline bool simdDecodeAscii(ushort *&dst, const uchar *&nextAscii, const
     }
     return src == end;
 }
+
+// Given bit masks of the ASCII bytes, of the lead bytes of two, three and
+// four byte sequences, of the continuation bytes and of the lead bytes of
+// sequences that are overlong, encode surrogates or go past U+10FFFF, in a
+// block of \a n bytes starting at a character boundary, returns how many
+// bytes at the start of the block hold well-formed sequences only, ending at
+// a character boundary. Whatever comes next is left for the scalar code.
+// \a keep is set to the mask of the first byte of every character in there.
+static inline int utf8ValidPrefix(uint ascii, uint lead2, uint lead3, uint lead4, uint cont,
+                                  uint bad, int n, uint *keep)
+{
+    const uint block = n == 32 ? ~0U : (1U << n) - 1;
+    const uint expected = ((lead2 | lead3 | lead4) << 1) | ((lead3 | lead4) << 2) | (lead4 << 3);
+    const uint error = (~(ascii | lead2 | lead3 | lead4 | cont) | (cont ^ expected) | bad) & block;
+    int prefix = error ? _bit_scan_forward(error) : n;
+    uint mask = prefix == 32 ? ~0U : (1U << prefix) - 1;
+
+    // a sequence running past that point is left out too
+    const uint crossing = (lead2 & mask & ~(mask >> 1)) | (lead3 & mask & ~(mask >> 2))
+            | (lead4 & mask & ~(mask >> 3));
+    if (crossing) {
+        prefix = _bit_scan_forward(crossing);
+        mask = (1U << prefix) - 1;
+    }
+    *keep = ~cont & mask;
+    return prefix;
+}
+
+// Classifies the 16 bytes of data, for which next holds the same bytes
+// shifted by one. Four byte sequences count as valid only if \a fourByte.
+static inline int utf8ValidPrefixSse2(__m128i data, __m128i next, bool fourByte, uint *keep)
+{
+    const __m128i highBits = _mm_and_si128(next, _mm_set1_epi8(char(0xe0)));
+    __m128i bad = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xe0))),
+                                             _mm_cmpeq_epi8(highBits, _mm_set1_epi8(char(0x80)))),
+                               _mm_and_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xed))),
+                                             _mm_cmpeq_epi8(highBits, _mm_set1_epi8(char(0xa0)))));
+    const uint ascii = ~_mm_movemask_epi8(data) & 0xffff;
+    const uint cont = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xc0))),
+                                                       _mm_set1_epi8(char(0x80))));
+    const uint lead2 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xe0))),
+                                                        _mm_set1_epi8(char(0xc0))))
+            & ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xfe))),
+                                                _mm_set1_epi8(char(0xc0)))); // overlong
+    const uint lead3 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xf0))),
+                                                        _mm_set1_epi8(char(0xe0))));
+    uint lead4 = 0;
+    if (fourByte) {
+        // 0xf0 to 0xf4; 0xf0 0x80 to 0x8f are overlong, 0xf4 0x90 and up are too big
+        const __m128i highNibble = _mm_and_si128(next, _mm_set1_epi8(char(0xf0)));
+        lead4 = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xf8))),
+                                                               _mm_set1_epi8(char(0xf0))),
+                                                _mm_cmpeq_epi8(_mm_min_epu8(data, _mm_set1_epi8(char(0xf4))), data)));
+        bad = _mm_or_si128(bad, _mm_and_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xf0))),
+                                              _mm_cmpeq_epi8(highNibble, _mm_set1_epi8(char(0x80)))));
+        bad = _mm_or_si128(bad, _mm_andnot_si128(_mm_cmpeq_epi8(highNibble, _mm_set1_epi8(char(0x80))),
+                                                 _mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xf4)))));
+    }
+    return utf8ValidPrefix(ascii, lead2, lead3, lead4, cont, _mm_movemask_epi8(bad), 16, keep);
+}
+
+static const uchar *simdFindInvalidUtf8Sse2(const uchar *src, const uchar *end)
+{
+    // we're going to read src[0..16]
+    for ( ; end - src >= 17; ) {
+        const __m128i data = _mm_loadu_si128((const __m128i *)src);
+        if (!_mm_movemask_epi8(data)) {
+            src += 16;
+            continue;
+        }
+        const __m128i next = _mm_loadu_si128((const __m128i *)(src + 1));
+        uint keep;
+        const int n = utf8ValidPrefixSse2(data, next, true, &keep);
+        if (!n)
+            break;
+        src += n;
+        if (n < 13) // stopped before something we leave to the scalar code
+            break;
+    }
+    return src;
+}
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static inline int utf8ValidPrefixAvx2(__m256i data, __m256i next, bool fourByte, uint *keep)
+{
+    const __m256i highBits = _mm256_and_si256(next, _mm256_set1_epi8(char(0xe0)));
+    __m256i bad = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xe0))),
+                                                   _mm256_cmpeq_epi8(highBits, _mm256_set1_epi8(char(0x80)))),
+                                  _mm256_and_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xed))),
+                                                   _mm256_cmpeq_epi8(highBits, _mm256_set1_epi8(char(0xa0)))));
+    const uint ascii = ~uint(_mm256_movemask_epi8(data));
+    const uint cont = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xc0))),
+                                                             _mm256_set1_epi8(char(0x80))));
+    const uint lead2 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xe0))),
+                                                              _mm256_set1_epi8(char(0xc0))))
+            & ~_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xfe))),
+                                                      _mm256_set1_epi8(char(0xc0)))); // overlong
+    const uint lead3 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xf0))),
+                                                              _mm256_set1_epi8(char(0xe0))));
+    uint lead4 = 0;
+    if (fourByte) {
+        const __m256i highNibble = _mm256_and_si256(next, _mm256_set1_epi8(char(0xf0)));
+        lead4 = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xf8))),
+                                                                        _mm256_set1_epi8(char(0xf0))),
+                                                      _mm256_cmpeq_epi8(_mm256_min_epu8(data, _mm256_set1_epi8(char(0xf4))), data)));
+        bad = _mm256_or_si256(bad, _mm256_and_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xf0))),
+                                                    _mm256_cmpeq_epi8(highNibble, _mm256_set1_epi8(char(0x80)))));
+        bad = _mm256_or_si256(bad, _mm256_andnot_si256(_mm256_cmpeq_epi8(highNibble, _mm256_set1_epi8(char(0x80))),
+                                                       _mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xf4)))));
+    }
+    return utf8ValidPrefix(ascii, lead2, lead3, lead4, cont, _mm256_movemask_epi8(bad), 32, keep);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i utf8DecodeAvx2(__m256i w0, __m256i w1, __m256i w2)
+{
+    const __m256i is3 = _mm256_cmpeq_epi16(_mm256_and_si256(w0, _mm256_set1_epi16(0xf0)), _mm256_set1_epi16(0xe0));
+    const __m256i is2 = _mm256_cmpeq_epi16(_mm256_and_si256(w0, _mm256_set1_epi16(0xe0)), _mm256_set1_epi16(0xc0));
+    const __m256i c1 = _mm256_and_si256(w1, _mm256_set1_epi16(0x3f));
+    const __m256i c2 = _mm256_and_si256(w2, _mm256_set1_epi16(0x3f));
+    const __m256i v2 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(w0, _mm256_set1_epi16(0x1f)), 6), c1);
+    const __m256i v3 = _mm256_or_si256(_mm256_slli_epi16(w0, 12), _mm256_or_si256(_mm256_slli_epi16(c1, 6), c2));
+    return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(is3, v3), _mm256_and_si256(is2, v2)),
+                           _mm256_andnot_si256(_mm256_or_si256(is2, is3), w0));
+}
+
+// for every mask of four 16-bit lanes, the byte shuffle moving the ones
+// selected to the front
+static const uchar utf8CompactShuffle[16][8] = {
+    { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x02, 0x03, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80 },
+    { 0x04, 0x05, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x04, 0x05, 0x80, 0x80, 0x80, 0x80 },
+    { 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80 },
+    { 0x06, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80 },
+    { 0x02, 0x03, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x06, 0x07, 0x80, 0x80 },
+    { 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80 },
+    { 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 }
+};
+
+QT_FUNCTION_TARGET(AVX2)
+static inline void utf8CompactAvx2(ushort *&dst, const ushort *values, uint keep)
+{
+    // this always writes four characters, which is fine: the output buffers
+    // have room for one character per input byte and there are more left
+    for (int i = 0; i < 32; i += 4, keep >>= 4) {
+        const uint lanes = keep & 0xf;
+        const __m128i shuffle = _mm_loadl_epi64((const __m128i *)utf8CompactShuffle[lanes]);
+        const __m128i chunk = _mm_loadl_epi64((const __m128i *)(values + i));
+        _mm_storel_epi64((__m128i *)dst, _mm_shuffle_epi8(chunk, shuffle));
+        dst += qPopulationCount(lanes);
+    }
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static bool simdDecodeUtf8Avx2(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const uchar *start = src;
+
+    // we're going to read src[0..33]
+    for ( ; end - src >= 34; ) {
+        const __m256i data = _mm256_loadu_si256((const __m256i *)src);
+        const __m256i next = _mm256_loadu_si256((const __m256i *)(src + 1));
+        uint keep;
+        const int n = utf8ValidPrefixAvx2(data, next, false, &keep);
+        if (!n)
+            break;
+
+        const __m256i next2 = _mm256_loadu_si256((const __m256i *)(src + 2));
+        ushort values[32];
+        _mm256_storeu_si256((__m256i *)values,
+                            utf8DecodeAvx2(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(data)),
+                                           _mm256_cvtepu8_epi16(_mm256_castsi256_si128(next)),
+                                           _mm256_cvtepu8_epi16(_mm256_castsi256_si128(next2))));
+        _mm256_storeu_si256((__m256i *)values + 1,
+                            utf8DecodeAvx2(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1)),
+                                           _mm256_cvtepu8_epi16(_mm256_extracti128_si256(next, 1)),
+                                           _mm256_cvtepu8_epi16(_mm256_extracti128_si256(next2, 1))));
+        utf8CompactAvx2(dst, values, keep);
+        src += n;
+        if (n < 29) // stopped before something we leave to the scalar code
+            break;
+    }
+    return src != start;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static const uchar *simdFindInvalidUtf8Avx2(const uchar *src, const uchar *end)
+{
+    // we're going to read src[0..32]
+    for ( ; end - src >= 33; ) {
+        const __m256i data = _mm256_loadu_si256((const __m256i *)src);
+        if (!_mm256_movemask_epi8(data)) {
+            src += 32;
+            continue;
+        }
+        const __m256i next = _mm256_loadu_si256((const __m256i *)(src + 1));
+        uint keep;
+        const int n = utf8ValidPrefixAvx2(data, next, true, &keep);
+        if (!n)
+            break;
+        src += n;
+        if (n < 29) // stopped before something we leave to the scalar code
+            break;
+    }
+    return src;
+}
+#  endif
+
+// Without AVX2 there's no byte shuffle to put the characters together, which
+// makes decoding in blocks slower than the scalar code.
+static inline bool simdDecodeUtf8Supported()
+{
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    return qCpuHasFeature(AVX2);
+#  else
+    return false;
+#  endif
+}
+
+// Decodes text made of one to three byte sequences (that is, all of the
+// Basic Multilingual Plane) in blocks, stopping at anything else or close
+// to the end. Returns true if it decoded anything. Only call this if
+// simdDecodeUtf8Supported().
+static inline bool simdDecodeUtf8(ushort *&dst, const uchar *&src, const uchar *end)
+{
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    // don't bother if it's going to stop right away
+    if (*src >= 0xc2 && *src < 0xf0) {
+        // work on copies, so the caller's pointers can stay in registers in
+        // its ASCII loop instead of being written back to memory every block
+        ushort *d = dst;
+        const uchar *s = src;
+        const bool progress = simdDecodeUtf8Avx2(d, s, end);
+        dst = d;
+        src = s;
+        return progress;
+    }
+#  else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#  endif
+    return false;
+}
+
+// Skips well-formed UTF-8 in blocks, stopping at anything else or close to
+// the end.
+static inline const uchar *simdFindInvalidUtf8(const uchar *src, const uchar *end)
+{
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return simdFindInvalidUtf8Avx2(src, end);
+#  endif
+    return simdFindInvalidUtf8Sse2(src, end);
+}
 #else
 static inline bool simdEncodeAscii(uchar *, const ushort *, const ushort *, const ushort *)
 {
@@ -143,6 +407,21 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 {
     return false;
 }
+
+static inline bool simdDecodeUtf8Supported()
+{
+    return false;
+}
+
+static inline bool simdDecodeUtf8(ushort *, const uchar *, const uchar *)
+{
+    return false;
+}
+
+static inline const uchar *simdFindInvalidUtf8(const uchar *src, const uchar *)
+{
+    return src;
+}
 #endif
 
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
@@ -272,10 +551,17 @@ QString QUtf8::convertToUnicode(const char *chars, int len)
             src += 3;
         }
 
+        const uchar *nextUtf8 = simdDecodeUtf8Supported() ? src : end;
         while (src < end) {
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (src >= nextUtf8) {
+                if (simdDecodeUtf8(dst, src, end))
+                    continue;
+                // that stopped right away, so give it a rest for a few blocks
+                nextUtf8 = src + 64;
+            }
 
             do {
                 uchar b = *src++;
@@ -292,6 +578,31 @@ QString QUtf8::convertToUnicode(const char *chars, int len)
     return result;
 }
 
+bool QUtf8::isValidUtf8(const char *chars, int len)
+{
+    const uchar *src = reinterpret_cast<const uchar *>(chars);
+    const uchar *const end = src + len;
+    const uchar *nextSimd = src;
+    while (src < end) {
+        if (src >= nextSimd) {
+            src = simdFindInvalidUtf8(src, end);
+            if (src == end)
+                break;
+            // that stopped at something it can't handle; go byte by byte for a while
+            nextSimd = src + 64;
+        }
+
+        const uchar b = *src++;
+        if (b < 0x80)
+            continue;
+        uint uc;
+        uint *dst = &uc;
+        if (QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end) < 0)
+            return false;
+    }
+    return true;
+}
+
 QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::ConverterState *state)
 {
     bool headerdone = false;
@@ -364,9 +675,23 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     // main body, stateless decoding
     res = 0;
     const uchar *nextAscii = src;
+    const uchar *nextUtf8 = simdDecodeUtf8Supported() ? src : end;
+    // the ASCII decoding below doesn't check for the BOM; there's none if we start with ASCII
+    if (!headerdone && src < end && *src < 0x80)
+        headerdone = true;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the BOM check below needs the first character decoded here
+            if (headerdone && src >= nextUtf8) {
+                if (simdDecodeUtf8(dst, src, end)) {
+                    nextAscii = src;
+                    continue;
+                }
+                nextUtf8 = src + 64;
+            }
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -285,6 +285,7 @@ struct QUtf8
     static QString convertToUnicode(const char *, int, QTextCodec::ConverterState *);
     static QByteArray convertFromUnicode(const QChar *, int);
     static QByteArray convertFromUnicode(const QChar *, int, QTextCodec::ConverterState *);
+    static bool isValidUtf8(const char *, int);
 };
 
 struct QUtf16
@@ -12,6 +12,7 @@ HEADERS +=  \
         global/qglobalstatic.h \
         global/qlibraryinfo.h \
         global/qlogging.h \
+        global/qlogging_p.h \
         global/qtypeinfo.h \
         global/qsysinfo.h \
         global/qisenum.h \
@@ -34,6 +34,7 @@
 ****************************************************************************/
 
 #include "qlogging.h"
+#include "qlogging_p.h"
 #include "qlist.h"
 #include "qbytearray.h"
 #include "qstring.h"
@@ -46,6 +47,7 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#include "qwaitcondition.h"
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #endif
@@ -69,6 +71,7 @@
 # include <sys/types.h>
 # include <sys/stat.h>
 # include <unistd.h>
+# include <pthread.h>
 # include "private/qcore_unix_p.h"
 #endif
 
@@ -1453,6 +1456,474 @@ static void android_default_message_handler(QtMsgType type,
 }
 #endif //Q_OS_ANDROID
 
+#if defined(Q_COMPILER_THREAD_LOCAL) && !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_THREAD)
+#  define QLOGGING_HAVE_ASYNC_SINK
+
+/*
+    Asynchronous console output of the default message handler.
+
+    Every logging thread appends its formatted messages to a ring buffer of
+    its own, which only it writes to, so logging does not take any lock. A
+    writer thread drains all buffers and writes their contents to stderr in
+    batches. A message that does not fit into the buffer is dropped and
+    counted; the writer reports the number of dropped messages.
+
+    Messages are still formatted in the logging thread, since placeholders
+    like %{threadid}, %{time} and %{backtrace} refer to it.
+
+    A forked child has no writer thread: fork() first waits until everything
+    logged so far is written, and the child then logs synchronously.
+*/
+static QBasicAtomicInt asyncLoggingEnabled = Q_BASIC_ATOMIC_INITIALIZER(-1);
+
+struct QAsyncLogBuffer
+{
+    enum { Capacity = 64 * 1024 };  // must be a power of two
+
+    QAsyncLogBuffer() : next(Q_NULLPTR), droppedSeen(0)
+    {
+        head.store(0);
+        tail.store(0);
+        dropped.store(0);
+        orphaned.store(0);
+    }
+
+    void copyIn(uint pos, const char *src, uint len)
+    {
+        const uint offset = pos & (Capacity - 1);
+        const uint first = qMin(len, uint(Capacity) - offset);
+        memcpy(data + offset, src, first);
+        memcpy(data, src + first, len - first);
+    }
+    void copyOut(uint pos, char *dst, uint len) const
+    {
+        const uint offset = pos & (Capacity - 1);
+        const uint first = qMin(len, uint(Capacity) - offset);
+        memcpy(dst, data + offset, first);
+        memcpy(dst + first, data, len - first);
+    }
+
+    QAsyncLogBuffer *next;
+    uint droppedSeen;                    // only used by the writer
+    QBasicAtomicInteger<uint> head;      // only written by the logging thread
+    QBasicAtomicInteger<uint> dropped;   // only written by the logging thread
+    char padding[64];
+    QBasicAtomicInteger<uint> tail;      // only written by the writer
+    QBasicAtomicInt orphaned;            // set when the logging thread exits
+    char data[Capacity];
+};
+
+struct QAsyncLogBufferOwner
+{
+    ~QAsyncLogBufferOwner()
+    {
+        // the writer frees the buffer once it is drained; anything this
+        // thread logs from now on is written synchronously
+        if (buffer)
+            buffer->orphaned.storeRelease(1);
+        buffer = Q_NULLPTR;
+        exited = true;
+    }
+
+    QAsyncLogBuffer *buffer;
+    bool exited;
+};
+
+static thread_local QAsyncLogBufferOwner asyncLogBufferOwner = { Q_NULLPTR, false };
+
+class QAsyncLogSink;
+
+class QAsyncLogWriterThread : public QThread
+{
+public:
+    explicit QAsyncLogWriterThread(QAsyncLogSink *sink) : sink(sink) {}
+protected:
+    void run() Q_DECL_OVERRIDE;
+private:
+    QAsyncLogSink *sink;
+};
+
+class QAsyncLogSink
+{
+public:
+    enum { WriteInterval = 10 };    // ms
+    enum WriterState {
+        Writing,
+        Waiting,                    // for WriteInterval or a half full buffer
+        Sleeping                    // for the next message
+    };
+
+    QAsyncLogSink();
+    ~QAsyncLogSink();
+
+    void append(const QByteArray &message);
+    void flush();
+    quint64 droppedMessages();
+
+    void run();
+
+private:
+    QAsyncLogBuffer *localBuffer();
+    bool needsWrite(uint threshold) const;
+    bool drain(QByteArray *batch);
+    static void write(QByteArray *batch);
+
+#ifdef Q_OS_UNIX
+    static void prepareFork();
+    static void resumeAfterFork();
+    static void detachInChild();
+#endif
+
+    QBasicAtomicPointer<QAsyncLogBuffer> buffers;
+    QBasicAtomicInt writerState;
+    QMutex mutex;
+    // allocated, so that a forked child can leave them alone: their waiters
+    // only exist in the parent
+    QWaitCondition *wakeWriter;
+    QWaitCondition *flushed;
+    int flushRequested;
+    int flushCompleted;
+    bool quit;
+    bool detached;
+    quint64 droppedTotal;
+    quint64 droppedReported;
+    QAsyncLogWriterThread *thread;
+};
+
+void QAsyncLogWriterThread::run()
+{
+    sink->run();
+}
+
+QAsyncLogSink::QAsyncLogSink()
+    : wakeWriter(new QWaitCondition), flushed(new QWaitCondition),
+      flushRequested(0), flushCompleted(0), quit(false), detached(false),
+      droppedTotal(0), droppedReported(0), thread(new QAsyncLogWriterThread(this))
+{
+    buffers.store(Q_NULLPTR);
+    writerState.store(Writing);
+    thread->setObjectName(QStringLiteral("Qt log writer"));
+    thread->start();
+#ifdef Q_OS_UNIX
+    pthread_atfork(prepareFork, resumeAfterFork, detachInChild);
+#endif
+}
+
+QAsyncLogSink::~QAsyncLogSink()
+{
+    // in a forked child, the writer thread and the buffers of the other
+    // threads belong to the parent; whatever they hold was written there
+    if (detached)
+        return;
+
+    mutex.lock();
+    quit = true;
+    wakeWriter->wakeAll();
+    mutex.unlock();
+    thread->wait();
+    delete thread;
+    delete flushed;
+    delete wakeWriter;
+
+    // write what was logged while the writer was finishing
+    QByteArray batch;
+    drain(&batch);
+
+    // buffers of threads that are still running stay allocated, since those
+    // threads release them when they exit
+    for (QAsyncLogBuffer *buffer = buffers.load(); buffer; ) {
+        QAsyncLogBuffer *next = buffer->next;
+        if (buffer->orphaned.loadAcquire())
+            delete buffer;
+        buffer = next;
+    }
+}
+
+QAsyncLogBuffer *QAsyncLogSink::localBuffer()
+{
+    QAsyncLogBuffer *buffer = asyncLogBufferOwner.buffer;
+    if (!buffer && !asyncLogBufferOwner.exited) {
+        buffer = new QAsyncLogBuffer;
+        QAsyncLogBuffer *first;
+        do {
+            first = buffers.loadAcquire();
+            buffer->next = first;
+        } while (!buffers.testAndSetRelease(first, buffer));
+        asyncLogBufferOwner.buffer = buffer;
+    }
+    return buffer;
+}
+
+void QAsyncLogSink::append(const QByteArray &message)
+{
+    QAsyncLogBuffer *buffer = localBuffer();
+    const uint length = message.size() + 1;
+    const uint recordSize = sizeof(length) + length;
+
+    if (!buffer || recordSize > uint(QAsyncLogBuffer::Capacity)) {
+        // this thread is exiting, or the message could never fit: write it
+        // ourselves, after everything logged before
+        flush();
+        fprintf(stderr, "%s\n", message.constData());
+        fflush(stderr);
+        return;
+    }
+
+    const uint head = buffer->head.load();
+    if (uint(QAsyncLogBuffer::Capacity) - (head - buffer->tail.loadAcquire()) < recordSize) {
+        buffer->dropped.store(buffer->dropped.load() + 1);
+        return;
+    }
+
+    buffer->copyIn(head, reinterpret_cast<const char *>(&length), sizeof(length));
+    buffer->copyIn(head + sizeof(length), message.constData(), length - 1);
+    buffer->copyIn(head + recordSize - 1, "\n", 1);
+
+    // publish the message; the full barrier orders it before reading
+    // writerState, which the writer sets before checking the buffers. A
+    // Waiting writer wakes up by itself every WriteInterval ms, so only wake
+    // it early if the buffer is filling up.
+    buffer->head.fetchAndStoreOrdered(head + recordSize);
+    const uint used = head + recordSize - buffer->tail.load();
+    const int state = writerState.load();
+    if (state == Sleeping || (state == Waiting && used >= uint(QAsyncLogBuffer::Capacity) / 2)) {
+        QMutexLocker lock(&mutex);
+        wakeWriter->wakeOne();
+    }
+}
+
+void QAsyncLogSink::flush()
+{
+    if (detached)
+        return;
+    QMutexLocker lock(&mutex);
+    const int request = ++flushRequested;
+    wakeWriter->wakeOne();
+    while (flushCompleted - request < 0 && !quit)
+        flushed->wait(&mutex);
+}
+
+quint64 QAsyncLogSink::droppedMessages()
+{
+    QMutexLocker lock(&mutex);
+    return droppedTotal;
+}
+
+bool QAsyncLogSink::needsWrite(uint threshold) const
+{
+    for (QAsyncLogBuffer *buffer = buffers.loadAcquire(); buffer; buffer = buffer->next) {
+        if (buffer->head.loadAcquire() - buffer->tail.load() >= threshold)
+            return true;
+    }
+    return false;
+}
+
+void QAsyncLogSink::write(QByteArray *batch)
+{
+    if (batch->isEmpty())
+        return;
+    fwrite(batch->constData(), 1, batch->size(), stderr);
+    fflush(stderr);
+    batch->resize(0);
+}
+
+// Returns \c true if anything was logged since the last call.
+bool QAsyncLogSink::drain(QByteArray *batch)
+{
+    bool logged = false;
+    quint64 dropped = 0;
+    QAsyncLogBuffer *previous = Q_NULLPTR;
+    QAsyncLogBuffer *buffer = buffers.loadAcquire();
+    while (buffer) {
+        QAsyncLogBuffer *next = buffer->next;
+        const bool orphaned = buffer->orphaned.loadAcquire();
+        const uint head = buffer->head.loadAcquire();
+        uint tail = buffer->tail.load();
+        logged = logged || tail != head;
+        while (tail != head) {
+            uint length;
+            buffer->copyOut(tail, reinterpret_cast<char *>(&length), sizeof(length));
+            const int size = batch->size();
+            batch->resize(size + length);
+            buffer->copyOut(tail + sizeof(length), batch->data() + size, length);
+            tail += sizeof(length) + length;
+            if (batch->size() >= QAsyncLogBuffer::Capacity) {
+                buffer->tail.storeRelease(tail);
+                write(batch);
+            }
+        }
+        buffer->tail.storeRelease(tail);
+
+        const uint droppedNow = buffer->dropped.load();
+        dropped += droppedNow - buffer->droppedSeen;
+        buffer->droppedSeen = droppedNow;
+
+        // unlink buffers of exited threads; the first one stays until a new
+        // buffer is pushed in front of it
+        if (orphaned && previous) {
+            previous->next = next;
+            delete buffer;
+        } else {
+            previous = buffer;
+        }
+        buffer = next;
+    }
+
+    if (dropped) {
+        mutex.lock();
+        droppedTotal += dropped;
+        const quint64 report = droppedTotal - droppedReported;
+        droppedReported = droppedTotal;
+        mutex.unlock();
+        batch->append(QByteArray("QtCore: dropped ") + QByteArray::number(report)
+                      + " log messages (asynchronous logging buffer full)\n");
+    }
+    write(batch);
+    return logged || dropped;
+}
+
+void QAsyncLogSink::run()
+{
+    QByteArray batch;
+    batch.reserve(QAsyncLogBuffer::Capacity);
+    forever {
+        mutex.lock();
+        const int flushTarget = flushRequested;
+        const bool stop = quit;
+        mutex.unlock();
+
+        const bool logged = drain(&batch);
+
+        QMutexLocker lock(&mutex);
+        flushCompleted = flushTarget;
+        flushed->wakeAll();
+        if (stop)
+            return;
+        if (flushRequested == flushTarget && !quit) {
+            // once a whole interval passed without messages, sleep until
+            // the next one; the barrier pairs with the one in append()
+            const WriterState state = logged ? Waiting : Sleeping;
+            writerState.fetchAndStoreOrdered(state);
+            if (state == Waiting && !needsWrite(uint(QAsyncLogBuffer::Capacity) / 2))
+                wakeWriter->wait(&mutex, WriteInterval);
+            else if (state == Sleeping && !needsWrite(1))
+                wakeWriter->wait(&mutex);
+            writerState.store(Writing);
+        }
+    }
+}
+
+Q_GLOBAL_STATIC(QAsyncLogSink, asyncLogSink)
+
+#ifdef Q_OS_UNIX
+// set by prepareFork() in the forking thread, if it holds the sink's mutex
+static thread_local bool asyncLogSinkLockedForFork = false;
+
+void QAsyncLogSink::prepareFork()
+{
+    // write everything logged before fork() exactly once, and keep the
+    // writer from holding the mutex while the process is copied
+    if (!asyncLogSink.exists() || asyncLogSink.isDestroyed())
+        return;
+    QAsyncLogSink *sink = asyncLogSink();
+    sink->flush();
+    sink->mutex.lock();
+    asyncLogSinkLockedForFork = true;
+}
+
+void QAsyncLogSink::resumeAfterFork()
+{
+    if (!asyncLogSinkLockedForFork)
+        return;
+    asyncLogSinkLockedForFork = false;
+    asyncLogSink()->mutex.unlock();
+}
+
+void QAsyncLogSink::detachInChild()
+{
+    asyncLoggingEnabled.store(0);
+    if (asyncLogSink.exists() && !asyncLogSink.isDestroyed())
+        asyncLogSink()->detached = true;
+    if (!asyncLogSinkLockedForFork)
+        return;
+    asyncLogSinkLockedForFork = false;
+    asyncLogSink()->mutex.unlock();
+}
+#endif
+
+static bool useAsyncLogging()
+{
+    int enabled = asyncLoggingEnabled.loadAcquire();
+    if (enabled < 0) {
+        enabled = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC") ? 1 : 0;
+        asyncLoggingEnabled.testAndSetRelaxed(-1, enabled);
+        enabled = asyncLoggingEnabled.loadAcquire();
+    }
+    return enabled;
+}
+#endif // Q_COMPILER_THREAD_LOCAL && !QT_BOOTSTRAPPED && !QT_NO_THREAD
+
+/*!
+    \internal
+
+    Returns whether the default message handler writes to the console
+    asynchronously.
+*/
+bool qt_async_logging()
+{
+#ifdef QLOGGING_HAVE_ASYNC_SINK
+    return useAsyncLogging();
+#else
+    return false;
+#endif
+}
+
+/*!
+    \internal
+
+    Enables or disables asynchronous console output of the default message
+    handler, overriding the QT_LOGGING_ASYNC environment variable.
+*/
+void qt_set_async_logging(bool enable)
+{
+#ifdef QLOGGING_HAVE_ASYNC_SINK
+    if (!enable)
+        qt_flush_async_logging();
+    asyncLoggingEnabled.storeRelease(enable ? 1 : 0);
+#else
+    Q_UNUSED(enable);
+#endif
+}
+
+/*!
+    \internal
+
+    Returns once all messages logged asynchronously before the call have been
+    written.
+*/
+void qt_flush_async_logging()
+{
+#ifdef QLOGGING_HAVE_ASYNC_SINK
+    if (asyncLogSink.exists() && !asyncLogSink.isDestroyed())
+        asyncLogSink()->flush();
+#endif
+}
+
+/*!
+    \internal
+
+    Returns the number of messages dropped because the asynchronous logging
+    buffer of their thread was full, up to the last flush.
+*/
+quint64 qt_async_logging_dropped_messages()
+{
+#ifdef QLOGGING_HAVE_ASYNC_SINK
+    if (asyncLogSink.exists() && !asyncLogSink.isDestroyed())
+        return asyncLogSink()->droppedMessages();
+#endif
+    return 0;
+}
+
 /*!
     \internal
 */
@@ -1483,6 +1954,19 @@ static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &con
         return;
 #endif
     }
+
+#ifdef QLOGGING_HAVE_ASYNC_SINK
+    if (useAsyncLogging()) {
+        QAsyncLogSink *sink = asyncLogSink();
+        if (sink && !isFatal(type)) {
+            sink->append(logMessage.toLocal8Bit());
+            return;
+        }
+        // write fatal messages after everything logged before them
+        if (sink)
+            sink->flush();
+    }
+#endif
     fprintf(stderr, "%s\n", logMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -1665,6 +2149,16 @@ void qErrnoWarning(int code, const char *msg, ...)
     output under X11 or to the debugger under Windows. If it is a
     fatal message, the application aborts immediately.
 
+    If the environment variable \c QT_LOGGING_ASYNC is set to a non-zero
+    value, the default message handler writes to the console
+    asynchronously: messages are formatted in the calling thread, but
+    written in batches by a background thread, so that threads logging
+    concurrently do not wait for each other. Every thread buffers up to
+    64 KB of messages; messages that do not fit are dropped, and the number
+    of dropped messages is reported in the output. Buffered messages are
+    written before a fatal message and when the application exits, but
+    may be lost if the application crashes.
+
     Only one message handler can be defined, since this is usually
     done on an application-wide basis to control debug output.
 
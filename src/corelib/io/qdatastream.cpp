@@ -40,7 +40,9 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <limits.h>
 #include "qendian.h"
+#include <private/qsimd_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -1173,6 +1175,164 @@ int QDataStream::skipRawData(int len)
     }
 }
 
+/*****************************************************************************
+  QDataStream array streaming
+ *****************************************************************************/
+
+template <typename T>
+static void swapScalars(char *data, qint64 count)
+{
+    for (qint64 i = 0; i < count; ++i) {
+        T value;
+        memcpy(&value, data + i * sizeof(T), sizeof(T));
+        value = qbswap(value);
+        memcpy(data + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+QT_FUNCTION_TARGET(SSSE3)
+static qint64 swapScalarsSsse3(char *data, qint64 size, int scalarSize)
+{
+    const __m128i mask = scalarSize == 2
+            ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+            : scalarSize == 4
+            ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+            : _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    qint64 i = 0;
+    for ( ; i + 16 <= size; i += 16) {
+        __m128i *p = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+    }
+    return i;
+}
+#endif
+
+// swaps the byte order of the scalarSize-byte values in data, in place
+static void swapScalars(char *data, qint64 size, int scalarSize)
+{
+    qint64 done = 0;
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+    if (qCpuHasFeature(SSSE3))
+        done = swapScalarsSsse3(data, size, scalarSize);
+#endif
+    switch (scalarSize) {
+    case 2:
+        swapScalars<quint16>(data + done, (size - done) / 2);
+        break;
+    case 4:
+        swapScalars<quint32>(data + done, (size - done) / 4);
+        break;
+    case 8:
+        swapScalars<quint64>(data + done, (size - done) / 8);
+        break;
+    }
+}
+
+// whether arrays of this kind have the same format as their elements
+// written one by one with the stream's current settings
+static bool canStreamArray(const QDataStream &s, QtPrivate::DataStreamArrayKind kind)
+{
+    if (!s.device())
+        return false;
+
+    switch (kind) {
+    case QtPrivate::NoArrayStreaming:
+        return false;
+    case QtPrivate::IntegerArray:
+        return true;
+    case QtPrivate::Integer64Array:
+        // older versions write two 32-bit halves
+        return s.version() >= 6;
+    case QtPrivate::FloatArray:
+        return s.version() < QDataStream::Qt_4_6
+                || s.floatingPointPrecision() == QDataStream::SinglePrecision;
+    case QtPrivate::DoubleArray:
+        return s.version() < QDataStream::Qt_4_6
+                || s.floatingPointPrecision() == QDataStream::DoublePrecision;
+    }
+    return false;
+}
+
+static inline bool needsByteSwap(const QDataStream &s, int scalarSize)
+{
+    return scalarSize > 1 && s.byteOrder() != QDataStream::ByteOrder(QSysInfo::ByteOrder);
+}
+
+/*!
+    \internal
+
+    Writes the \a count elements at \a data, which are \a stride bytes
+    apart, in blocks instead of one by one. Returns false if \a kind
+    can't be streamed that way with the current settings of \a s.
+*/
+bool QtPrivate::writeDataStreamArray(QDataStream &s, const void *data, int count, int stride,
+                                     DataStreamArrayKind kind, int scalarSize, int elementSize)
+{
+    if (!canStreamArray(s, kind))
+        return false;
+
+    const char *src = static_cast<const char *>(data);
+    const bool swap = needsByteSwap(s, scalarSize);
+    if (!swap && stride == elementSize) {
+        // the stream format is the memory layout
+        const int maxCount = INT_MAX / elementSize;
+        while (count > 0 && s.status() == QDataStream::Ok) {
+            const int n = qMin(count, maxCount);
+            s.writeRawData(src, n * elementSize);
+            src += qint64(n) * elementSize;
+            count -= n;
+        }
+        return true;
+    }
+
+    char buffer[4096];
+    const int blockCount = int(sizeof(buffer)) / elementSize;
+    while (count > 0 && s.status() == QDataStream::Ok) {
+        const int n = qMin(count, blockCount);
+        if (stride == elementSize) {
+            memcpy(buffer, src, n * elementSize);
+        } else {
+            for (int i = 0; i < n; ++i)
+                memcpy(buffer + i * elementSize, src + i * stride, elementSize);
+        }
+        if (swap)
+            swapScalars(buffer, n * elementSize, scalarSize);
+        s.writeRawData(buffer, n * elementSize);
+        src += qint64(n) * stride;
+        count -= n;
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Reads up to \a count contiguous elements into \a data at once and
+    returns the number of bytes read. Scalars that could not be read
+    completely are set to zero. Returns -1 if \a kind can't be streamed
+    that way with the current settings of \a s.
+*/
+qint64 QtPrivate::readDataStreamArray(QDataStream &s, void *data, int count,
+                                      DataStreamArrayKind kind, int scalarSize, int elementSize)
+{
+    if (!canStreamArray(s, kind))
+        return -1;
+
+    char *dst = static_cast<char *>(data);
+    const qint64 size = qint64(count) * elementSize;
+    qint64 bytes = s.device()->read(dst, size);
+    if (bytes < 0)
+        bytes = 0;
+    // like reading the scalars one by one, keep those of an incomplete
+    // element that were read completely
+    const qint64 complete = bytes - bytes % scalarSize;
+    memset(dst + complete, 0, size - complete);
+    if (needsByteSwap(s, scalarSize))
+        swapScalars(dst, complete, scalarSize);
+    return bytes;
+}
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_DATASTREAM
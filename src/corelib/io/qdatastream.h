@@ -54,6 +54,7 @@ template <typename T> class QVector;
 template <typename T> class QSet;
 template <class Key, class T> class QHash;
 template <class Key, class T> class QMap;
+class QPointF;
 
 #if !defined(QT_NO_DATASTREAM) || defined(QT_BOOTSTRAPPED)
 class QDataStreamPrivate;
@@ -221,6 +222,117 @@ inline QDataStream &QDataStream::operator<<(quint32 i)
 inline QDataStream &QDataStream::operator<<(quint64 i)
 { return *this << qint64(i); }
 
+namespace QtPrivate {
+
+// Element types that are streamed as a fixed number of scalars laid out
+// in memory exactly as in the stream, apart from the byte order. Arrays of
+// them are read and written in blocks instead of element by element.
+enum DataStreamArrayKind {
+    NoArrayStreaming,
+    IntegerArray,
+    Integer64Array,
+    FloatArray,
+    DoubleArray
+};
+
+template <typename T>
+struct DataStreamArrayTraits
+{
+    enum { IsSupported = false, Kind = NoArrayStreaming, ScalarSize = 1, ElementSize = 1 };
+};
+
+#define Q_DATASTREAM_ARRAY_TYPE(Type, ArrayKind, Scalar, Count) \
+template <> \
+struct DataStreamArrayTraits<Type> \
+{ \
+    enum { \
+        IsSupported = (ArrayKind) != NoArrayStreaming, \
+        Kind = ArrayKind, \
+        ScalarSize = sizeof(Scalar), \
+        ElementSize = sizeof(Scalar) * Count \
+    }; \
+};
+
+Q_DATASTREAM_ARRAY_TYPE(qint8, IntegerArray, qint8, 1)
+Q_DATASTREAM_ARRAY_TYPE(quint8, IntegerArray, quint8, 1)
+Q_DATASTREAM_ARRAY_TYPE(qint16, IntegerArray, qint16, 1)
+Q_DATASTREAM_ARRAY_TYPE(quint16, IntegerArray, quint16, 1)
+Q_DATASTREAM_ARRAY_TYPE(qint32, IntegerArray, qint32, 1)
+Q_DATASTREAM_ARRAY_TYPE(quint32, IntegerArray, quint32, 1)
+Q_DATASTREAM_ARRAY_TYPE(qint64, Integer64Array, qint64, 1)
+Q_DATASTREAM_ARRAY_TYPE(quint64, Integer64Array, quint64, 1)
+Q_DATASTREAM_ARRAY_TYPE(float, FloatArray, float, 1)
+Q_DATASTREAM_ARRAY_TYPE(double, DoubleArray, double, 1)
+Q_DATASTREAM_ARRAY_TYPE(QPointF, (sizeof(qreal) == sizeof(double) ? DoubleArray : NoArrayStreaming), double, 2)
+
+#undef Q_DATASTREAM_ARRAY_TYPE
+
+Q_CORE_EXPORT bool writeDataStreamArray(QDataStream &s, const void *data, int count, int stride,
+                                        DataStreamArrayKind kind, int scalarSize, int elementSize);
+Q_CORE_EXPORT qint64 readDataStreamArray(QDataStream &s, void *data, int count,
+                                         DataStreamArrayKind kind, int scalarSize, int elementSize);
+
+// Writes \a count elements that are \a stride bytes apart. Returns false
+// if the elements have to be written one by one instead.
+template <typename T>
+inline bool writeDataStreamArray(QDataStream &s, const T *data, int count, int stride = sizeof(T))
+{
+    typedef DataStreamArrayTraits<T> Traits;
+    return Traits::IsSupported
+            && writeDataStreamArray(s, data, count, stride, DataStreamArrayKind(Traits::Kind),
+                                    Traits::ScalarSize, Traits::ElementSize);
+}
+
+// Reads up to \a count elements and returns the number of bytes read, or
+// -1 if the elements have to be read one by one instead. Scalars that
+// could not be read completely are zeroed.
+template <typename T>
+inline qint64 readDataStreamArray(QDataStream &s, T *data, int count)
+{
+    typedef DataStreamArrayTraits<T> Traits;
+    if (!Traits::IsSupported)
+        return -1;
+    return readDataStreamArray(s, data, count, DataStreamArrayKind(Traits::Kind),
+                               Traits::ScalarSize, Traits::ElementSize);
+}
+
+template <typename T, bool = DataStreamArrayTraits<T>::IsSupported>
+struct DataStreamListReader
+{
+    static bool read(QDataStream &, QList<T> &, quint32) { return false; }
+};
+
+template <typename T>
+struct DataStreamListReader<T, true>
+{
+    // Reads the elements in blocks and stops at the end of the data, as
+    // reading them one by one does. Returns false if the elements have to
+    // be read one by one instead.
+    static bool read(QDataStream &s, QList<T> &l, quint32 c)
+    {
+        enum { ElementSize = DataStreamArrayTraits<T>::ElementSize };
+        T buffer[4096 / ElementSize];
+        for (quint32 i = 0; i < c; ) {
+            const int n = int(qMin(c - i, quint32(sizeof(buffer) / sizeof(T))));
+            const int bytes = int(readDataStreamArray(s, buffer, n));
+            if (bytes < 0)
+                return false;
+            // an incomplete element is read as zero
+            const int elements = bytes ? (bytes + ElementSize - 1) / ElementSize : 1;
+            if (!bytes || bytes % ElementSize)
+                s.setStatus(QDataStream::ReadPastEnd);
+            for (int j = 0; j < elements; ++j)
+                l.append(buffer[j]);
+            i += elements;
+            if (elements < n || s.atEnd())
+                break;
+        }
+        return true;
+    }
+};
+
+} // namespace QtPrivate
+
 template <typename T>
 QDataStream& operator>>(QDataStream& s, QList<T>& l)
 {
@@ -228,6 +340,8 @@ QDataStream& operator>>(QDataStream& s, QList<T>& l)
     quint32 c;
     s >> c;
     l.reserve(c);
+    if (QtPrivate::DataStreamListReader<T>::read(s, l, c))
+        return s;
     for(quint32 i = 0; i < c; ++i)
     {
         T t;
@@ -243,6 +357,10 @@ template <typename T>
 QDataStream& operator<<(QDataStream& s, const QList<T>& l)
 {
     s << quint32(l.size());
+    // small movable types are stored in place, one per pointer sized slot
+    if (!QTypeInfo<T>::isLarge && !QTypeInfo<T>::isStatic && !l.isEmpty()
+            && QtPrivate::writeDataStreamArray(s, &l.at(0), l.size(), sizeof(void *)))
+        return s;
     for (int i = 0; i < l.size(); ++i)
         s << l.at(i);
     return s;
@@ -282,6 +400,12 @@ QDataStream& operator>>(QDataStream& s, QVector<T>& v)
     quint32 c;
     s >> c;
     v.resize(c);
+    const qint64 bytes = QtPrivate::readDataStreamArray(s, v.data(), v.size());
+    if (bytes >= 0) {
+        if (bytes < v.size() * qint64(QtPrivate::DataStreamArrayTraits<T>::ElementSize))
+            s.setStatus(QDataStream::ReadPastEnd);
+        return s;
+    }
     for(quint32 i = 0; i < c; ++i) {
         T t;
         s >> t;
@@ -294,6 +418,8 @@ template<typename T>
 QDataStream& operator<<(QDataStream& s, const QVector<T>& v)
 {
     s << quint32(v.size());
+    if (QtPrivate::writeDataStreamArray(s, v.constData(), v.size()))
+        return s;
     for (typename QVector<T>::const_iterator it = v.begin(); it != v.end(); ++it)
         s << *it;
     return s;
@@ -77,6 +77,15 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value Parallel When combined with Subdirectories, directories are listed
+    concurrently by a pool of worker threads owned by the iterator, and next()
+    returns entries as soon as any worker has found them. This speeds up
+    walking large trees, in particular on network file systems where each
+    directory read waits on the server. The order in which entries are
+    returned is not deterministic. This flag has no effect for paths handled
+    by a QAbstractFileEngine, such as resources. This value was introduced in
+    Qt 5.6.
 */
 
 #include "qdiriterator.h"
@@ -86,6 +95,13 @@
 #include <QtCore/qset.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qvariant.h>
+#ifndef QT_NO_THREAD
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+#endif
 
 #include <QtCore/private/qfilesystemiterator_p.h>
 #include <QtCore/private/qfilesystementry_p.h>
@@ -105,6 +121,52 @@ public:
     }
 };
 
+#if !defined(QT_NO_FILESYSTEMITERATOR) && !defined(QT_NO_THREAD)
+#define QDIRITERATOR_PARALLEL
+
+// Shared state of a QDirIterator::Parallel walk. Every directory is listed
+// by a QDirIteratorWalkTask running in the pool; the entries that pass the
+// filters are appended to the results queue in batches, from which the
+// iterating thread takes them. The queue is bounded so that a slow consumer
+// cannot make a walk of a huge tree buffer it entirely in memory.
+struct QDirIteratorParallelWalk
+{
+    enum {
+        BatchSize = 64,
+        MaxQueuedResults = 16 * 1024
+    };
+
+    QDirIteratorParallelWalk() : pendingDirectories(0), cancelled(0)
+    {
+        pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+    }
+
+    ~QDirIteratorParallelWalk()
+    {
+        {
+            QMutexLocker locker(&mutex);
+            cancelled.store(1);
+            spaceAvailable.wakeAll();
+        }
+        pool.clear();
+        pool.waitForDone();
+    }
+
+    QMutex mutex;
+    QWaitCondition resultsAvailable;
+    QWaitCondition spaceAvailable;
+    QList<QFileInfo> results;
+    int pendingDirectories;
+    // written under the mutex, but also polled by the workers without it
+    QAtomicInt cancelled;
+
+    // protects QDirIteratorPrivate::visitedLinks
+    QMutex linksMutex;
+
+    QThreadPool pool;
+};
+#endif
+
 class QDirIteratorPrivate
 {
 public:
@@ -116,7 +178,14 @@ public:
     bool entryMatches(const QString & fileName, const QFileInfo &fileInfo);
     void pushDirectory(const QFileInfo &fileInfo);
     void checkAndPushDirectory(const QFileInfo &);
+#ifndef QT_NO_REGEXP
+    bool matchesFilters(const QString &fileName, const QFileInfo &fi) const
+    { return matchesFilters(fileName, fi, nameRegExps); }
+    bool matchesFilters(const QString &fileName, const QFileInfo &fi,
+                        const QVector<QRegExp> &regExps) const;
+#else
     bool matchesFilters(const QString &fileName, const QFileInfo &fi) const;
+#endif
 
     QScopedPointer<QAbstractFileEngine> engine;
 
@@ -139,8 +208,52 @@ public:
 
     // Loop protection
     QSet<QString> visitedLinks;
+
+#ifdef QDIRITERATOR_PARALLEL
+    void walkDirectory(const QFileSystemEntry &entry);
+    bool deliver(QList<QFileInfo> &batch, bool finished);
+
+    // Declared last: destroying it waits for the workers, which use the
+    // members above.
+    QScopedPointer<QDirIteratorParallelWalk> parallelWalk;
+    bool parallelHasNext;
+#endif
 };
 
+#ifdef QDIRITERATOR_PARALLEL
+class QDirIteratorWalkTask : public QRunnable
+{
+public:
+    QDirIteratorWalkTask(QDirIteratorPrivate *d, const QFileSystemEntry &entry)
+        : d(d), entry(entry)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        d->walkDirectory(entry);
+    }
+
+private:
+    QDirIteratorPrivate *d;
+    const QFileSystemEntry entry;
+};
+#endif
+
+#ifndef QT_NO_REGEXP
+static QVector<QRegExp> nameFilterRegExps(const QStringList &nameFilters, QDir::Filters filters)
+{
+    QVector<QRegExp> regExps;
+    regExps.reserve(nameFilters.size());
+    for (int i = 0; i < nameFilters.size(); ++i)
+        regExps.append(
+            QRegExp(nameFilters.at(i),
+                    (filters & QDir::CaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive,
+                    QRegExp::Wildcard));
+    return regExps;
+}
+#endif
+
 /*!
     \internal
 */
@@ -150,20 +263,23 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
       , nameFilters(nameFilters.contains(QLatin1String("*")) ? QStringList() : nameFilters)
       , filters(QDir::NoFilter == filters ? QDir::AllEntries : filters)
       , iteratorFlags(flags)
+#ifdef QDIRITERATOR_PARALLEL
+      , parallelHasNext(false)
+#endif
 {
 #ifndef QT_NO_REGEXP
-    nameRegExps.reserve(nameFilters.size());
-    for (int i = 0; i < nameFilters.size(); ++i)
-        nameRegExps.append(
-            QRegExp(nameFilters.at(i),
-                    (filters & QDir::CaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive,
-                    QRegExp::Wildcard));
+    nameRegExps = nameFilterRegExps(nameFilters, filters);
 #endif
     QFileSystemMetaData metaData;
     if (resolveEngine)
         engine.reset(QFileSystemEngine::resolveEntryAndCreateLegacyEngine(dirEntry, metaData));
     QFileInfo fileInfo(new QFileInfoPrivate(dirEntry, metaData));
 
+#ifdef QDIRITERATOR_PARALLEL
+    if (!engine && (flags & QDirIterator::Parallel) && (flags & QDirIterator::Subdirectories))
+        parallelWalk.reset(new QDirIteratorParallelWalk);
+#endif
+
     // Populate fields for hasNext() and next()
     pushDirectory(fileInfo);
     advance();
@@ -181,8 +297,25 @@ void QDirIteratorPrivate::pushDirectory(const QFileInfo &fileInfo)
         path = fileInfo.canonicalFilePath();
 #endif
 
-    if (iteratorFlags & QDirIterator::FollowSymlinks)
+    if (iteratorFlags & QDirIterator::FollowSymlinks) {
+#ifdef QDIRITERATOR_PARALLEL
+        QMutexLocker locker(parallelWalk ? &parallelWalk->linksMutex : 0);
+#endif
         visitedLinks << fileInfo.canonicalFilePath();
+    }
+
+#ifdef QDIRITERATOR_PARALLEL
+    if (parallelWalk) {
+        {
+            QMutexLocker locker(&parallelWalk->mutex);
+            if (parallelWalk->cancelled.load())
+                return;
+            ++parallelWalk->pendingDirectories;
+        }
+        parallelWalk->pool.start(new QDirIteratorWalkTask(this, fileInfo.d_ptr->fileEntry));
+        return;
+    }
+#endif
 
     if (engine) {
         engine->setFileName(path);
@@ -222,6 +355,26 @@ inline bool QDirIteratorPrivate::entryMatches(const QString & fileName, const QF
 */
 void QDirIteratorPrivate::advance()
 {
+#ifdef QDIRITERATOR_PARALLEL
+    if (parallelWalk) {
+        QDirIteratorParallelWalk *walk = parallelWalk.data();
+        QMutexLocker locker(&walk->mutex);
+        while (walk->results.isEmpty() && walk->pendingDirectories)
+            walk->resultsAvailable.wait(&walk->mutex);
+
+        currentFileInfo = nextFileInfo;
+        parallelHasNext = !walk->results.isEmpty();
+        if (parallelHasNext) {
+            nextFileInfo = walk->results.takeFirst();
+            if (walk->results.size() == QDirIteratorParallelWalk::MaxQueuedResults - 1)
+                walk->spaceAvailable.wakeAll();
+        } else {
+            nextFileInfo = QFileInfo();
+        }
+        return;
+    }
+#endif
+
     if (engine) {
         while (!fileEngineIterators.isEmpty()) {
             // Find the next valid iterator that matches the filters.
@@ -260,6 +413,72 @@ void QDirIteratorPrivate::advance()
     nextFileInfo = QFileInfo();
 }
 
+#ifdef QDIRITERATOR_PARALLEL
+/*!
+    \internal
+
+    Lists one directory on behalf of a parallel walk. Runs in a worker
+    thread; subdirectories are handed back to the pool by
+    checkAndPushDirectory().
+*/
+void QDirIteratorPrivate::walkDirectory(const QFileSystemEntry &entry)
+{
+#ifndef QT_NO_REGEXP
+    // a QRegExp is not reentrant, not even through copies, so each listing
+    // matches with regexps of its own
+    const QVector<QRegExp> regExps = nameFilterRegExps(nameFilters, filters);
+#endif
+    QFileSystemIterator it(entry, filters, nameFilters, iteratorFlags);
+    QFileSystemEntry nextEntry;
+    QFileSystemMetaData nextMetaData;
+    QList<QFileInfo> batch;
+
+    while (!parallelWalk->cancelled.load() && it.advance(nextEntry, nextMetaData)) {
+        QFileInfo info(new QFileInfoPrivate(nextEntry, nextMetaData));
+        checkAndPushDirectory(info);
+#ifndef QT_NO_REGEXP
+        const bool matches = matchesFilters(nextEntry.fileName(), info, regExps);
+#else
+        const bool matches = matchesFilters(nextEntry.fileName(), info);
+#endif
+        if (matches) {
+            batch.append(info);
+            if (batch.size() == QDirIteratorParallelWalk::BatchSize && !deliver(batch, false))
+                return;
+        }
+    }
+
+    deliver(batch, true);
+}
+
+/*!
+    \internal
+
+    Moves \a batch to the results of the parallel walk, waiting for the
+    iterating thread to catch up if too many results are queued. If \a
+    finished is true, the calling worker is done with its directory.
+
+    Returns \c false if the walk was cancelled, in which case the worker is
+    considered done and must stop.
+*/
+bool QDirIteratorPrivate::deliver(QList<QFileInfo> &batch, bool finished)
+{
+    QDirIteratorParallelWalk *walk = parallelWalk.data();
+    QMutexLocker locker(&walk->mutex);
+    while (walk->results.size() >= QDirIteratorParallelWalk::MaxQueuedResults && !walk->cancelled.load())
+        walk->spaceAvailable.wait(&walk->mutex);
+
+    const bool cancelled = walk->cancelled.load();
+    if (!cancelled)
+        walk->results.append(batch);
+    batch.clear();
+    if (finished || cancelled)
+        --walk->pendingDirectories;
+    walk->resultsAvailable.wakeOne();
+    return !cancelled;
+}
+#endif
+
 /*!
     \internal
  */
@@ -287,9 +506,21 @@ void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
         return;
 
     // Stop link loops
-    if (!visitedLinks.isEmpty() &&
-        visitedLinks.contains(fileInfo.canonicalFilePath()))
-        return;
+    if (iteratorFlags & QDirIterator::FollowSymlinks) {
+        const QString canonicalPath = fileInfo.canonicalFilePath();
+#ifdef QDIRITERATOR_PARALLEL
+        QMutexLocker locker(parallelWalk ? &parallelWalk->linksMutex : 0);
+        if (visitedLinks.contains(canonicalPath))
+            return;
+        // claim the directory while holding the lock, so that no other
+        // worker descends into it through another link
+        if (parallelWalk)
+            visitedLinks << canonicalPath;
+#else
+        if (visitedLinks.contains(canonicalPath))
+            return;
+#endif
+    }
 
     pushDirectory(fileInfo);
 }
@@ -305,7 +536,12 @@ void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
     otherwise, false is returned.
 */
 
+#ifndef QT_NO_REGEXP
+bool QDirIteratorPrivate::matchesFilters(const QString &fileName, const QFileInfo &fi,
+                                         const QVector<QRegExp> &regExps) const
+#else
 bool QDirIteratorPrivate::matchesFilters(const QString &fileName, const QFileInfo &fi) const
+#endif
 {
     Q_ASSERT(!fileName.isEmpty());
 
@@ -324,8 +560,8 @@ bool QDirIteratorPrivate::matchesFilters(const QString &fileName, const QFileInf
     // Pass all entries through name filters, except dirs if the AllDirs
     if (!nameFilters.isEmpty() && !((filters & QDir::AllDirs) && fi.isDir())) {
         bool matched = false;
-        for (QVector<QRegExp>::const_iterator iter = nameRegExps.constBegin(),
-                                              end = nameRegExps.constEnd();
+        for (QVector<QRegExp>::const_iterator iter = regExps.constBegin(),
+                                              end = regExps.constEnd();
                 iter != end; ++iter) {
 
             QRegExp copy = *iter;
@@ -490,6 +726,10 @@ QString QDirIterator::next()
 */
 bool QDirIterator::hasNext() const
 {
+#ifdef QDIRITERATOR_PARALLEL
+    if (d->parallelWalk)
+        return d->parallelHasNext;
+#endif
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
     else
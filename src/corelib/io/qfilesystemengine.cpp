@@ -216,6 +216,49 @@ bool QFileSystemEngine::fillMetaData(int fd, QFileSystemMetaData &data)
     return false;
 }
 
+//static
+bool QFileSystemEngine::fillMetaData(int dirFd, const char *name, QFileSystemMetaData &data)
+{
+#if defined(AT_SYMLINK_NOFOLLOW)
+#  if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#    define QT_FSTATAT ::fstatat64
+#  else
+#    define QT_FSTATAT ::fstatat
+#  endif
+    // Same as fillMetaData(entry, data, LinkType | PosixStatFlags), but the
+    // kernel does not need to resolve the path of the entry again.
+    QT_STATBUF statBuffer;
+    if (!(data.knownFlagsMask & QFileSystemMetaData::LinkType)) {
+        if (QT_FSTATAT(dirFd, name, &statBuffer, AT_SYMLINK_NOFOLLOW) != 0)
+            return false;
+
+        data.knownFlagsMask |= QFileSystemMetaData::LinkType;
+        if (!S_ISLNK(statBuffer.st_mode)) {
+            data.entryFlags &= ~(QFileSystemMetaData::LinkType | QFileSystemMetaData::PosixStatFlags);
+            data.fillFromStatBuf(statBuffer);
+            data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags
+                | QFileSystemMetaData::ExistsAttribute;
+            return true;
+        }
+        data.entryFlags |= QFileSystemMetaData::LinkType;
+    }
+
+    // for symbolic links, describe the target; broken links are left for
+    // fillMetaData() to handle
+    if (QT_FSTATAT(dirFd, name, &statBuffer, 0) != 0)
+        return false;
+    data.entryFlags &= ~QFileSystemMetaData::PosixStatFlags;
+    data.fillFromStatBuf(statBuffer);
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags
+        | QFileSystemMetaData::ExistsAttribute;
+    return true;
+#  undef QT_FSTATAT
+#else
+    Q_UNUSED(dirFd) Q_UNUSED(name) Q_UNUSED(data)
+    return false;
+#endif
+}
+
 #if defined(QT_EXT_QNX_READDIR_R)
 static void fillStat64fromStat32(struct stat64 *statBuf64, const struct stat &statBuf32)
 {
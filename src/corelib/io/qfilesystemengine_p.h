@@ -86,6 +86,7 @@ public:
                              QFileSystemMetaData::MetaDataFlags what);
 #if defined(Q_OS_UNIX)
     static bool fillMetaData(int fd, QFileSystemMetaData &data); // what = PosixStatFlags
+    static bool fillMetaData(int dirFd, const char *name, QFileSystemMetaData &data); // what = LinkType | PosixStatFlags
 #endif
 #if defined(Q_OS_WIN)
 
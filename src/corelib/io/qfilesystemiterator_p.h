@@ -96,6 +96,7 @@ private:
 #endif
 #endif
     int lastError;
+    bool needsFileType;
 #endif
 
     Q_DISABLE_COPY(QFileSystemIterator)
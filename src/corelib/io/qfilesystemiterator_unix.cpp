@@ -33,6 +33,7 @@
 
 #include "qplatformdefs.h"
 #include "qfilesystemiterator_p.h"
+#include "qfilesystemengine_p.h"
 
 #ifndef QT_NO_FILESYSTEMITERATOR
 
@@ -41,6 +42,25 @@
 
 QT_BEGIN_NAMESPACE
 
+// Returns \c true if QDirIterator needs to know the type of the entries
+// to apply \a filters and \a nameFilters, or to find the subdirectories.
+// Otherwise the type is not looked up unless QFileInfo is asked for it.
+static bool filtersNeedFileType(QDir::Filters filters, const QStringList &nameFilters,
+                                QDirIterator::IteratorFlags flags)
+{
+    if (filters == QDir::NoFilter)
+        filters = QDir::AllEntries;
+
+    if (flags & QDirIterator::Subdirectories)
+        return true;
+    if (!(filters & QDir::System) || (filters & (QDir::NoSymLinks | QDir::PermissionMask)))
+        return true;
+    if (!(filters & QDir::Files) || !(filters & (QDir::Dirs | QDir::AllDirs)))
+        return true;
+    // directories bypass the name filters
+    return (filters & QDir::AllDirs) && !nameFilters.isEmpty();
+}
+
 QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
                                          const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
     : nativePath(entry.nativeFilePath())
@@ -50,10 +70,8 @@ QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Fi
     , direntSize(0)
 #endif
     , lastError(0)
+    , needsFileType(filtersNeedFileType(filters, nameFilters, flags))
 {
-    Q_UNUSED(filters)
-    Q_UNUSED(nameFilters)
-    Q_UNUSED(flags)
 
     if ((dir = QT_OPENDIR(nativePath.constData())) == 0) {
         lastError = errno;
@@ -114,6 +132,16 @@ bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaDa
     if (dirEntry) {
         fileEntry = QFileSystemEntry(nativePath + QByteArray(dirEntry->d_name), QFileSystemEntry::FromNativePath());
         metaData.fillFromDirEnt(*dirEntry);
+
+        // Some file systems (NFS, XFS and others) do not report the type of
+        // the entries, and symbolic links need their target examined. If the
+        // filters need the type, doing it now, relative to the directory, is
+        // cheaper than the stat() of the full path QFileInfo would do later.
+#if defined(AT_SYMLINK_NOFOLLOW)
+        if (needsFileType
+                && !metaData.hasFlags(QFileSystemMetaData::LinkType | QFileSystemMetaData::DirectoryType))
+            QFileSystemEngine::fillMetaData(dirfd(dir), dirEntry->d_name, metaData);
+#endif
         return true;
     }
 
@@ -39,6 +39,7 @@
 #include <qdatetime.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qdiriterator.h>
 #include <qfileinfo.h>
 #include <qset.h>
 #include <qtimer.h>
@@ -79,7 +80,7 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(0), poller(0)
+    : native(0), poller(0), treeEngine(0), coalescingInterval(0), coalescingTimer(0)
 {
 }
 
@@ -87,16 +88,8 @@ void QFileSystemWatcherPrivate::init()
 {
     Q_Q(QFileSystemWatcher);
     native = createNativeEngine(q);
-    if (native) {
-        QObject::connect(native,
-                         SIGNAL(fileChanged(QString,bool)),
-                         q,
-                         SLOT(_q_fileChanged(QString,bool)));
-        QObject::connect(native,
-                         SIGNAL(directoryChanged(QString,bool)),
-                         q,
-                         SLOT(_q_directoryChanged(QString,bool)));
-    }
+    if (native)
+        connectEngine(native);
 }
 
 void QFileSystemWatcherPrivate::initPollerEngine()
@@ -106,40 +99,235 @@ void QFileSystemWatcherPrivate::initPollerEngine()
 
     Q_Q(QFileSystemWatcher);
     poller = new QPollingFileSystemWatcherEngine(q); // that was a mouthful
-    QObject::connect(poller,
+    connectEngine(poller);
+}
+
+void QFileSystemWatcherPrivate::connectEngine(QFileSystemWatcherEngine *engine)
+{
+    Q_Q(QFileSystemWatcher);
+    QObject::connect(engine,
                      SIGNAL(fileChanged(QString,bool)),
                      q,
                      SLOT(_q_fileChanged(QString,bool)));
-    QObject::connect(poller,
+    QObject::connect(engine,
                      SIGNAL(directoryChanged(QString,bool)),
                      q,
                      SLOT(_q_directoryChanged(QString,bool)));
+    QObject::connect(engine,
+                     SIGNAL(subdirectoryAdded(QString)),
+                     q,
+                     SLOT(_q_subdirectoryAdded(QString)));
+    QObject::connect(engine,
+                     SIGNAL(subdirectoryRemoved(QString)),
+                     q,
+                     SLOT(_q_subdirectoryRemoved(QString)));
 }
 
-void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
+QFileSystemWatcherEngine *QFileSystemWatcherPrivate::selectEngine()
+{
+    Q_Q(QFileSystemWatcher);
+    if (!q->objectName().startsWith(QLatin1String("_qt_autotest_force_engine_"))) {
+        // Normal runtime case - search intelligently for best engine
+        if (native)
+            return native;
+        initPollerEngine();
+        return poller;
+    }
+
+    // Autotest override case - use the explicitly selected engine only
+    QString forceName = q->objectName().mid(26);
+    if (forceName == QLatin1String("poller")) {
+        qDebug() << "QFileSystemWatcher: skipping native engine, using only polling engine";
+        initPollerEngine();
+        return poller;
+    } else if (forceName == QLatin1String("native")) {
+        qDebug() << "QFileSystemWatcher: skipping polling engine, using only native engine";
+        return native;
+    }
+    return 0;
+}
+
+/*
+    Watches \a directory and every directory below it that is not already
+    part of a recursive watch. Symbolic links are not followed, so a tree
+    cannot contain itself. Returns \c false if \a directory itself could not
+    be watched.
+*/
+bool QFileSystemWatcherPrivate::addTree(const QString &directory)
+{
+    if (!treeEngine || treeDirectories.contains(directory))
+        return treeDirectories.contains(directory);
+
+    QStringList paths(directory);
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!treeDirectories.contains(path))
+            paths.append(path);
+    }
+
+    // the engine reports what it watches through these; treeDirectories
+    // takes their place, so that files() and directories() only list what
+    // was added explicitly
+    QStringList watchedFiles, watchedDirectories;
+    const QStringList failed = treeEngine->addPaths(paths, &watchedFiles, &watchedDirectories);
+    for (int i = 0; i < watchedDirectories.size(); ++i)
+        treeDirectories.insert(watchedDirectories.at(i));
+    for (int i = 0; i < failed.size(); ++i) {
+        // the engine refuses paths it already watches for addPath()
+        if (directories.contains(failed.at(i)))
+            treeDirectories.insert(failed.at(i));
+    }
+    return treeDirectories.contains(directory);
+}
+
+// Returns \c true if \a path is \a root or a directory below it.
+static bool isInTree(const QString &path, const QString &root)
+{
+    return path.startsWith(root)
+            && (path.size() == root.size() || path.at(root.size()) == QLatin1Char('/')
+                || root.endsWith(QLatin1Char('/')));
+}
+
+/*
+    Stops watching \a root and every tree directory below it, except for
+    those that were also added with addPath() and those of the recursive
+    watches nested in \a root. The nested watches are only dropped if they
+    went away with \a root, like when it was moved out of its tree.
+*/
+void QFileSystemWatcherPrivate::removeTree(const QString &root)
+{
+    QStringList nestedRoots;
+    QMutableListIterator<QString> roots(recursiveRoots);
+    while (roots.hasNext()) {
+        const QString &path = roots.next();
+        if (!isInTree(path, root))
+            continue;
+        if (path != root && QFileInfo(path).isDir())
+            nestedRoots.append(path);
+        else
+            roots.remove();
+    }
+
+    QStringList paths;
+    QSet<QString>::iterator it = treeDirectories.begin();
+    while (it != treeDirectories.end()) {
+        bool remove = isInTree(*it, root);
+        for (int i = 0; remove && i < nestedRoots.size(); ++i)
+            remove = !isInTree(*it, nestedRoots.at(i));
+        if (remove) {
+            if (!directories.contains(*it))
+                paths.append(*it);
+            it = treeDirectories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (paths.isEmpty() || !treeEngine)
+        return;
+    QStringList watchedFiles, watchedDirectories;
+    treeEngine->removePaths(paths, &watchedFiles, &watchedDirectories);
+}
+
+void QFileSystemWatcherPrivate::emitChanged(const QString &path, bool isDirectory)
 {
     Q_Q(QFileSystemWatcher);
+    if (coalescingInterval <= 0) {
+        if (isDirectory)
+            emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+        else
+            emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+        return;
+    }
+
+    if (pendingPaths.contains(path))
+        return;
+    pendingPaths.insert(path);
+    if (isDirectory)
+        pendingDirectories.append(path);
+    else
+        pendingFiles.append(path);
+
+    if (!coalescingTimer) {
+        coalescingTimer = new QTimer(q);
+        coalescingTimer->setSingleShot(true);
+        QObject::connect(coalescingTimer, SIGNAL(timeout()), q, SLOT(_q_flushChanges()));
+    }
+    if (!coalescingTimer->isActive())
+        coalescingTimer->start(coalescingInterval);
+}
+
+void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
+{
     if (!files.contains(path)) {
         // the path was removed after a change was detected, but before we delivered the signal
         return;
     }
     if (removed)
         files.removeAll(path);
-    emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+    emitChanged(path, false);
 }
 
 void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool removed)
 {
-    Q_Q(QFileSystemWatcher);
-    if (!directories.contains(path)) {
+    const bool inTree = treeDirectories.contains(path);
+    if (!inTree && !directories.contains(path)) {
         // perhaps the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
+    if (removed) {
         directories.removeAll(path);
-    emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+        if (inTree) {
+            treeDirectories.remove(path);
+            recursiveRoots.removeAll(path);
+        }
+    } else if (inTree && treeEngine && !treeEngine->reportsSubdirectoryChanges()) {
+        // the engine only tells us that something changed; look for new
+        // subdirectories ourselves
+        QDirIterator it(path, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+        while (it.hasNext()) {
+            const QString subdirectory = it.next();
+            if (!treeDirectories.contains(subdirectory))
+                addTree(subdirectory);
+        }
+    }
+    emitChanged(path, true);
+}
+
+void QFileSystemWatcherPrivate::_q_subdirectoryAdded(const QString &path)
+{
+    const int slash = path.lastIndexOf(QLatin1Char('/'));
+    if (slash > 0 && treeDirectories.contains(path.left(slash)))
+        addTree(path);
+}
+
+void QFileSystemWatcherPrivate::_q_subdirectoryRemoved(const QString &path)
+{
+    // a directory moved out of the tree keeps its watch; drop it, or its
+    // changes would be reported under a path that no longer exists
+    if (treeDirectories.contains(path))
+        removeTree(path);
 }
 
+void QFileSystemWatcherPrivate::_q_flushChanges()
+{
+    Q_Q(QFileSystemWatcher);
+    if (pendingPaths.isEmpty())
+        return;
+
+    QStringList changedFiles, changedDirectories;
+    changedFiles.swap(pendingFiles);
+    changedDirectories.swap(pendingDirectories);
+    pendingPaths.clear();
+
+    for (int i = 0; i < changedFiles.size(); ++i)
+        emit q->fileChanged(changedFiles.at(i), QFileSystemWatcher::QPrivateSignal());
+    for (int i = 0; i < changedDirectories.size(); ++i)
+        emit q->directoryChanged(changedDirectories.at(i), QFileSystemWatcher::QPrivateSignal());
+    emit q->pathsChanged(changedFiles + changedDirectories, QFileSystemWatcher::QPrivateSignal());
+}
 
 
 /*!
@@ -294,30 +482,22 @@ QStringList QFileSystemWatcher::addPaths(const QStringList &paths)
         return QStringList();
     }
 
-    QFileSystemWatcherEngine *engine = 0;
-
-    if(!objectName().startsWith(QLatin1String("_qt_autotest_force_engine_"))) {
-        // Normal runtime case - search intelligently for best engine
-        if(d->native) {
-            engine = d->native;
-        } else {
-            d_func()->initPollerEngine();
-            engine = d->poller;
-        }
-
-    } else {
-        // Autotest override case - use the explicitly selected engine only
-        QString forceName = objectName().mid(26);
-        if(forceName == QLatin1String("poller")) {
-            qDebug() << "QFileSystemWatcher: skipping native engine, using only polling engine";
-            d_func()->initPollerEngine();
-            engine = d->poller;
-        } else if(forceName == QLatin1String("native")) {
-            qDebug() << "QFileSystemWatcher: skipping polling engine, using only native engine";
-            engine = d->native;
+    if (!d->treeDirectories.isEmpty()) {
+        // directories that a recursive watch already covers only need to be
+        // listed
+        QMutableListIterator<QString> it(p);
+        while (it.hasNext()) {
+            const QString &path = it.next();
+            if (d->treeDirectories.contains(path) && !d->directories.contains(path)) {
+                d->directories.append(path);
+                it.remove();
+            }
         }
+        if (p.isEmpty())
+            return p;
     }
 
+    QFileSystemWatcherEngine *engine = d->selectEngine();
     if(engine)
         p = engine->addPaths(p, &d->files, &d->directories);
 
@@ -374,12 +554,29 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
         return QStringList();
     }
 
+    QStringList failed;
+    if (!d->treeDirectories.isEmpty()) {
+        // keep the watch of directories that a recursive watch still needs;
+        // those only watched through it were never added, so they fail
+        QMutableListIterator<QString> it(p);
+        while (it.hasNext()) {
+            const QString &path = it.next();
+            if (!d->treeDirectories.contains(path))
+                continue;
+            if (!d->directories.removeAll(path))
+                failed.append(path);
+            it.remove();
+        }
+        if (p.isEmpty())
+            return failed;
+    }
+
     if (d->native)
         p = d->native->removePaths(p, &d->files, &d->directories);
     if (d->poller)
         p = d->poller->removePaths(p, &d->files, &d->directories);
 
-    return p;
+    return p + failed;
 }
 
 /*!
@@ -404,6 +601,18 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
     \sa fileChanged()
 */
 
+/*!
+    \fn void QFileSystemWatcher::pathsChanged(const QStringList &paths)
+    \since 5.6
+
+    This signal is emitted at the end of each coalescing interval with
+    the \a paths of all files and directories that changed during it,
+    after the fileChanged() and directoryChanged() signals for those
+    paths. It is not emitted when coalescingInterval() is 0.
+
+    \sa setCoalescingInterval()
+*/
+
 /*!
     \fn QStringList QFileSystemWatcher::directories() const
 
@@ -432,6 +641,131 @@ QStringList QFileSystemWatcher::files() const
     return d->files;
 }
 
+/*!
+    \since 5.6
+
+    Watches \a directory and, recursively, every directory below it.
+    Directories created in or moved into the tree later are watched as
+    well, and directories moved out of it or removed are no longer
+    watched. Symbolic links to directories are not followed.
+
+    The directoryChanged() signal is emitted for each directory of the
+    tree that changes. Files in the tree are not watched individually;
+    a change to the contents of a file does not emit any signal unless
+    the file is also added with addPath().
+
+    Returns \c true if \a directory could be watched. The directories
+    of the tree are not listed by directories().
+
+    \note Every directory of the tree counts against the system limit
+    on watched paths. If the limit is reached, parts of the tree are
+    not watched.
+
+    \sa removeRecursivePath(), recursiveDirectories()
+*/
+bool QFileSystemWatcher::addRecursivePath(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::addRecursivePath: path is empty");
+        return false;
+    }
+
+    const QString root = QDir::cleanPath(directory);
+    if (d->recursiveRoots.contains(root) || !QFileInfo(root).isDir())
+        return false;
+
+    if (!d->treeEngine)
+        d->treeEngine = d->selectEngine();
+    if (!d->addTree(root))
+        return false;
+    d->recursiveRoots.append(root);
+    return true;
+}
+
+/*!
+    \since 5.6
+
+    Stops watching the tree below \a directory, which must have been
+    added with addRecursivePath(). Directories that are also part of
+    another recursive watch, or that were added with addPath(), are
+    still watched.
+
+    Returns \c true if \a directory was watched recursively.
+
+    \sa addRecursivePath()
+*/
+bool QFileSystemWatcher::removeRecursivePath(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+    const QString root = QDir::cleanPath(directory);
+    if (!d->recursiveRoots.contains(root))
+        return false;
+
+    for (int i = 0; i < d->recursiveRoots.size(); ++i) {
+        const QString &other = d->recursiveRoots.at(i);
+        if (other != root && isInTree(root, other)) {
+            // the tree is part of a larger one, which still needs the watches
+            d->recursiveRoots.removeAll(root);
+            return true;
+        }
+    }
+    d->removeTree(root);
+    return true;
+}
+
+/*!
+    \since 5.6
+
+    Returns the directories added with addRecursivePath() that are
+    still being watched.
+*/
+QStringList QFileSystemWatcher::recursiveDirectories() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->recursiveRoots;
+}
+
+/*!
+    \since 5.6
+
+    Returns the interval, in milliseconds, over which changes are
+    collected before they are reported. The default is 0, which reports
+    every change as soon as it is detected.
+
+    \sa setCoalescingInterval()
+*/
+int QFileSystemWatcher::coalescingInterval() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->coalescingInterval;
+}
+
+/*!
+    \since 5.6
+
+    Collects changes for \a msecs milliseconds after the first one is
+    detected before reporting them. During this window, fileChanged()
+    and directoryChanged() are emitted at most once for each path, and
+    pathsChanged() is emitted once with all of them at the end.
+
+    This keeps bursts, such as a build writing thousands of files, from
+    flooding the event loop with signals. Setting an interval of 0 or
+    less reports any changes still pending immediately.
+
+    \sa coalescingInterval(), pathsChanged()
+*/
+void QFileSystemWatcher::setCoalescingInterval(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    d->coalescingInterval = qMax(0, msecs);
+    if (d->coalescingInterval == 0) {
+        if (d->coalescingTimer)
+            d->coalescingTimer->stop();
+        d->_q_flushChanges();
+    }
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qfilesystemwatcher.cpp"
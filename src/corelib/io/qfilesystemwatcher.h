@@ -61,13 +61,24 @@ public:
     QStringList files() const;
     QStringList directories() const;
 
+    bool addRecursivePath(const QString &directory);
+    bool removeRecursivePath(const QString &directory);
+    QStringList recursiveDirectories() const;
+
+    int coalescingInterval() const;
+    void setCoalescingInterval(int msecs);
+
 Q_SIGNALS:
     void fileChanged(const QString &path, QPrivateSignal);
     void directoryChanged(const QString &path, QPrivateSignal);
+    void pathsChanged(const QStringList &paths, QPrivateSignal);
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
     Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &path, bool removed))
+    Q_PRIVATE_SLOT(d_func(), void _q_subdirectoryAdded(const QString &path))
+    Q_PRIVATE_SLOT(d_func(), void _q_subdirectoryRemoved(const QString &path))
+    Q_PRIVATE_SLOT(d_func(), void _q_flushChanges())
 };
 
 QT_END_NAMESPACE
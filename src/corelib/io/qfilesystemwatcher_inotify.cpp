@@ -259,15 +259,12 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
+        // already watched; pathToID is what files and directories list,
+        // but does not need a linear search
+        if (pathToID.contains(path))
+            continue;
         QFileInfo fi(path);
         bool isDir = fi.isDir();
-        if (isDir) {
-            if (directories->contains(path))
-                continue;
-        } else {
-            if (files->contains(path))
-                continue;
-        }
 
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
@@ -347,9 +344,17 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     char * const end = at + buffSize;
 
     QHash<int, inotify_event *> eventForId;
+    QVarLengthArray<inotify_event *, 16> subdirectoryEvents;
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
 
+        // the names are lost when merging, so remember the events about
+        // subdirectories for recursive watches
+        if ((event->mask & IN_ISDIR) && event->len
+                && (event->mask & (IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM))) {
+            subdirectoryEvents.append(event);
+        }
+
         if (eventForId.contains(event->wd))
             eventForId[event->wd]->mask |= event->mask;
         else
@@ -358,6 +363,18 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
         at += sizeof(inotify_event) + event->len;
     }
 
+    for (int i = 0; i < subdirectoryEvents.size(); ++i) {
+        const inotify_event &event = *subdirectoryEvents.at(i);
+        const QString path = getPathFromID(-event.wd);
+        if (path.isEmpty())
+            continue;
+        const QString subdirectory = path + QLatin1Char('/') + QFile::decodeName(event.name);
+        if (event.mask & IN_MOVED_FROM)
+            emit subdirectoryRemoved(subdirectory);
+        else
+            emit subdirectoryAdded(subdirectory);
+    }
+
     QHash<int, inotify_event *>::const_iterator it = eventForId.constBegin();
     while (it != eventForId.constEnd()) {
         const inotify_event &event = **it;
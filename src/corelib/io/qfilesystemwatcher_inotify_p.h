@@ -66,6 +66,7 @@ public:
 
     QStringList addPaths(const QStringList &paths, QStringList *files, QStringList *directories) Q_DECL_OVERRIDE;
     QStringList removePaths(const QStringList &paths, QStringList *files, QStringList *directories) Q_DECL_OVERRIDE;
+    bool reportsSubdirectoryChanges() const Q_DECL_OVERRIDE { return true; }
 
 private Q_SLOTS:
     void readFromInotify();
@@ -52,9 +52,12 @@
 #include <private/qobject_p.h>
 
 #include <QtCore/qstringlist.h>
+#include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class QFileSystemWatcherEngine : public QObject
 {
     Q_OBJECT
@@ -78,9 +81,16 @@ public:
                                     QStringList *files,
                                     QStringList *directories) = 0;
 
+    // whether the engine emits subdirectoryAdded() and subdirectoryRemoved()
+    // for watched directories; if not, recursive watches rescan a directory
+    // whenever it changes
+    virtual bool reportsSubdirectoryChanges() const { return false; }
+
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    void subdirectoryAdded(const QString &path);
+    void subdirectoryRemoved(const QString &path);
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -93,13 +103,34 @@ public:
     QFileSystemWatcherPrivate();
     void init();
     void initPollerEngine();
+    void connectEngine(QFileSystemWatcherEngine *engine);
+    QFileSystemWatcherEngine *selectEngine();
+
+    bool addTree(const QString &directory);
+    void removeTree(const QString &root);
+    void emitChanged(const QString &path, bool isDirectory);
 
     QFileSystemWatcherEngine *native, *poller;
     QStringList files, directories;
 
+    // recursive watches: the directories passed to addRecursivePath(), and
+    // every directory watched on their behalf
+    QStringList recursiveRoots;
+    QSet<QString> treeDirectories;
+    QFileSystemWatcherEngine *treeEngine;
+
+    // changes held back until the coalescing interval elapses
+    int coalescingInterval;
+    QTimer *coalescingTimer;
+    QStringList pendingFiles, pendingDirectories;
+    QSet<QString> pendingPaths;
+
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
+    void _q_subdirectoryAdded(const QString &path);
+    void _q_subdirectoryRemoved(const QString &path);
+    void _q_flushChanges();
 };
 
 
@@ -57,14 +57,14 @@ QStringList QPollingFileSystemWatcherEngine::addPaths(const QStringList &paths,
         if (!fi.exists())
             continue;
         if (fi.isDir()) {
-            if (directories->contains(path))
+            if (this->directories.contains(path))
                 continue;
             directories->append(path);
             if (!path.endsWith(QLatin1Char('/')))
                 fi = QFileInfo(path + QLatin1Char('/'));
             this->directories.insert(path, fi);
         } else {
-            if (files->contains(path))
+            if (this->files.contains(path))
                 continue;
             files->append(path);
             this->files.insert(path, fi);
@@ -87,21 +87,18 @@ int QLoggingRule::pass(const QString &cat, QtMsgType msgType) const
             return 0;
     }
 
-    const int idx = cat.indexOf(category);
-    if (idx >= 0) {
-        if (flags == MidFilter) {
-            // matches somewhere
-            if (idx >= 0)
-                return (enabled ? 1 : -1);
-        } else if (flags == LeftFilter) {
-            // matches left
-            if (idx == 0)
-                return (enabled ? 1 : -1);
-        } else if (flags == RightFilter) {
-            // matches right
-            if (idx == (cat.count() - category.count()))
-                return (enabled ? 1 : -1);
-        }
+    if (flags == MidFilter) {
+        // matches somewhere
+        if (cat.contains(category))
+            return (enabled ? 1 : -1);
+    } else if (flags == LeftFilter) {
+        // matches left
+        if (cat.startsWith(category))
+            return (enabled ? 1 : -1);
+    } else if (flags == RightFilter) {
+        // matches right
+        if (cat.endsWith(category))
+            return (enabled ? 1 : -1);
     }
     return 0;
 }
@@ -158,6 +155,203 @@ void QLoggingRule::parse(const QStringRef &pattern)
     category = p.toString();
 }
 
+/*!
+    \class QLoggingRuleSet
+    \internal
+
+    A list of logging rules compiled for matching category names.
+
+    Rules are stored in three tries: one for full-text and prefix patterns,
+    one for suffix patterns (stored reversed) and one for patterns that can
+    match anywhere in a name. Every trie node records, for each message type,
+    the last rule that decides it when the node is reached. Matching a
+    category name therefore walks the tries once (once per start position
+    for the third) instead of comparing the name against every rule, and
+    the last matching rule still wins.
+*/
+
+static int messageTypeSlot(int type)
+{
+    switch (type) {
+    case QtDebugMsg: return 0;
+    case QtInfoMsg: return 1;
+    case QtWarningMsg: return 2;
+    case QtCriticalMsg: return 3;
+    default: break;
+    }
+    return -1;
+}
+
+QLoggingRuleSet::Match::Match()
+{
+    for (int i = 0; i < TypeCount; ++i)
+        rule[i] = -1;
+}
+
+void QLoggingRuleSet::Match::add(const QLoggingRule &r, int index)
+{
+    const int slot = messageTypeSlot(r.messageType);
+    for (int i = 0; i < TypeCount; ++i) {
+        if (r.messageType == -1 || i == slot)
+            rule[i] = qMax(rule[i], index);
+    }
+}
+
+void QLoggingRuleSet::Match::merge(const Match &other)
+{
+    for (int i = 0; i < TypeCount; ++i)
+        rule[i] = qMax(rule[i], other.rule[i]);
+}
+
+QLoggingRuleSet::Trie::Trie()
+{
+    clear();
+}
+
+void QLoggingRuleSet::Trie::clear()
+{
+    nodes.clear();
+    nodes.append(Node());
+    edges.clear();
+    hasRootMatch = false;
+}
+
+/*!
+    \internal
+    Adds the nodes spelling \a pattern, backwards if \a reversed is true,
+    and returns the index of the last one. Returns -1 for patterns that
+    can never match, as category names are Latin-1.
+*/
+int QLoggingRuleSet::Trie::insert(const QString &pattern, bool reversed)
+{
+    int node = 0;
+    const int length = pattern.size();
+    for (int i = 0; i < length; ++i) {
+        const ushort ch = pattern.at(reversed ? length - 1 - i : i).unicode();
+        if (ch > 0xff)
+            return -1;
+        const quint64 key = (quint64(node) << 16) | ch;
+        QHash<quint64, int>::const_iterator it = edges.constFind(key);
+        if (it != edges.constEnd()) {
+            node = it.value();
+        } else {
+            edges.insert(key, nodes.size());
+            node = nodes.size();
+            nodes.append(Node());
+        }
+    }
+    if (node == 0)
+        hasRootMatch = true;
+    return node;
+}
+
+QLoggingRuleSet::QLoggingRuleSet()
+    : ruleCount(0)
+{
+}
+
+/*!
+    \internal
+    Compiles \a rules. Later rules take precedence over earlier ones.
+*/
+void QLoggingRuleSet::setRules(const QVector<QLoggingRule> &rules)
+{
+    prefixes.clear();
+    suffixes.clear();
+    infixes.clear();
+    ruleEnabled.resize(rules.size());
+    ruleCount = rules.size();
+
+    for (int i = 0; i < rules.size(); ++i) {
+        const QLoggingRule &rule = rules.at(i);
+        ruleEnabled[i] = rule.enabled;
+
+        int node;
+        switch (int(rule.flags)) {
+        case QLoggingRule::FullText:
+            node = prefixes.insert(rule.category, false);
+            if (node >= 0)
+                prefixes.nodes[node].fullMatch.add(rule, i);
+            break;
+        case QLoggingRule::LeftFilter:
+            node = prefixes.insert(rule.category, false);
+            if (node >= 0)
+                prefixes.nodes[node].match.add(rule, i);
+            break;
+        case QLoggingRule::RightFilter:
+            node = suffixes.insert(rule.category, true);
+            if (node >= 0)
+                suffixes.nodes[node].match.add(rule, i);
+            break;
+        case QLoggingRule::MidFilter:
+            node = infixes.insert(rule.category, false);
+            if (node >= 0)
+                infixes.nodes[node].match.add(rule, i);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*!
+    \internal
+    Updates \a debug, \a info, \a warning and \a critical for the message
+    types that the rules decide for \a categoryName. The others are left
+    untouched.
+*/
+void QLoggingRuleSet::apply(const char *categoryName, bool *debug, bool *info,
+                            bool *warning, bool *critical) const
+{
+    if (!ruleCount)
+        return;
+
+    const uchar *name = reinterpret_cast<const uchar *>(categoryName ? categoryName : "");
+    const int length = int(qstrlen(reinterpret_cast<const char *>(name)));
+    Match result;
+
+    if (!prefixes.isEmpty()) {
+        int node = 0;
+        result.merge(prefixes.nodes.at(0).match);
+        for (int i = 0; i < length && node >= 0; ++i) {
+            node = prefixes.child(node, name[i]);
+            if (node >= 0)
+                result.merge(prefixes.nodes.at(node).match);
+        }
+        if (node >= 0)
+            result.merge(prefixes.nodes.at(node).fullMatch);
+    }
+
+    if (!suffixes.isEmpty()) {
+        int node = 0;
+        result.merge(suffixes.nodes.at(0).match);
+        for (int i = length - 1; i >= 0 && node >= 0; --i) {
+            node = suffixes.child(node, name[i]);
+            if (node >= 0)
+                result.merge(suffixes.nodes.at(node).match);
+        }
+    }
+
+    if (!infixes.isEmpty()) {
+        result.merge(infixes.nodes.at(0).match);
+        for (int start = 0; start < length; ++start) {
+            int node = 0;
+            for (int i = start; i < length; ++i) {
+                node = infixes.child(node, name[i]);
+                if (node < 0)
+                    break;
+                result.merge(infixes.nodes.at(node).match);
+            }
+        }
+    }
+
+    bool *const enabled[TypeCount] = { debug, info, warning, critical };
+    for (int i = 0; i < TypeCount; ++i) {
+        if (result.rule[i] >= 0)
+            *enabled[i] = ruleEnabled.at(result.rule[i]);
+    }
+}
+
 /*!
     \class QLoggingSettingsParser
     \since 5.3
@@ -354,9 +548,12 @@ void QLoggingRegistry::updateRules()
         return;
 
     rules = configRules + apiRules + envRules;
+    ruleSet.setRules(rules);
 
-    foreach (QLoggingCategory *cat, categories.keys())
-        (*categoryFilter)(cat);
+    for (QHash<QLoggingCategory *, QtMsgType>::const_iterator it = categories.constBegin();
+         it != categories.constEnd(); ++it) {
+        (*categoryFilter)(it.key());
+    }
 }
 
 /*!
@@ -374,8 +571,10 @@ QLoggingRegistry::installFilter(QLoggingCategory::CategoryFilter filter)
     QLoggingCategory::CategoryFilter old = categoryFilter;
     categoryFilter = filter;
 
-    foreach (QLoggingCategory *cat, categories.keys())
-        (*categoryFilter)(cat);
+    for (QHash<QLoggingCategory *, QtMsgType>::const_iterator it = categories.constBegin();
+         it != categories.constEnd(); ++it) {
+        (*categoryFilter)(it.key());
+    }
 
     return old;
 }
@@ -409,21 +608,7 @@ void QLoggingRegistry::defaultCategoryFilter(QLoggingCategory *cat)
             debug = false;
     }
 
-    QString categoryName = QLatin1String(cat->categoryName());
-    foreach (const QLoggingRule &item, reg->rules) {
-        int filterpass = item.pass(categoryName, QtDebugMsg);
-        if (filterpass != 0)
-            debug = (filterpass > 0);
-        filterpass = item.pass(categoryName, QtInfoMsg);
-        if (filterpass != 0)
-            info = (filterpass > 0);
-        filterpass = item.pass(categoryName, QtWarningMsg);
-        if (filterpass != 0)
-            warning = (filterpass > 0);
-        filterpass = item.pass(categoryName, QtCriticalMsg);
-        if (filterpass != 0)
-            critical = (filterpass > 0);
-    }
+    reg->ruleSet.apply(cat->categoryName(), &debug, &info, &warning, &critical);
 
     cat->setEnabled(QtDebugMsg, debug);
     cat->setEnabled(QtInfoMsg, info);
@@ -45,6 +45,7 @@
 // We mean it.
 //
 
+#include <QtCore/qhash.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qmutex.h>
@@ -83,6 +84,55 @@ private:
 Q_DECLARE_OPERATORS_FOR_FLAGS(QLoggingRule::PatternFlags)
 Q_DECLARE_TYPEINFO(QLoggingRule, Q_MOVABLE_TYPE);
 
+class Q_AUTOTEST_EXPORT QLoggingRuleSet
+{
+public:
+    QLoggingRuleSet();
+
+    void setRules(const QVector<QLoggingRule> &rules);
+    bool isEmpty() const { return ruleCount == 0; }
+
+    void apply(const char *categoryName, bool *debug, bool *info,
+               bool *warning, bool *critical) const;
+
+private:
+    enum { TypeCount = 4 };
+
+    // for every message type, the index of the last rule matching there
+    struct Match {
+        Match();
+        void add(const QLoggingRule &rule, int index);
+        void merge(const Match &other);
+        int rule[TypeCount];
+    };
+
+    struct Node {
+        Match match;        // rules matching names with this prefix/suffix/substring
+        Match fullMatch;    // FullText rules matching exactly this string
+    };
+
+    class Trie
+    {
+    public:
+        Trie();
+        void clear();
+        int insert(const QString &pattern, bool reversed);
+        int child(int node, uchar ch) const
+        { return edges.value((quint64(node) << 16) | ch, -1); }
+        bool isEmpty() const { return nodes.size() == 1 && !hasRootMatch; }
+
+        QVector<Node> nodes;
+        QHash<quint64, int> edges;
+        bool hasRootMatch;
+    };
+
+    Trie prefixes;  // FullText and LeftFilter rules
+    Trie suffixes;  // RightFilter rules, stored reversed
+    Trie infixes;   // MidFilter rules
+    QVector<bool> ruleEnabled;
+    int ruleCount;
+};
+
 class Q_AUTOTEST_EXPORT QLoggingSettingsParser
 {
 public:
@@ -126,6 +176,7 @@ private:
     QVector<QLoggingRule> envRules;
     QVector<QLoggingRule> apiRules;
     QVector<QLoggingRule> rules;
+    QLoggingRuleSet ruleSet;
     QHash<QLoggingCategory*,QtMsgType> categories;
     QLoggingCategory::CategoryFilter categoryFilter;
 
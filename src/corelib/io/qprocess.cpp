@@ -1878,6 +1878,11 @@ void QProcess::setProcessState(ProcessState state)
 
     \warning This function is called by QProcess on Unix and OS X
     only. On Windows and QNX, it is not called.
+
+    \note On Linux, QProcess starts the program without copying the memory
+    of the calling process, which is considerably faster for processes with
+    large heaps. This is not possible when this function needs to be called,
+    so it is only done for QProcess objects that are not of a subclass.
 */
 void QProcess::setupChildProcess()
 {
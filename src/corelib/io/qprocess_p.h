@@ -349,6 +349,8 @@ public:
     void startProcess();
 #if defined(Q_OS_UNIX) && !defined(QPROCESS_USE_SPAWN)
     void execChild(const char *workingDirectory, char **path, char **argv, char **envp);
+    void redirectChildChannels();
+    static int execProgram(char **path, char **argv, char **envp);
 #elif defined(QPROCESS_USE_SPAWN)
     pid_t spawnChild(pid_t *ppid, const char *workingDirectory, char **argv, char **envp);
 #endif
@@ -107,6 +107,9 @@ QT_END_NAMESPACE
 #include <stdlib.h>
 #include <string.h>
 #include <forkfd.h>
+#ifndef QT_NO_RTTI
+#  include <typeinfo>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -317,6 +320,53 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Hash &environm
     return envp;
 }
 
+#if !defined(QPROCESS_USE_SPAWN)
+namespace {
+struct VforkChildData
+{
+    QProcessPrivate *d;
+    const char *workingDir;
+    char **path;
+    char **argv;
+    char **envp;
+    int chdirErrno;
+    int execErrno;
+};
+}
+
+/*
+    Runs in a child created by vforkfd(), which shares our memory until it
+    calls execve(), so it must not allocate or call into Qt. Failures are
+    passed back in \a token and reported by the parent.
+*/
+static int execChildVforked(void *token)
+{
+    VforkChildData *data = static_cast<VforkChildData *>(token);
+
+    ::signal(SIGPIPE, SIG_DFL);         // reset the signal that we ignored
+    data->d->redirectChildChannels();
+
+    if (data->workingDir && QT_CHDIR(data->workingDir) == -1)
+        data->chdirErrno = errno;
+
+    data->execErrno = QProcessPrivate::execProgram(data->path, data->argv, data->envp);
+    return -1;
+}
+
+static bool canStartWithoutFork(const QProcess *process)
+{
+#if defined(Q_OS_LINUX) && !defined(QT_NO_RTTI)
+    // vforkfd() only shares our memory with the child on Linux; elsewhere the
+    // child could not pass failures back. Only subclasses can reimplement
+    // setupChildProcess(), which needs a forked child of its own.
+    return typeid(*process) == typeid(QProcess);
+#else
+    Q_UNUSED(process);
+    return false;
+#endif
+}
+#endif
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -430,7 +480,14 @@ void QProcessPrivate::startProcess()
     Q_ASSUME(forkfd != FFD_CHILD_PROCESS);
 #else
     pid_t childPid;
-    forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
+    VforkChildData vforkData = { this, workingDirPtr, path, argv, envp, 0, 0 };
+    // Forking a parent with a large heap copies all of its page tables, so
+    // unless setupChildProcess() has to run, start the child without a copy.
+    const bool useVfork = canStartWithoutFork(q);
+    if (useVfork)
+        forkfd = ::vforkfd(FFD_CLOEXEC, &childPid, execChildVforked, &vforkData);
+    else
+        forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
 #endif
     int lastForkErrno = errno;
     if (forkfd != FFD_CHILD_PROCESS) {
@@ -475,6 +532,18 @@ void QProcessPrivate::startProcess()
 
     pid = Q_PID(childPid);
 
+#if !defined(QPROCESS_USE_SPAWN)
+    if (useVfork) {
+        if (vforkData.chdirErrno)
+            qWarning("QProcessPrivate::execChild() failed to chdir to %s", workingDirPtr);
+        if (vforkData.execErrno) {
+            // notify failure as execChild() does
+            QString error = qt_error_string(vforkData.execErrno);
+            qt_safe_write(childStartedPipe[1], error.data(), error.length() * sizeof(QChar));
+        }
+    }
+#endif
+
     // parent
     // close the ends we don't use and make all pipes non-blocking
     qt_safe_close(childStartedPipe[1]);
@@ -657,6 +726,36 @@ void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv
 
     Q_Q(QProcess);
 
+    redirectChildChannels();
+
+    // enter the working directory
+    if (workingDir) {
+        if (QT_CHDIR(workingDir) == -1)
+            qWarning("QProcessPrivate::execChild() failed to chdir to %s", workingDir);
+    }
+
+    // this is a virtual call, and it base behavior is to do nothing.
+    q->setupChildProcess();
+
+    // execute the process
+    int execErrno = execProgram(path, argv, envp);
+
+    // notify failure
+    QString error = qt_error_string(execErrno);
+#if defined (QPROCESS_DEBUG)
+    fprintf(stderr, "QProcessPrivate::execChild() failed (%s), notifying parent process\n", qPrintable(error));
+#endif
+    qt_safe_write(childStartedPipe[1], error.data(), error.length() * sizeof(QChar));
+    qt_safe_close(childStartedPipe[1]);
+    childStartedPipe[1] = -1;
+}
+
+/*
+    Sets up the standard channels of the child process. Called in the child;
+    only uses async-signal-safe functions.
+*/
+void QProcessPrivate::redirectChildChannels()
+{
     // copy the stdin socket if asked to (without closing on exec)
     if (inputChannelMode != QProcess::ForwardedInputChannel)
         qt_safe_dup2(stdinChannel.pipe[0], STDIN_FILENO, 0);
@@ -676,17 +775,14 @@ void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv
 
     // make sure this fd is closed if execvp() succeeds
     qt_safe_close(childStartedPipe[0]);
+}
 
-    // enter the working directory
-    if (workingDir) {
-        if (QT_CHDIR(workingDir) == -1)
-            qWarning("QProcessPrivate::execChild() failed to chdir to %s", workingDir);
-    }
-
-    // this is a virtual call, and it base behavior is to do nothing.
-    q->setupChildProcess();
-
-    // execute the process
+/*
+    Executes the program in the child process. Only returns if that failed,
+    with the errno of the last attempt.
+*/
+int QProcessPrivate::execProgram(char **path, char **argv, char **envp)
+{
     if (!envp) {
         qt_safe_execvp(argv[0], argv);
     } else {
@@ -707,15 +803,7 @@ void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv
             qt_safe_execve(argv[0], argv, envp);
         }
     }
-
-    // notify failure
-    QString error = qt_error_string(errno);
-#if defined (QPROCESS_DEBUG)
-    fprintf(stderr, "QProcessPrivate::execChild() failed (%s), notifying parent process\n", qPrintable(error));
-#endif
-    qt_safe_write(childStartedPipe[1], error.data(), error.length() * sizeof(QChar));
-    qt_safe_close(childStartedPipe[1]);
-    childStartedPipe[1] = -1;
+    return errno;
 }
 #endif
 
@@ -45,7 +45,15 @@
 #include "qstringlist.h"
 #include <qshareddata.h>
 #include <qplatformdefs.h>
+#include "qcache.h"
+#include "qendian.h"
+#include "qthreadstorage.h"
 #include "private/qabstractfileengine_p.h"
+#include "private/qtools_p.h"
+
+#ifndef QT_NO_ZSTD
+#  include <zstd.h>
+#endif
 
 #ifdef Q_OS_UNIX
 # include "private/qcore_unix_p.h"
@@ -92,22 +100,36 @@ class QResourceRoot
     enum Flags
     {
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedZstd = 0x04
     };
     const uchar *tree, *names, *payloads;
+    const uchar *parentNodes, *pathIndex;
+    uint pathIndexMask;
     inline int findOffset(int node) const { return node * 14; } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
+    bool nameEquals(int node, const QChar *str, int length) const;
     short flags(int node) const;
+    int findNodeInIndex(const QString &path, const QLocale &locale, uint pathHash) const;
+    bool matchesPath(int node, const QChar *path, int length) const;
 public:
     mutable QAtomicInt ref;
 
-    inline QResourceRoot(): tree(0), names(0), payloads(0) {}
-    inline QResourceRoot(const uchar *t, const uchar *n, const uchar *d) { setSource(t, n, d); }
+    inline QResourceRoot(): tree(0), names(0), payloads(0), parentNodes(0), pathIndex(0), pathIndexMask(0) {}
+    inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
     virtual ~QResourceRoot() { }
-    int findNode(const QString &path, const QLocale &locale=QLocale()) const;
+    int findNode(const QString &path, const QLocale &locale=QLocale(), uint *pathHash=0) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
-    inline bool isCompressed(int node) const { return flags(node) & Compressed; }
+    inline QResource::Compression compressionAlgorithm(int node) const
+    {
+        const short nodeFlags = flags(node);
+        if (nodeFlags & Compressed)
+            return QResource::ZlibCompression;
+        if (nodeFlags & CompressedZstd)
+            return QResource::ZstdCompression;
+        return QResource::NoCompression;
+    }
     const uchar *data(int node, qint64 *size) const;
     QStringList children(int node) const;
     virtual QString mappingRoot() const { return QString(); }
@@ -120,13 +142,29 @@ public:
     virtual ResourceRootType type() const { return Resource_Builtin; }
 
 protected:
-    inline void setSource(const uchar *t, const uchar *n, const uchar *d) {
+    inline void setSource(int version, const uchar *t, const uchar *n, const uchar *d) {
         tree = t;
         names = n;
         payloads = d;
+        parentNodes = 0;
+        pathIndex = 0;
+        pathIndexMask = 0;
+        // version 3 adds a path index after the tree, see rcc
+        if (version >= 0x03) {
+            const int nodeCount = qFromBigEndian<qint32>(tree);
+            parentNodes = tree + findOffset(nodeCount);
+            pathIndexMask = qFromBigEndian<quint32>(parentNodes + 4 * nodeCount) - 1;
+            pathIndex = parentNodes + 4 * nodeCount + 4;
+        }
     }
 };
 
+static inline bool isSupportedResourceVersion(int version)
+{
+    // version 2 may use zstd compression, version 3 adds a path index
+    return version >= 0x01 && version <= 0x03;
+}
+
 static QString cleanPath(const QString &_path)
 {
     QString path = QDir::cleanPath(_path);
@@ -144,8 +182,179 @@ Q_GLOBAL_STATIC_WITH_ARGS(QMutex, resourceMutex, (QMutex::Recursive))
 typedef QList<QResourceRoot*> ResourceList;
 Q_GLOBAL_STATIC(ResourceList, resourceList)
 
+/*
+    Resource lookups do not lock resourceMutex. Each thread looks up in its
+    own copy of resourceList(), which it refreshes when the registrations
+    have changed since, as counted by resourceListGeneration.
+
+    Such a copy may still contain roots that have since been unregistered,
+    so roots losing their last reference are retired rather than deleted,
+    and only deleted once every thread has refreshed its copy.
+*/
+static QBasicAtomicInt resourceListGeneration = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+
+struct ResourceListSnapshot
+{
+    ResourceListSnapshot() : generation(-1) { }
+    ~ResourceListSnapshot();
+
+    int generation;
+    ResourceList roots;
+};
+
+struct RetiredResourceRoot
+{
+    QResourceRoot *root;
+    int generation;
+};
+
+// guarded by resourceMutex
+struct ResourceListSnapshots
+{
+    QList<ResourceListSnapshot *> snapshots;
+    QVector<RetiredResourceRoot> retired;
+};
+
+}
+
+Q_DECLARE_TYPEINFO(RetiredResourceRoot, Q_PRIMITIVE_TYPE);
+
+Q_GLOBAL_STATIC(ResourceListSnapshots, resourceListSnapshots)
+Q_GLOBAL_STATIC(QThreadStorage<ResourceListSnapshot *>, localResourceListSnapshot)
+
+// must be called with resourceMutex locked
+static void reclaimRetiredResourceRoots(ResourceListSnapshots *d)
+{
+    int oldest = resourceListGeneration.load();
+    for (int i = 0; i < d->snapshots.size(); ++i)
+        oldest = qMin(oldest, d->snapshots.at(i)->generation);
+
+    for (int i = 0; i < d->retired.size(); ) {
+        const RetiredResourceRoot &retired = d->retired.at(i);
+        if (retired.generation <= oldest) {
+            // a lookup may have taken a new reference in the meantime
+            if (!retired.root->ref.load())
+                delete retired.root;
+            d->retired.remove(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+ResourceListSnapshot::~ResourceListSnapshot()
+{
+    QMutex *mutex = resourceMutex();
+    ResourceListSnapshots *d = resourceListSnapshots();
+    if (!mutex || !d)
+        return;
+    QMutexLocker lock(mutex);
+    d->snapshots.removeOne(this);
+    reclaimRetiredResourceRoots(d);
+}
+
+// must be called with resourceMutex locked
+static inline void resourceListChanged()
+{
+    resourceListGeneration.fetchAndAddRelease(1);
+}
+
+// returns \c true if this was the last reference to \a root
+static bool releaseResourceRoot(QResourceRoot *root)
+{
+    if (root->ref.deref())
+        return false;
+
+    QMutexLocker lock(resourceMutex());
+    ResourceListSnapshots *d = resourceListSnapshots();
+    if (!d) {
+        delete root;
+        return true;
+    }
+    for (int i = 0; i < d->retired.size(); ++i) {
+        if (d->retired.at(i).root == root) {
+            d->retired[i].generation = resourceListGeneration.load();
+            return true;
+        }
+    }
+    const RetiredResourceRoot retired = { root, resourceListGeneration.load() };
+    d->retired.append(retired);
+    reclaimRetiredResourceRoots(d);
+    return true;
+}
+
+static ResourceList registeredResourceRoots()
+{
+    QThreadStorage<ResourceListSnapshot *> *storage = localResourceListSnapshot();
+    ResourceListSnapshots *d = resourceListSnapshots();
+    if (!storage || !d) {
+        QMutexLocker lock(resourceMutex());
+        return *resourceList();
+    }
+
+    ResourceListSnapshot *snapshot = storage->localData();
+    if (!snapshot) {
+        snapshot = new ResourceListSnapshot;
+        storage->setLocalData(snapshot);
+        QMutexLocker lock(resourceMutex());
+        d->snapshots.append(snapshot);
+    }
+    if (snapshot->generation != resourceListGeneration.loadAcquire()) {
+        QMutexLocker lock(resourceMutex());
+        snapshot->roots = *resourceList();
+        snapshot->generation = resourceListGeneration.load();
+        reclaimRetiredResourceRoots(d);
+    }
+    return snapshot->roots;
+}
+
 Q_GLOBAL_STATIC(QStringList, resourceSearchPaths)
 
+namespace {
+
+// Decompressed data of resources, keyed by their compressed data. It helps
+// applications that open the same compressed resources repeatedly, and is
+// disabled unless QT_RESOURCE_CACHE_SIZE gives its size in kilobytes.
+struct UncompressedResourceCache
+{
+    UncompressedResourceCache()
+        : cache(qBound(0, qEnvironmentVariableIntValue("QT_RESOURCE_CACHE_SIZE"), INT_MAX / 1024) * 1024)
+    { }
+
+    QMutex mutex;
+    QCache<const uchar *, QByteArray> cache;
+};
+
+#ifndef QT_NO_ZSTD
+// one decompression context per thread, so that opening a resource does not
+// have to allocate one
+struct ZstdDecompressionContext
+{
+    ZstdDecompressionContext() : context(ZSTD_createDCtx()) { }
+    ~ZstdDecompressionContext() { ZSTD_freeDCtx(context); }
+    ZSTD_DCtx *context;
+};
+#endif
+
+}
+
+Q_GLOBAL_STATIC(UncompressedResourceCache, uncompressedResourceCache)
+#ifndef QT_NO_ZSTD
+Q_GLOBAL_STATIC(QThreadStorage<ZstdDecompressionContext *>, zstdDecompressionContexts)
+#endif
+
+// the data of a resource root may go away when it is unregistered
+static void clearUncompressedResourceCache()
+{
+    UncompressedResourceCache *c = uncompressedResourceCache();
+    if (!c)
+        return;
+    QMutexLocker lock(&c->mutex);
+    c->cache.clear();
+}
+
 /*!
     \class QResource
     \inmodule QtCore
@@ -173,11 +382,16 @@ Q_GLOBAL_STATIC(QStringList, resourceSearchPaths)
     which will be found in the list of paths returned by QDir::searchPaths().
 
     A QResource that is representing a file will have data backing it, this
-    data can possibly be compressed, in which case qUncompress() must be
-    used to access the real data; this happens implicitly when accessed
+    data can possibly be compressed, in which case uncompressedData() must
+    be used to access the real data; this happens implicitly when accessed
     through a QFile. A QResource that is representing a directory will have
     only children and no data.
 
+    Compressed resources are decompressed whenever they are opened. Setting
+    the \c QT_RESOURCE_CACHE_SIZE environment variable to a size in
+    kilobytes keeps up to that much decompressed data in memory, for
+    applications that open the same compressed resources repeatedly.
+
     \section1 Dynamic Resource Loading
 
     A resource can be left out of an application's binary and loaded when
@@ -213,6 +427,8 @@ public:
 
     void ensureInitialized() const;
     void ensureChildren() const;
+    qint64 uncompressedSize() const;
+    QByteArray uncompressedData() const;
 
     bool load(const QString &file);
     void clear();
@@ -221,7 +437,7 @@ public:
     QString fileName, absoluteFilePath;
     QList<QResourceRoot*> related;
     uint container : 1;
-    mutable uint compressed : 1;
+    mutable uint compressionAlgo : 2;
     mutable qint64 size;
     mutable const uchar *data;
     mutable QStringList children;
@@ -234,16 +450,13 @@ void
 QResourcePrivate::clear()
 {
     absoluteFilePath.clear();
-    compressed = 0;
+    compressionAlgo = QResource::NoCompression;
     data = 0;
     size = 0;
     children.clear();
     container = 0;
-    for(int i = 0; i < related.size(); ++i) {
-        QResourceRoot *root = related.at(i);
-        if(!root->ref.deref())
-            delete root;
-    }
+    for(int i = 0; i < related.size(); ++i)
+        releaseResourceRoot(related.at(i));
     related.clear();
 }
 
@@ -251,22 +464,22 @@ bool
 QResourcePrivate::load(const QString &file)
 {
     related.clear();
-    QMutexLocker lock(resourceMutex());
-    const ResourceList *list = resourceList();
+    const ResourceList list = registeredResourceRoots();
     QString cleaned = cleanPath(file);
-    for(int i = 0; i < list->size(); ++i) {
-        QResourceRoot *res = list->at(i);
-        const int node = res->findNode(cleaned, locale);
+    uint cleanedHash = 0;
+    for(int i = 0; i < list.size(); ++i) {
+        QResourceRoot *res = list.at(i);
+        const int node = res->findNode(cleaned, locale, &cleanedHash);
         if(node != -1) {
             if(related.isEmpty()) {
                 container = res->isContainer(node);
                 if(!container) {
                     data = res->data(node, &size);
-                    compressed = res->isCompressed(node);
+                    compressionAlgo = res->compressionAlgorithm(node);
                 } else {
                     data = 0;
                     size = 0;
-                    compressed = 0;
+                    compressionAlgo = QResource::NoCompression;
                 }
             } else if(res->isContainer(node) != container) {
                 qWarning("QResourceInfo: Resource [%s] has both data and children!", file.toLatin1().constData());
@@ -277,7 +490,7 @@ QResourcePrivate::load(const QString &file)
             container = true;
             data = 0;
             size = 0;
-            compressed = 0;
+            compressionAlgo = QResource::NoCompression;
             res->ref.ref();
             related.append(res);
         }
@@ -285,6 +498,74 @@ QResourcePrivate::load(const QString &file)
     return !related.isEmpty();
 }
 
+qint64 QResourcePrivate::uncompressedSize() const
+{
+    switch (compressionAlgo) {
+    case QResource::NoCompression:
+        return size;
+    case QResource::ZlibCompression:
+        // qCompress() stores the size in front of the data
+        if (size < 4)
+            return -1;
+        return qFromBigEndian<quint32>(data);
+    case QResource::ZstdCompression: {
+#ifndef QT_NO_ZSTD
+        const unsigned long long n = ZSTD_getFrameContentSize(data, size);
+        if (n == ZSTD_CONTENTSIZE_UNKNOWN || n == ZSTD_CONTENTSIZE_ERROR)
+            return -1;
+        return qint64(n);
+#else
+        break;
+#endif
+    }
+    }
+    return -1;
+}
+
+QByteArray QResourcePrivate::uncompressedData() const
+{
+    if (!data)
+        return QByteArray();
+
+    switch (compressionAlgo) {
+    case QResource::NoCompression:
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(data), size);
+    case QResource::ZlibCompression:
+#ifndef QT_NO_COMPRESS
+        return qUncompress(data, size);
+#else
+        qWarning("QResource: Qt built without support for zlib compression");
+        break;
+#endif
+    case QResource::ZstdCompression: {
+#ifndef QT_NO_ZSTD
+        const qint64 n = uncompressedSize();
+        QThreadStorage<ZstdDecompressionContext *> *contexts = zstdDecompressionContexts();
+        if (n < 0 || n >= MaxAllocSize || !contexts) {
+            qWarning("QResource: Invalid compressed data in %s", qPrintable(absoluteFilePath));
+            return QByteArray();
+        }
+        if (!contexts->hasLocalData())
+            contexts->setLocalData(new ZstdDecompressionContext);
+
+        QByteArray result(int(n), Qt::Uninitialized);
+        const size_t r = ZSTD_decompressDCtx(contexts->localData()->context, result.data(), size_t(n),
+                                             data, size_t(size));
+        if (ZSTD_isError(r) || r != size_t(n)) {
+            qWarning("QResource: Cannot decompress %s: %s", qPrintable(absoluteFilePath),
+                     ZSTD_isError(r) ? ZSTD_getErrorName(r) : "size mismatch");
+            return QByteArray();
+        }
+        return result;
+#else
+        qWarning("QResource: Qt built without support for zstd compression");
+        break;
+#endif
+    }
+    }
+    return QByteArray();
+}
+
 void
 QResourcePrivate::ensureInitialized() const
 {
@@ -304,8 +585,11 @@ QResourcePrivate::ensureInitialized() const
     if(path.startsWith(QLatin1Char('/'))) {
         that->load(path);
     } else {
-        QMutexLocker lock(resourceMutex());
-        QStringList searchPaths = *resourceSearchPaths();
+        QStringList searchPaths;
+        {
+            QMutexLocker lock(resourceMutex());
+            searchPaths = *resourceSearchPaths();
+        }
         searchPaths << QLatin1String("");
         for(int i = 0; i < searchPaths.size(); ++i) {
             const QString searchPath(searchPaths.at(i) + QLatin1Char('/') + path);
@@ -468,14 +752,42 @@ bool QResource::isValid() const
     Returns \c true if the resource represents a file and the data backing it
     is in a compressed format, false otherwise.
 
-    \sa data(), isFile()
+    \sa data(), compressionAlgorithm(), isFile()
 */
 
 bool QResource::isCompressed() const
+{
+    return compressionAlgorithm() != NoCompression;
+}
+
+/*!
+    \enum QResource::Compression
+    \since 5.6
+
+    This enum describes how the data backing a resource is compressed.
+
+    \value NoCompression   The data is not compressed.
+    \value ZlibCompression The data was compressed with qCompress(), and can
+                           be decompressed with qUncompress().
+    \value ZstdCompression The data is a Zstandard frame.
+
+    \sa compressionAlgorithm()
+*/
+
+/*!
+    \since 5.6
+
+    Returns how the data backing the resource is compressed. Use
+    uncompressedData() to get the data regardless of the algorithm.
+
+    \sa isCompressed(), uncompressedData()
+*/
+
+QResource::Compression QResource::compressionAlgorithm() const
 {
     Q_D(const QResource);
     d->ensureInitialized();
-    return d->compressed;
+    return Compression(d->compressionAlgo);
 }
 
 /*!
@@ -493,11 +805,11 @@ qint64 QResource::size() const
 
 /*!
     Returns direct access to a read only segment of data that this resource
-    represents. If the resource is compressed the data returns is
-    compressed and qUncompress() must be used to access the data. If the
-    resource is a directory 0 is returned.
+    represents. If the resource is compressed the data returned is
+    compressed and uncompressedData() must be used to access the data. If
+    the resource is a directory 0 is returned.
 
-    \sa size(), isCompressed(), isFile()
+    \sa size(), isCompressed(), uncompressedData(), isFile()
 */
 
 const uchar *QResource::data() const
@@ -507,6 +819,56 @@ const uchar *QResource::data() const
     return d->data;
 }
 
+/*!
+    \since 5.6
+
+    Returns the size of the data after decompression, without decompressing
+    it. This is the same as size() if the resource is not compressed.
+    Returns -1 if the size cannot be determined.
+
+    \sa uncompressedData(), size()
+*/
+
+qint64 QResource::uncompressedSize() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    return d->uncompressedSize();
+}
+
+/*!
+    \since 5.6
+
+    Returns the data of the resource, decompressed if it is compressed. The
+    data is not copied if the resource is not compressed. Returns an empty
+    QByteArray if the data cannot be decompressed, or if the resource is a
+    directory.
+
+    \sa data(), uncompressedSize(), compressionAlgorithm()
+*/
+
+QByteArray QResource::uncompressedData() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    if (d->compressionAlgo == NoCompression || !d->data)
+        return d->uncompressedData();
+
+    UncompressedResourceCache *c = uncompressedResourceCache();
+    const bool cached = c && c->cache.maxCost() > 0;
+    if (cached) {
+        QMutexLocker lock(&c->mutex);
+        if (const QByteArray *hit = c->cache.object(d->data))
+            return *hit;
+    }
+    const QByteArray result = d->uncompressedData();
+    if (cached && !result.isEmpty()) {
+        QMutexLocker lock(&c->mutex);
+        c->cache.insert(d->data, new QByteArray(result), result.size());
+    }
+    return result;
+}
+
 /*!
     Returns \c true if the resource represents a directory and thus may have
     children() in it, false if it represents a file.
@@ -612,19 +974,22 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
-int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
+// pathHash, if given, caches the hash of _path for the path index; it is 0
+// until computed
+int QResourceRoot::findNode(const QString &_path, const QLocale &locale, uint *pathHash) const
 {
     QString path = _path;
     {
-        QString root = mappingRoot();
+        const QString root = mappingRoot();
         if(!root.isEmpty()) {
             if(root == path) {
                 path = QLatin1Char('/');
             } else {
-                if(!root.endsWith(QLatin1Char('/')))
-                    root += QLatin1Char('/');
-                if(path.size() >= root.size() && path.startsWith(root))
-                    path = path.mid(root.length()-1);
+                // strip "root/", keeping the slash
+                const int rootLength = root.endsWith(QLatin1Char('/')) ? root.size() - 1 : root.size();
+                if(path.size() > rootLength && path.at(rootLength) == QLatin1Char('/')
+                   && path.startsWith(QStringRef(&root, 0, rootLength)))
+                    path = path.mid(rootLength);
                 if(path.isEmpty())
                     path = QLatin1Char('/');
             }
@@ -637,6 +1002,18 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if(path == QLatin1String("/"))
         return 0;
 
+    if (pathIndex && path.startsWith(QLatin1Char('/')) && !path.endsWith(QLatin1Char('/'))
+            && !path.contains(QLatin1String("//"))) {
+        const bool mapped = path.constData() != _path.constData();
+        if (!pathHash || mapped || !*pathHash) {
+            const uint h = qt_hash(QStringRef(&path, 1, path.size() - 1));
+            if (pathHash && !mapped)
+                *pathHash = h;
+            return findNodeInIndex(path, locale, h);
+        }
+        return findNodeInIndex(path, locale, *pathHash);
+    }
+
     //the root node is always first
     int child_count = (tree[6] << 24) + (tree[7] << 16) +
                       (tree[8] << 8) + (tree[9] << 0);
@@ -742,6 +1119,88 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 #endif
     return node;
 }
+bool QResourceRoot::nameEquals(int node, const QChar *str, int length) const
+{
+    if(!node) // root
+        return length == 0;
+    const int offset = findOffset(node);
+    int name_offset = qFromBigEndian<qint32>(tree + offset);
+    const int name_length = qFromBigEndian<quint16>(names + name_offset);
+    if (name_length != length)
+        return false;
+    name_offset += 2;
+    name_offset += 4; //jump past hash
+
+    const uchar *name = names + name_offset;
+    for (int i = 0; i < length; ++i) {
+        if (str[i].unicode() != qFromBigEndian<quint16>(name + 2 * i))
+            return false;
+    }
+    return true;
+}
+
+// checks that \a node is at \a path, given without the leading slash, by
+// comparing the names of the node and its parents to the segments of the path
+bool QResourceRoot::matchesPath(int node, const QChar *path, int length) const
+{
+    int end = length;
+    while (node) {
+        if (end < 0)
+            return false;
+        int start = end;
+        while (start > 0 && path[start - 1] != QLatin1Char('/'))
+            --start;
+        if (!nameEquals(node, path + start, end - start))
+            return false;
+        node = qFromBigEndian<qint32>(parentNodes + 4 * node);
+        end = start - 1;
+    }
+    return end < 0;
+}
+
+// the slot where lookups for hash h start, as in rcc
+static inline uint resourceIndexSlot(uint h, uint mask)
+{
+    h ^= h >> 15;
+    h *= 0x2c1b3c6dU;
+    h ^= h >> 12;
+    return h & mask;
+}
+
+// single probe into the path index that rcc writes from version 3 on,
+// choosing among locale variants as findNode() does
+int QResourceRoot::findNodeInIndex(const QString &path, const QLocale &locale, uint h) const
+{
+    const QChar *relativePath = path.constData() + 1;
+    const int length = path.size() - 1;
+
+    int node = -1;
+    for (uint slot = resourceIndexSlot(h, pathIndexMask); ; slot = (slot + 1) & pathIndexMask) {
+        const uchar *entry = pathIndex + 8 * slot;
+        const int entryNode = qFromBigEndian<qint32>(entry + 4);
+        if (!entryNode)
+            break;
+        if (qFromBigEndian<quint32>(entry) != h || !matchesPath(entryNode, relativePath, length))
+            continue;
+
+        int offset = findOffset(entryNode) + 4; //jump past name
+        const short flags = qFromBigEndian<qint16>(tree + offset);
+        offset += 2;
+        if (flags & Directory)
+            return entryNode;
+
+        const short country = qFromBigEndian<qint16>(tree + offset);
+        const short language = qFromBigEndian<qint16>(tree + offset + 2);
+        if (country == locale.country() && language == locale.language()) {
+            return entryNode;
+        } else if ((country == QLocale::AnyCountry && language == locale.language()) ||
+                   (country == QLocale::AnyCountry && language == QLocale::C && node == -1)) {
+            node = entryNode;
+        }
+    }
+    return node;
+}
+
 short QResourceRoot::flags(int node) const
 {
     if(node == -1)
@@ -799,21 +1258,15 @@ bool QResourceRoot::mappingRootSubdir(const QString &path, QString *match) const
 {
     const QString root = mappingRoot();
     if(!root.isEmpty()) {
-        const QStringList root_segments = root.split(QLatin1Char('/'), QString::SkipEmptyParts),
-                          path_segments = path.split(QLatin1Char('/'), QString::SkipEmptyParts);
-        if(path_segments.size() <= root_segments.size()) {
-            int matched = 0;
-            for(int i = 0; i < path_segments.size(); ++i) {
-                if(root_segments[i] != path_segments[i])
-                    break;
-                ++matched;
-            }
-            if(matched == path_segments.size()) {
-                if(match && root_segments.size() > matched)
-                    *match = root_segments.at(matched);
-                return true;
-            }
+        // is path a parent of the root, segment by segment?
+        QStringSplitter root_segments(root), path_segments(path);
+        while(path_segments.hasNext()) {
+            if(!root_segments.hasNext() || root_segments.next() != path_segments.next())
+                return false;
         }
+        if(match && root_segments.hasNext())
+            *match = root_segments.next().toString();
+        return true;
     }
     return false;
 }
@@ -822,9 +1275,9 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
                                          const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if(version == 0x01 && resourceList()) {
+    if (isSupportedResourceVersion(version) && resourceList()) {
         bool found = false;
-        QResourceRoot res(tree, name, data);
+        QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ++i) {
             if(*resourceList()->at(i) == res) {
                 found = true;
@@ -832,9 +1285,10 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
             }
         }
         if(!found) {
-            QResourceRoot *root = new QResourceRoot(tree, name, data);
+            QResourceRoot *root = new QResourceRoot(version, tree, name, data);
             root->ref.ref();
             resourceList()->append(root);
+            resourceListChanged();
         }
         return true;
     }
@@ -845,13 +1299,14 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
                                            const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if(version == 0x01 && resourceList()) {
-        QResourceRoot res(tree, name, data);
+    if (isSupportedResourceVersion(version) && resourceList()) {
+        QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ) {
             if(*resourceList()->at(i) == res) {
+                clearUncompressedResourceCache();
                 QResourceRoot *root = resourceList()->takeAt(i);
-                if(!root->ref.deref())
-                    delete root;
+                resourceListChanged();
+                releaseResourceRoot(root);
             } else {
                 ++i;
             }
@@ -870,7 +1325,7 @@ class QDynamicBufferResourceRoot: public QResourceRoot
 
 public:
     inline QDynamicBufferResourceRoot(const QString &_root) : root(_root), buffer(0) { }
-    inline ~QDynamicBufferResourceRoot() { }
+    inline ~QDynamicBufferResourceRoot() { clearUncompressedResourceCache(); }
     inline const uchar *mappingBuffer() const { return buffer; }
     virtual QString mappingRoot() const Q_DECL_OVERRIDE { return root; }
     virtual ResourceRootType type() const Q_DECL_OVERRIDE { return Resource_Buffer; }
@@ -912,9 +1367,9 @@ public:
         if (size >= 0 && (tree_offset >= size || data_offset >= size || name_offset >= size))
             return false;
 
-        if(version == 0x01) {
+        if (isSupportedResourceVersion(version)) {
             buffer = b;
-            setSource(b+tree_offset, b+name_offset, b+data_offset);
+            setSource(version, b+tree_offset, b+name_offset, b+data_offset);
             return true;
         }
         return false;
@@ -947,6 +1402,7 @@ class QDynamicFileResourceRoot: public QDynamicBufferResourceRoot
 public:
     inline QDynamicFileResourceRoot(const QString &_root) : QDynamicBufferResourceRoot(_root), unmapPointer(0), unmapLength(0) { }
     ~QDynamicFileResourceRoot() {
+        clearUncompressedResourceCache();
 #if defined(QT_USE_MMAP)
         if (unmapPointer) {
             munmap((char*)unmapPointer, unmapLength);
@@ -1066,6 +1522,7 @@ QResource::registerResource(const QString &rccFilename, const QString &resourceR
         root->ref.ref();
         QMutexLocker lock(resourceMutex());
         resourceList()->append(root);
+        resourceListChanged();
         return true;
     }
     delete root;
@@ -1096,11 +1553,8 @@ QResource::unregisterResource(const QString &rccFilename, const QString &resourc
             QDynamicFileResourceRoot *root = reinterpret_cast<QDynamicFileResourceRoot*>(res);
             if (root->mappingFile() == rccFilename && root->mappingRoot() == r) {
                 resourceList()->removeAt(i);
-                if(!root->ref.deref()) {
-                    delete root;
-                    return true;
-                }
-                return false;
+                resourceListChanged();
+                return releaseResourceRoot(root);
             }
         }
     }
@@ -1137,6 +1591,7 @@ QResource::registerResource(const uchar *rccData, const QString &resourceRoot)
         root->ref.ref();
         QMutexLocker lock(resourceMutex());
         resourceList()->append(root);
+        resourceListChanged();
         return true;
     }
     delete root;
@@ -1167,11 +1622,8 @@ QResource::unregisterResource(const uchar *rccData, const QString &resourceRoot)
             QDynamicBufferResourceRoot *root = reinterpret_cast<QDynamicBufferResourceRoot*>(res);
             if (root->mappingBuffer() == rccData && root->mappingRoot() == r) {
                 resourceList()->removeAt(i);
-                if(!root->ref.deref()) {
-                    delete root;
-                    return true;
-                }
-                return false;
+                resourceListChanged();
+                return releaseResourceRoot(root);
             }
         }
     }
@@ -1223,13 +1675,6 @@ QResourceFileEngine::QResourceFileEngine(const QString &file) :
 {
     Q_D(QResourceFileEngine);
     d->resource.setFileName(file);
-    if(d->resource.isCompressed() && d->resource.size()) {
-#ifndef QT_NO_COMPRESS
-        d->uncompressed = qUncompress(d->resource.data(), d->resource.size());
-#else
-        Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
-#endif
-    }
 }
 
 QResourceFileEngine::~QResourceFileEngine()
@@ -1253,6 +1698,12 @@ bool QResourceFileEngine::open(QIODevice::OpenMode flags)
         return false;
     if(!d->resource.isValid())
        return false;
+    // decompress when opening, not when QFileInfo merely looks at the file
+    if (d->resource.isCompressed() && d->resource.size()) {
+        d->uncompressed = d->resource.uncompressedData();
+        if (d->uncompressed.isNull())
+            return false;
+    }
     return true;
 }
 
@@ -1314,8 +1765,11 @@ qint64 QResourceFileEngine::size() const
     Q_D(const QResourceFileEngine);
     if(!d->resource.isValid())
         return 0;
-    if(d->resource.isCompressed())
-        return d->uncompressed.size();
+    if (d->resource.isCompressed()) {
+        if (!d->uncompressed.isNull())
+            return d->uncompressed.size();
+        return qMax<qint64>(0, d->resource.uncompressedSize());
+    }
     return d->resource.size();
 }
 
@@ -1470,10 +1924,19 @@ uchar *QResourceFileEnginePrivate::map(qint64 offset, qint64 size, QFile::Memory
 {
     Q_Q(QResourceFileEngine);
     Q_UNUSED(flags);
-    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > resource.size()) {
+    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > q->size()) {
         q->setError(QFile::UnspecifiedError, QString());
         return 0;
     }
+    // a compressed resource maps its decompressed data, which stays valid
+    // until the file is closed
+    if (resource.isCompressed()) {
+        if (uncompressed.isNull()) {
+            q->setError(QFile::UnspecifiedError, QString());
+            return 0;
+        }
+        return reinterpret_cast<uchar *>(const_cast<char *>(uncompressed.constData())) + offset;
+    }
     uchar *address = const_cast<uchar *>(resource.data());
     return (address + offset);
 }
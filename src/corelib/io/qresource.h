@@ -47,6 +47,12 @@ class QResourcePrivate;
 class Q_CORE_EXPORT QResource
 {
 public:
+    enum Compression {
+        NoCompression,
+        ZlibCompression,
+        ZstdCompression
+    };
+
     QResource(const QString &file=QString(), const QLocale &locale=QLocale());
     ~QResource();
 
@@ -60,8 +66,11 @@ public:
     bool isValid() const;
 
     bool isCompressed() const;
+    Compression compressionAlgorithm() const;
     qint64 size() const;
     const uchar *data() const;
+    qint64 uncompressedSize() const;
+    QByteArray uncompressedData() const;
 
     static void addSearchPath(const QString &path);
     static QStringList searchPaths();
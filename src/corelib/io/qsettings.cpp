@@ -1456,7 +1456,22 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
         so everything is under control.
     */
     if (!readOnly) {
-        ensureAllSectionsParsed(confFile);
+        /*
+            Only the INI sections that we modify need to be parsed. The
+            others are written back exactly as they were read, which keeps
+            the cost of a sync proportional to the changes. This includes
+            the sections of removed keys, which may have been read again
+            above if the file changed on disk.
+        */
+        if (format <= QSettings::IniFormat) {
+            ParsedSettingsMap::const_iterator i = confFile->addedKeys.constBegin();
+            for (; i != confFile->addedKeys.constEnd(); ++i)
+                ensureSectionParsed(confFile, i.key());
+            for (i = confFile->removedKeys.constBegin(); i != confFile->removedKeys.constEnd(); ++i)
+                ensureSectionParsed(confFile, i.key());
+        } else {
+            ensureAllSectionsParsed(confFile);
+        }
         ParsedSettingsMap mergedKeys = confFile->mergedKeyMap();
 
 #ifdef Q_OS_MAC
@@ -1474,7 +1489,7 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
                 setStatus(QSettings::AccessError);
                 ok = false;
             } else if (format <= QSettings::IniFormat) {
-                ok = writeIniFile(sf, mergedKeys);
+                ok = writeIniFile(sf, mergedKeys, confFile->unparsedIniSections);
             } else {
                 if (writeFunc) {
                     QSettings::SettingsMap tempOriginalKeys;
@@ -1496,7 +1511,7 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
         }
 
         if (ok) {
-            confFile->unparsedIniSections.clear();
+            // the unparsed sections are still valid, since they were written back unchanged
             confFile->originalKeys = mergedKeys;
             confFile->addedKeys.clear();
             confFile->removedKeys.clear();
@@ -1774,11 +1789,15 @@ typedef QMap<QString, QSettingsIniSection> IniMap;
 /*
     This would be more straightforward if we didn't try to remember the original
     key order in the .ini file, but we do.
+
+    The sections in \a unparsedIniSections are written out as they were read.
 */
-bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSettingsMap &map)
+bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSettingsMap &map,
+                                            const UnparsedSettingsMap &unparsedIniSections)
 {
     IniMap iniMap;
     IniMap::const_iterator i;
+    QHash<QString, QByteArray> rawSections;
 
 #ifdef Q_OS_WIN
     const char * const eol = "\r\n";
@@ -1804,21 +1823,43 @@ bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSetti
         iniSection.keyMap[key] = j.value();
     }
 
-    const int sectionCount = iniMap.size();
     QVector<QSettingsIniKey> sections;
-    sections.reserve(sectionCount);
+    sections.reserve(iniMap.size() + unparsedIniSections.size());
     for (i = iniMap.constBegin(); i != iniMap.constEnd(); ++i)
         sections.append(QSettingsIniKey(i.key(), i.value().position));
+
+    for (UnparsedSettingsMap::const_iterator k = unparsedIniSections.constBegin();
+         k != unparsedIniSections.constEnd(); ++k) {
+        // the data starts right after the section header and runs up to the next one
+        const QByteArray &data = k.value();
+        int dataStart = 0;
+        int dataEnd = data.size();
+        char ch;
+        while (dataStart < dataEnd && ((ch = data.at(dataStart)) == '\n' || ch == '\r'))
+            ++dataStart;
+        while (dataEnd > dataStart && ((ch = data.at(dataEnd - 1)) == '\n' || ch == '\r'
+                                       || ch == ' ' || ch == '\t'))
+            --dataEnd;
+        if (dataEnd == dataStart)
+            continue;
+        QString section = k.key().originalCaseKey();
+        section.chop(1); // the trailing '/', or nothing for [General]
+        Q_ASSERT(!iniMap.contains(section));
+        rawSections.insert(section, data.mid(dataStart, dataEnd - dataStart) + eol);
+        sections.append(QSettingsIniKey(section, k.key().originalKeyPosition()));
+    }
+
+    const int sectionCount = sections.size();
     std::sort(sections.begin(), sections.end());
 
     bool writeError = false;
     for (int j = 0; !writeError && j < sectionCount; ++j) {
-        i = iniMap.constFind(sections.at(j));
-        Q_ASSERT(i != iniMap.constEnd());
+        const QString &section = sections.at(j);
+        i = iniMap.constFind(section);
 
         QByteArray realSection;
 
-        iniEscapedKey(i.key(), realSection);
+        iniEscapedKey(section, realSection);
 
         if (realSection.isEmpty()) {
             realSection = "[General]";
@@ -1835,6 +1876,12 @@ bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSetti
 
         device.write(realSection);
 
+        if (i == iniMap.constEnd()) {
+            if (device.write(rawSections.value(section)) == -1)
+                writeError = true;
+            continue;
+        }
+
         const IniKeyMap &ents = i.value().keyMap;
         for (IniKeyMap::const_iterator j = ents.constBegin(); j != ents.constEnd(); ++j) {
             QByteArray block;
@@ -292,7 +292,8 @@ private:
     void initFormat();
     void initAccess();
     void syncConfFile(int confFileNo);
-    bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
+    bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map,
+                      const UnparsedSettingsMap &unparsedIniSections = UnparsedSettingsMap());
 #ifdef Q_OS_MAC
     bool readPlistFile(const QString &fileName, ParsedSettingsMap *map) const;
     bool writePlistFile(const QString &fileName, const ParsedSettingsMap &map) const;
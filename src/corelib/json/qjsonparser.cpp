@@ -39,6 +39,7 @@
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include "private/qlocale_tools_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -705,32 +706,30 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
         return false;
     }
 
-    QByteArray number(start, json - start);
-    DEBUG << "numberstring" << number;
-
-    if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
-            val->int_value = n;
-            val->latinOrIntValue = true;
-            END;
-            return true;
-        }
-    }
+    const int length = json - start;
+    DEBUG << "numberstring" << QByteArray::fromRawData(start, length);
 
     bool ok;
+    int processed;
     union {
         quint64 ui;
         double d;
     };
-    d = number.toDouble(&ok);
+    d = qt_asciiToDouble(start, length, ok, processed);
 
-    if (!ok) {
+    if (!ok || processed != length) {
         lastError = QJsonParseError::IllegalNumber;
         return false;
     }
 
+    // integers are parsed exactly; small ones are stored inline
+    if (isInt && d < (1<<25) && d > -(1<<25)) {
+        val->int_value = int(d);
+        val->latinOrIntValue = true;
+        END;
+        return true;
+    }
+
     int pos = reserveSpace(sizeof(double));
     *(quint64 *)(data + pos) = qToLittleEndian(ui);
     if (current - baseOffset >= Value::MaxSize) {
@@ -35,6 +35,7 @@
 #include "qjsonwriter_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include "private/qlocale_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -122,10 +123,17 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
         break;
     case QJsonValue::Double: {
         const double d = v.toDouble(b);
-        if (qIsFinite(d)) // +2 to format to ensure the expected precision
-            json += QByteArray::number(d, 'g', std::numeric_limits<double>::digits10 + 2); // ::digits10 is 15
-        else
+        if (qIsFinite(d)) {
+            char buf[QLocaleData::CLocaleDoubleBufferSize];
+            const int length = QLocaleData::doubleToCLocale(buf, sizeof(buf), d,
+                                                            QLocale::FloatingPointShortest,
+                                                            QLocaleData::DFSignificantDigits,
+                                                            QLocaleData::NoFlags);
+            Q_ASSERT(length >= 0); // the shortest representation always fits
+            json.append(buf, length);
+        } else {
             json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+        }
         break;
     }
     case QJsonValue::String:
@@ -149,7 +149,9 @@ unix|integrity {
    contains(QT_CONFIG, clock-gettime):include($$QT_SOURCE_TREE/config.tests/unix/clock-gettime/clock-gettime.pri)
 
     !android {
-        SOURCES += kernel/qsharedmemory_posix.cpp \
+        HEADERS += kernel/qsharedmemorychannel.h
+        SOURCES += kernel/qsharedmemorychannel.cpp \
+                   kernel/qsharedmemory_posix.cpp \
                    kernel/qsharedmemory_systemv.cpp \
                    kernel/qsharedmemory_unix.cpp \
                    kernel/qsystemsemaphore_posix.cpp \
@@ -0,0 +1,889 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsharedmemorychannel.h"
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_ANDROID) \
+    && !defined(QT_NO_SHAREDMEMORY) && !defined(QT_NO_SYSTEMSEMAPHORE)
+
+#include "qplatformdefs.h"
+
+#include "qcryptographichash.h"
+#include "qdir.h"
+#include "qelapsedtimer.h"
+#include "qfile.h"
+#include "qsharedmemory.h"
+#include "qsocketnotifier.h"
+
+#include "qobject_p.h"
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <sys/stat.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The shared memory segment starts with a ChannelHeader, followed by the
+    ring. Positions are free running byte counters; their difference is the
+    number of bytes in use and, as the capacity is a power of two, a
+    position modulo the capacity is an offset into the ring.
+
+    Every message is stored as an 8-byte record header, holding the size of
+    the message, followed by the message padded to a multiple of 8 bytes.
+    Messages are never split: if a record doesn't fit at the end of the
+    ring, a wrap marker is written there instead and the record starts at
+    the beginning of the ring.
+
+    Each side has a FIFO that the other side writes a byte to in order to
+    wake it up, which is what its QSocketNotifier watches. Waking up costs a
+    system call, so it's only done when the side to be woken asked for it
+    by setting its waiting flag; under load, a single wake-up covers many
+    messages.
+*/
+namespace {
+enum {
+    ChannelMagic = 0x51534d43,          // "QSMC"
+    ChannelVersion = 1,
+    RecordHeaderSize = 8,
+    MinimumCapacity = 4096,
+    MaximumCapacity = 1 << 30
+};
+
+static const quint32 WrapMarker = 0xffffffff;
+
+struct ChannelHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 capacity;
+    quint32 reserved;
+    char padding0[64 - 4 * sizeof(quint32)];
+
+    // advanced by the producer
+    QBasicAtomicInteger<quint32> writePosition;
+    QBasicAtomicInt writerWaiting;
+    char padding1[64 - 2 * sizeof(quint32)];
+
+    // advanced by the consumer
+    QBasicAtomicInteger<quint32> readPosition;
+    QBasicAtomicInt readerWaiting;
+    char padding2[64 - 2 * sizeof(quint32)];
+};
+}
+
+static inline quint32 recordSize(int size)
+{
+    return (RecordHeaderSize + quint32(size) + 7) & ~quint32(7);
+}
+
+class QSharedMemoryChannelPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QSharedMemoryChannel)
+public:
+    QSharedMemoryChannelPrivate()
+        : role(QSharedMemoryChannel::Producer), header(0), ring(0), capacity(0),
+          wakeFd(-1), peerFd(-1), notifier(0), created(false),
+          reservedSize(-1), reservedSkip(0), peekedSize(-1), peekedSkip(0),
+          error(QSharedMemoryChannel::NoError)
+    {}
+
+    QString fifoPath(QSharedMemoryChannel::Role r) const;
+    bool setUp(QSharedMemoryChannel::Role r, const char *function);
+    void tearDown();
+    void setError(QSharedMemoryChannel::ChannelError e, const QString &message);
+    void setMemoryError();
+
+    // whether a record of this size (including any skipped tail) fits;
+    // ordered after setting writerWaiting
+    bool hasSpace(quint32 bytes, bool ordered) const
+    {
+        const quint32 read = ordered ? header->readPosition.fetchAndAddOrdered(0)
+                                     : header->readPosition.loadAcquire();
+        return capacity - (header->writePosition.load() - read) >= bytes;
+    }
+    bool hasMessage(bool ordered) const
+    {
+        const quint32 write = ordered ? header->writePosition.fetchAndAddOrdered(0)
+                                      : header->writePosition.loadAcquire();
+        return header->readPosition.load() != write;
+    }
+    quint32 spaceNeeded(int size, quint32 *skip) const
+    {
+        const quint32 tail = capacity - (header->writePosition.load() & (capacity - 1));
+        const quint32 record = recordSize(size);
+        *skip = record > tail ? tail : 0;
+        return *skip + record;
+    }
+
+    void wakePeer();
+    void drainWakeUps();
+    bool waitForWakeUp(const QElapsedTimer &timer, int msecs);
+    void _q_wakeUp();
+
+    QString key;
+    QSharedMemory memory;
+    QSharedMemoryChannel::Role role;
+    ChannelHeader *header;
+    char *ring;
+    quint32 capacity;
+    int wakeFd;
+    int peerFd;
+    QSocketNotifier *notifier;
+    bool created;
+
+    int reservedSize;
+    quint32 reservedSkip;
+    int peekedSize;
+    quint32 peekedSkip;
+
+    QSharedMemoryChannel::ChannelError error;
+    QString errorString;
+};
+
+/*!
+    \internal
+    Returns the path of the FIFO that wakes up the side with role \a r.
+*/
+QString QSharedMemoryChannelPrivate::fifoPath(QSharedMemoryChannel::Role r) const
+{
+    const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir::tempPath() + QLatin1String("/qipc_channel_") + QLatin1String(hash)
+            + (r == QSharedMemoryChannel::Producer ? QLatin1String("_producer")
+                                                   : QLatin1String("_consumer"));
+}
+
+void QSharedMemoryChannelPrivate::setError(QSharedMemoryChannel::ChannelError e,
+                                           const QString &message)
+{
+    error = e;
+    errorString = message;
+}
+
+void QSharedMemoryChannelPrivate::setMemoryError()
+{
+    QSharedMemoryChannel::ChannelError e;
+    switch (memory.error()) {
+    case QSharedMemory::NoError: e = QSharedMemoryChannel::NoError; break;
+    case QSharedMemory::PermissionDenied: e = QSharedMemoryChannel::PermissionDenied; break;
+    case QSharedMemory::InvalidSize: e = QSharedMemoryChannel::InvalidSize; break;
+    case QSharedMemory::KeyError: e = QSharedMemoryChannel::KeyError; break;
+    case QSharedMemory::AlreadyExists: e = QSharedMemoryChannel::AlreadyExists; break;
+    case QSharedMemory::NotFound: e = QSharedMemoryChannel::NotFound; break;
+    case QSharedMemory::OutOfResources: e = QSharedMemoryChannel::OutOfResources; break;
+    default: e = QSharedMemoryChannel::UnknownError; break;
+    }
+    setError(e, memory.errorString());
+}
+
+/*!
+    \internal
+    Opens the FIFO at \a path. The temporary directory is shared with other
+    users, so it must be a FIFO of ours and not a symbolic link.
+*/
+static int openFifo(const QString &path)
+{
+    const int fd = qt_safe_open(QFile::encodeName(path).constData(), O_RDWR | O_NONBLOCK | O_NOFOLLOW);
+    if (fd == -1)
+        return -1;
+    QT_STATBUF st;
+    if (QT_FSTAT(fd, &st) == -1 || !S_ISFIFO(st.st_mode) || st.st_uid != ::geteuid()) {
+        qt_safe_close(fd);
+        errno = EACCES;
+        return -1;
+    }
+    return fd;
+}
+
+/*!
+    \internal
+    Opens the FIFOs of an initialized segment and starts watching ours.
+*/
+bool QSharedMemoryChannelPrivate::setUp(QSharedMemoryChannel::Role r, const char *function)
+{
+    Q_Q(QSharedMemoryChannel);
+    const QSharedMemoryChannel::Role peer = r == QSharedMemoryChannel::Producer
+            ? QSharedMemoryChannel::Consumer : QSharedMemoryChannel::Producer;
+
+    // opening a FIFO for reading and writing never blocks and doesn't
+    // require the other side to have it open
+    wakeFd = openFifo(fifoPath(r));
+    if (wakeFd != -1)
+        peerFd = openFifo(fifoPath(peer));
+    if (wakeFd == -1 || peerFd == -1) {
+        const int savedErrno = errno;
+        setError(savedErrno == ENOENT ? QSharedMemoryChannel::NotFound
+                 : savedErrno == EACCES || savedErrno == ELOOP ? QSharedMemoryChannel::PermissionDenied
+                 : QSharedMemoryChannel::UnknownError,
+                 QSharedMemoryChannel::tr("%1: %2").arg(QLatin1String(function), qt_error_string(savedErrno)));
+        tearDown();
+        return false;
+    }
+
+    role = r;
+    header = static_cast<ChannelHeader *>(memory.data());
+    ring = static_cast<char *>(memory.data()) + sizeof(ChannelHeader);
+    capacity = header->capacity;
+    reservedSize = -1;
+    peekedSize = -1;
+
+    notifier = new QSocketNotifier(wakeFd, QSocketNotifier::Read, q);
+    QObject::connect(notifier, SIGNAL(activated(int)), q, SLOT(_q_wakeUp()));
+
+    if (role == QSharedMemoryChannel::Consumer) {
+        header->readerWaiting.fetchAndStoreOrdered(1);
+        if (hasMessage(true))
+            QMetaObject::invokeMethod(q, "messageAvailable", Qt::QueuedConnection);
+    }
+    setError(QSharedMemoryChannel::NoError, QString());
+    return true;
+}
+
+void QSharedMemoryChannelPrivate::tearDown()
+{
+    delete notifier;
+    notifier = 0;
+    if (wakeFd != -1)
+        qt_safe_close(wakeFd);
+    if (peerFd != -1)
+        qt_safe_close(peerFd);
+    wakeFd = peerFd = -1;
+    if (created) {
+        QFile::remove(fifoPath(QSharedMemoryChannel::Producer));
+        QFile::remove(fifoPath(QSharedMemoryChannel::Consumer));
+        created = false;
+    }
+    if (memory.isAttached())
+        memory.detach();
+    header = 0;
+    ring = 0;
+    capacity = 0;
+    reservedSize = -1;
+    peekedSize = -1;
+}
+
+void QSharedMemoryChannelPrivate::wakePeer()
+{
+    // if the FIFO is full, a wake-up is pending anyway
+    const char c = 0;
+    qt_safe_write(peerFd, &c, 1);
+}
+
+void QSharedMemoryChannelPrivate::drainWakeUps()
+{
+    char buffer[64];
+    while (qt_safe_read(wakeFd, buffer, sizeof(buffer)) > 0)
+        ;
+}
+
+bool QSharedMemoryChannelPrivate::waitForWakeUp(const QElapsedTimer &timer, int msecs)
+{
+    int timeout = -1;
+    if (msecs >= 0) {
+        timeout = msecs - int(timer.elapsed());
+        if (timeout <= 0)
+            return false;
+    }
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(wakeFd, &fds);
+    if (qt_select_msecs(wakeFd + 1, &fds, 0, timeout) <= 0)
+        return false;
+    drainWakeUps();
+    return true;
+}
+
+void QSharedMemoryChannelPrivate::_q_wakeUp()
+{
+    Q_Q(QSharedMemoryChannel);
+    drainWakeUps();
+    if (!header)
+        return;
+    if (role == QSharedMemoryChannel::Consumer) {
+        // ask for the next wake-up before looking, so no message is missed
+        header->readerWaiting.fetchAndStoreOrdered(1);
+        if (hasMessage(true))
+            emit q->messageAvailable();
+    } else {
+        emit q->spaceAvailable();
+    }
+}
+
+/*!
+    \class QSharedMemoryChannel
+    \inmodule QtCore
+    \since 5.6
+    \brief The QSharedMemoryChannel class passes messages from one process
+    to another through shared memory.
+
+    \ingroup ipc
+
+    A shared memory channel is a ring buffer in a shared memory segment,
+    with a single producer that writes messages into it and a single
+    consumer that reads them. Messages are not copied through the kernel,
+    as they are with pipes and local sockets: the producer can build a
+    message directly in shared memory with reserveMessage() and
+    commitMessage(), and the consumer can use it in place with
+    peekMessage() before handing the space back with releaseMessage().
+    This makes the channel suitable for large payloads, such as video
+    frames, exchanged between processes on the same host.
+
+    One side calls create() with the capacity of the ring, the other calls
+    attach() with the same key. Either side can be the producer. To send
+    messages in both directions, use two channels.
+
+    \code
+    // producer
+    QSharedMemoryChannel channel("frames");
+    channel.create(QSharedMemoryChannel::Producer, 64 * 1024 * 1024);
+    if (char *frame = channel.reserveMessage(frameSize)) {
+        renderInto(frame);
+        channel.commitMessage();
+    }
+
+    // consumer
+    QSharedMemoryChannel channel("frames");
+    channel.attach(QSharedMemoryChannel::Consumer);
+    connect(&channel, &QSharedMemoryChannel::messageAvailable, [&]() {
+        int size;
+        while (const char *frame = channel.peekMessage(&size)) {
+            display(frame, size);
+            channel.releaseMessage();
+        }
+    });
+    \endcode
+
+    The consumer is notified of new messages through the event loop with
+    the messageAvailable() signal, and the producer of space freed by the
+    consumer with spaceAvailable(). Notifications are only sent when the
+    other side is waiting for them, so a busy channel makes very few system
+    calls. Without an event loop, use waitForMessage() and waitForSpace().
+
+    Unlike QSharedMemory alone, a channel can only connect processes that
+    run as the same user, with the same temporary directory. The
+    notifications go through FIFOs that the side calling create() makes in
+    QDir::tempPath(), and both sides refuse FIFOs that are owned by another
+    user. attach() fails with NotFound if the other process uses a
+    different \c TMPDIR, and with PermissionDenied if it runs as another
+    user.
+
+    A QSharedMemoryChannel object must only be used from the thread it
+    lives in. This class is currently only available on Unix.
+
+    \sa QSharedMemory, QLocalSocket
+*/
+
+/*!
+    \enum QSharedMemoryChannel::Role
+
+    \value Producer The channel writes messages.
+    \value Consumer The channel reads messages.
+*/
+
+/*!
+    \enum QSharedMemoryChannel::ChannelError
+
+    \value NoError No error occurred.
+    \value PermissionDenied The operation failed because the caller
+    didn't have the required permissions.
+    \value InvalidSize The capacity passed to create() is not valid.
+    \value KeyError The operation failed because of an invalid key.
+    \value AlreadyExists A channel with the key already exists, or this
+    object is already attached.
+    \value NotFound No channel with the key exists.
+    \value OutOfResources Not enough memory was available.
+    \value MessageTooLarge The message is larger than maximumMessageSize().
+    \value UnknownError Something else happened.
+*/
+
+/*!
+    \fn void QSharedMemoryChannel::messageAvailable()
+
+    This signal is emitted when a consumer has messages to read. It is not
+    emitted again until new messages arrive after it was emitted.
+*/
+
+/*!
+    \fn void QSharedMemoryChannel::spaceAvailable()
+
+    This signal is emitted when the consumer has freed space after
+    reserveMessage() or writeMessage() failed for lack of space.
+*/
+
+/*!
+    Constructs a shared memory channel with the given \a parent and no key.
+    Call setKey() before create() or attach().
+*/
+QSharedMemoryChannel::QSharedMemoryChannel(QObject *parent)
+    : QObject(*new QSharedMemoryChannelPrivate, parent)
+{
+}
+
+/*!
+    Constructs a shared memory channel with the given \a parent for the
+    channel identified by \a key.
+*/
+QSharedMemoryChannel::QSharedMemoryChannel(const QString &key, QObject *parent)
+    : QObject(*new QSharedMemoryChannelPrivate, parent)
+{
+    setKey(key);
+}
+
+/*!
+    Destroys the channel object, detaching from the channel.
+
+    \sa detach()
+*/
+QSharedMemoryChannel::~QSharedMemoryChannel()
+{
+    detach();
+}
+
+/*!
+    Sets the key of the channel to \a key, detaching first if attached.
+*/
+void QSharedMemoryChannel::setKey(const QString &key)
+{
+    Q_D(QSharedMemoryChannel);
+    if (key == d->key)
+        return;
+    detach();
+    d->key = key;
+    d->memory.setKey(key);
+}
+
+/*!
+    Returns the key of the channel.
+*/
+QString QSharedMemoryChannel::key() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return d->key;
+}
+
+/*!
+    Creates the channel with a ring of at least \a capacity bytes and
+    attaches to it in the given \a role. Returns \c true on success.
+
+    The capacity is rounded up to a power of two. Messages can be up to
+    half its size.
+
+    \sa attach(), maximumMessageSize()
+*/
+bool QSharedMemoryChannel::create(Role role, int capacity)
+{
+    Q_D(QSharedMemoryChannel);
+    const char *function = "QSharedMemoryChannel::create";
+    if (isAttached()) {
+        d->setError(AlreadyExists, tr("%1: already attached").arg(QLatin1String(function)));
+        return false;
+    }
+    if (capacity <= 0 || capacity > MaximumCapacity) {
+        d->setError(InvalidSize, tr("%1: invalid capacity").arg(QLatin1String(function)));
+        return false;
+    }
+
+    quint32 ringSize = MinimumCapacity;
+    while (ringSize < quint32(capacity))
+        ringSize *= 2;
+
+    if (!d->memory.create(int(sizeof(ChannelHeader) + ringSize))) {
+        d->setMemoryError();
+        return false;
+    }
+
+    // the FIFOs of a channel that wasn't cleaned up can be reused;
+    // setUp() makes sure that they are ours
+    const QByteArray producerFifo = QFile::encodeName(d->fifoPath(Producer));
+    const QByteArray consumerFifo = QFile::encodeName(d->fifoPath(Consumer));
+    if ((::mkfifo(producerFifo.constData(), 0600) == -1 && errno != EEXIST)
+        || (::mkfifo(consumerFifo.constData(), 0600) == -1 && errno != EEXIST)) {
+        const int savedErrno = errno;
+        d->setError(savedErrno == EACCES ? PermissionDenied : UnknownError,
+                    tr("%1: %2").arg(QLatin1String(function), qt_error_string(savedErrno)));
+        d->memory.detach();
+        return false;
+    }
+    d->created = true;
+
+    d->memory.lock();
+    ChannelHeader *header = static_cast<ChannelHeader *>(d->memory.data());
+    memset(d->memory.data(), 0, sizeof(ChannelHeader));
+    header->version = ChannelVersion;
+    header->capacity = ringSize;
+    header->magic = ChannelMagic;
+    d->memory.unlock();
+
+    return d->setUp(role, function);
+}
+
+/*!
+    Attaches to the channel created with the same key in another process
+    (or by another object), in the given \a role. Returns \c true on
+    success.
+
+    There must be only one producer and one consumer at a time.
+
+    \sa create()
+*/
+bool QSharedMemoryChannel::attach(Role role)
+{
+    Q_D(QSharedMemoryChannel);
+    const char *function = "QSharedMemoryChannel::attach";
+    if (isAttached()) {
+        d->setError(AlreadyExists, tr("%1: already attached").arg(QLatin1String(function)));
+        return false;
+    }
+    if (!d->memory.attach()) {
+        d->setMemoryError();
+        return false;
+    }
+
+    d->memory.lock();
+    const ChannelHeader *header = static_cast<const ChannelHeader *>(d->memory.constData());
+    const quint32 ringSize = header->capacity;
+    const bool valid = d->memory.size() >= int(sizeof(ChannelHeader))
+            && header->magic == ChannelMagic && header->version == ChannelVersion
+            && ringSize >= quint32(MinimumCapacity) && ringSize <= quint32(MaximumCapacity)
+            && !(ringSize & (ringSize - 1))
+            && ringSize <= quint32(d->memory.size()) - sizeof(ChannelHeader);
+    d->memory.unlock();
+
+    if (!valid) {
+        // not initialized yet, or not a channel
+        d->setError(NotFound, tr("%1: doesn't exist").arg(QLatin1String(function)));
+        d->memory.detach();
+        return false;
+    }
+    return d->setUp(role, function);
+}
+
+/*!
+    Returns \c true if this object is attached to a channel.
+*/
+bool QSharedMemoryChannel::isAttached() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return d->header != 0;
+}
+
+/*!
+    Detaches from the channel. Messages that are reserved but not
+    committed are discarded. The channel is destroyed when the last side
+    detaches.
+*/
+void QSharedMemoryChannel::detach()
+{
+    Q_D(QSharedMemoryChannel);
+    d->tearDown();
+}
+
+/*!
+    Returns the role this object was attached with.
+*/
+QSharedMemoryChannel::Role QSharedMemoryChannel::role() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return d->role;
+}
+
+/*!
+    Returns the size of the ring in bytes, or 0 if not attached.
+*/
+int QSharedMemoryChannel::capacity() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return int(d->capacity);
+}
+
+/*!
+    Returns the size of the largest message the channel can pass, or 0 if
+    not attached.
+*/
+int QSharedMemoryChannel::maximumMessageSize() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return d->capacity ? int(d->capacity / 2 - RecordHeaderSize) : 0;
+}
+
+/*!
+    Reserves space for a message of \a size bytes and returns a pointer to
+    it, for the producer to write the message into. Returns \c nullptr if
+    there isn't enough free space; spaceAvailable() is emitted when the
+    consumer frees some.
+
+    The message is not visible to the consumer until commitMessage() is
+    called. Reserving again before that replaces the reservation.
+
+    \sa commitMessage(), writeMessage(), waitForSpace()
+*/
+char *QSharedMemoryChannel::reserveMessage(int size)
+{
+    Q_D(QSharedMemoryChannel);
+    if (!d->header || d->role != Producer) {
+        qWarning("QSharedMemoryChannel::reserveMessage: not attached as a producer");
+        return 0;
+    }
+    if (size < 0 || size > maximumMessageSize()) {
+        d->setError(MessageTooLarge, tr("%1: message too large")
+                    .arg(QLatin1String("QSharedMemoryChannel::reserveMessage")));
+        return 0;
+    }
+
+    quint32 skip;
+    const quint32 needed = d->spaceNeeded(size, &skip);
+    if (!d->hasSpace(needed, false)) {
+        d->header->writerWaiting.fetchAndStoreOrdered(1);
+        if (!d->hasSpace(needed, true))
+            return 0;
+    }
+
+    d->reservedSize = size;
+    d->reservedSkip = skip;
+    const quint32 offset = (d->header->writePosition.load() + skip) & (d->capacity - 1);
+    return d->ring + offset + RecordHeaderSize;
+}
+
+/*!
+    Makes the message reserved with reserveMessage() available to the
+    consumer. Returns \c false if no message was reserved.
+*/
+bool QSharedMemoryChannel::commitMessage()
+{
+    Q_D(QSharedMemoryChannel);
+    if (d->reservedSize < 0)
+        return false;
+
+    const quint32 write = d->header->writePosition.load();
+    const quint32 mask = d->capacity - 1;
+    if (d->reservedSkip)
+        *reinterpret_cast<quint32 *>(d->ring + (write & mask)) = WrapMarker;
+    quint32 *record = reinterpret_cast<quint32 *>(d->ring + ((write + d->reservedSkip) & mask));
+    record[0] = quint32(d->reservedSize);
+    record[1] = 0;
+
+    d->header->writePosition.fetchAndStoreOrdered(write + d->reservedSkip + recordSize(d->reservedSize));
+    d->reservedSize = -1;
+
+    if (d->header->readerWaiting.testAndSetOrdered(1, 0))
+        d->wakePeer();
+    return true;
+}
+
+/*!
+    Copies the \a size bytes at \a data into a new message and makes it
+    available to the consumer. Returns \c false if there isn't enough free
+    space or the message is too large.
+
+    \sa reserveMessage()
+*/
+bool QSharedMemoryChannel::writeMessage(const char *data, int size)
+{
+    char *message = reserveMessage(size);
+    if (!message)
+        return false;
+    memcpy(message, data, size);
+    return commitMessage();
+}
+
+/*!
+    \fn bool QSharedMemoryChannel::writeMessage(const QByteArray &message)
+    \overload
+*/
+
+/*!
+    Blocks until a message of \a size bytes can be reserved, or until
+    \a msecs milliseconds have passed. If \a msecs is -1, this function
+    doesn't time out. Returns \c true if the message can be reserved.
+*/
+bool QSharedMemoryChannel::waitForSpace(int size, int msecs)
+{
+    Q_D(QSharedMemoryChannel);
+    if (!d->header || d->role != Producer || size < 0 || size > maximumMessageSize())
+        return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    forever {
+        quint32 skip;
+        const quint32 needed = d->spaceNeeded(size, &skip);
+        if (d->hasSpace(needed, false))
+            return true;
+        d->header->writerWaiting.fetchAndStoreOrdered(1);
+        if (d->hasSpace(needed, true))
+            return true;
+        if (!d->waitForWakeUp(timer, msecs))
+            return d->hasSpace(needed, true);
+    }
+}
+
+/*!
+    Returns \c true if the consumer has a message to read.
+*/
+bool QSharedMemoryChannel::hasPendingMessage() const
+{
+    Q_D(const QSharedMemoryChannel);
+    if (!d->header || d->role != Consumer)
+        return false;
+    return d->peekedSize >= 0 || d->hasMessage(false);
+}
+
+/*!
+    Returns a pointer to the oldest message in the channel and sets \a size
+    to its size, without removing it. Returns \c nullptr if there are no
+    messages.
+
+    The message stays valid, in shared memory, until releaseMessage() is
+    called. Peeking again before that returns the same message.
+
+    \sa releaseMessage(), readMessage()
+*/
+const char *QSharedMemoryChannel::peekMessage(int *size)
+{
+    Q_D(QSharedMemoryChannel);
+    if (!d->header || d->role != Consumer) {
+        qWarning("QSharedMemoryChannel::peekMessage: not attached as a consumer");
+        return 0;
+    }
+
+    const quint32 read = d->header->readPosition.load();
+    const quint32 mask = d->capacity - 1;
+    if (d->peekedSize < 0) {
+        if (!d->hasMessage(false)) {
+            d->header->readerWaiting.fetchAndStoreOrdered(1);
+            if (!d->hasMessage(true))
+                return 0;
+        }
+        quint32 skip = 0;
+        if (*reinterpret_cast<const quint32 *>(d->ring + (read & mask)) == WrapMarker)
+            skip = d->capacity - (read & mask);
+        const quint32 offset = (read + skip) & mask;
+        const quint32 size = *reinterpret_cast<const quint32 *>(d->ring + offset);
+
+        // the producer is another process; never trust it to stay within
+        // the ring
+        const quint32 available = d->header->writePosition.loadAcquire() - read;
+        if (size > quint32(maximumMessageSize()) || offset + recordSize(size) > d->capacity
+                || skip + recordSize(size) > available) {
+            d->setError(UnknownError, tr("%1: invalid message").arg(QLatin1String("QSharedMemoryChannel::peekMessage")));
+            return 0;
+        }
+        d->peekedSkip = skip;
+        d->peekedSize = int(size);
+    }
+
+    if (size)
+        *size = d->peekedSize;
+    return d->ring + ((read + d->peekedSkip) & mask) + RecordHeaderSize;
+}
+
+/*!
+    Removes the message returned by peekMessage() from the channel,
+    handing its space back to the producer.
+*/
+void QSharedMemoryChannel::releaseMessage()
+{
+    Q_D(QSharedMemoryChannel);
+    if (d->peekedSize < 0)
+        return;
+
+    const quint32 read = d->header->readPosition.load();
+    d->header->readPosition.fetchAndStoreOrdered(read + d->peekedSkip + recordSize(d->peekedSize));
+    d->peekedSize = -1;
+
+    if (d->header->writerWaiting.testAndSetOrdered(1, 0))
+        d->wakePeer();
+}
+
+/*!
+    Removes the oldest message from the channel and returns a copy of it.
+    Returns an empty byte array if there are no messages.
+*/
+QByteArray QSharedMemoryChannel::readMessage()
+{
+    int size;
+    const char *message = peekMessage(&size);
+    if (!message)
+        return QByteArray();
+    const QByteArray result(message, size);
+    releaseMessage();
+    return result;
+}
+
+/*!
+    Blocks until the consumer has a message to read, or until \a msecs
+    milliseconds have passed. If \a msecs is -1, this function doesn't
+    time out. Returns \c true if a message is available.
+*/
+bool QSharedMemoryChannel::waitForMessage(int msecs)
+{
+    Q_D(QSharedMemoryChannel);
+    if (!d->header || d->role != Consumer)
+        return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    forever {
+        if (hasPendingMessage())
+            return true;
+        d->header->readerWaiting.fetchAndStoreOrdered(1);
+        if (d->hasMessage(true))
+            return true;
+        if (!d->waitForWakeUp(timer, msecs))
+            return d->hasMessage(true);
+    }
+}
+
+/*!
+    Returns the type of the last error that occurred.
+*/
+QSharedMemoryChannel::ChannelError QSharedMemoryChannel::error() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return d->error;
+}
+
+/*!
+    Returns a description of the last error that occurred.
+*/
+QString QSharedMemoryChannel::errorString() const
+{
+    Q_D(const QSharedMemoryChannel);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qsharedmemorychannel.cpp"
+
+#endif // Q_OS_UNIX && !Q_OS_ANDROID && !QT_NO_SHAREDMEMORY && !QT_NO_SYSTEMSEMAPHORE
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSHAREDMEMORYCHANNEL_H
+#define QSHAREDMEMORYCHANNEL_H
+
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_ANDROID) \
+    && !defined(QT_NO_SHAREDMEMORY) && !defined(QT_NO_SYSTEMSEMAPHORE)
+
+class QSharedMemoryChannelPrivate;
+
+class Q_CORE_EXPORT QSharedMemoryChannel : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QSharedMemoryChannel)
+
+public:
+    enum Role
+    {
+        Producer,
+        Consumer
+    };
+
+    enum ChannelError
+    {
+        NoError,
+        PermissionDenied,
+        InvalidSize,
+        KeyError,
+        AlreadyExists,
+        NotFound,
+        OutOfResources,
+        MessageTooLarge,
+        UnknownError
+    };
+
+    explicit QSharedMemoryChannel(QObject *parent = Q_NULLPTR);
+    explicit QSharedMemoryChannel(const QString &key, QObject *parent = Q_NULLPTR);
+    ~QSharedMemoryChannel();
+
+    void setKey(const QString &key);
+    QString key() const;
+
+    bool create(Role role, int capacity);
+    bool attach(Role role);
+    bool isAttached() const;
+    void detach();
+
+    Role role() const;
+    int capacity() const;
+    int maximumMessageSize() const;
+
+    // producer
+    char *reserveMessage(int size);
+    bool commitMessage();
+    bool writeMessage(const char *data, int size);
+    inline bool writeMessage(const QByteArray &message)
+    { return writeMessage(message.constData(), message.size()); }
+    bool waitForSpace(int size, int msecs = 30000);
+
+    // consumer
+    bool hasPendingMessage() const;
+    const char *peekMessage(int *size);
+    void releaseMessage();
+    QByteArray readMessage();
+    bool waitForMessage(int msecs = 30000);
+
+    ChannelError error() const;
+    QString errorString() const;
+
+Q_SIGNALS:
+    void messageAvailable();
+    void spaceAvailable();
+
+private:
+    Q_DISABLE_COPY(QSharedMemoryChannel)
+    Q_PRIVATE_SLOT(d_func(), void _q_wakeUp())
+};
+
+#endif // Q_OS_UNIX && !Q_OS_ANDROID && !QT_NO_SHAREDMEMORY && !QT_NO_SYSTEMSEMAPHORE
+
+QT_END_NAMESPACE
+
+#endif // QSHAREDMEMORYCHANNEL_H
@@ -1003,6 +1003,27 @@ const QVariant::Handler qt_dummy_variant_handler = {
 #endif
 };
 
+// Custom types that don't fit into QVariant::Private::Data are stored in a
+// single heap block: the PrivateShared header followed by the payload, padded
+// so that the payload is suitably aligned for any fundamental type.
+union CustomSharedAlignment
+{
+    QVariant::PrivateShared shared;
+    double d;
+    qint64 ll;
+    void *ptr;
+    long double ld;
+};
+
+static const size_t CustomPayloadOffset = sizeof(CustomSharedAlignment);
+
+static inline QVariant::PrivateShared *customAllocateShared(uint size)
+{
+    void *block = ::malloc(CustomPayloadOffset + size);
+    Q_CHECK_PTR(block);
+    return new (block) QVariant::PrivateShared(static_cast<char *>(block) + CustomPayloadOffset);
+}
+
 static void customConstruct(QVariant::Private *d, const void *copy)
 {
     const QMetaType type(d->type);
@@ -1019,9 +1040,10 @@ static void customConstruct(QVariant::Private *d, const void *copy)
         type.construct(&d->data.ptr, copy);
         d->is_shared = false;
     } else {
-        void *ptr = type.create(copy);
+        QVariant::PrivateShared *shared = customAllocateShared(size);
+        type.construct(shared->ptr, copy);
         d->is_shared = true;
-        d->data.shared = new QVariant::PrivateShared(ptr);
+        d->data.shared = shared;
     }
 }
 
@@ -1030,8 +1052,10 @@ static void customClear(QVariant::Private *d)
     if (!d->is_shared) {
         QMetaType::destruct(d->type, &d->data.ptr);
     } else {
-        QMetaType::destroy(d->type, d->data.shared->ptr);
-        delete d->data.shared;
+        QMetaType::destruct(d->type, d->data.shared->ptr);
+        // allocated in one block by customAllocateShared()
+        d->data.shared->~PrivateShared();
+        ::free(d->data.shared);
     }
 }
 
@@ -3694,6 +3718,19 @@ QDebug operator<<(QDebug dbg, const QVariant::Type p)
     \sa setValue(), value()
 */
 
+/*! \fn static QVariant QVariant::fromValue(T &&value)
+    \since 5.6
+
+    \overload
+
+    Returns a QVariant holding \a value, which is moved into the
+    variant's storage instead of being copied. This avoids a deep copy
+    for temporaries of types that are expensive to copy but cheap to
+    move.
+
+    \sa setValue(), value()
+*/
+
 /*!
     \fn QVariant qVariantFromValue(const T &value)
     \relates QVariant
@@ -83,6 +83,21 @@ class QVariantComparisonHelper;
 template <typename T>
 inline QVariant qVariantFromValue(const T &);
 
+#ifdef Q_COMPILER_RVALUE_REFS
+namespace QtPrivate {
+    // selects the rvalue overloads of fromValue() for non-const temporaries only
+    template <typename T>
+    struct VariantCanMoveFrom
+    {
+        enum { Value = !is_reference<T>::value && !is_const<T>::value && !is_same<T, QVariant>::value };
+    };
+}
+
+template <typename T>
+inline typename QtPrivate::QEnableIf<QtPrivate::VariantCanMoveFrom<T>::Value, QVariant>::Type
+qVariantFromValue(T &&);
+#endif
+
 template<typename T>
 inline T qvariant_cast(const QVariant &);
 
@@ -349,6 +364,13 @@ class Q_CORE_EXPORT QVariant
     static inline QVariant fromValue(const T &value)
     { return qVariantFromValue(value); }
 
+#ifdef Q_COMPILER_RVALUE_REFS
+    template<typename T>
+    static inline QVariant fromValue(T &&value,
+                                     typename QtPrivate::QEnableIf<QtPrivate::VariantCanMoveFrom<T>::Value, int>::Type = 0)
+    { return qVariantFromValue(std::move(value)); }
+#endif
+
     template<typename T>
     bool canConvert() const
     { return canConvert(qMetaTypeId<T>()); }
@@ -499,6 +521,26 @@ inline QVariant qVariantFromValue(const T &t)
 template <>
 inline QVariant qVariantFromValue(const QVariant &t) { return t; }
 
+#ifdef Q_COMPILER_RVALUE_REFS
+template <typename T>
+inline typename QtPrivate::QEnableIf<QtPrivate::VariantCanMoveFrom<T>::Value, QVariant>::Type
+qVariantFromValue(T &&t)
+{
+    if (QTypeInfo<T>::isPointer)
+        return QVariant(qMetaTypeId<T>(), &t, QTypeInfo<T>::isPointer);
+
+    // let QVariant allocate the storage, then move-construct t into it
+    QVariant v(qMetaTypeId<T>(), Q_NULLPTR);
+    if (v.isValid()) {
+        T *storage = static_cast<T *>(v.data());
+        if (QTypeInfo<T>::isComplex)
+            storage->~T();
+        new (storage) T(std::move(t));
+    }
+    return v;
+}
+#endif
+
 template <typename T>
 inline void qVariantSetValue(QVariant &v, const T &t)
 {
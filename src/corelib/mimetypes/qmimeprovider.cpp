@@ -45,6 +45,7 @@
 #include <QByteArrayMatcher>
 #include <QDebug>
 #include <QDateTime>
+#include <QResource>
 #include <QtEndian>
 
 static void initResources()
@@ -87,10 +88,18 @@ bool QMimeProviderBase::shouldCheck()
 }
 
 QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db)
-    : QMimeProviderBase(db), m_mimetypeListLoaded(false)
+    : QMimeProviderBase(db), m_mimetypeListLoaded(false), m_builtin(false)
 {
 }
 
+// mime/mime.cache and mime/types are the output of shared-mime-info's
+// update-mime-database for mime/packages/freedesktop.org.xml; regenerate them
+// whenever that file is updated. The cache and types are stored uncompressed,
+// so that they can be used in place from the read-only data of the library.
+static const char builtinXmlFileName[] = ":/qt-project.org/qmime/freedesktop.org.xml";
+static const char builtinCacheFileName[] = ":/qt-project.org/qmime/mime.cache";
+static const char builtinTypesFileName[] = ":/qt-project.org/qmime/types";
+
 #if defined(Q_OS_UNIX) && !defined(Q_OS_INTEGRITY)
 #define QT_USE_MMAP
 #endif
@@ -103,11 +112,11 @@ struct QMimeBinaryProvider::CacheFile
     bool isValid() const { return m_valid; }
     inline quint16 getUint16(int offset) const
     {
-        return qFromBigEndian(*reinterpret_cast<quint16 *>(data + offset));
+        return qFromBigEndian<quint16>(data + offset);
     }
     inline quint32 getUint32(int offset) const
     {
-        return qFromBigEndian(*reinterpret_cast<quint32 *>(data + offset));
+        return qFromBigEndian<quint32>(data + offset);
     }
     inline const char *getCharStar(int offset) const
     {
@@ -186,26 +195,46 @@ enum {
 
 bool QMimeBinaryProvider::isValid()
 {
-#if defined(QT_USE_MMAP)
     if (!qEnvironmentVariableIsEmpty("QT_NO_MIME_CACHE"))
         return false;
 
     Q_ASSERT(m_cacheFiles.isEmpty()); // this method is only ever called once
+#if defined(QT_USE_MMAP)
     checkCache();
 
     if (m_cacheFiles.count() > 1)
         return true;
-    if (m_cacheFiles.isEmpty())
-        return false;
-
-    // We found exactly one file; is it the user-modified mimes, or a system file?
-    const QString foundFile = m_cacheFiles.first()->file.fileName();
-    const QString localCacheFile = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/mime/mime.cache");
+    if (!m_cacheFiles.isEmpty()) {
+        // We found exactly one file; is it the user-modified mimes, or a system file?
+        const QString foundFile = m_cacheFiles.first()->file.fileName();
+        const QString localCacheFile = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/mime/mime.cache");
 
-    return foundFile != localCacheFile;
-#else
-    return false;
+        return foundFile != localCacheFile;
+    }
 #endif
+    return loadBuiltinCache();
+}
+
+// No mime.cache is installed: query the one built into QtCore instead of
+// parsing the whole of freedesktop.org.xml with the XML provider.
+bool QMimeBinaryProvider::loadBuiltinCache()
+{
+    // Package files installed without a cache are only understood by the XML provider
+    if (!QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime/packages"), QStandardPaths::LocateDirectory).isEmpty())
+        return false;
+
+    initResources();
+    const QString cacheFileName = QLatin1String(builtinCacheFileName);
+    if (QResource(cacheFileName).isCompressed()) // QFile::map would return the compressed data
+        return false;
+    CacheFile *cacheFile = new CacheFile(cacheFileName);
+    if (!cacheFile->isValid()) {
+        delete cacheFile;
+        return false;
+    }
+    m_cacheFiles.append(cacheFile);
+    m_builtin = true;
+    return true;
 }
 
 bool QMimeBinaryProvider::CacheFileList::checkCacheChanged()
@@ -235,6 +264,31 @@ void QMimeBinaryProvider::checkCache()
     if (!shouldCheck())
         return;
 
+    if (m_builtin) {
+#if defined(QT_USE_MMAP)
+        // switch to an installed database as soon as there is one
+        const QStringList cacheFileNames = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime/mime.cache"));
+        CacheFileList installed;
+        foreach (const QString &cacheFileName, cacheFileNames) {
+            CacheFile *cacheFile = new CacheFile(cacheFileName);
+            if (cacheFile->isValid())
+                installed.append(cacheFile);
+            else
+                delete cacheFile;
+        }
+        if (installed.isEmpty())
+            return;
+        qDeleteAll(m_cacheFiles);
+        m_cacheFiles = installed;
+        m_cacheFileNames = cacheFileNames;
+        m_builtin = false;
+        m_builtinXml.clear();
+        m_builtinXmlIndex.clear();
+        m_mimetypeListLoaded = false;
+#endif
+        return;
+    }
+
     // First iterate over existing known cache files and check for uptodate
     if (m_cacheFiles.checkCacheChanged())
         m_mimetypeListLoaded = false;
@@ -523,7 +577,9 @@ void QMimeBinaryProvider::loadMimeTypeList()
         m_mimetypeNames.clear();
         // Unfortunately mime.cache doesn't have a full list of all mimetypes.
         // So we have to parse the plain-text files called "types".
-        const QStringList typesFilenames = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime/types"));
+        const QStringList typesFilenames = m_builtin
+                ? QStringList(QLatin1String(builtinTypesFileName))
+                : QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime/types"));
         foreach (const QString &typeFilename, typesFilenames) {
             QFile file(typeFilename);
             if (file.open(QIODevice::ReadOnly)) {
@@ -549,6 +605,85 @@ QList<QMimeType> QMimeBinaryProvider::allMimeTypes()
     return result;
 }
 
+#ifndef QT_NO_XMLSTREAMREADER
+// Reads the comments and glob patterns of a single <mime-type> element, as found
+// in the per-mimetype files written by update-mime-database
+static void parseMimeTypeElement(QXmlStreamReader &xml, QMimeTypePrivate &data, QString *mainPattern)
+{
+    if (!xml.readNextStartElement() || xml.name() != QLatin1String("mime-type"))
+        return;
+    const QString name = xml.attributes().value(QLatin1String("type")).toString();
+    if (name.isEmpty())
+        return;
+    if (name != data.name) {
+        qWarning() << "Got name" << name << "expected" << data.name;
+    }
+
+    while (xml.readNextStartElement()) {
+        const QStringRef tag = xml.name();
+        if (tag == QLatin1String("comment")) {
+            QString lang = xml.attributes().value(QLatin1String("xml:lang")).toString();
+            const QString text = xml.readElementText();
+            if (lang.isEmpty()) {
+                lang = QLatin1String("en_US");
+            }
+            data.localeComments.insert(lang, text);
+            continue; // we called readElementText, so we're at the EndElement already.
+        } else if (tag == QLatin1String("icon")) { // as written out by shared-mime-info >= 0.40
+            data.iconName = xml.attributes().value(QLatin1String("name")).toString();
+        } else if (tag == QLatin1String("glob-deleteall")) { // as written out by shared-mime-info >= 0.70
+            data.globPatterns.clear();
+        } else if (tag == QLatin1String("glob")) { // as written out by shared-mime-info >= 0.70
+            const QString pattern = xml.attributes().value(QLatin1String("pattern")).toString();
+            if (mainPattern->isEmpty() && pattern.startsWith(QLatin1Char('*'))) {
+                *mainPattern = pattern;
+            }
+            if (!data.globPatterns.contains(pattern))
+                data.globPatterns.append(pattern);
+        }
+        xml.skipCurrentElement();
+    }
+    Q_ASSERT(xml.name() == QLatin1String("mime-type"));
+}
+
+// The built-in database has no per-mimetype files; parse the matching
+// <mime-type> element of freedesktop.org.xml instead of the whole file.
+void QMimeBinaryProvider::loadBuiltinMimeTypePrivate(QMimeTypePrivate &data, QString *mainPattern)
+{
+    static const char elementStart[] = "<mime-type type=\"";
+    static const char elementEnd[] = "</mime-type>";
+
+    if (m_builtinXml.isNull()) {
+        const QResource resource((QLatin1String(builtinXmlFileName)));
+        if (!resource.isValid())
+            return;
+        if (resource.isCompressed())
+            m_builtinXml = qUncompress(resource.data(), int(resource.size()));
+        else
+            m_builtinXml = QByteArray::fromRawData(reinterpret_cast<const char *>(resource.data()), int(resource.size()));
+
+        const QByteArrayMatcher matcher(elementStart, int(sizeof(elementStart)) - 1);
+        for (int pos = matcher.indexIn(m_builtinXml); pos != -1; pos = matcher.indexIn(m_builtinXml, pos + 1)) {
+            const int nameStart = pos + int(sizeof(elementStart)) - 1;
+            const int nameEnd = m_builtinXml.indexOf('"', nameStart);
+            if (nameEnd == -1)
+                break;
+            m_builtinXmlIndex.insert(m_builtinXml.mid(nameStart, nameEnd - nameStart), pos);
+        }
+    }
+
+    const int begin = m_builtinXmlIndex.value(data.name.toLatin1(), -1);
+    if (begin == -1)
+        return;
+    const int end = m_builtinXml.indexOf(elementEnd, begin);
+    if (end == -1)
+        return;
+    QXmlStreamReader xml(QByteArray::fromRawData(m_builtinXml.constData() + begin,
+                                                 end + int(sizeof(elementEnd)) - 1 - begin));
+    parseMimeTypeElement(xml, data, mainPattern);
+}
+#endif // QT_NO_XMLSTREAMREADER
+
 void QMimeBinaryProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
 {
 #ifdef QT_NO_XMLSTREAMREADER
@@ -560,65 +695,31 @@ void QMimeBinaryProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
     data.loaded = true;
     // load comment and globPatterns
 
-    const QString file = data.name + QLatin1String(".xml");
-    const QStringList mimeFiles = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QString::fromLatin1("mime/") + file);
-    if (mimeFiles.isEmpty()) {
-        // TODO: ask Thiago about this
-        qWarning() << "No file found for" << file << ", even though the file appeared in a directory listing.";
-        qWarning() << "Either it was just removed, or the directory doesn't have executable permission...";
-        qWarning() << QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime"), QStandardPaths::LocateDirectory);
-        return;
-    }
-
-    QString comment;
     QString mainPattern;
-    const QString preferredLanguage = QLocale::system().name();
-
-    QListIterator<QString> mimeFilesIter(mimeFiles);
-    mimeFilesIter.toBack();
-    while (mimeFilesIter.hasPrevious()) { // global first, then local.
-        const QString fullPath = mimeFilesIter.previous();
-        QFile qfile(fullPath);
-        if (!qfile.open(QFile::ReadOnly))
-            continue;
 
-        QXmlStreamReader xml(&qfile);
-        if (xml.readNextStartElement()) {
-            if (xml.name() != QLatin1String("mime-type")) {
-                continue;
-            }
-            const QString name = xml.attributes().value(QLatin1String("type")).toString();
-            if (name.isEmpty())
+    if (m_builtin) {
+        loadBuiltinMimeTypePrivate(data, &mainPattern);
+    } else {
+        const QString file = data.name + QLatin1String(".xml");
+        const QStringList mimeFiles = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QString::fromLatin1("mime/") + file);
+        if (mimeFiles.isEmpty()) {
+            // TODO: ask Thiago about this
+            qWarning() << "No file found for" << file << ", even though the file appeared in a directory listing.";
+            qWarning() << "Either it was just removed, or the directory doesn't have executable permission...";
+            qWarning() << QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime"), QStandardPaths::LocateDirectory);
+            return;
+        }
+
+        QListIterator<QString> mimeFilesIter(mimeFiles);
+        mimeFilesIter.toBack();
+        while (mimeFilesIter.hasPrevious()) { // global first, then local.
+            const QString fullPath = mimeFilesIter.previous();
+            QFile qfile(fullPath);
+            if (!qfile.open(QFile::ReadOnly))
                 continue;
-            if (name != data.name) {
-                qWarning() << "Got name" << name << "in file" << file << "expected" << data.name;
-            }
 
-            while (xml.readNextStartElement()) {
-                const QStringRef tag = xml.name();
-                if (tag == QLatin1String("comment")) {
-                    QString lang = xml.attributes().value(QLatin1String("xml:lang")).toString();
-                    const QString text = xml.readElementText();
-                    if (lang.isEmpty()) {
-                        lang = QLatin1String("en_US");
-                    }
-                    data.localeComments.insert(lang, text);
-                    continue; // we called readElementText, so we're at the EndElement already.
-                } else if (tag == QLatin1String("icon")) { // as written out by shared-mime-info >= 0.40
-                    data.iconName = xml.attributes().value(QLatin1String("name")).toString();
-                } else if (tag == QLatin1String("glob-deleteall")) { // as written out by shared-mime-info >= 0.70
-                    data.globPatterns.clear();
-                } else if (tag == QLatin1String("glob")) { // as written out by shared-mime-info >= 0.70
-                    const QString pattern = xml.attributes().value(QLatin1String("pattern")).toString();
-                    if (mainPattern.isEmpty() && pattern.startsWith(QLatin1Char('*'))) {
-                        mainPattern = pattern;
-                    }
-                    if (!data.globPatterns.contains(pattern))
-                        data.globPatterns.append(pattern);
-                }
-                xml.skipCurrentElement();
-            }
-            Q_ASSERT(xml.name() == QLatin1String("mime-type"));
+            QXmlStreamReader xml(&qfile);
+            parseMimeTypeElement(xml, data, &mainPattern);
         }
     }
 
@@ -50,6 +50,7 @@
 #ifndef QT_NO_MIMETYPE
 
 #include <QtCore/qdatetime.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
@@ -81,7 +82,9 @@ protected:
 };
 
 /*
-   Parses the files 'mime.cache' and 'types' on demand
+   Parses the files 'mime.cache' and 'types' on demand.
+   Falls back to the copies built into QtCore when no shared-mime-info
+   database is installed.
  */
 class QMimeBinaryProvider : public QMimeProviderBase
 {
@@ -110,6 +113,8 @@ private:
     QString iconForMime(CacheFile *cacheFile, int posListOffset, const QByteArray &inputMime);
     void loadMimeTypeList();
     void checkCache();
+    bool loadBuiltinCache();
+    void loadBuiltinMimeTypePrivate(QMimeTypePrivate &data, QString *mainPattern);
 
     class CacheFileList : public QList<CacheFile *>
     {
@@ -121,6 +126,9 @@ private:
     QStringList m_cacheFileNames;
     QSet<QString> m_mimetypeNames;
     bool m_mimetypeListLoaded;
+    bool m_builtin;
+    QByteArray m_builtinXml;
+    QHash<QByteArray, int> m_builtinXmlIndex; // mimetype name -> offset of its <mime-type> element
 };
 
 /*
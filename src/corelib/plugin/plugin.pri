@@ -10,7 +10,8 @@ HEADERS += \
 	plugin/qfactoryloader_p.h \
 	plugin/qsystemlibrary_p.h \
         plugin/qelfparser_p.h \
-        plugin/qmachparser_p.h
+        plugin/qmachparser_p.h \
+        plugin/qpluginmetadatacache_p.h
 
 SOURCES += \
 	plugin/qpluginloader.cpp \
@@ -18,7 +19,8 @@ SOURCES += \
 	plugin/quuid.cpp \
 	plugin/qlibrary.cpp \
         plugin/qelfparser_p.cpp \
-        plugin/qmachparser.cpp
+        plugin/qmachparser.cpp \
+        plugin/qpluginmetadatacache.cpp
 
 win32 {
 	SOURCES += \
@@ -43,6 +43,7 @@
 #include "qpluginloader.h"
 #include "private/qobject_p.h"
 #include "private/qcoreapplication_p.h"
+#include "private/qpluginmetadatacache_p.h"
 #include "qjsondocument.h"
 #include "qjsonvalue.h"
 #include "qjsonobject.h"
@@ -131,6 +132,7 @@ void QFactoryLoader::update()
 
         QStringList plugins = QDir(path).entryList(QDir::Files);
         QLibraryPrivate *library = 0;
+        QPluginMetaDataCache cache(path);
 
 #ifdef Q_OS_MAC
         // Loading both the debug and release version of the cocoa plugins causes the objective-c runtime
@@ -160,7 +162,7 @@ void QFactoryLoader::update()
                 qDebug() << "QFactoryLoader::QFactoryLoader() looking at" << fileName;
             }
             library = QLibraryPrivate::findOrCreate(QFileInfo(fileName).canonicalFilePath());
-            if (!library->isPlugin()) {
+            if (!library->isPlugin(&cache)) {
                 if (qt_debug_component()) {
                     qDebug() << library->errorString;
                     qDebug() << "         not a plugin";
@@ -213,6 +215,7 @@ void QFactoryLoader::update()
             else
                 library->release();
         }
+        cache.save();
     }
 #else
     Q_D(QFactoryLoader);
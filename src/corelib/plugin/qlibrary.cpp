@@ -57,6 +57,7 @@
 #include <qjsonvalue.h>
 #include "qelfparser_p.h"
 #include "qmachparser_p.h"
+#include "qpluginmetadatacache_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -684,15 +685,15 @@ static bool qt_get_metadata(QtPluginQueryVerificationDataFunction pfn, QLibraryP
     return true;
 }
 
-bool QLibraryPrivate::isPlugin()
+bool QLibraryPrivate::isPlugin(QPluginMetaDataCache *cache)
 {
     if (pluginState == MightBeAPlugin)
-        updatePluginState();
+        updatePluginState(cache);
 
     return pluginState == IsAPlugin;
 }
 
-void QLibraryPrivate::updatePluginState()
+void QLibraryPrivate::updatePluginState(QPluginMetaDataCache *cache)
 {
     errorString.clear();
     if (pluginState != MightBeAPlugin)
@@ -715,8 +716,15 @@ void QLibraryPrivate::updatePluginState()
 #endif
 
     if (!pHnd) {
-        // scan for the plugin metadata without loading
-        success = findPatternUnloaded(fileName, this);
+        // scan for the plugin metadata without loading, unless it was
+        // cached the last time the file was seen
+        if (cache && cache->find(fileName, &metaData)) {
+            success = !metaData.isEmpty();
+        } else {
+            success = findPatternUnloaded(fileName, this);
+            if (cache)
+                cache->insert(fileName, success ? metaData : QJsonObject());
+        }
     } else {
         // library is already loaded (probably via QLibrary)
         // simply get the target function and call it.
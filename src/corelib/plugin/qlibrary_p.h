@@ -64,6 +64,7 @@ QT_BEGIN_NAMESPACE
 bool qt_debug_component();
 
 class QLibraryStore;
+class QPluginMetaDataCache;
 class QLibraryPrivate
 {
 public:
@@ -101,8 +102,8 @@ public:
 
     QString errorString;
 
-    void updatePluginState();
-    bool isPlugin();
+    void updatePluginState(QPluginMetaDataCache *cache = 0);
+    bool isPlugin(QPluginMetaDataCache *cache = 0);
 
     static inline QJsonDocument fromRawMetaData(const char *raw) {
         raw += strlen("QTMETADATA  ");
@@ -0,0 +1,255 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+#include "qpluginmetadatacache_p.h"
+
+#ifndef QT_NO_LIBRARY
+
+#include "qcryptographichash.h"
+#include "qdatastream.h"
+#include "qdatetime.h"
+#include "qdir.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qjsondocument.h"
+#include "qsavefile.h"
+#include "qstandardpaths.h"
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QPluginMetaDataCache remembers the metadata that QFactoryLoader found in
+    the plugins of one directory, so that the plugins do not have to be
+    opened and parsed again as long as their size and modification time are
+    unchanged. Files that are not plugins are remembered too, with empty
+    metadata.
+
+    The cache is a file per plugin directory. It is mapped when the cache is
+    created and only the position of each entry is recorded; the metadata is
+    decoded when it is needed.
+
+    Set QT_PLUGIN_CACHE_PATH to choose where the cache files are kept, or
+    QT_NO_PLUGIN_CACHE to disable the cache.
+*/
+
+enum {
+    CacheMagic = 0x51504d43, // 'QPMC'
+    CacheFormatVersion = 1
+};
+
+QPluginMetaDataCache::QPluginMetaDataCache(const QString &directory)
+    : directory(directory), cacheFile(0), dirty(false)
+{
+    const QString cacheDir = cacheDirectory();
+    if (cacheDir.isEmpty())
+        return;
+
+    const QByteArray hash = QCryptographicHash::hash(QFile::encodeName(directory),
+                                                     QCryptographicHash::Sha1);
+    cacheFileName = cacheDir + QLatin1Char('/') + QLatin1String(hash.toHex());
+    load();
+}
+
+QPluginMetaDataCache::~QPluginMetaDataCache()
+{
+    // the entries read from the file point into the mapping
+    entries.clear();
+    delete cacheFile;
+}
+
+QString QPluginMetaDataCache::cacheDirectory()
+{
+    if (qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE"))
+        return QString();
+    if (qEnvironmentVariableIsSet("QT_PLUGIN_CACHE_PATH"))
+        return QFile::decodeName(qgetenv("QT_PLUGIN_CACHE_PATH"));
+#ifndef QT_NO_STANDARDPATHS
+    const QString location = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (!location.isEmpty())
+        return location + QLatin1String("/qtplugincache");
+#endif
+    return QString();
+}
+
+bool QPluginMetaDataCache::stat(const QString &fileName, qint64 *size, qint64 *lastModified)
+{
+#ifdef Q_OS_UNIX
+    // QFileInfo::lastModified() converts to local time, which costs more
+    // than the rest of a lookup
+    QT_STATBUF st;
+    if (QT_STAT(QFile::encodeName(fileName).constData(), &st) != 0)
+        return false;
+    *size = st.st_size;
+    *lastModified = qint64(st.st_mtime) * 1000;
+#  ifdef Q_OS_LINUX
+    *lastModified += st.st_mtim.tv_nsec / 1000000;
+#  endif
+#else
+    const QFileInfo info(fileName);
+    if (!info.exists())
+        return false;
+    *size = info.size();
+    *lastModified = info.lastModified().toMSecsSinceEpoch();
+#endif
+    return true;
+}
+
+void QPluginMetaDataCache::load()
+{
+    cacheFile = new QFile(cacheFileName);
+    if (!cacheFile->open(QIODevice::ReadOnly))
+        return;
+    const qint64 fileSize = cacheFile->size();
+    const char *mapped = reinterpret_cast<const char *>(cacheFile->map(0, fileSize));
+    if (!mapped || fileSize > INT_MAX)
+        return;
+
+    QDataStream stream(QByteArray::fromRawData(mapped, int(fileSize)));
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, formatVersion, qtVersion, count;
+    QString cachedDirectory;
+    stream >> magic >> formatVersion >> qtVersion >> cachedDirectory >> count;
+    if (stream.status() != QDataStream::Ok || magic != CacheMagic
+            || formatVersion != CacheFormatVersion || qtVersion != QT_VERSION
+            || cachedDirectory != directory) {
+        return;
+    }
+
+    QHash<QString, Entry> loaded;
+    for (quint32 i = 0; i < count; ++i) {
+        QString fileName;
+        Entry entry;
+        quint32 length;
+        stream >> fileName >> entry.size >> entry.lastModified >> length;
+        if (stream.status() != QDataStream::Ok)
+            return;
+        const qint64 offset = stream.device()->pos();
+        if (length > quint32(fileSize - offset))
+            return;
+        entry.data = mapped + offset;
+        entry.length = int(length);
+        stream.skipRawData(int(length));
+        loaded.insert(fileName, entry);
+    }
+    entries.swap(loaded);
+}
+
+/*
+    Returns \c true and sets \a metaData if \a fileName is in the cache and
+    has not changed since. The metadata is empty if the file is not a plugin.
+*/
+bool QPluginMetaDataCache::find(const QString &fileName, QJsonObject *metaData)
+{
+    QHash<QString, Entry>::const_iterator it = entries.constFind(fileName);
+    if (it == entries.constEnd())
+        return false;
+
+    qint64 size, lastModified;
+    if (!stat(fileName, &size, &lastModified)
+            || size != it->size || lastModified != it->lastModified) {
+        return false;
+    }
+
+    if (it->length == 0) {
+        *metaData = QJsonObject();
+        return true;
+    }
+    const QJsonDocument doc = QJsonDocument::fromBinaryData(QByteArray::fromRawData(it->data, it->length));
+    if (!doc.isObject())
+        return false;
+    *metaData = doc.object();
+    return true;
+}
+
+void QPluginMetaDataCache::insert(const QString &fileName, const QJsonObject &metaData)
+{
+    if (!isEnabled())
+        return;
+
+    Entry entry;
+    if (!stat(fileName, &entry.size, &entry.lastModified))
+        return;
+    if (!metaData.isEmpty())
+        entry.ownData = QJsonDocument(metaData).toBinaryData();
+    entry.data = entry.ownData.constData();
+    entry.length = entry.ownData.size();
+    entries.insert(fileName, entry);
+    dirty = true;
+}
+
+/*
+    Writes the cache file if entries were added. Entries for files that no
+    longer exist are dropped.
+*/
+bool QPluginMetaDataCache::save()
+{
+#ifndef QT_NO_TEMPORARYFILE
+    if (!dirty)
+        return true;
+    if (!QDir().mkpath(QFileInfo(cacheFileName).absolutePath()))
+        return false;
+
+    QSaveFile file(cacheFileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QStringList fileNames;
+    for (QHash<QString, Entry>::const_iterator it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (QFileInfo::exists(it.key()))
+            fileNames.append(it.key());
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << quint32(CacheMagic) << quint32(CacheFormatVersion) << quint32(QT_VERSION)
+           << directory << quint32(fileNames.size());
+    for (int i = 0; i < fileNames.size(); ++i) {
+        const Entry &entry = entries[fileNames.at(i)];
+        stream << fileNames.at(i) << entry.size << entry.lastModified << quint32(entry.length);
+        stream.writeRawData(entry.data, entry.length);
+    }
+    if (stream.status() != QDataStream::Ok || !file.commit())
+        return false;
+    dirty = false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_LIBRARY
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPLUGINMETADATACACHE_P_H
+#define QPLUGINMETADATACACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qhash.h"
+#include "QtCore/qjsonobject.h"
+#include "QtCore/qstring.h"
+
+#ifndef QT_NO_LIBRARY
+
+QT_BEGIN_NAMESPACE
+
+class QFile;
+
+class Q_CORE_EXPORT QPluginMetaDataCache
+{
+public:
+    explicit QPluginMetaDataCache(const QString &directory);
+    ~QPluginMetaDataCache();
+
+    bool isEnabled() const { return !cacheFileName.isEmpty(); }
+    QString fileName() const { return cacheFileName; }
+
+    bool find(const QString &fileName, QJsonObject *metaData);
+    void insert(const QString &fileName, const QJsonObject &metaData);
+    bool save();
+
+    static QString cacheDirectory();
+
+private:
+    Q_DISABLE_COPY(QPluginMetaDataCache)
+
+    struct Entry {
+        qint64 size;
+        qint64 lastModified;
+        // binary JSON; points into the mapped cache file for entries that
+        // were read from it
+        const char *data;
+        int length;
+        QByteArray ownData;
+    };
+
+    void load();
+    static bool stat(const QString &fileName, qint64 *size, qint64 *lastModified);
+
+    QString directory;
+    QString cacheFileName;
+    QFile *cacheFile;
+    QHash<QString, Entry> entries;
+    bool dirty;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_LIBRARY
+
+#endif // QPLUGINMETADATACACHE_P_H
@@ -33,6 +33,7 @@
 
 #include <QtCore/qarraydata.h>
 #include <QtCore/private/qtools_p.h>
+#include <QtCore/private/qarraydataarena_p.h>
 
 #include <stdlib.h>
 
@@ -98,7 +99,9 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
 
     size_t allocSize = headerSize + objectSize * capacity;
 
-    QArrayData *header = static_cast<QArrayData *>(::malloc(allocSize));
+    QArrayData *header = static_cast<QArrayData *>(QArrayDataArena::tryAllocate(allocSize));
+    if (!header)
+        header = static_cast<QArrayData *>(::malloc(allocSize));
     if (header) {
         quintptr data = (quintptr(header) + sizeof(QArrayData) + alignment - 1)
                 & ~(alignment - 1);
@@ -128,7 +131,8 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
 
     Q_ASSERT_X(data == 0 || !data->ref.isStatic(), "QArrayData::deallocate",
                "Static data can not be deleted");
-    ::free(data);
+    if (!QArrayDataArena::tryRelease(data))
+        ::free(data);
 }
 
 namespace QtPrivate {
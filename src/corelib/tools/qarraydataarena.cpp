@@ -0,0 +1,359 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qarraydataarena_p.h"
+
+#include <QtCore/qmutex.h>
+
+#include <new>
+#include <stdlib.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QArrayDataArena
+    \inmodule QtCore
+
+    \brief The QArrayDataArena class serves QArrayData allocations made on
+    the current thread from large chunks instead of the heap.
+
+    Constructing a QArrayDataArena installs it for the current thread until
+    it is destroyed; arenas nest and must be destroyed in the reverse order
+    of their construction. While installed, every QString, QByteArray and
+    QVector buffer up to MaxBlockSize bytes that the thread allocates is
+    carved out of a ChunkSize-byte chunk by bumping a pointer, and freeing
+    it only decrements the chunk's count of live blocks; chunks whose blocks
+    have all been freed are reused while the arena exists. This turns the
+    malloc/free churn of a parsing loop that creates many short-lived
+    strings into a handful of chunk allocations.
+
+    Arena buffers are ordinary QArrayData: they can be copied, shared with
+    other threads and outlive the arena. When the arena is destroyed, the
+    chunks without live blocks are released immediately; a chunk that still
+    holds a buffer is released when the last of its buffers is freed. Since
+    a single escaped string keeps its whole chunk alive, an arena should
+    only be installed around code whose results are mostly discarded or
+    copied out.
+
+    An arena buffer is never resized in place: QString and QByteArray move
+    it to a fresh allocation instead of calling realloc() on it.
+
+    Chunks are aligned to their size and registered in a fixed-size global
+    table, so that a buffer can be mapped back to its chunk from any thread.
+    When the table is full, or the thread has no arena installed, the heap
+    is used as usual.
+*/
+
+struct QArrayDataArena::Chunk
+{
+    // live blocks, plus one while the arena that owns the chunk exists.
+    // While the chunk is the one being allocated from, blocks are counted
+    // in m_pending instead, and CurrentChunkBias keeps frees of those
+    // blocks from bringing this to zero.
+    QAtomicInt live;
+    Chunk *next;
+};
+
+namespace {
+enum {
+    RegistryBits = 12,
+    RegistrySize = 1 << RegistryBits,
+    MaxProbe = 16,
+    Tombstone = 1,
+    MaxRecycleScan = 8,
+    CurrentChunkBias = 1 << 30,
+    BlockAlignment = 2 * sizeof(void *)
+};
+}
+
+Q_STATIC_ASSERT(!(QArrayDataArena::ChunkSize & (QArrayDataArena::ChunkSize - 1)));
+
+QBasicAtomicInt QArrayDataArena::installedCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+QBasicAtomicInt QArrayDataArena::liveChunkCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// Open-addressed set of chunk base addresses. Lookups are lock-free;
+// insertions and removals are serialized by registryMutex. A removed entry
+// becomes a tombstone and never turns back to zero, so a lookup that stops
+// at the first empty slot cannot miss a chunk inserted further along.
+static QBasicAtomicInteger<quintptr> chunkRegistry[RegistrySize];
+static QBasicMutex registryMutex;
+
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QArrayDataArena *currentArena = Q_NULLPTR;
+#endif
+
+static inline uint registrySlot(quintptr base)
+{
+    return (quint32(base / QArrayDataArena::ChunkSize) * 2654435761U) >> (32 - RegistryBits);
+}
+
+static bool registerChunk(quintptr base)
+{
+    QMutexLocker locker(&registryMutex);
+    const uint slot = registrySlot(base);
+    for (int i = 0; i < MaxProbe; ++i) {
+        QBasicAtomicInteger<quintptr> &entry = chunkRegistry[(slot + i) & (RegistrySize - 1)];
+        const quintptr value = entry.load();
+        if (value == 0 || value == Tombstone) {
+            entry.storeRelease(base);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void unregisterChunk(quintptr base)
+{
+    QMutexLocker locker(&registryMutex);
+    const uint slot = registrySlot(base);
+    for (int i = 0; i < MaxProbe; ++i) {
+        QBasicAtomicInteger<quintptr> &entry = chunkRegistry[(slot + i) & (RegistrySize - 1)];
+        if (entry.load() == base) {
+            entry.storeRelease(Tombstone);
+            return;
+        }
+    }
+    Q_UNREACHABLE();
+}
+
+static void *allocateChunkMemory()
+{
+#if defined(Q_OS_UNIX)
+    void *memory;
+    if (posix_memalign(&memory, QArrayDataArena::ChunkSize, QArrayDataArena::ChunkSize) != 0)
+        return Q_NULLPTR;
+    return memory;
+#else
+    return qMallocAligned(QArrayDataArena::ChunkSize, QArrayDataArena::ChunkSize);
+#endif
+}
+
+static void freeChunkMemory(void *memory)
+{
+#if defined(Q_OS_UNIX)
+    ::free(memory);
+#else
+    qFreeAligned(memory);
+#endif
+}
+
+/*!
+    Constructs an arena and installs it for the current thread.
+*/
+QArrayDataArena::QArrayDataArena()
+    : m_previous(Q_NULLPTR), m_chunks(Q_NULLPTR), m_cursor(Q_NULLPTR), m_end(Q_NULLPTR),
+      m_pending(0), m_chunkCount(0), m_allocationCount(0)
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    m_previous = currentArena;
+    currentArena = this;
+    installedCount.ref();
+#endif
+}
+
+/*!
+    Uninstalls the arena, reinstating the one that was current when it was
+    constructed, and releases every chunk that no longer holds live blocks.
+*/
+QArrayDataArena::~QArrayDataArena()
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    Q_ASSERT_X(currentArena == this, "QArrayDataArena",
+               "Arenas must be destroyed in reverse order of construction");
+    currentArena = m_previous;
+    installedCount.deref();
+#endif
+
+    settleCurrentChunk();
+    Chunk *chunk = m_chunks;
+    while (chunk) {
+        // the chunk may be freed by another thread as soon as we drop our
+        // reference, so read the link first
+        Chunk *next = chunk->next;
+        if (!chunk->live.deref())
+            freeChunk(chunk);
+        chunk = next;
+    }
+}
+
+/*!
+    Returns the arena installed for the current thread, or \c nullptr.
+*/
+QArrayDataArena *QArrayDataArena::current() Q_DECL_NOTHROW
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    return currentArena;
+#else
+    return Q_NULLPTR;
+#endif
+}
+
+/*!
+    \fn int QArrayDataArena::chunkCount() const
+
+    Returns the number of chunks this arena has allocated.
+*/
+
+/*!
+    \fn int QArrayDataArena::allocationCount() const
+
+    Returns the number of blocks this arena has handed out.
+*/
+
+void QArrayDataArena::settleCurrentChunk() Q_DECL_NOTHROW
+{
+    if (m_cursor) {
+        m_chunks->live.fetchAndAddRelease(m_pending - CurrentChunkBias);
+        m_pending = 0;
+        m_cursor = m_end = Q_NULLPTR;
+    }
+}
+
+char *QArrayDataArena::firstBlock(Chunk *chunk) Q_DECL_NOTHROW
+{
+    // the header must not be mistaken for the chunk base by findChunk()
+    const size_t headerSize = (sizeof(Chunk) + BlockAlignment - 1) & ~size_t(BlockAlignment - 1);
+    return reinterpret_cast<char *>(chunk) + headerSize;
+}
+
+QArrayDataArena::Chunk *QArrayDataArena::nextChunk() Q_DECL_NOTHROW
+{
+    // Reuse a chunk whose blocks have all been freed. Only this thread
+    // allocates from our chunks, so one holding nothing but the arena's own
+    // reference cannot gain blocks behind our back. Recycling keeps the
+    // working set small and cache-hot, like the heap's free lists would.
+    // Only the most recently used chunks are inspected, to keep this cheap
+    // when many blocks are held for the lifetime of the arena.
+    settleCurrentChunk();
+    Chunk **link = &m_chunks;
+    for (int i = 0; i < MaxRecycleScan && *link; ++i) {
+        Chunk *chunk = *link;
+        if (chunk->live.loadAcquire() == 1) {
+            *link = chunk->next;
+            chunk->next = m_chunks;
+            m_chunks = chunk;
+            chunk->live.fetchAndAddRelaxed(CurrentChunkBias);
+            m_cursor = firstBlock(chunk);
+            m_end = reinterpret_cast<char *>(chunk) + ChunkSize;
+            return chunk;
+        }
+        link = &chunk->next;
+    }
+
+    void *memory = allocateChunkMemory();
+    if (!memory)
+        return Q_NULLPTR;
+    if (!registerChunk(quintptr(memory))) {
+        freeChunkMemory(memory);
+        return Q_NULLPTR;
+    }
+    liveChunkCount.ref();
+
+    Chunk *chunk = new (memory) Chunk;
+    chunk->live.store(1 + CurrentChunkBias);
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+    ++m_chunkCount;
+
+    m_cursor = firstBlock(chunk);
+    m_end = static_cast<char *>(memory) + ChunkSize;
+    return chunk;
+}
+
+void *QArrayDataArena::allocateSlow(size_t size) Q_DECL_NOTHROW
+{
+    QArrayDataArena *arena = current();
+    if (!arena || size > size_t(MaxBlockSize))
+        return Q_NULLPTR;
+
+    size = (size + BlockAlignment - 1) & ~size_t(BlockAlignment - 1);
+    if (size > size_t(arena->m_end - arena->m_cursor) && !arena->nextChunk())
+        return Q_NULLPTR;
+
+    void *block = arena->m_cursor;
+    arena->m_cursor += size;
+    ++arena->m_pending;
+    ++arena->m_allocationCount;
+    return block;
+}
+
+bool QArrayDataArena::releaseSlow(void *block) Q_DECL_NOTHROW
+{
+    Chunk *chunk = findChunk(block);
+    if (!chunk)
+        return false;
+
+    // Blocks of the chunk being allocated from are counted in m_pending,
+    // which the owning thread can update without atomics. Once they are all
+    // gone the chunk is empty and allocation can start over from its
+    // beginning, reusing memory that is still in the cache.
+    QArrayDataArena *arena = current();
+    if (arena && arena->m_cursor && arena->m_chunks == chunk) {
+        if (!--arena->m_pending)
+            arena->m_cursor = firstBlock(chunk);
+        return true;
+    }
+
+    if (!chunk->live.deref())
+        freeChunk(chunk);
+    return true;
+}
+
+QArrayDataArena::Chunk *QArrayDataArena::findChunk(const void *block) Q_DECL_NOTHROW
+{
+    if (!block)
+        return Q_NULLPTR;
+
+    const quintptr base = quintptr(block) & ~quintptr(ChunkSize - 1);
+    const uint slot = registrySlot(base);
+    for (int i = 0; i < MaxProbe; ++i) {
+        const quintptr value = chunkRegistry[(slot + i) & (RegistrySize - 1)].loadAcquire();
+        if (value == base)
+            return reinterpret_cast<Chunk *>(base);
+        if (value == 0)
+            break;
+    }
+    return Q_NULLPTR;
+}
+
+void QArrayDataArena::freeChunk(Chunk *chunk) Q_DECL_NOTHROW
+{
+    unregisterChunk(quintptr(chunk));
+    liveChunkCount.deref();
+    chunk->~Chunk();
+    freeChunkMemory(chunk);
+}
+
+QT_END_NAMESPACE
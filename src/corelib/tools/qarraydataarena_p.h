@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QARRAYDATAARENA_P_H
+#define QARRAYDATAARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qatomic.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QArrayDataArena
+{
+public:
+    enum {
+        ChunkSize = 64 * 1024,
+        MaxBlockSize = ChunkSize / 4
+    };
+
+    QArrayDataArena();
+    ~QArrayDataArena();
+
+    static QArrayDataArena *current() Q_DECL_NOTHROW;
+
+    int chunkCount() const Q_DECL_NOTHROW { return m_chunkCount; }
+    int allocationCount() const Q_DECL_NOTHROW { return m_allocationCount; }
+
+    // Hooks used by QArrayData, QString and QByteArray. All of them are a
+    // single relaxed load when no arena is in use.
+#ifndef QT_BOOTSTRAPPED
+    static void *tryAllocate(size_t size) Q_DECL_NOTHROW
+    { return Q_UNLIKELY(installedCount.load()) ? allocateSlow(size) : Q_NULLPTR; }
+    static bool tryRelease(void *block) Q_DECL_NOTHROW
+    { return Q_UNLIKELY(liveChunkCount.load()) && releaseSlow(block); }
+    static bool isArenaBlock(const void *block) Q_DECL_NOTHROW
+    { return Q_UNLIKELY(liveChunkCount.load()) && findChunk(block); }
+#else
+    // the bootstrapped tools do not build qarraydataarena.cpp
+    static void *tryAllocate(size_t) Q_DECL_NOTHROW { return Q_NULLPTR; }
+    static bool tryRelease(void *) Q_DECL_NOTHROW { return false; }
+    static bool isArenaBlock(const void *) Q_DECL_NOTHROW { return false; }
+#endif
+
+private:
+    Q_DISABLE_COPY(QArrayDataArena)
+
+    struct Chunk;
+
+    static void *allocateSlow(size_t size) Q_DECL_NOTHROW;
+    static bool releaseSlow(void *block) Q_DECL_NOTHROW;
+    static Chunk *findChunk(const void *block) Q_DECL_NOTHROW;
+    static void freeChunk(Chunk *chunk) Q_DECL_NOTHROW;
+    static char *firstBlock(Chunk *chunk) Q_DECL_NOTHROW;
+    Chunk *nextChunk() Q_DECL_NOTHROW;
+    void settleCurrentChunk() Q_DECL_NOTHROW;
+
+    static QBasicAtomicInt installedCount;
+    static QBasicAtomicInt liveChunkCount;
+
+    QArrayDataArena *m_previous;
+    Chunk *m_chunks;
+    char *m_cursor;
+    char *m_end;
+    int m_pending;
+    int m_chunkCount;
+    int m_allocationCount;
+};
+
+QT_END_NAMESPACE
+
+#endif // QARRAYDATAARENA_P_H
@@ -0,0 +1,1036 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBTREEMAP_H
+#define QBTREEMAP_H
+
+#include <QtCore/qmap.h>
+#include <QtCore/qvector.h>
+
+#include <map>
+#include <new>
+#include <string.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#include <utility>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The items live in the leaves of the tree, sorted by key, and the leaves
+    are linked to each other in order. The inner nodes only hold separator
+    keys: the first key of each of their children except the first one.
+    All nodes have room for one item more than their capacity, so that an
+    item can be inserted before the node is split.
+*/
+struct Q_CORE_EXPORT QBTreeMapData
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int height; // number of inner levels, 0 if the root is a leaf
+    void *root;
+    void *first; // leftmost leaf
+    void *last; // rightmost leaf
+
+    static const QBTreeMapData shared_null;
+};
+
+template <class Key, class T>
+class QBTreeMap
+{
+    struct Leaf
+    {
+        int count;
+        Leaf *prev;
+        Leaf *next;
+        // followed by LeafCapacity + 1 keys and as many values
+    };
+
+    struct Inner
+    {
+        int count; // number of keys, there is one more child
+        // followed by InnerCapacity + 1 keys and InnerCapacity + 2 children
+    };
+
+    // nodes of about eight cache lines
+    enum {
+        NodeBytes = 512,
+        LeafCapacity = NodeBytes / (sizeof(Key) + sizeof(T)) < 8 ? 8 : NodeBytes / (sizeof(Key) + sizeof(T)),
+        InnerCapacity = NodeBytes / (sizeof(Key) + sizeof(void *)) < 8 ? 8 : NodeBytes / (sizeof(Key) + sizeof(void *)),
+        MinLeaf = LeafCapacity / 2,
+        MinInner = InnerCapacity / 2,
+        MaxHeight = 32,
+        StrictAlignment = Q_ALIGNOF(Key) > 8 || Q_ALIGNOF(T) > 8
+    };
+
+    static inline size_t alignUp(size_t n, size_t a) { return (n + a - 1) & ~(a - 1); }
+    static inline size_t leafKeysOffset() { return alignUp(sizeof(Leaf), Q_ALIGNOF(Key)); }
+    static inline size_t leafValuesOffset()
+    { return alignUp(leafKeysOffset() + (LeafCapacity + 1) * sizeof(Key), Q_ALIGNOF(T)); }
+    static inline size_t innerKeysOffset() { return alignUp(sizeof(Inner), Q_ALIGNOF(Key)); }
+    static inline size_t innerChildrenOffset()
+    { return alignUp(innerKeysOffset() + (InnerCapacity + 1) * sizeof(Key), Q_ALIGNOF(void *)); }
+
+    static inline Key *keysOf(Leaf *l)
+    { return reinterpret_cast<Key *>(reinterpret_cast<char *>(l) + leafKeysOffset()); }
+    static inline T *valuesOf(Leaf *l)
+    { return reinterpret_cast<T *>(reinterpret_cast<char *>(l) + leafValuesOffset()); }
+    static inline Key *keysOf(Inner *n)
+    { return reinterpret_cast<Key *>(reinterpret_cast<char *>(n) + innerKeysOffset()); }
+    static inline void **childrenOf(Inner *n)
+    { return reinterpret_cast<void **>(reinterpret_cast<char *>(n) + innerChildrenOffset()); }
+
+    QBTreeMapData *d;
+
+public:
+    inline QBTreeMap() Q_DECL_NOTHROW : d(const_cast<QBTreeMapData *>(&QBTreeMapData::shared_null)) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QBTreeMap(std::initializer_list<std::pair<Key,T> > list)
+        : d(const_cast<QBTreeMapData *>(&QBTreeMapData::shared_null))
+    {
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    explicit QBTreeMap(const QMap<Key, T> &other);
+    explicit QBTreeMap(const std::map<Key, T> &other);
+    inline QBTreeMap(const QBTreeMap &other) : d(other.d) { d->ref.ref(); }
+    inline ~QBTreeMap() { if (!d->ref.deref()) freeData(d); }
+
+    QBTreeMap &operator=(const QBTreeMap &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QBTreeMap(QBTreeMap &&other) Q_DECL_NOTHROW
+        : d(other.d) { other.d = const_cast<QBTreeMapData *>(&QBTreeMapData::shared_null); }
+    inline QBTreeMap &operator=(QBTreeMap &&other) Q_DECL_NOTHROW
+    { QBTreeMap moved(std::move(other)); swap(moved); return *this; }
+#endif
+    inline void swap(QBTreeMap &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    QMap<Key, T> toMap() const;
+
+    bool operator==(const QBTreeMap &other) const;
+    inline bool operator!=(const QBTreeMap &other) const { return !(*this == other); }
+
+    inline int size() const { return d->size; }
+    inline int count() const { return d->size; }
+    inline bool isEmpty() const { return d->size == 0; }
+
+    inline void detach() { if (d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d->ref.isShared(); }
+    inline bool isSharedWith(const QBTreeMap &other) const { return d == other.d; }
+
+    void clear();
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    inline bool contains(const Key &key) const { return constFind(key) != constEnd(); }
+    inline int count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    const T value(const Key &key, const T &defaultValue = T()) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QBTreeMap<Key, T>;
+        Leaf *l;
+        int i;
+
+        inline iterator(Leaf *leaf, int index) : l(leaf), i(index) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : l(Q_NULLPTR), i(0) { }
+
+        inline const Key &key() const { return QBTreeMap::keysOf(l)[i]; }
+        inline T &value() const { return QBTreeMap::valuesOf(l)[i]; }
+        inline T &operator*() const { return value(); }
+        inline T *operator->() const { return &value(); }
+        inline bool operator==(const iterator &o) const { return l == o.l && i == o.i; }
+        inline bool operator!=(const iterator &o) const { return !(*this == o); }
+        inline bool operator==(const const_iterator &o) const { return l == o.l && i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        inline iterator &operator++()
+        {
+            if (++i == l->count && l->next) {
+                l = l->next;
+                i = 0;
+            }
+            return *this;
+        }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+        inline iterator &operator--()
+        {
+            if (i == 0) {
+                l = l->prev;
+                i = l->count;
+            }
+            --i;
+            return *this;
+        }
+        inline iterator operator--(int) { iterator r = *this; --*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QBTreeMap<Key, T>;
+        Leaf *l;
+        int i;
+
+        inline const_iterator(Leaf *leaf, int index) : l(leaf), i(index) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : l(Q_NULLPTR), i(0) { }
+        inline const_iterator(const iterator &o) : l(o.l), i(o.i) { }
+
+        inline const Key &key() const { return QBTreeMap::keysOf(l)[i]; }
+        inline const T &value() const { return QBTreeMap::valuesOf(l)[i]; }
+        inline const T &operator*() const { return value(); }
+        inline const T *operator->() const { return &value(); }
+        inline bool operator==(const const_iterator &o) const { return l == o.l && i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        inline const_iterator &operator++()
+        {
+            if (++i == l->count && l->next) {
+                l = l->next;
+                i = 0;
+            }
+            return *this;
+        }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+        inline const_iterator &operator--()
+        {
+            if (i == 0) {
+                l = l->prev;
+                i = l->count;
+            }
+            --i;
+            return *this;
+        }
+        inline const_iterator operator--(int) { const_iterator r = *this; --*this; return r; }
+    };
+    friend class const_iterator;
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(static_cast<Leaf *>(d->first), 0); }
+    inline const_iterator begin() const { return constBegin(); }
+    inline const_iterator cbegin() const { return constBegin(); }
+    inline const_iterator constBegin() const { return const_iterator(static_cast<Leaf *>(d->first), 0); }
+    inline iterator end() { detach(); return iterator(constEnd().l, constEnd().i); }
+    inline const_iterator end() const { return constEnd(); }
+    inline const_iterator cend() const { return constEnd(); }
+    inline const_iterator constEnd() const
+    {
+        Leaf *last = static_cast<Leaf *>(d->last);
+        return const_iterator(last, last ? last->count : 0);
+    }
+
+    iterator erase(iterator it);
+
+    iterator insert(const Key &key, const T &value);
+    iterator find(const Key &key);
+    inline const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+    iterator lowerBound(const Key &key);
+    const_iterator lowerBound(const Key &key) const;
+    iterator upperBound(const Key &key);
+    const_iterator upperBound(const Key &key) const;
+
+    inline const Key &firstKey() const { Q_ASSERT(!isEmpty()); return constBegin().key(); }
+    inline const Key &lastKey() const { Q_ASSERT(!isEmpty()); return (--constEnd()).key(); }
+    inline T &first() { Q_ASSERT(!isEmpty()); return *begin(); }
+    inline const T &first() const { Q_ASSERT(!isEmpty()); return *constBegin(); }
+    inline T &last() { Q_ASSERT(!isEmpty()); return *(--end()); }
+    inline const T &last() const { Q_ASSERT(!isEmpty()); return *(--constEnd()); }
+
+    // STL compatibility
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    void detach_helper();
+    static void freeData(QBTreeMapData *x);
+    static void freeTree(void *node, int height);
+    static void *copyTree(void *node, int height, Leaf **prev);
+    template <typename InputIterator>
+    void buildFromSorted(InputIterator it, int n);
+
+    static Leaf *createLeaf();
+    static Inner *createInner();
+    static void freeNode(void *node);
+    template <typename X>
+    static void relocate(X *to, X *from, int n);
+
+    static int lowerBoundIndex(const Key *k, int n, const Key &key);
+    static int upperBoundIndex(const Key *k, int n, const Key &key);
+    Leaf *findLeaf(const Key &key) const;
+    const_iterator lowerBoundHelper(const Key &key) const;
+    const_iterator upperBoundHelper(const Key &key) const;
+
+    void rebalance(Inner **path, const int *childIndex, Leaf *leaf);
+    static void removeChild(Inner *n, int keyIndex);
+
+    static inline const Key &sourceKey(typename QMap<Key, T>::const_iterator it) { return it.key(); }
+    static inline const T &sourceValue(typename QMap<Key, T>::const_iterator it) { return it.value(); }
+    static inline const Key &sourceKey(typename std::map<Key, T>::const_iterator it) { return it->first; }
+    static inline const T &sourceValue(typename std::map<Key, T>::const_iterator it) { return it->second; }
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::Leaf *QBTreeMap<Key, T>::createLeaf()
+{
+    const size_t size = leafValuesOffset() + (LeafCapacity + 1) * sizeof(T);
+    void *p = StrictAlignment ? qMallocAligned(size, qMax(Q_ALIGNOF(Key), Q_ALIGNOF(T))) : ::malloc(size);
+    Q_CHECK_PTR(p);
+    Leaf *l = static_cast<Leaf *>(p);
+    l->count = 0;
+    l->prev = l->next = Q_NULLPTR;
+    return l;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::Inner *QBTreeMap<Key, T>::createInner()
+{
+    const size_t size = innerChildrenOffset() + (InnerCapacity + 2) * sizeof(void *);
+    void *p = StrictAlignment ? qMallocAligned(size, qMax(Q_ALIGNOF(Key), Q_ALIGNOF(void *))) : ::malloc(size);
+    Q_CHECK_PTR(p);
+    Inner *n = static_cast<Inner *>(p);
+    n->count = 0;
+    return n;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QBTreeMap<Key, T>::freeNode(void *node)
+{
+    if (StrictAlignment)
+        qFreeAligned(node);
+    else
+        ::free(node);
+}
+
+/*
+    Moves n items from \a from to the uninitialized, possibly
+    overlapping, memory at \a to.
+*/
+template <class Key, class T>
+template <typename X>
+Q_OUTOFLINE_TEMPLATE void QBTreeMap<Key, T>::relocate(X *to, X *from, int n)
+{
+    if (!QTypeInfo<X>::isStatic) {
+        ::memmove(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(X));
+    } else if (to < from) {
+        for (int i = 0; i < n; ++i) {
+            new (to + i) X(from[i]);
+            from[i].~X();
+        }
+    } else {
+        for (int i = n - 1; i >= 0; --i) {
+            new (to + i) X(from[i]);
+            from[i].~X();
+        }
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QBTreeMap<Key, T>::freeTree(void *node, int height)
+{
+    if (height == 0) {
+        Leaf *l = static_cast<Leaf *>(node);
+        if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+            for (int i = 0; i < l->count; ++i) {
+                keysOf(l)[i].~Key();
+                valuesOf(l)[i].~T();
+            }
+        }
+    } else {
+        Inner *n = static_cast<Inner *>(node);
+        for (int i = 0; i <= n->count; ++i)
+            freeTree(childrenOf(n)[i], height - 1);
+        if (QTypeInfo<Key>::isComplex) {
+            for (int i = 0; i < n->count; ++i)
+                keysOf(n)[i].~Key();
+        }
+    }
+    freeNode(node);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QBTreeMap<Key, T>::freeData(QBTreeMapData *x)
+{
+    if (x->root)
+        freeTree(x->root, x->height);
+    delete x;
+}
+
+/*
+    Copies the subtree at \a node, linking the copied leaves after
+    \a prev, which is updated to the last one.
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void *QBTreeMap<Key, T>::copyTree(void *node, int height, Leaf **prev)
+{
+    if (height == 0) {
+        Leaf *from = static_cast<Leaf *>(node);
+        Leaf *to = createLeaf();
+        for (int i = 0; i < from->count; ++i) {
+            new (keysOf(to) + i) Key(keysOf(from)[i]);
+            new (valuesOf(to) + i) T(valuesOf(from)[i]);
+        }
+        to->count = from->count;
+        to->prev = *prev;
+        if (*prev)
+            (*prev)->next = to;
+        *prev = to;
+        return to;
+    }
+
+    Inner *from = static_cast<Inner *>(node);
+    Inner *to = createInner();
+    for (int i = 0; i < from->count; ++i)
+        new (keysOf(to) + i) Key(keysOf(from)[i]);
+    for (int i = 0; i <= from->count; ++i)
+        childrenOf(to)[i] = copyTree(childrenOf(from)[i], height - 1, prev);
+    to->count = from->count;
+    return to;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QBTreeMap<Key, T>::detach_helper()
+{
+    QBTreeMapData *x = new QBTreeMapData;
+    x->ref.initializeOwned();
+    x->size = d->size;
+    x->height = d->height;
+    x->root = x->first = x->last = Q_NULLPTR;
+    if (d->root) {
+        Leaf *prev = Q_NULLPTR;
+        x->root = copyTree(d->root, d->height, &prev);
+        Leaf *first = prev;
+        while (first->prev)
+            first = first->prev;
+        x->first = first;
+        x->last = prev;
+    }
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+/*
+    Builds the tree bottom-up from \a n items in ascending key order, with
+    the items spread evenly over as few leaves as possible.
+*/
+template <class Key, class T>
+template <typename InputIterator>
+Q_OUTOFLINE_TEMPLATE void QBTreeMap<Key, T>::buildFromSorted(InputIterator it, int n)
+{
+    Q_ASSERT(d == &QBTreeMapData::shared_null);
+    if (n == 0)
+        return;
+
+    QVector<void *> nodes;
+    QVector<Key> firstKeys;
+    const int leafCount = (n + LeafCapacity - 1) / LeafCapacity;
+    nodes.reserve(leafCount);
+    firstKeys.reserve(leafCount);
+
+    Leaf *prev = Q_NULLPTR;
+    for (int i = 0; i < leafCount; ++i) {
+        Leaf *l = createLeaf();
+        const int count = n / leafCount + (i < n % leafCount ? 1 : 0);
+        for (int j = 0; j < count; ++j, ++it) {
+            new (keysOf(l) + j) Key(sourceKey(it));
+            new (valuesOf(l) + j) T(sourceValue(it));
+        }
+        l->count = count;
+        l->prev = prev;
+        if (prev)
+            prev->next = l;
+        prev = l;
+        nodes.append(l);
+        firstKeys.append(keysOf(l)[0]);
+    }
+
+    int height = 0;
+    while (nodes.size() > 1) {
+        const int m = nodes.size();
+        const int innerCount = (m + InnerCapacity) / (InnerCapacity + 1);
+        QVector<void *> parents;
+        QVector<Key> parentKeys;
+        parents.reserve(innerCount);
+        parentKeys.reserve(innerCount);
+        for (int i = 0, start = 0; i < innerCount; ++i) {
+            Inner *p = createInner();
+            const int count = m / innerCount + (i < m % innerCount ? 1 : 0);
+            for (int j = 0; j < count; ++j) {
+                childrenOf(p)[j] = nodes.at(start + j);
+                if (j > 0)
+                    new (keysOf(p) + j - 1) Key(firstKeys.at(start + j));
+            }
+            p->count = count - 1;
+            parents.append(p);
+            parentKeys.append(firstKeys.at(start));
+            start += count;
+        }
+        nodes.swap(parents);
+        firstKeys.swap(parentKeys);
+        ++height;
+    }
+
+    QBTreeMapData *x = new QBTreeMapData;
+    x->ref.initializeOwned();
+    x->size = n;
+    x->height = height;
+    x->root = nodes.first();
+    x->first = static_cast<Leaf *>(x->root);
+    for (int h = height; h > 0; --h)
+        x->first = childrenOf(static_cast<Inner *>(x->first))[0];
+    x->last = prev;
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QBTreeMap<Key, T>::QBTreeMap(const QMap<Key, T> &other)
+    : d(const_cast<QBTreeMapData *>(&QBTreeMapData::shared_null))
+{
+    buildFromSorted(other.constBegin(), other.size());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QBTreeMap<Key, T>::QBTreeMap(const std::map<Key, T> &other)
+    : d(const_cast<QBTreeMapData *>(&QBTreeMapData::shared_null))
+{
+    buildFromSorted(other.begin(), int(other.size()));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QMap<Key, T> QBTreeMap<Key, T>::toMap() const
+{
+    QMap<Key, T> map;
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        map.insert(map.constEnd(), it.key(), it.value());
+    return map;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QBTreeMap<Key, T> &QBTreeMap<Key, T>::operator=(const QBTreeMap &other)
+{
+    if (d != other.d) {
+        QBTreeMapData *o = other.d;
+        o->ref.ref();
+        if (!d->ref.deref())
+            freeData(d);
+        d = o;
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QBTreeMap<Key, T>::operator==(const QBTreeMap &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    const_iterator it1 = constBegin();
+    const_iterator it2 = other.constBegin();
+    while (it1 != constEnd()) {
+        if (!(it1.value() == it2.value()) || qMapLessThanKey(it1.key(), it2.key())
+                || qMapLessThanKey(it2.key(), it1.key()))
+            return false;
+        ++it1;
+        ++it2;
+    }
+    return true;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QBTreeMap<Key, T>::clear()
+{
+    *this = QBTreeMap();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QBTreeMap<Key, T>::lowerBoundIndex(const Key *k, int n, const Key &key)
+{
+    int lo = 0;
+    while (n > 0) {
+        const int half = n / 2;
+        if (qMapLessThanKey(k[lo + half], key)) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QBTreeMap<Key, T>::upperBoundIndex(const Key *k, int n, const Key &key)
+{
+    int lo = 0;
+    while (n > 0) {
+        const int half = n / 2;
+        if (!qMapLessThanKey(key, k[lo + half])) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::Leaf *QBTreeMap<Key, T>::findLeaf(const Key &key) const
+{
+    void *node = d->root;
+    for (int h = d->height; h > 0; --h) {
+        Inner *n = static_cast<Inner *>(node);
+        node = childrenOf(n)[upperBoundIndex(keysOf(n), n->count, key)];
+    }
+    return static_cast<Leaf *>(node);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::const_iterator QBTreeMap<Key, T>::lowerBoundHelper(const Key &key) const
+{
+    if (!d->root)
+        return constEnd();
+    Leaf *l = findLeaf(key);
+    const int i = lowerBoundIndex(keysOf(l), l->count, key);
+    if (i == l->count && l->next)
+        return const_iterator(l->next, 0);
+    return const_iterator(l, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::const_iterator QBTreeMap<Key, T>::upperBoundHelper(const Key &key) const
+{
+    if (!d->root)
+        return constEnd();
+    Leaf *l = findLeaf(key);
+    const int i = upperBoundIndex(keysOf(l), l->count, key);
+    if (i == l->count && l->next)
+        return const_iterator(l->next, 0);
+    return const_iterator(l, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::const_iterator QBTreeMap<Key, T>::constFind(const Key &akey) const
+{
+    if (!d->root)
+        return constEnd();
+    Leaf *l = findLeaf(akey);
+    const int i = lowerBoundIndex(keysOf(l), l->count, akey);
+    if (i < l->count && !qMapLessThanKey(akey, keysOf(l)[i]))
+        return const_iterator(l, i);
+    return constEnd();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::iterator QBTreeMap<Key, T>::find(const Key &akey)
+{
+    detach();
+    const const_iterator it = constFind(akey);
+    return iterator(it.l, it.i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::const_iterator QBTreeMap<Key, T>::lowerBound(const Key &akey) const
+{
+    return lowerBoundHelper(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::iterator QBTreeMap<Key, T>::lowerBound(const Key &akey)
+{
+    detach();
+    const const_iterator it = lowerBoundHelper(akey);
+    return iterator(it.l, it.i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::const_iterator QBTreeMap<Key, T>::upperBound(const Key &akey) const
+{
+    return upperBoundHelper(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QBTreeMap<Key, T>::iterator QBTreeMap<Key, T>::upperBound(const Key &akey)
+{
+    detach();
+    const const_iterator it = upperBoundHelper(akey);
+    return iterator(it.l, it.i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QBTreeMap<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    const const_iterator it = constFind(akey);
+    return it == constEnd() ? adefaultValue : it.value();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QBTreeMap<Key, T>::operator[](const Key &akey)
+{
+    iterator it = find(akey);
+    if (it == end())
+        it = insert(akey, T());
+    return it.value();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QBTreeMap<Key, T>::operator[](const Key &akey) const
+{
+    return value(akey);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QBTreeMap<Key, T>::iterator QBTreeMap<Key, T>::insert(const Key &akey,
+                                                                                   const T &avalue)
+{
+    detach();
+    if (!d->root) {
+        Leaf *l = createLeaf();
+        d->root = d->first = d->last = l;
+        d->height = 0;
+    }
+
+    Inner *path[MaxHeight];
+    int childIndex[MaxHeight];
+    void *node = d->root;
+    for (int level = 0; level < d->height; ++level) {
+        Inner *n = static_cast<Inner *>(node);
+        const int ci = upperBoundIndex(keysOf(n), n->count, akey);
+        path[level] = n;
+        childIndex[level] = ci;
+        node = childrenOf(n)[ci];
+    }
+
+    Leaf *l = static_cast<Leaf *>(node);
+    const int pos = lowerBoundIndex(keysOf(l), l->count, akey);
+    if (pos < l->count && !qMapLessThanKey(akey, keysOf(l)[pos])) {
+        valuesOf(l)[pos] = avalue;
+        return iterator(l, pos);
+    }
+
+    // the key and the value may live in this map, copy them before moving items
+    const Key k(akey);
+    const T v(avalue);
+    relocate(keysOf(l) + pos + 1, keysOf(l) + pos, l->count - pos);
+    relocate(valuesOf(l) + pos + 1, valuesOf(l) + pos, l->count - pos);
+    new (keysOf(l) + pos) Key(k);
+    new (valuesOf(l) + pos) T(v);
+    ++l->count;
+    ++d->size;
+    if (l->count <= LeafCapacity)
+        return iterator(l, pos);
+
+    // Keys that are appended in ascending order leave the full nodes
+    // behind, so that building a map in order packs them densely.
+    const bool appending = !l->next && pos == LeafCapacity;
+    const int split = appending ? int(LeafCapacity) : l->count / 2;
+    Leaf *right = createLeaf();
+    relocate(keysOf(right), keysOf(l) + split, l->count - split);
+    relocate(valuesOf(right), valuesOf(l) + split, l->count - split);
+    right->count = l->count - split;
+    l->count = split;
+    right->prev = l;
+    right->next = l->next;
+    if (l->next)
+        l->next->prev = right;
+    else
+        d->last = right;
+    l->next = right;
+    const iterator result = pos < split ? iterator(l, pos) : iterator(right, pos - split);
+
+    Key separator(keysOf(right)[0]);
+    void *newChild = right;
+    for (int level = d->height - 1; level >= 0; --level) {
+        Inner *n = path[level];
+        const int ci = childIndex[level];
+        relocate(keysOf(n) + ci + 1, keysOf(n) + ci, n->count - ci);
+        new (keysOf(n) + ci) Key(separator);
+        ::memmove(childrenOf(n) + ci + 2, childrenOf(n) + ci + 1, (n->count - ci) * sizeof(void *));
+        childrenOf(n)[ci + 1] = newChild;
+        ++n->count;
+        if (n->count <= InnerCapacity)
+            return result;
+
+        // the separator at mid moves up, the right node keeps at least one key
+        const int mid = appending ? n->count - 2 : n->count / 2;
+        Inner *r = createInner();
+        separator = keysOf(n)[mid];
+        keysOf(n)[mid].~Key();
+        relocate(keysOf(r), keysOf(n) + mid + 1, n->count - mid - 1);
+        ::memcpy(childrenOf(r), childrenOf(n) + mid + 1, (n->count - mid) * sizeof(void *));
+        r->count = n->count - mid - 1;
+        n->count = mid;
+        newChild = r;
+    }
+
+    Inner *root = createInner();
+    new (keysOf(root)) Key(separator);
+    childrenOf(root)[0] = d->root;
+    childrenOf(root)[1] = newChild;
+    root->count = 1;
+    d->root = root;
+    ++d->height;
+    Q_ASSERT(d->height < MaxHeight);
+    return result;
+}
+
+/*
+    Removes the key at \a keyIndex and the child after it from \a n.
+*/
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QBTreeMap<Key, T>::removeChild(Inner *n, int keyIndex)
+{
+    keysOf(n)[keyIndex].~Key();
+    relocate(keysOf(n) + keyIndex, keysOf(n) + keyIndex + 1, n->count - keyIndex - 1);
+    ::memmove(childrenOf(n) + keyIndex + 1, childrenOf(n) + keyIndex + 2,
+              (n->count - keyIndex - 1) * sizeof(void *));
+    --n->count;
+}
+
+/*
+    Restores the invariants after an item was removed from \a leaf: a node
+    with too few items is merged with a sibling if they fit together in one
+    node, or takes an item from that sibling otherwise. Merging removes a
+    child from the parent, which may then need rebalancing as well.
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QBTreeMap<Key, T>::rebalance(Inner **path, const int *childIndex, Leaf *leaf)
+{
+    if (d->height == 0) {
+        if (leaf->count == 0) {
+            freeNode(leaf);
+            d->root = d->first = d->last = Q_NULLPTR;
+        }
+        return;
+    }
+    if (leaf->count >= MinLeaf)
+        return;
+
+    Inner *parent = path[d->height - 1];
+    int ci = childIndex[d->height - 1];
+    int sep = ci > 0 ? ci - 1 : 0;
+    Leaf *left = static_cast<Leaf *>(childrenOf(parent)[sep]);
+    Leaf *right = static_cast<Leaf *>(childrenOf(parent)[sep + 1]);
+
+    if (left->count + right->count <= LeafCapacity) {
+        relocate(keysOf(left) + left->count, keysOf(right), right->count);
+        relocate(valuesOf(left) + left->count, valuesOf(right), right->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next)
+            right->next->prev = left;
+        else
+            d->last = left;
+        freeNode(right);
+        removeChild(parent, sep);
+    } else {
+        if (leaf == right) {
+            relocate(keysOf(right) + 1, keysOf(right), right->count);
+            relocate(valuesOf(right) + 1, valuesOf(right), right->count);
+            relocate(keysOf(right), keysOf(left) + left->count - 1, 1);
+            relocate(valuesOf(right), valuesOf(left) + left->count - 1, 1);
+            --left->count;
+            ++right->count;
+        } else {
+            relocate(keysOf(left) + left->count, keysOf(right), 1);
+            relocate(valuesOf(left) + left->count, valuesOf(right), 1);
+            relocate(keysOf(right), keysOf(right) + 1, right->count - 1);
+            relocate(valuesOf(right), valuesOf(right) + 1, right->count - 1);
+            ++left->count;
+            --right->count;
+        }
+        keysOf(parent)[sep] = keysOf(right)[0];
+        return;
+    }
+
+    Inner *node = parent;
+    for (int level = d->height - 2; level >= 0 && node->count < MinInner; --level) {
+        parent = path[level];
+        ci = childIndex[level];
+        sep = ci > 0 ? ci - 1 : 0;
+        Inner *l = static_cast<Inner *>(childrenOf(parent)[sep]);
+        Inner *r = static_cast<Inner *>(childrenOf(parent)[sep + 1]);
+
+        if (l->count + 1 + r->count <= InnerCapacity) {
+            new (keysOf(l) + l->count) Key(keysOf(parent)[sep]);
+            relocate(keysOf(l) + l->count + 1, keysOf(r), r->count);
+            ::memcpy(childrenOf(l) + l->count + 1, childrenOf(r), (r->count + 1) * sizeof(void *));
+            l->count += 1 + r->count;
+            freeNode(r);
+            removeChild(parent, sep);
+            node = parent;
+        } else {
+            if (node == r) {
+                relocate(keysOf(r) + 1, keysOf(r), r->count);
+                ::memmove(childrenOf(r) + 1, childrenOf(r), (r->count + 1) * sizeof(void *));
+                new (keysOf(r)) Key(keysOf(parent)[sep]);
+                childrenOf(r)[0] = childrenOf(l)[l->count];
+                keysOf(parent)[sep] = keysOf(l)[l->count - 1];
+                keysOf(l)[l->count - 1].~Key();
+                --l->count;
+                ++r->count;
+            } else {
+                new (keysOf(l) + l->count) Key(keysOf(parent)[sep]);
+                childrenOf(l)[l->count + 1] = childrenOf(r)[0];
+                keysOf(parent)[sep] = keysOf(r)[0];
+                keysOf(r)[0].~Key();
+                relocate(keysOf(r), keysOf(r) + 1, r->count - 1);
+                ::memmove(childrenOf(r), childrenOf(r) + 1, r->count * sizeof(void *));
+                ++l->count;
+                --r->count;
+            }
+            return;
+        }
+    }
+
+    while (d->height > 0 && static_cast<Inner *>(d->root)->count == 0) {
+        Inner *root = static_cast<Inner *>(d->root);
+        d->root = childrenOf(root)[0];
+        freeNode(root);
+        --d->height;
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QBTreeMap<Key, T>::remove(const Key &akey)
+{
+    if (constFind(akey) == constEnd())
+        return 0;
+    detach();
+
+    Inner *path[MaxHeight];
+    int childIndex[MaxHeight];
+    void *node = d->root;
+    for (int level = 0; level < d->height; ++level) {
+        Inner *n = static_cast<Inner *>(node);
+        const int ci = upperBoundIndex(keysOf(n), n->count, akey);
+        path[level] = n;
+        childIndex[level] = ci;
+        node = childrenOf(n)[ci];
+    }
+
+    Leaf *l = static_cast<Leaf *>(node);
+    const int pos = lowerBoundIndex(keysOf(l), l->count, akey);
+    keysOf(l)[pos].~Key();
+    valuesOf(l)[pos].~T();
+    relocate(keysOf(l) + pos, keysOf(l) + pos + 1, l->count - pos - 1);
+    relocate(valuesOf(l) + pos, valuesOf(l) + pos + 1, l->count - pos - 1);
+    --l->count;
+    --d->size;
+    rebalance(path, childIndex, l);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QBTreeMap<Key, T>::take(const Key &akey)
+{
+    const const_iterator it = constFind(akey);
+    if (it == constEnd())
+        return T();
+    T t = it.value();
+    remove(akey);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QBTreeMap<Key, T>::iterator QBTreeMap<Key, T>::erase(iterator it)
+{
+    if (it == end())
+        return it;
+    const Key akey = it.key();
+    remove(akey);
+    return lowerBound(akey);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QBTreeMap<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QBTreeMap<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+QT_END_NAMESPACE
+
+#endif // QBTREEMAP_H
@@ -35,10 +35,12 @@
 #include "qbytearray.h"
 #include "qbytearraymatcher.h"
 #include "qtools_p.h"
+#include "qarraydataarena_p.h"
 #include "qstring.h"
 #include "qlist.h"
 #include "qlocale.h"
 #include "qlocale_p.h"
+#include "qlocale_tools_p.h"
 #include "qstringalgorithms_p.h"
 #include "qscopedpointer.h"
 #include <qdatastream.h>
@@ -1563,7 +1565,8 @@ QByteArray &QByteArray::fill(char ch, int size)
 
 void QByteArray::reallocData(uint alloc, Data::AllocationOptions options)
 {
-    if (d->ref.isShared() || IS_RAW_DATA(d)) {
+    // arena blocks cannot be resized in place
+    if (d->ref.isShared() || IS_RAW_DATA(d) || QArrayDataArena::isArenaBlock(d)) {
         Data *x = Data::allocate(alloc, options);
         Q_CHECK_PTR(x);
         x->size = qMin(int(alloc) - 1, d->size);
@@ -2407,11 +2410,9 @@ int QByteArray::indexOf(char ch, int from) const
     if (from < 0)
         from = qMax(from + d->size, 0);
     if (from < d->size) {
-        const char *n = d->data() + from - 1;
-        const char *e = d->data() + d->size;
-        while (++n != e)
-        if (*n == ch)
-            return  n - d->data();
+        const char *n = static_cast<const char *>(memchr(d->data() + from, ch, d->size - from));
+        if (n)
+            return n - d->data();
     }
     return -1;
 }
@@ -3758,14 +3759,7 @@ static char *qulltoa2(char *p, qulonglong n, int base)
         base = 10;
     }
 #endif
-    const char b = 'a' - 10;
-    do {
-        const int c = n % base;
-        n /= base;
-        *--p = c + (c < 10 ? '0' : b);
-    } while (n);
-
-    return p;
+    return qulltoaBackwards(p, n, base);
 }
 
 /*!
@@ -3862,7 +3856,14 @@ QByteArray &QByteArray::setNum(double n, char f, int prec)
             break;
     }
 
-    *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
+    char buf[QLocaleData::CLocaleDoubleBufferSize];
+    const int length = QLocaleData::doubleToCLocale(buf, sizeof(buf), n, prec, form, flags);
+    if (length >= 0) {
+        clear();
+        append(buf, length);
+    } else {
+        *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
+    }
     return *this;
 }
 
@@ -34,6 +34,24 @@
 
 #include <qcryptographichash.h>
 #include <qiodevice.h>
+#include <qatomic.h>
+#include <qvarlengtharray.h>
+#include <qvector.h>
+#include <private/qsimd_p.h>
+
+#ifndef QT_BOOTSTRAPPED
+#include <qfiledevice.h>
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#include <fcntl.h>
+#endif
+#endif
+
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_THREAD)
+#include <qrunnable.h>
+#include <qsemaphore.h>
+#include <qthread.h>
+#include <qthreadpool.h>
+#endif
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -138,6 +156,206 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
 
 QT_BEGIN_NAMESPACE
 
+#ifdef QT_COMPILER_SUPPORTS_SHA
+/*
+    Block functions for processors with the SHA extensions. They take the
+    same state as the portable code above, so that a hash can be started on
+    one path and finished on the other.
+*/
+template <int Group>
+static inline QT_FUNCTION_TARGET(SHA)
+void sha1RoundsShaNi(__m128i &abcd, __m128i *e, __m128i *w)
+{
+    // four rounds; the message schedule for later groups is computed on the fly
+    __m128i &current = w[Group & 3];
+    if (Group == 0) {
+        e[0] = _mm_add_epi32(e[0], current);
+    } else {
+        e[Group & 1] = _mm_sha1nexte_epu32(e[Group & 1], current);
+    }
+    e[(Group + 1) & 1] = abcd;
+    if (Group >= 3 && Group <= 18)
+        w[(Group + 1) & 3] = _mm_sha1msg2_epu32(w[(Group + 1) & 3], current);
+    abcd = _mm_sha1rnds4_epu32(abcd, e[Group & 1], Group / 5);
+    if (Group >= 1 && Group <= 16)
+        w[(Group + 3) & 3] = _mm_sha1msg1_epu32(w[(Group + 3) & 3], current);
+    if (Group >= 2 && Group <= 17)
+        w[(Group + 2) & 3] = _mm_xor_si128(w[(Group + 2) & 3], current);
+}
+
+QT_FUNCTION_TARGET(SHA)
+static void sha1ProcessChunksShaNi(Sha1State *state, const unsigned char *data, qint64 chunks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0001020304050607), Q_INT64_C(0x08090a0b0c0d0e0f));
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&state->h0)), 0x1b);
+    __m128i e[2];
+    e[0] = _mm_set_epi32(state->h4, 0, 0, 0);
+    e[1] = _mm_setzero_si128();
+
+    for ( ; chunks; --chunks, data += 64) {
+        const __m128i savedAbcd = abcd;
+        const __m128i savedE = e[0];
+        __m128i w[4];
+        for (int i = 0; i < 4; ++i)
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i)), byteSwap);
+
+        sha1RoundsShaNi<0>(abcd, e, w);  sha1RoundsShaNi<1>(abcd, e, w);  sha1RoundsShaNi<2>(abcd, e, w);
+        sha1RoundsShaNi<3>(abcd, e, w);  sha1RoundsShaNi<4>(abcd, e, w);  sha1RoundsShaNi<5>(abcd, e, w);
+        sha1RoundsShaNi<6>(abcd, e, w);  sha1RoundsShaNi<7>(abcd, e, w);  sha1RoundsShaNi<8>(abcd, e, w);
+        sha1RoundsShaNi<9>(abcd, e, w);  sha1RoundsShaNi<10>(abcd, e, w); sha1RoundsShaNi<11>(abcd, e, w);
+        sha1RoundsShaNi<12>(abcd, e, w); sha1RoundsShaNi<13>(abcd, e, w); sha1RoundsShaNi<14>(abcd, e, w);
+        sha1RoundsShaNi<15>(abcd, e, w); sha1RoundsShaNi<16>(abcd, e, w); sha1RoundsShaNi<17>(abcd, e, w);
+        sha1RoundsShaNi<18>(abcd, e, w); sha1RoundsShaNi<19>(abcd, e, w);
+
+        e[0] = _mm_sha1nexte_epu32(e[0], savedE);
+        abcd = _mm_add_epi32(abcd, savedAbcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&state->h0), _mm_shuffle_epi32(abcd, 0x1b));
+    state->h4 = _mm_extract_epi32(e[0], 3);
+}
+#endif // QT_COMPILER_SUPPORTS_SHA
+
+// same as sha1Update(), but processes whole chunks with the SHA extensions if available
+static void sha1UpdateDispatch(Sha1State *state, const unsigned char *data, qint64 len)
+{
+#ifdef QT_COMPILER_SUPPORTS_SHA
+    if (qCpuHasFeature(SHA)) {
+        const int rest = int(state->messageSize & 63);
+        if (rest) {
+            const qint64 fill = qMin<qint64>(64 - rest, len);
+            sha1Update(state, data, fill);
+            data += fill;
+            len -= fill;
+        }
+        if (len >= 64) {
+            const qint64 chunks = len / 64;
+            sha1ProcessChunksShaNi(state, data, chunks);
+            state->messageSize += chunks * 64;
+            data += chunks * 64;
+            len -= chunks * 64;
+        }
+    }
+#endif
+    sha1Update(state, data, len);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#ifdef QT_COMPILER_SUPPORTS_SHA
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline QT_FUNCTION_TARGET(SHA)
+void sha256RoundsShaNi(__m128i &abef, __m128i &cdgh, __m128i w, int round)
+{
+    w = _mm_add_epi32(w, _mm_loadu_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants + round)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, w);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(w, 0x0e));
+}
+
+static inline QT_FUNCTION_TARGET(SHA)
+__m128i sha256ScheduleShaNi(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    return _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4)), w3);
+}
+
+QT_FUNCTION_TARGET(SHA)
+static void sha256ProcessBlocksShaNi(quint32 *hash, const unsigned char *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0c0d0e0f08090a0b), Q_INT64_C(0x0405060700010203));
+    const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0xb1);
+    const __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i savedAbef = abef;
+        const __m128i savedCdgh = cdgh;
+        __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), byteSwap);
+        __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), byteSwap);
+        __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), byteSwap);
+        __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), byteSwap);
+        sha256RoundsShaNi(abef, cdgh, w0, 0);
+        sha256RoundsShaNi(abef, cdgh, w1, 4);
+        sha256RoundsShaNi(abef, cdgh, w2, 8);
+        sha256RoundsShaNi(abef, cdgh, w3, 12);
+        for (int round = 16; round < 64; round += 16) {
+            w0 = sha256ScheduleShaNi(w0, w1, w2, w3);
+            sha256RoundsShaNi(abef, cdgh, w0, round);
+            w1 = sha256ScheduleShaNi(w1, w2, w3, w0);
+            sha256RoundsShaNi(abef, cdgh, w1, round + 4);
+            w2 = sha256ScheduleShaNi(w2, w3, w0, w1);
+            sha256RoundsShaNi(abef, cdgh, w2, round + 8);
+            w3 = sha256ScheduleShaNi(w3, w0, w1, w2);
+            sha256RoundsShaNi(abef, cdgh, w3, round + 12);
+        }
+        abef = _mm_add_epi32(abef, savedAbef);
+        cdgh = _mm_add_epi32(cdgh, savedCdgh);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif // QT_COMPILER_SUPPORTS_SHA
+
+/*
+    Replaces SHA224Input() and SHA256Input(), which copy their input one
+    byte at a time: whole blocks are processed straight from \a data.
+*/
+static void sha224_256Input(SHA256Context *context, const unsigned char *data, unsigned int length)
+{
+    if (context->Computed || context->Corrupted || !length) {
+        SHA256Input(context, data, length); // for the error handling
+        return;
+    }
+
+    if (context->Message_Block_Index) {
+        const unsigned int fill = qMin<unsigned int>(SHA256_Message_Block_Size - context->Message_Block_Index, length);
+        SHA256Input(context, data, fill);
+        data += fill;
+        length -= fill;
+    }
+
+    if (length >= SHA256_Message_Block_Size) {
+        const unsigned int blocks = length / SHA256_Message_Block_Size;
+        const quint64 oldBits = quint64(context->Length_High) << 32 | context->Length_Low;
+        const quint64 newBits = oldBits + quint64(blocks) * SHA256_Message_Block_Size * 8;
+        if (newBits < oldBits) {
+            context->Corrupted = shaInputTooLong;
+            return;
+        }
+        context->Length_High = quint32(newBits >> 32);
+        context->Length_Low = quint32(newBits);
+
+#ifdef QT_COMPILER_SUPPORTS_SHA
+        if (qCpuHasFeature(SHA)) {
+            sha256ProcessBlocksShaNi(context->Intermediate_Hash, data, blocks);
+        } else
+#endif
+        {
+            for (unsigned int i = 0; i < blocks; ++i) {
+                memcpy(context->Message_Block, data + i * SHA256_Message_Block_Size, SHA256_Message_Block_Size);
+                SHA224_256ProcessMessageBlock(context);
+            }
+        }
+        data += blocks * SHA256_Message_Block_Size;
+        length -= blocks * SHA256_Message_Block_Size;
+    }
+
+    SHA256Input(context, data, length);
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
 class QCryptographicHashPrivate
 {
 public:
@@ -265,7 +483,7 @@ void QCryptographicHash::addData(const char *data, int length)
 {
     switch (d->method) {
     case Sha1:
-        sha1Update(&d->sha1Context, (const unsigned char *)data, length);
+        sha1UpdateDispatch(&d->sha1Context, (const unsigned char *)data, length);
         break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
     default:
@@ -280,10 +498,10 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha224_256Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha224_256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha384:
         SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -329,11 +547,41 @@ bool QCryptographicHash::addData(QIODevice* device)
     if (!device->isOpen())
         return false;
 
-    char buffer[1024];
-    int length;
+#ifndef QT_BOOTSTRAPPED
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    int advisedHandle = -1;
+    qint64 advisedOffset = 0;
+#endif
+    if (QFileDevice *file = qobject_cast<QFileDevice *>(device)) {
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+        // ask for more read-ahead, since the rest of the file will be read in
+        // order; Linux applies this to the whole open file description, so it
+        // is reset once we are done
+        if (!file->isSequential() && file->handle() != -1) {
+            advisedHandle = file->handle();
+            advisedOffset = file->pos();
+            ::posix_fadvise(advisedHandle, advisedOffset, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
+    }
+#endif
 
-    while ((length = device->read(buffer,sizeof(buffer))) > 0)
-        addData(buffer,length);
+    // large reads keep the number of system calls down for big files
+    // without costing an allocation for small ones; files are read rather
+    // than mapped, since a mapping raises SIGBUS if the file shrinks under us
+    qint64 bufferSize = 256 * 1024;
+    if (!device->isSequential())
+        bufferSize = qBound<qint64>(1024, device->size() - device->pos(), bufferSize);
+    QVarLengthArray<char, 1024> buffer(static_cast<int>(bufferSize));
+    qint64 length;
+
+    while ((length = device->read(buffer.data(), buffer.size())) > 0)
+        addData(buffer.constData(), int(length));
+
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    if (advisedHandle != -1)
+        ::posix_fadvise(advisedHandle, advisedOffset, 0, POSIX_FADV_NORMAL);
+#endif
 
     return device->atEnd();
 }
@@ -438,4 +686,116 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+namespace {
+class QCryptographicHashBatch
+{
+public:
+    QCryptographicHashBatch(const QByteArrayList &data, QByteArray *results,
+                            QCryptographicHash::Algorithm method, int chunkSize)
+        : data(data), results(results), method(method), chunkSize(chunkSize), next(0)
+    {}
+
+    // hashes chunks of the list until none are left; called from several threads
+    void run()
+    {
+        QCryptographicHash hash(method);
+        const int count = data.size();
+        int begin;
+        while ((begin = next.fetchAndAddRelaxed(chunkSize)) < count) {
+            const int end = qMin(begin + chunkSize, count);
+            for (int i = begin; i < end; ++i) {
+                hash.reset();
+                hash.addData(data.at(i));
+                results[i] = hash.result();
+            }
+        }
+    }
+
+private:
+    const QByteArrayList &data;
+    QByteArray *results;
+    const QCryptographicHash::Algorithm method;
+    const int chunkSize;
+    QAtomicInt next;
+};
+
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_THREAD)
+class QCryptographicHashBatchRunnable : public QRunnable
+{
+public:
+    QCryptographicHashBatchRunnable(QCryptographicHashBatch *batch, QSemaphore *finished)
+        : batch(batch), finished(finished)
+    { setAutoDelete(false); }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        batch->run();
+        finished->release();
+    }
+
+private:
+    QCryptographicHashBatch *batch;
+    QSemaphore *finished;
+};
+#endif
+} // unnamed namespace
+
+/*!
+  \overload hash()
+  \since 5.6
+
+  Returns the hashes of each of the buffers in \a data using \a method, in
+  the same order.
+
+  The buffers are hashed independently of one another. When there is
+  enough data for it to pay off, the work is shared with idle threads of
+  QThreadPool::globalInstance(); the calling thread takes part as well, so
+  this function also completes when the pool is busy.
+*/
+QByteArrayList QCryptographicHash::hash(const QByteArrayList &data, Algorithm method)
+{
+    const int count = data.size();
+    if (!count)
+        return QByteArrayList();
+    QVector<QByteArray> results(count);
+
+    int helpers = 0;
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_THREAD)
+    // starting threads only pays off when there is a fair amount to hash
+    qint64 totalSize = 0;
+    for (int i = 0; i < count; ++i)
+        totalSize += data.at(i).size() + 64;
+    if (count > 1 && totalSize >= 256 * 1024)
+        helpers = qMin(QThread::idealThreadCount(), count) - 1;
+#endif
+
+    // hand out work in chunks small enough to balance, large enough to keep
+    // the threads from contending on the shared counter
+    const int chunkSize = qBound(1, count / ((helpers + 1) * 16), 256);
+    QCryptographicHashBatch batch(data, results.data(), method, chunkSize);
+
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_THREAD)
+    if (helpers > 0) {
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore finished;
+        QVarLengthArray<QCryptographicHashBatchRunnable *, 16> runnables;
+        for (int i = 0; pool && i < helpers; ++i) {
+            QCryptographicHashBatchRunnable *runnable = new QCryptographicHashBatchRunnable(&batch, &finished);
+            if (!pool->tryStart(runnable)) {
+                delete runnable;
+                break;
+            }
+            runnables.append(runnable);
+        }
+        batch.run();
+        finished.acquire(runnables.size());
+        qDeleteAll(runnables);
+        return results.toList();
+    }
+#endif
+
+    batch.run();
+    return results.toList();
+}
+
 QT_END_NAMESPACE
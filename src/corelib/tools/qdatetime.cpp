@@ -229,17 +229,6 @@ static ParsedRfcDateTime rfcDateImpl(const QString &s)
 }
 #endif // QT_NO_DATESTRING
 
-// Return offset in [+-]HH:mm format
-static QString toOffsetString(Qt::DateFormat format, int offset)
-{
-    return QString::asprintf("%c%02d%s%02d",
-                             offset >= 0 ? '+' : '-',
-                             qAbs(offset) / SECS_PER_HOUR,
-                             // Qt::ISODate puts : between the hours and minutes, but Qt:TextDate does not:
-                             format == Qt::TextDate ? "" : ":",
-                             (qAbs(offset) / 60) % 60);
-}
-
 // Parse offset in [+-]HH[[:]mm] format
 static int fromOffsetString(const QStringRef &offsetString, bool *valid)
 {
@@ -282,6 +271,149 @@ static int fromOffsetString(const QStringRef &offsetString, bool *valid)
     return sign * ((hour * 60) + minute) * 60;
 }
 
+/*
+    Fast paths for the ISO 8601 / RFC 3339 representation produced by
+    toString(Qt::ISODate), "yyyy-MM-ddTHH:mm:ss[.zzz][Z|+HH:mm]".  They write
+    and read the characters directly instead of going through the temporary
+    strings the general code creates.  The readers only accept input in this
+    exact shape and return false for anything else, leaving it to the more
+    lenient general parser.
+*/
+
+static inline uint isoCharValue(QChar c) { return c.unicode(); }
+static inline uint isoCharValue(char c) { return uchar(c); }
+
+template <typename Char>
+static inline bool readIsoDigits(const Char *str, int count, int *value)
+{
+    int result = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint digit = isoCharValue(str[i]) - '0';
+        if (digit > 9)
+            return false;
+        result = result * 10 + int(digit);
+    }
+    *value = result;
+    return true;
+}
+
+static inline QChar *writeIsoDigits(QChar *out, int value, int count)
+{
+    for (int i = count - 1; i >= 0; --i) {
+        out[i] = QLatin1Char('0' + value % 10);
+        value /= 10;
+    }
+    return out + count;
+}
+
+// Writes yyyy-MM-dd, the year must be in the range 0 to 9999
+static inline QChar *writeIsoDate(QChar *out, int year, int month, int day)
+{
+    out = writeIsoDigits(out, year, 4);
+    *out++ = QLatin1Char('-');
+    out = writeIsoDigits(out, month, 2);
+    *out++ = QLatin1Char('-');
+    return writeIsoDigits(out, day, 2);
+}
+
+// Writes HH:mm:ss
+static inline QChar *writeIsoTime(QChar *out, int hour, int minute, int second)
+{
+    out = writeIsoDigits(out, hour, 2);
+    *out++ = QLatin1Char(':');
+    out = writeIsoDigits(out, minute, 2);
+    *out++ = QLatin1Char(':');
+    return writeIsoDigits(out, second, 2);
+}
+
+// Writes [+-]HH:mm, the offset must be less than 100 hours
+static inline QChar *writeIsoOffset(QChar *out, int offset)
+{
+    *out++ = QLatin1Char(offset >= 0 ? '+' : '-');
+    out = writeIsoDigits(out, qAbs(offset) / SECS_PER_HOUR, 2);
+    *out++ = QLatin1Char(':');
+    return writeIsoDigits(out, (qAbs(offset) / 60) % 60, 2);
+}
+
+template <typename Char>
+static bool fastFromIsoDateTime(const Char *str, int size, QDateTime *result)
+{
+    // yyyy-MM-dd
+    int year, month, day;
+    if (size < 10 || isoCharValue(str[4]) != '-' || isoCharValue(str[7]) != '-'
+        || !readIsoDigits(str, 4, &year) || !readIsoDigits(str + 5, 2, &month)
+        || !readIsoDigits(str + 8, 2, &day) || year == 0) {
+        return false;
+    }
+    const QDate date(year, month, day);
+    if (!date.isValid())
+        return false;
+    if (size == 10) {
+        *result = QDateTime(date);
+        return true;
+    }
+
+    // THH:mm:ss
+    int hour, minute, second;
+    if (size < 19 || (isoCharValue(str[10]) != 'T' && isoCharValue(str[10]) != ' ')
+        || isoCharValue(str[13]) != ':' || isoCharValue(str[16]) != ':'
+        || !readIsoDigits(str + 11, 2, &hour) || !readIsoDigits(str + 14, 2, &minute)
+        || !readIsoDigits(str + 17, 2, &second) || hour == 24) {
+        return false;
+    }
+    int pos = 19;
+
+    // optional fraction of a second; like the general parser, only the first
+    // four digits are taken into account
+    int msec = 0;
+    if (pos < size && (isoCharValue(str[pos]) == '.' || isoCharValue(str[pos]) == ',')) {
+        const int fractionStart = ++pos;
+        while (pos < size && isoCharValue(str[pos]) - '0' <= 9)
+            ++pos;
+        const int digits = qMin(pos - fractionStart, 4);
+        int fraction;
+        if (!digits || !readIsoDigits(str + fractionStart, digits, &fraction))
+            return false;
+        const double secondFraction(fraction / (std::pow(double(10), digits)));
+        msec = qMin(qRound(secondFraction * 1000.0), 999);
+    }
+
+    const QTime time(hour, minute, second, msec);
+    if (!time.isValid())
+        return false;
+
+    // optional Z or [+-]HH:mm
+    if (pos == size) {
+        *result = QDateTime(date, time, Qt::LocalTime);
+        return true;
+    }
+    const uint c = isoCharValue(str[pos]);
+    if (c == 'Z' && pos + 1 == size) {
+        *result = QDateTime(date, time, Qt::UTC);
+        return true;
+    }
+    int offsetHour, offsetMinute;
+    if ((c == '+' || c == '-') && pos + 6 == size && isoCharValue(str[pos + 3]) == ':'
+        && readIsoDigits(str + pos + 1, 2, &offsetHour)
+        && readIsoDigits(str + pos + 4, 2, &offsetMinute) && offsetMinute <= 59) {
+        const int offset = (c == '-' ? -1 : 1) * (offsetHour * 60 + offsetMinute) * 60;
+        *result = QDateTime(date, time, Qt::OffsetFromUTC, offset);
+        return true;
+    }
+    return false;
+}
+
+// Return offset in [+-]HH:mm format
+static QString toOffsetString(Qt::DateFormat format, int offset)
+{
+    return QString::asprintf("%c%02d%s%02d",
+                             offset >= 0 ? '+' : '-',
+                             qAbs(offset) / SECS_PER_HOUR,
+                             // Qt::ISODate puts : between the hours and minutes, but Qt:TextDate does not:
+                             format == Qt::TextDate ? "" : ":",
+                             (qAbs(offset) / 60) % 60);
+}
+
 /*****************************************************************************
   QDate member functions
  *****************************************************************************/
@@ -781,10 +913,11 @@ static QString toStringTextDate(QDate date)
 static QString toStringIsoDate(qint64 jd)
 {
     const ParsedDate pd = getDateFromJulianDay(jd);
-    if (pd.year >= 0 && pd.year <= 9999)
-        return QString::asprintf("%04d-%02d-%02d", pd.year, pd.month, pd.day);
-    else
+    if (pd.year < 0 || pd.year > 9999)
         return QString();
+    QString result(10, Qt::Uninitialized);
+    writeIsoDate(result.data(), pd.year, pd.month, pd.day);
+    return result;
 }
 
 /*!
@@ -1582,8 +1715,11 @@ QString QTime::toString(Qt::DateFormat format) const
     case Qt::RFC2822Date:
     case Qt::ISODate:
     case Qt::TextDate:
-    default:
-        return QString::asprintf("%02d:%02d:%02d", hour(), minute(), second());
+    default: {
+        QString result(8, Qt::Uninitialized);
+        writeIsoTime(result.data(), hour(), minute(), second());
+        return result;
+    }
     }
 }
 
@@ -3551,17 +3687,31 @@ QString QDateTime::toString(Qt::DateFormat format) const
         const QPair<QDate, QTime> p = d->getDateTime();
         const QDate &dt = p.first;
         const QTime &tm = p.second;
-        buf = dt.toString(Qt::ISODate);
-        if (buf.isEmpty())
+        const ParsedDate pd = getDateFromJulianDay(dt.toJulianDay());
+        if (pd.year < 0 || pd.year > 9999)
             return QString();   // failed to convert
-        buf += QLatin1Char('T');
-        buf += tm.toString(Qt::ISODate);
+
+        const bool fastOffset = qAbs(d->m_offsetFromUtc) < 100 * SECS_PER_HOUR;
+        int size = 19;
+        if (d->m_spec == Qt::UTC)
+            size += 1;
+        else if (d->m_spec == Qt::OffsetFromUTC && fastOffset)
+            size += 6;
+
+        // write everything into a single allocation
+        buf.resize(size);
+        QChar *out = writeIsoDate(buf.data(), pd.year, pd.month, pd.day);
+        *out++ = QLatin1Char('T');
+        out = writeIsoTime(out, tm.hour(), tm.minute(), tm.second());
         switch (d->m_spec) {
         case Qt::UTC:
-            buf += QLatin1Char('Z');
+            *out = QLatin1Char('Z');
             break;
         case Qt::OffsetFromUTC:
-            buf += toOffsetString(Qt::ISODate, d->m_offsetFromUtc);
+            if (fastOffset)
+                writeIsoOffset(out, d->m_offsetFromUtc);
+            else
+                buf += toOffsetString(Qt::ISODate, d->m_offsetFromUtc);
             break;
         default:
             break;
@@ -4364,6 +4514,10 @@ QDateTime QDateTime::fromString(const QString& string, Qt::DateFormat format)
         if (size < 10)
             return QDateTime();
 
+        QDateTime fastResult;
+        if (fastFromIsoDateTime(string.constData(), size, &fastResult))
+            return fastResult;
+
         QStringRef isoString(&string);
         Qt::TimeSpec spec = Qt::LocalTime;
 
@@ -4529,6 +4683,29 @@ QDateTime QDateTime::fromString(const QString& string, Qt::DateFormat format)
     return QDateTime();
 }
 
+/*!
+    \since 5.6
+    \overload
+
+    Returns the QDateTime represented by the Latin-1 \a string, using the
+    \a format given, or an invalid datetime if this is not possible.
+
+    For Qt::ISODate, the common "yyyy-MM-ddTHH:mm:ss[.zzz][Z|+HH:mm]" form
+    is parsed directly from \a string without converting it to a QString
+    first, which makes this overload well suited for reading timestamps
+    from log files or CSV data. Since ISO 8601 date-times are plain ASCII,
+    UTF-8 encoded input can be passed as well.
+*/
+QDateTime QDateTime::fromString(QLatin1String string, Qt::DateFormat format)
+{
+    if (format == Qt::ISODate) {
+        QDateTime result;
+        if (fastFromIsoDateTime(string.data(), string.size(), &result))
+            return result;
+    }
+    return fromString(QString(string), format);
+}
+
 /*!
     \fn QDateTime::fromString(const QString &string, const QString &format)
 
@@ -0,0 +1,837 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qendian.h>
+
+#include <new>
+#include <string.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#include <utility>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define QT_FLATHASH_SSE2
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The table is an array of slots and an array of control bytes, one per
+    slot, in a single allocation. A control byte is Empty, Deleted or, for
+    a slot that holds an item, the top seven bits of the item's hash. The
+    control bytes are followed by a sentinel that looks like a full slot, so
+    that iterators need no bounds check.
+
+    Lookups probe whole groups of GroupWidth control bytes at a time. The
+    group width is the same whether or not SIMD instructions are available,
+    so that the layout doesn't depend on compiler flags.
+*/
+struct Q_CORE_EXPORT QFlatHashData
+{
+    enum {
+        Empty = -128,
+        Deleted = -2,
+        GroupWidth = 16
+    };
+
+    QtPrivate::RefCount ref;
+    int size;
+    int capacity;
+    int growthLeft;
+    uint seed;
+    uint strictAlignment;
+    signed char *ctrl;
+    void *nodes;
+
+    static QFlatHashData *allocate(int capacity, int slotSize, int slotAlign);
+    static void deallocate(QFlatHashData *d);
+
+    static inline int maxLoad(int capacity) { return capacity - capacity / 8; }
+    static inline int capacityForSize(int size)
+    {
+        int capacity = GroupWidth;
+        while (maxLoad(capacity) < size)
+            capacity *= 2;
+        return capacity;
+    }
+
+    static inline uint mix(uint h)
+    {
+        h ^= h >> 16;
+        h *= 0x85ebca6bU;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return h;
+    }
+    static inline signed char tag(uint h) { return static_cast<signed char>(h >> 25); }
+
+    static const QFlatHashData shared_null;
+};
+
+struct QFlatHashGroup
+{
+#ifdef QT_FLATHASH_SSE2
+    explicit inline QFlatHashGroup(const signed char *pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+    inline uint match(signed char tag) const
+    { return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl))); }
+    inline uint matchEmpty() const { return match(QFlatHashData::Empty); }
+    inline uint matchEmptyOrDeleted() const { return uint(_mm_movemask_epi8(ctrl)); }
+
+private:
+    __m128i ctrl;
+#else
+    explicit inline QFlatHashGroup(const signed char *pos)
+        : lo(qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(pos))),
+          hi(qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(pos) + 8)) {}
+
+    // may report false positives, but only for slots that hold an item
+    inline uint match(signed char tag) const
+    { return toMask(matchZero(lo ^ (lsbs() * uchar(tag))), matchZero(hi ^ (lsbs() * uchar(tag)))); }
+    inline uint matchEmpty() const
+    { return toMask(lo & ~(lo << 1) & msbs(), hi & ~(hi << 1) & msbs()); }
+    inline uint matchEmptyOrDeleted() const { return toMask(lo & msbs(), hi & msbs()); }
+
+private:
+    static inline quint64 lsbs() { return Q_UINT64_C(0x0101010101010101); }
+    static inline quint64 msbs() { return Q_UINT64_C(0x8080808080808080); }
+    static inline quint64 matchZero(quint64 x) { return (x - lsbs()) & ~x & msbs(); }
+    static inline uint gather(quint64 m) { return uint(((m >> 7) * Q_UINT64_C(0x0102040810204080)) >> 56); }
+    static inline uint toMask(quint64 l, quint64 h) { return gather(l) | (gather(h) << 8); }
+
+    quint64 lo;
+    quint64 hi;
+#endif
+};
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    Key key;
+    T val;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), val(value0) {}
+    inline T &value() { return val; }
+    inline const T &value() const { return val; }
+};
+
+template <class Key>
+struct QFlatHashNode<Key, QHashDummyValue>
+{
+    Key key;
+
+    inline QFlatHashNode(const Key &key0, const QHashDummyValue &) : key(key0) {}
+    inline QHashDummyValue &value() const { return dummy; }
+
+    static QHashDummyValue dummy;
+};
+
+template <class Key>
+QHashDummyValue QFlatHashNode<Key, QHashDummyValue>::dummy;
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+
+    enum {
+        NodeIsComplex = QTypeInfo<Key>::isComplex || (QTypeInfo<T>::isComplex && !QTypeInfo<T>::isDummy),
+        NodeIsStatic = QTypeInfo<Key>::isStatic || QTypeInfo<T>::isStatic
+    };
+
+    QFlatHashData *d;
+
+    inline Node *nodes() const { return static_cast<Node *>(d->nodes); }
+    static inline uint hashOf(const Key &key, uint seed) { return QFlatHashData::mix(qHash(key, seed)); }
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null)) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null))
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    inline QFlatHash(const QFlatHash &other) : d(other.d) { d->ref.ref(); }
+    inline ~QFlatHash() { if (!d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW
+        : d(other.d) { other.d = const_cast<QFlatHashData *>(&QFlatHashData::shared_null); }
+    inline QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    inline void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const { return d->size; }
+    inline bool isEmpty() const { return d->size == 0; }
+
+    inline int capacity() const { return QFlatHashData::maxLoad(d->capacity); }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d->ref.isShared(); }
+    inline bool isSharedWith(const QFlatHash &other) const { return d == other.d; }
+
+    void clear();
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    inline bool contains(const Key &key) const { return indexOf(key) >= 0; }
+    inline int count(const Key &key) const { return indexOf(key) >= 0 ? 1 : 0; }
+    inline int count() const { return d->size; }
+
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        const signed char *c;
+        Node *n;
+
+        inline iterator(const signed char *ctrl, Node *node) : c(ctrl), n(node) {}
+        inline void skipFree() { while (*c < 0) { ++c; ++n; } }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : c(Q_NULLPTR), n(Q_NULLPTR) { }
+
+        inline const Key &key() const { return n->key; }
+        inline T &value() const { return n->value(); }
+        inline T &operator*() const { return n->value(); }
+        inline T *operator->() const { return &n->value(); }
+        inline bool operator==(const iterator &o) const { return n == o.n; }
+        inline bool operator!=(const iterator &o) const { return n != o.n; }
+        inline bool operator==(const const_iterator &o) const { return n == o.n; }
+        inline bool operator!=(const const_iterator &o) const { return n != o.n; }
+
+        inline iterator &operator++() { ++c; ++n; skipFree(); return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const signed char *c;
+        const Node *n;
+
+        inline const_iterator(const signed char *ctrl, const Node *node) : c(ctrl), n(node) {}
+        inline void skipFree() { while (*c < 0) { ++c; ++n; } }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : c(Q_NULLPTR), n(Q_NULLPTR) { }
+        inline const_iterator(const iterator &o) : c(o.c), n(o.n) { }
+
+        inline const Key &key() const { return n->key; }
+        inline const T &value() const { return n->value(); }
+        inline const T &operator*() const { return n->value(); }
+        inline const T *operator->() const { return &n->value(); }
+        inline bool operator==(const const_iterator &o) const { return n == o.n; }
+        inline bool operator!=(const const_iterator &o) const { return n != o.n; }
+
+        inline const_iterator &operator++() { ++c; ++n; skipFree(); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iteratorAt(0); }
+    inline const_iterator begin() const { return constIteratorAt(0); }
+    inline const_iterator cbegin() const { return constIteratorAt(0); }
+    inline const_iterator constBegin() const { return constIteratorAt(0); }
+    inline iterator end() { detach(); return iterator(d->ctrl + d->capacity, nodes() + d->capacity); }
+    inline const_iterator end() const { return constEnd(); }
+    inline const_iterator cend() const { return constEnd(); }
+    inline const_iterator constEnd() const
+    { return const_iterator(d->ctrl + d->capacity, nodes() + d->capacity); }
+
+    iterator erase(const_iterator it);
+    inline iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    iterator insert(const Key &key, const T &value);
+    iterator find(const Key &key);
+    inline const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    void detach_helper();
+    void rehash(int newCapacity);
+    static void freeData(QFlatHashData *x);
+
+    inline iterator iteratorAt(int i)
+    { iterator it(d->ctrl + i, nodes() + i); it.skipFree(); return it; }
+    inline const_iterator constIteratorAt(int i) const
+    { const_iterator it(d->ctrl + i, nodes() + i); it.skipFree(); return it; }
+
+    inline int indexOf(const Key &key) const
+    { return d->size ? findIndex(key, hashOf(key, d->seed)) : -1; }
+    int findIndex(const Key &key, uint h) const;
+    int findIndex(const Key &key, uint h, int *freeSlot) const;
+    static int insertIndex(const QFlatHashData *x, uint h);
+    Node *createNode(uint h, int slot, const Key &key, const T &value);
+    void eraseAt(int i);
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::operator=(const QFlatHash &other)
+{
+    if (d != other.d) {
+        QFlatHashData *o = other.d;
+        o->ref.ref();
+        if (!d->ref.deref())
+            freeData(d);
+        d = o;
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const int i = other.indexOf(it.key());
+        if (i < 0 || !(other.nodes()[i].value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int newCapacity = QFlatHashData::capacityForSize(qMax(asize, d->size));
+    if (newCapacity > d->capacity)
+        rehash(newCapacity);
+    else
+        detach();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (d->size == 0) {
+        clear();
+        return;
+    }
+    const int newCapacity = QFlatHashData::capacityForSize(d->size);
+    if (newCapacity < d->capacity)
+        rehash(newCapacity);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::clear()
+{
+    *this = QFlatHash();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (NodeIsComplex) {
+        Node *s = static_cast<Node *>(x->nodes);
+        for (int i = 0; i < x->capacity; ++i) {
+            if (x->ctrl[i] >= 0)
+                s[i].~Node();
+        }
+    }
+    QFlatHashData::deallocate(x);
+}
+
+/*
+    Copies the table slot by slot, so that indexes into it stay valid
+    across a detach().
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    const int newCapacity = d->capacity ? d->capacity : int(QFlatHashData::GroupWidth);
+    QFlatHashData *x = QFlatHashData::allocate(newCapacity, sizeof(Node), Q_ALIGNOF(Node));
+    if (d->capacity) {
+        x->seed = d->seed;
+        if (NodeIsComplex) {
+            Node *from = nodes();
+            Node *to = static_cast<Node *>(x->nodes);
+            QT_TRY {
+                for (int i = 0; i < d->capacity; ++i) {
+                    if (d->ctrl[i] >= 0) {
+                        new (to + i) Node(from[i]);
+                        x->ctrl[i] = d->ctrl[i];
+                    }
+                }
+            } QT_CATCH(...) {
+                freeData(x);
+                QT_RETHROW;
+            }
+        } else {
+            ::memcpy(x->nodes, d->nodes, size_t(d->capacity) * sizeof(Node));
+        }
+        ::memcpy(x->ctrl, d->ctrl, d->capacity);
+        x->size = d->size;
+        x->growthLeft = d->growthLeft;
+    }
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int newCapacity)
+{
+    Q_ASSERT(QFlatHashData::maxLoad(newCapacity) >= d->size);
+    QFlatHashData *x = QFlatHashData::allocate(newCapacity, sizeof(Node), Q_ALIGNOF(Node));
+    if (d->capacity)
+        x->seed = d->seed;
+
+    // items of movable types are relocated with memcpy if nobody else sees them
+    const bool relocate = !NodeIsStatic && !d->ref.isShared();
+    Node *from = nodes();
+    Node *to = static_cast<Node *>(x->nodes);
+    QT_TRY {
+        for (int i = 0; i < d->capacity; ++i) {
+            if (d->ctrl[i] < 0)
+                continue;
+            const uint h = hashOf(from[i].key, x->seed);
+            const int slot = insertIndex(x, h);
+            if (relocate)
+                ::memcpy(static_cast<void *>(to + slot), static_cast<const void *>(from + i), sizeof(Node));
+            else
+                new (to + slot) Node(from[i]);
+            x->ctrl[slot] = QFlatHashData::tag(h);
+        }
+    } QT_CATCH(...) {
+        if (relocate)
+            QFlatHashData::deallocate(x);
+        else
+            freeData(x);
+        QT_RETHROW;
+    }
+    x->size = d->size;
+    x->growthLeft -= d->size;
+
+    if (relocate)
+        QFlatHashData::deallocate(d);
+    else if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key, uint h) const
+{
+    const uint groupMask = uint(d->capacity / QFlatHashData::GroupWidth) - 1;
+    const signed char tag = QFlatHashData::tag(h);
+    const Node *s = nodes();
+    uint g = h & groupMask;
+
+    // triangular probing over a power of two number of groups visits all of them
+    for (uint step = 1; ; ++step) {
+        const int base = int(g) * QFlatHashData::GroupWidth;
+        const QFlatHashGroup group(d->ctrl + base);
+        for (uint m = group.match(tag); m; m &= m - 1) {
+            const int i = base + int(qCountTrailingZeroBits(m));
+            if (s[i].key == key)
+                return i;
+        }
+        if (group.matchEmpty())
+            return -1;
+        g = (g + step) & groupMask;
+    }
+}
+
+/*
+    Like the above, but also finds the first free slot on the probe
+    sequence of \a h, where the key would be inserted.
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key, uint h, int *freeSlot) const
+{
+    const uint groupMask = uint(d->capacity / QFlatHashData::GroupWidth) - 1;
+    const signed char tag = QFlatHashData::tag(h);
+    const Node *s = nodes();
+    uint g = h & groupMask;
+    *freeSlot = -1;
+
+    for (uint step = 1; ; ++step) {
+        const int base = int(g) * QFlatHashData::GroupWidth;
+        const QFlatHashGroup group(d->ctrl + base);
+        for (uint m = group.match(tag); m; m &= m - 1) {
+            const int i = base + int(qCountTrailingZeroBits(m));
+            if (s[i].key == key)
+                return i;
+        }
+        if (*freeSlot < 0) {
+            const uint m = group.matchEmptyOrDeleted();
+            if (m)
+                *freeSlot = base + int(qCountTrailingZeroBits(m));
+        }
+        if (group.matchEmpty())
+            return -1;
+        g = (g + step) & groupMask;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::insertIndex(const QFlatHashData *x, uint h)
+{
+    const uint groupMask = uint(x->capacity / QFlatHashData::GroupWidth) - 1;
+    uint g = h & groupMask;
+    for (uint step = 1; ; ++step) {
+        const int base = int(g) * QFlatHashData::GroupWidth;
+        const uint m = QFlatHashGroup(x->ctrl + base).matchEmptyOrDeleted();
+        if (m)
+            return base + int(qCountTrailingZeroBits(m));
+        g = (g + step) & groupMask;
+    }
+}
+
+/*
+    Creates a node for a key that isn't in the hash yet. \a slot is the
+    first free slot on the key's probe sequence, as found by findIndex().
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::Node *
+QFlatHash<Key, T>::createNode(uint h, int slot, const Key &key, const T &value)
+{
+    if (d->growthLeft == 0 && d->ctrl[slot] == QFlatHashData::Empty) {
+        // the key or the value may live in this hash, so copy them before moving the items
+        const Key copiedKey(key);
+        const T copiedValue(value);
+        if (qint64(d->size) * 32 <= qint64(d->capacity) * 25)
+            rehash(d->capacity); // enough deleted slots to reclaim, don't grow
+        else
+            rehash(d->capacity * 2);
+        return createNode(h, insertIndex(d, h), copiedKey, copiedValue);
+    }
+
+    Node *n = new (nodes() + slot) Node(key, value);
+    if (d->ctrl[slot] == QFlatHashData::Empty)
+        --d->growthLeft;
+    d->ctrl[slot] = QFlatHashData::tag(h);
+    ++d->size;
+    return n;
+}
+
+/*
+    A slot can be marked empty again if its group has an empty slot,
+    since then no probe sequence ever continued past this group.
+*/
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(int i)
+{
+    nodes()[i].~Node();
+    const int base = i & ~(int(QFlatHashData::GroupWidth) - 1);
+    if (QFlatHashGroup(d->ctrl + base).matchEmpty()) {
+        d->ctrl[i] = QFlatHashData::Empty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[i] = QFlatHashData::Deleted;
+    }
+    --d->size;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    const int i = indexOf(akey);
+    return i < 0 ? T() : nodes()[i].value();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    const int i = indexOf(akey);
+    return i < 0 ? adefaultValue : nodes()[i].value();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    detach();
+
+    const uint h = hashOf(akey, d->seed);
+    int slot;
+    const int i = findIndex(akey, h, &slot);
+    if (i >= 0)
+        return nodes()[i].value();
+    return createNode(h, slot, akey, T())->value();
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &akey) const
+{
+    return value(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &akey,
+                                                                                const T &avalue)
+{
+    detach();
+
+    const uint h = hashOf(akey, d->seed);
+    int slot;
+    int i = findIndex(akey, h, &slot);
+    if (i >= 0) {
+        if (!QTypeInfo<T>::isDummy) // Insert from QFlatSet.
+            nodes()[i].value() = avalue;
+    } else {
+        i = int(createNode(h, slot, akey, avalue) - nodes());
+    }
+    return iterator(d->ctrl + i, nodes() + i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &akey)
+{
+    const int i = indexOf(akey);
+    if (i < 0)
+        return 0;
+    detach(); // keeps the indexes
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &akey)
+{
+    const int i = indexOf(akey);
+    if (i < 0)
+        return T();
+    detach();
+    T t = qMove(nodes()[i].value());
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.n >= nodes() && it.n < nodes() + d->capacity,
+               "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    const int i = int(it.n - nodes());
+    detach();
+    eraseAt(i);
+    return iteratorAt(i + 1);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    const int i = indexOf(akey);
+    if (i < 0)
+        return end();
+    detach();
+    return iterator(d->ctrl + i, nodes() + i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    const int i = indexOf(akey);
+    if (i < 0)
+        return constEnd();
+    return const_iterator(d->ctrl + i, nodes() + i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class T>
+class QFlatSet
+{
+    typedef QFlatHash<T, QHashDummyValue> Hash;
+
+public:
+    inline QFlatSet() {}
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatSet(std::initializer_list<T> list)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<T>::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(*it);
+    }
+#endif
+    inline void swap(QFlatSet<T> &other) { q_hash.swap(other.q_hash); }
+
+    inline bool operator==(const QFlatSet<T> &other) const
+        { return q_hash == other.q_hash; }
+    inline bool operator!=(const QFlatSet<T> &other) const
+        { return q_hash != other.q_hash; }
+
+    inline int size() const { return q_hash.size(); }
+    inline bool isEmpty() const { return q_hash.isEmpty(); }
+
+    inline int capacity() const { return q_hash.capacity(); }
+    inline void reserve(int size) { q_hash.reserve(size); }
+    inline void squeeze() { q_hash.squeeze(); }
+
+    inline void detach() { q_hash.detach(); }
+    inline bool isDetached() const { return q_hash.isDetached(); }
+
+    inline void clear() { q_hash.clear(); }
+
+    inline bool remove(const T &value) { return q_hash.remove(value) != 0; }
+    inline bool contains(const T &value) const { return q_hash.contains(value); }
+
+    class const_iterator
+    {
+        typename Hash::const_iterator i;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() {}
+        inline const_iterator(typename Hash::const_iterator o) : i(o) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+        inline const_iterator &operator++() { ++i; return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+
+        friend class QFlatSet<T>;
+    };
+    typedef const_iterator iterator;
+
+    // STL style
+    inline const_iterator begin() const { return q_hash.begin(); }
+    inline const_iterator cbegin() const { return q_hash.begin(); }
+    inline const_iterator constBegin() const { return q_hash.constBegin(); }
+    inline const_iterator end() const { return q_hash.end(); }
+    inline const_iterator cend() const { return q_hash.end(); }
+    inline const_iterator constEnd() const { return q_hash.constEnd(); }
+
+    inline const_iterator erase(const_iterator it)
+        { return static_cast<typename Hash::const_iterator>(q_hash.erase(it.i)); }
+
+    inline const_iterator insert(const T &value)
+        { return static_cast<typename Hash::const_iterator>(q_hash.insert(value, QHashDummyValue())); }
+    inline const_iterator find(const T &value) const { return q_hash.constFind(value); }
+    inline const_iterator constFind(const T &value) const { return q_hash.constFind(value); }
+
+    QList<T> values() const { return q_hash.keys(); }
+
+    // STL compatibility
+    typedef T key_type;
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    Hash q_hash;
+};
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
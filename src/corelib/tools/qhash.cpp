@@ -41,6 +41,7 @@
 #include <stdlib.h>
 
 #include "qhash.h"
+#include "qflathash.h"
 
 #ifdef truncate
 #undef truncate
@@ -48,6 +49,7 @@
 
 #include <qbitarray.h>
 #include <qstring.h>
+#include <qutf8stringview.h>
 #include <qglobal.h>
 #include <qbytearray.h>
 #include <qdatetime.h>
@@ -207,6 +209,11 @@ uint qHash(QLatin1String key, uint seed) Q_DECL_NOTHROW
     return hash(reinterpret_cast<const uchar *>(key.data()), key.size(), seed);
 }
 
+uint qHash(QUtf8StringView key, uint seed) Q_DECL_NOTHROW
+{
+    return hash(reinterpret_cast<const uchar *>(key.data()), key.size(), seed);
+}
+
 /*!
     \internal
 
@@ -654,6 +661,65 @@ void QHashData::checkSanity()
 }
 #endif
 
+/*
+    The empty table has no slots, only the sentinel control byte.
+*/
+static const signed char qt_flathash_empty_ctrl[1] = { 0 };
+
+const QFlatHashData QFlatHashData::shared_null = {
+    Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 0, 0, false,
+    const_cast<signed char *>(qt_flathash_empty_ctrl), 0
+};
+
+/*!
+    \internal
+
+    Allocates a table with \a capacity slots of \a slotSize bytes, all of
+    them empty, together with its control bytes.
+*/
+QFlatHashData *QFlatHashData::allocate(int capacity, int slotSize, int slotAlign)
+{
+    Q_ASSERT(capacity >= GroupWidth && (capacity & (capacity - 1)) == 0);
+
+    const size_t headerSize = (sizeof(QFlatHashData) + slotAlign - 1) & ~size_t(slotAlign - 1);
+    if (size_t(capacity) > (size_t(-1) - headerSize - 1) / (size_t(slotSize) + 1))
+        qBadAlloc();
+    const size_t slotsSize = size_t(capacity) * slotSize;
+    const size_t allocSize = headerSize + slotsSize + capacity + 1;
+
+    qt_initialize_qhash_seed(); // may throw
+
+    const bool strict = slotAlign > 8;
+    void *block = strict ? qMallocAligned(allocSize, slotAlign) : ::malloc(allocSize);
+    Q_CHECK_PTR(block);
+
+    QFlatHashData *d = static_cast<QFlatHashData *>(block);
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->capacity = capacity;
+    d->growthLeft = maxLoad(capacity);
+    d->seed = uint(qt_qhash_seed.load());
+    d->strictAlignment = strict;
+    d->nodes = static_cast<char *>(block) + headerSize;
+    d->ctrl = reinterpret_cast<signed char *>(static_cast<char *>(d->nodes) + slotsSize);
+    memset(d->ctrl, Empty, capacity);
+    d->ctrl[capacity] = 0;
+    return d;
+}
+
+/*!
+    \internal
+
+    Frees the memory of \a d, without destroying any items.
+*/
+void QFlatHashData::deallocate(QFlatHashData *d)
+{
+    if (d->strictAlignment)
+        qFreeAligned(d);
+    else
+        ::free(d);
+}
+
 /*!
     \fn uint qHash(const QPair<T1, T2> &key, uint seed = 0)
     \since 5.0
@@ -919,6 +985,14 @@ uint qHash(long double key, uint seed) Q_DECL_NOTHROW
     Returns the hash value for the \a key, using \a seed to seed the calculation.
 */
 
+/*! \fn uint qHash(QUtf8StringView key, uint seed = 0)
+    \relates QHash
+    \since 5.6
+
+    Returns the hash value for the \a key, using \a seed to seed the calculation.
+    The result is the same as for a QByteArray holding the same bytes.
+*/
+
 /*! \fn uint qHash(const T *key, uint seed = 0)
     \relates QHash
     \since 5.0
@@ -2722,6 +2722,28 @@ QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
                           d, precision, form, width, flags);
 }
 
+// The padding doubleToString() applies to the digits of a number.
+static PrecisionMode doublePrecisionMode(QLocaleData::DoubleForm form, int precision,
+                                         unsigned flags)
+{
+    if (precision == QLocale::FloatingPointShortest)
+        return PMChopTrailingZeros;
+    if (form == QLocaleData::DFSignificantDigits)
+        return (flags & QLocaleData::Alternate) ? PMSignificantDigits : PMChopTrailingZeros;
+    return PMDecimalDigits;
+}
+
+// Whether doubleToString() writes a number with the given digits in exponent form.
+static bool doubleUsesExponentForm(QLocaleData::DoubleForm form, int precision,
+                                   int length, int decpt)
+{
+    if (form != QLocaleData::DFSignificantDigits)
+        return form == QLocaleData::DFExponent;
+    if (precision == QLocale::FloatingPointShortest)
+        precision = QLocaleData::DoubleMaxSignificant;
+    return decpt != length && (decpt <= -4 || decpt > precision);
+}
+
 QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const QChar minus,
                                     const QChar exponential, const QChar group, const QChar decimal,
                                     double d, int precision, DoubleForm form, int width, unsigned flags)
@@ -2731,6 +2753,17 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
     if (width == -1)
         width = 0;
 
+    // Unless there is padding or grouping to do, numbers in the C locale's
+    // characters are built in a buffer and only then turned into a QString.
+    if (_zero.unicode() == '0' && decimal.unicode() == '.' && exponential.unicode() == 'e'
+            && plus.unicode() == '+' && minus.unicode() == '-'
+            && !(flags & (ZeroPadded | ThousandsGroup))) {
+        char buf[CLocaleDoubleBufferSize];
+        const int length = doubleToCLocale(buf, sizeof(buf), d, precision, form, flags);
+        if (length >= 0)
+            return QString::fromLatin1(buf, length);
+    }
+
     bool negative = false;
     bool special_number = false; // nan, +/-inf
     QString num_str;
@@ -2747,36 +2780,20 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
 
     // Handle normal numbers
     if (!special_number) {
-        int decpt, sign;
-        QString digits;
-
-        int mode;
-        if (form == DFDecimal)
-            mode = 3;
-        else
-            mode = 2;
-
-        /* This next bit is a bit quirky. In DFExponent form, the precision
-           is the number of digits after decpt. So that would suggest using
-           mode=3 for qdtoa. But qdtoa behaves strangely when mode=3 and
-           precision=0. So we get around this by using mode=2 and reasoning
-           that we want precision+1 significant digits, since the decimal
-           point in this mode is always after the first digit. */
-        int pr = precision;
-        if (form == DFExponent)
-            ++pr;
-
-        char *rve = 0;
-        char *buff = 0;
-        QT_TRY {
-            digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
-        } QT_CATCH(...) {
-            if (buff != 0)
-                free(buff);
-            QT_RETHROW;
+        int bufSize = DoubleMaxSignificant + 1;
+        if (form == DFDecimal && precision != QLocale::FloatingPointShortest) {
+            // optimize for numbers smaller than 512k
+            bufSize = qMax(bufSize, 1 + precision
+                           + ((d > (1 << 19) || d < -(1 << 19)) ? DoubleMaxDigitsBeforeDecimal : 6));
+        } else {
+            // DFExponent form needs precision + 1 digits
+            bufSize = qMax(bufSize, precision + 2);
         }
-        if (buff != 0)
-            free(buff);
+        QVarLengthArray<char> buf(bufSize);
+        int decpt, length;
+        bool sign;
+        qt_doubleToAscii(d, form, precision, buf.data(), bufSize, sign, length, decpt);
+        QString digits = QString::fromLatin1(buf.data(), length);
 
         if (_zero.unicode() != '0') {
             ushort z = _zero.unicode() - '0';
@@ -2785,36 +2802,17 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         }
 
         bool always_show_decpt = (flags & Alternate || flags & ForcePoint);
-        switch (form) {
-            case DFExponent: {
-                num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                       digits, decpt, precision, PMDecimalDigits,
-                                       always_show_decpt);
-                break;
-            }
-            case DFDecimal: {
-                num_str = decimalForm(_zero, decimal, group,
-                                      digits, decpt, precision, PMDecimalDigits,
-                                      always_show_decpt, flags & ThousandsGroup);
-                break;
-            }
-            case DFSignificantDigits: {
-                PrecisionMode mode = (flags & Alternate) ?
-                            PMSignificantDigits : PMChopTrailingZeros;
-
-                if (decpt != digits.length() && (decpt <= -4 || decpt > precision))
-                    num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                           digits, decpt, precision, mode,
-                                           always_show_decpt);
-                else
-                    num_str = decimalForm(_zero, decimal, group,
-                                          digits, decpt, precision, mode,
-                                          always_show_decpt, flags & ThousandsGroup);
-                break;
-            }
-        }
+        PrecisionMode mode = doublePrecisionMode(form, precision, flags);
+        if (doubleUsesExponentForm(form, precision, length, decpt))
+            num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
+                                   digits, decpt, precision, mode,
+                                   always_show_decpt);
+        else
+            num_str = decimalForm(_zero, decimal, group,
+                                  digits, decpt, precision, mode,
+                                  always_show_decpt, flags & ThousandsGroup);
 
-        negative = sign != 0 && !isZero(d);
+        negative = sign && !isZero(d);
     }
 
     // pad with zeros. LeftAdjusted overrides this flag). Also, we don't
@@ -2847,6 +2845,108 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
     return num_str;
 }
 
+/*
+    Writes \a d to \a buf the way doubleToString() formats it with the C
+    locale's characters, and returns the number of characters written.
+    Returns -1 if \a flags ask for zero padding or group separators, or if
+    the result would not fit into \a bufSize characters; CLocaleDoubleBufferSize
+    is always enough for up to 40 digits of precision, except for numbers of
+    10^20 and more in DFDecimal form.
+*/
+int QLocaleData::doubleToCLocale(char *buf, int bufSize, double d, int precision,
+                                 DoubleForm form, unsigned flags)
+{
+    if (flags & (ZeroPadded | ThousandsGroup))
+        return -1;
+    if (precision == -1)
+        precision = 6;
+
+    const bool capital = flags & CapitalEorX;
+    const bool special = qt_is_inf(d) || qt_is_nan(d);
+    char digits[64];
+    int length = 0;
+    int decpt = 0;
+    bool negative;
+    if (special) {
+        negative = qt_is_inf(d) && d < 0;
+    } else {
+        if (precision != QLocale::FloatingPointShortest
+                && (precision < 0 || precision > 40 || (form == DFDecimal && !(qAbs(d) < 1e20)))) {
+            return -1;
+        }
+        bool sign;
+        qt_doubleToAscii(d, form, precision, digits, sizeof(digits), sign, length, decpt);
+        negative = sign && !isZero(d);
+    }
+
+    char signChar = 0;
+    if (negative)
+        signChar = '-';
+    else if (flags & AlwaysShowSign)
+        signChar = '+';
+    else if (flags & BlankBeforePositive)
+        signChar = ' ';
+
+    char *p = buf;
+    if (special) {
+        if (bufSize < 4)
+            return -1;
+        if (signChar)
+            *p++ = signChar;
+        memcpy(p, qt_is_inf(d) ? (capital ? "INF" : "inf") : (capital ? "NAN" : "nan"), 3);
+        return p + 3 - buf;
+    }
+
+    // Lay the digits out like decimalForm() and exponentForm() do: there are
+    // total of them, counting the zeros added before and after, and the
+    // decimal point goes in front of the one at pointPos.
+    const PrecisionMode mode = doublePrecisionMode(form, precision, flags);
+    const bool exponent = doubleUsesExponentForm(form, precision, length, decpt);
+    int leadingZeros = 0;
+    int pointPos = 1;
+    if (!exponent) {
+        leadingZeros = qMax(-decpt, 0);
+        pointPos = qMax(decpt, 0);
+    }
+    int total = qMax(leadingZeros + length, pointPos);
+    if (mode == PMDecimalDigits)
+        total = qMax(total, exponent ? precision + 1 : pointPos + precision);
+    else if (mode == PMSignificantDigits)
+        total = qMax(total, precision);
+    const bool point = (flags & Alternate) || pointPos < total;
+
+    // sign, leading zero, digits, decimal point and "e+308"
+    if (bufSize < total + 8)
+        return -1;
+
+    if (signChar)
+        *p++ = signChar;
+    if (pointPos == 0)
+        *p++ = '0';
+    const int digitsEnd = leadingZeros + length;
+    for (int i = 0; i < total; ++i) {
+        if (i == pointPos && point)
+            *p++ = '.';
+        *p++ = (i >= leadingZeros && i < digitsEnd) ? digits[i - leadingZeros] : '0';
+    }
+    if (pointPos == total && point)
+        *p++ = '.';
+
+    if (exponent) {
+        int exp = decpt - 1;
+        *p++ = capital ? 'E' : 'e';
+        *p++ = exp < 0 ? '-' : '+';
+        exp = qAbs(exp);
+        if (exp >= 100) {
+            *p++ = char('0' + exp / 100);
+            exp %= 100;
+        }
+        *p++ = char('0' + exp / 10);
+        *p++ = char('0' + exp % 10);
+    }
+    return p - buf;
+}
+
 QString QLocaleData::longLongToString(qlonglong l, int precision,
                                             int base, int width,
                                             unsigned flags) const
@@ -2861,6 +2961,18 @@ QString QLocaleData::longLongToString(const QChar zero, const QChar group,
                                          int base, int width,
                                          unsigned flags)
 {
+    if (precision == -1 && flags == NoFlags && (base != 10 || zero.unicode() == '0')) {
+        ushort buff[65]; // sign and MAX_ULLONG in base 2
+        ushort *p;
+        if (base == 10 && l < 0) {
+            p = qulltoaBackwards(buff + 65, qulonglong(-(1 + l)) + 1, 10);
+            *--p = minus.unicode();
+        } else {
+            p = qulltoaBackwards(buff + 65, qulonglong(l), base);
+        }
+        return QString(reinterpret_cast<QChar *>(p), buff + 65 - p);
+    }
+
     bool precision_not_specified = false;
     if (precision == -1) {
         precision_not_specified = true;
@@ -2956,6 +3068,12 @@ QString QLocaleData::unsLongLongToString(const QChar zero, const QChar group,
                                             int base, int width,
                                             unsigned flags)
 {
+    if (precision == -1 && flags == NoFlags && (base != 10 || zero.unicode() == '0')) {
+        ushort buff[64]; // MAX_ULLONG in base 2
+        ushort *p = qulltoaBackwards(buff + 64, l, base);
+        return QString(reinterpret_cast<QChar *>(p), buff + 64 - p);
+    }
+
     bool precision_not_specified = false;
     if (precision == -1) {
         precision_not_specified = true;
@@ -3278,8 +3396,9 @@ double QLocaleData::bytearrayToDouble(const char *num, bool *ok, bool *overflow)
         return -qt_inf();
 
     bool _ok;
-    const char *endptr;
-    double d = qstrtod(num, &endptr, &_ok);
+    int processed;
+    const int numLen = int(qstrlen(num));
+    double d = qt_asciiToDouble(num, numLen, _ok, processed);
 
     if (!_ok) {
         // the only way strtod can fail with *endptr != '\0' on a non-empty
@@ -3287,11 +3406,11 @@ double QLocaleData::bytearrayToDouble(const char *num, bool *ok, bool *overflow)
         if (ok != 0)
             *ok = false;
         if (overflow != 0)
-            *overflow = *endptr != '\0';
+            *overflow = processed != numLen;
         return 0.0;
     }
 
-    if (*endptr != '\0') {
+    if (processed != numLen) {
         // we stopped at a non-digit character after converting some digits
         if (ok != 0)
             *ok = false;
@@ -193,6 +193,12 @@ public:
 
     typedef QVarLengthArray<char, 256> CharBuff;
 
+    enum {
+        DoubleMaxSignificant = 17,          // enough to round-trip any double
+        DoubleMaxDigitsBeforeDecimal = 309, // DBL_MAX has that many
+        CLocaleDoubleBufferSize = 128       // for doubleToCLocale()
+    };
+
     static QString doubleToString(const QChar zero, const QChar plus,
                                   const QChar minus, const QChar exponent,
                                   const QChar group, const QChar decimal,
@@ -209,6 +215,9 @@ public:
                                        int base, int width,
                                        unsigned flags);
 
+    static int doubleToCLocale(char *buf, int bufSize, double d, int precision,
+                               DoubleForm form, unsigned flags);
+
     QString doubleToString(double d,
                            int precision = -1,
                            DoubleForm form = DFSignificantDigits,
@@ -117,24 +117,27 @@ qstrtoll(const char * nptr, const char **endptr, int base, bool *ok)
 static char *_qdtoa( NEEDS_VOLATILE double d, int mode, int ndigits, int *decpt,
                         int *sign, char **rve, char **digits_str);
 
+const char qt_digitPairs[200] = {
+    '0','0', '0','1', '0','2', '0','3', '0','4', '0','5', '0','6', '0','7', '0','8', '0','9',
+    '1','0', '1','1', '1','2', '1','3', '1','4', '1','5', '1','6', '1','7', '1','8', '1','9',
+    '2','0', '2','1', '2','2', '2','3', '2','4', '2','5', '2','6', '2','7', '2','8', '2','9',
+    '3','0', '3','1', '3','2', '3','3', '3','4', '3','5', '3','6', '3','7', '3','8', '3','9',
+    '4','0', '4','1', '4','2', '4','3', '4','4', '4','5', '4','6', '4','7', '4','8', '4','9',
+    '5','0', '5','1', '5','2', '5','3', '5','4', '5','5', '5','6', '5','7', '5','8', '5','9',
+    '6','0', '6','1', '6','2', '6','3', '6','4', '6','5', '6','6', '6','7', '6','8', '6','9',
+    '7','0', '7','1', '7','2', '7','3', '7','4', '7','5', '7','6', '7','7', '7','8', '7','9',
+    '8','0', '8','1', '8','2', '8','3', '8','4', '8','5', '8','6', '8','7', '8','8', '8','9',
+    '9','0', '9','1', '9','2', '9','3', '9','4', '9','5', '9','6', '9','7', '9','8', '9','9'
+};
+
 QString qulltoa(qulonglong l, int base, const QChar _zero)
 {
     ushort buff[65]; // length of MAX_ULLONG in base 2
     ushort *p = buff + 65;
 
     if (base != 10 || _zero.unicode() == '0') {
-        while (l != 0) {
-            int c = l % base;
-
-            --p;
-
-            if (c < 10)
-                *p = '0' + c;
-            else
-                *p = c - 10 + 'a';
-
-            l /= base;
-        }
+        if (l != 0)
+            p = qulltoaBackwards(p, l, base);
     }
     else {
         while (l != 0) {
@@ -151,7 +154,7 @@ QString qulltoa(qulonglong l, int base, const QChar _zero)
 
 QString qlltoa(qlonglong l, int base, const QChar zero)
 {
-    return qulltoa(l < 0 ? -l : l, base, zero);
+    return qulltoa(l < 0 ? qulonglong(-(1 + l)) + 1 : qulonglong(l), base, zero);
 }
 
 QString &decimalForm(QChar zero, QChar decimal, QChar group,
@@ -225,6 +228,544 @@ QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
     return digits;
 }
 
+/*
+    Digit generation for doubles using Grisu3, as described in Florian Loitsch,
+    "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+    (PLDI 2010). It only needs 64-bit integer arithmetic and no allocations, but
+    it gives up on a small fraction of the input, for which qt_doubleToAscii()
+    falls back to qdtoa(). Whenever it does produce digits, they are the same as
+    those qdtoa() would produce.
+*/
+
+namespace {
+struct DiyFp
+{
+    quint64 f;
+    int e;
+};
+}
+
+static inline DiyFp diyFp(quint64 f, int e)
+{
+    DiyFp r;
+    r.f = f;
+    r.e = e;
+    return r;
+}
+
+// the upper half of the 128-bit product, rounded
+static inline DiyFp diyFpMultiply(DiyFp x, DiyFp y)
+{
+    const quint64 mask32 = 0xffffffffU;
+    const quint64 a = x.f >> 32, b = x.f & mask32;
+    const quint64 c = y.f >> 32, d = y.f & mask32;
+    const quint64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    const quint64 tmp = (bd >> 32) + (ad & mask32) + (bc & mask32) + (Q_UINT64_C(1) << 31);
+    return diyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+static inline DiyFp diyFpNormalize(DiyFp x)
+{
+    while (!(x.f & Q_UINT64_C(0xffc0000000000000))) {
+        x.f <<= 10;
+        x.e -= 10;
+    }
+    while (!(x.f & (Q_UINT64_C(1) << 63))) {
+        x.f <<= 1;
+        x.e -= 1;
+    }
+    return x;
+}
+
+static inline DiyFp diyFpFromDouble(double v)
+{
+    quint64 bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const quint64 hiddenBit = Q_UINT64_C(0x0010000000000000);
+    const int biasedExponent = int(bits >> 52) & 0x7ff;
+    if (biasedExponent)
+        return diyFp((bits & (hiddenBit - 1)) | hiddenBit, biasedExponent - 1075);
+    return diyFp(bits & (hiddenBit - 1), -1074);
+}
+
+// Normalized 64-bit approximations of 10^-348, 10^-340, ..., 10^340.
+static const struct {
+    quint64 significand;
+    short binaryExponent;
+    short decimalExponent;
+} grisuCachedPowers[] = {
+    { Q_UINT64_C(0xfa8fd5a0081c0288), -1220, -348 },
+    { Q_UINT64_C(0xbaaee17fa23ebf76), -1193, -340 },
+    { Q_UINT64_C(0x8b16fb203055ac76), -1166, -332 },
+    { Q_UINT64_C(0xcf42894a5dce35ea), -1140, -324 },
+    { Q_UINT64_C(0x9a6bb0aa55653b2d), -1113, -316 },
+    { Q_UINT64_C(0xe61acf033d1a45df), -1087, -308 },
+    { Q_UINT64_C(0xab70fe17c79ac6ca), -1060, -300 },
+    { Q_UINT64_C(0xff77b1fcbebcdc4f), -1034, -292 },
+    { Q_UINT64_C(0xbe5691ef416bd60c), -1007, -284 },
+    { Q_UINT64_C(0x8dd01fad907ffc3c),  -980, -276 },
+    { Q_UINT64_C(0xd3515c2831559a83),  -954, -268 },
+    { Q_UINT64_C(0x9d71ac8fada6c9b5),  -927, -260 },
+    { Q_UINT64_C(0xea9c227723ee8bcb),  -901, -252 },
+    { Q_UINT64_C(0xaecc49914078536d),  -874, -244 },
+    { Q_UINT64_C(0x823c12795db6ce57),  -847, -236 },
+    { Q_UINT64_C(0xc21094364dfb5637),  -821, -228 },
+    { Q_UINT64_C(0x9096ea6f3848984f),  -794, -220 },
+    { Q_UINT64_C(0xd77485cb25823ac7),  -768, -212 },
+    { Q_UINT64_C(0xa086cfcd97bf97f4),  -741, -204 },
+    { Q_UINT64_C(0xef340a98172aace5),  -715, -196 },
+    { Q_UINT64_C(0xb23867fb2a35b28e),  -688, -188 },
+    { Q_UINT64_C(0x84c8d4dfd2c63f3b),  -661, -180 },
+    { Q_UINT64_C(0xc5dd44271ad3cdba),  -635, -172 },
+    { Q_UINT64_C(0x936b9fcebb25c996),  -608, -164 },
+    { Q_UINT64_C(0xdbac6c247d62a584),  -582, -156 },
+    { Q_UINT64_C(0xa3ab66580d5fdaf6),  -555, -148 },
+    { Q_UINT64_C(0xf3e2f893dec3f126),  -529, -140 },
+    { Q_UINT64_C(0xb5b5ada8aaff80b8),  -502, -132 },
+    { Q_UINT64_C(0x87625f056c7c4a8b),  -475, -124 },
+    { Q_UINT64_C(0xc9bcff6034c13053),  -449, -116 },
+    { Q_UINT64_C(0x964e858c91ba2655),  -422, -108 },
+    { Q_UINT64_C(0xdff9772470297ebd),  -396, -100 },
+    { Q_UINT64_C(0xa6dfbd9fb8e5b88f),  -369,  -92 },
+    { Q_UINT64_C(0xf8a95fcf88747d94),  -343,  -84 },
+    { Q_UINT64_C(0xb94470938fa89bcf),  -316,  -76 },
+    { Q_UINT64_C(0x8a08f0f8bf0f156b),  -289,  -68 },
+    { Q_UINT64_C(0xcdb02555653131b6),  -263,  -60 },
+    { Q_UINT64_C(0x993fe2c6d07b7fac),  -236,  -52 },
+    { Q_UINT64_C(0xe45c10c42a2b3b06),  -210,  -44 },
+    { Q_UINT64_C(0xaa242499697392d3),  -183,  -36 },
+    { Q_UINT64_C(0xfd87b5f28300ca0e),  -157,  -28 },
+    { Q_UINT64_C(0xbce5086492111aeb),  -130,  -20 },
+    { Q_UINT64_C(0x8cbccc096f5088cc),  -103,  -12 },
+    { Q_UINT64_C(0xd1b71758e219652c),   -77,   -4 },
+    { Q_UINT64_C(0x9c40000000000000),   -50,    4 },
+    { Q_UINT64_C(0xe8d4a51000000000),   -24,   12 },
+    { Q_UINT64_C(0xad78ebc5ac620000),     3,   20 },
+    { Q_UINT64_C(0x813f3978f8940984),    30,   28 },
+    { Q_UINT64_C(0xc097ce7bc90715b3),    56,   36 },
+    { Q_UINT64_C(0x8f7e32ce7bea5c70),    83,   44 },
+    { Q_UINT64_C(0xd5d238a4abe98068),   109,   52 },
+    { Q_UINT64_C(0x9f4f2726179a2245),   136,   60 },
+    { Q_UINT64_C(0xed63a231d4c4fb27),   162,   68 },
+    { Q_UINT64_C(0xb0de65388cc8ada8),   189,   76 },
+    { Q_UINT64_C(0x83c7088e1aab65db),   216,   84 },
+    { Q_UINT64_C(0xc45d1df942711d9a),   242,   92 },
+    { Q_UINT64_C(0x924d692ca61be758),   269,  100 },
+    { Q_UINT64_C(0xda01ee641a708dea),   295,  108 },
+    { Q_UINT64_C(0xa26da3999aef774a),   322,  116 },
+    { Q_UINT64_C(0xf209787bb47d6b85),   348,  124 },
+    { Q_UINT64_C(0xb454e4a179dd1877),   375,  132 },
+    { Q_UINT64_C(0x865b86925b9bc5c2),   402,  140 },
+    { Q_UINT64_C(0xc83553c5c8965d3d),   428,  148 },
+    { Q_UINT64_C(0x952ab45cfa97a0b3),   455,  156 },
+    { Q_UINT64_C(0xde469fbd99a05fe3),   481,  164 },
+    { Q_UINT64_C(0xa59bc234db398c25),   508,  172 },
+    { Q_UINT64_C(0xf6c69a72a3989f5c),   534,  180 },
+    { Q_UINT64_C(0xb7dcbf5354e9bece),   561,  188 },
+    { Q_UINT64_C(0x88fcf317f22241e2),   588,  196 },
+    { Q_UINT64_C(0xcc20ce9bd35c78a5),   614,  204 },
+    { Q_UINT64_C(0x98165af37b2153df),   641,  212 },
+    { Q_UINT64_C(0xe2a0b5dc971f303a),   667,  220 },
+    { Q_UINT64_C(0xa8d9d1535ce3b396),   694,  228 },
+    { Q_UINT64_C(0xfb9b7cd9a4a7443c),   720,  236 },
+    { Q_UINT64_C(0xbb764c4ca7a44410),   747,  244 },
+    { Q_UINT64_C(0x8bab8eefb6409c1a),   774,  252 },
+    { Q_UINT64_C(0xd01fef10a657842c),   800,  260 },
+    { Q_UINT64_C(0x9b10a4e5e9913129),   827,  268 },
+    { Q_UINT64_C(0xe7109bfba19c0c9d),   853,  276 },
+    { Q_UINT64_C(0xac2820d9623bf429),   880,  284 },
+    { Q_UINT64_C(0x80444b5e7aa7cf85),   907,  292 },
+    { Q_UINT64_C(0xbf21e44003acdd2d),   933,  300 },
+    { Q_UINT64_C(0x8e679c2f5e44ff8f),   960,  308 },
+    { Q_UINT64_C(0xd433179d9c8cb841),   986,  316 },
+    { Q_UINT64_C(0x9e19db92b4e31ba9),  1013,  324 },
+    { Q_UINT64_C(0xeb96bf6ebadf77d9),  1039,  332 },
+    { Q_UINT64_C(0xaf87023b9bf0ee6b),  1066,  340 },
+};
+
+static const quint32 grisuSmallPowersOfTen[] = {
+    0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+enum {
+    GrisuMinTargetExponent = -60,
+    GrisuMaxTargetExponent = -32
+};
+
+// Returns a cached power of ten 10^mk such that multiplying a normalized
+// number with binary exponent e by it gives an exponent in the target range.
+static inline DiyFp grisuCachedPower(int e, int *mk)
+{
+    const int minExponent = GrisuMinTargetExponent - (e + 64);
+    const int k = int(ceil((minExponent + 63) * 0.30102999566398114)); // 1 / lg(10)
+    const int index = (348 + k - 1) / 8 + 1;
+    Q_ASSERT(index >= 0 && index < int(sizeof(grisuCachedPowers) / sizeof(grisuCachedPowers[0])));
+    *mk = grisuCachedPowers[index].decimalExponent;
+    return diyFp(grisuCachedPowers[index].significand, grisuCachedPowers[index].binaryExponent);
+}
+
+// Returns the biggest power of ten not greater than number, which has at most
+// numberBits bits, and the number of decimal digits of number.
+static inline quint32 grisuBiggestPowerTen(quint32 number, int numberBits, int *exponentPlusOne)
+{
+    int guess = ((numberBits + 1) * 1233 >> 12) + 1;
+    if (number < grisuSmallPowersOfTen[guess])
+        --guess;
+    *exponentPlusOne = guess;
+    return grisuSmallPowersOfTen[guess];
+}
+
+// Moves the last digit of the shortest representation closer to the real
+// value, and checks that the result is guaranteed to be the closest one.
+static bool grisuRoundWeed(char *buffer, int length, quint64 distanceTooHighW, quint64 unsafeInterval,
+                           quint64 rest, quint64 tenKappa, quint64 unit)
+{
+    const quint64 smallDistance = distanceTooHighW - unit;
+    const quint64 bigDistance = distanceTooHighW + unit;
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa
+           && (rest + tenKappa < smallDistance
+               || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        buffer[length - 1]--;
+        rest += tenKappa;
+    }
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance
+            || bigDistance - rest > rest + tenKappa - bigDistance)) {
+        return false;
+    }
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+// Rounds the counted digits, unless the error could change the outcome.
+static bool grisuRoundWeedCounted(char *buffer, int length, quint64 rest, quint64 tenKappa,
+                                  quint64 unit, int *kappa)
+{
+    if (unit >= tenKappa || tenKappa - unit <= unit)
+        return false;
+    if (tenKappa - rest > rest && tenKappa - 2 * rest >= 2 * unit)
+        return true;
+    if (rest > unit && tenKappa - (rest - unit) <= rest - unit) {
+        buffer[length - 1]++;
+        for (int i = length - 1; i > 0; --i) {
+            if (buffer[i] != '0' + 10)
+                break;
+            buffer[i] = '0';
+            buffer[i - 1]++;
+        }
+        if (buffer[0] == '0' + 10) {
+            buffer[0] = '1';
+            ++*kappa;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Generates the shortest digits of v > 0 that read back as v; needs room for
+// 18 digits.
+static bool grisuShortest(double v, char *buffer, int *length, int *decpt)
+{
+    const DiyFp raw = diyFpFromDouble(v);
+    const DiyFp w = diyFpNormalize(raw);
+
+    // the boundaries of the interval of numbers that round to v
+    const DiyFp plus = diyFpNormalize(diyFp((raw.f << 1) + 1, raw.e - 1));
+    DiyFp minus;
+    if (raw.f == Q_UINT64_C(0x0010000000000000) && raw.e > -1074)
+        minus = diyFp((raw.f << 2) - 1, raw.e - 2);
+    else
+        minus = diyFp((raw.f << 1) - 1, raw.e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    int mk;
+    const DiyFp tenMk = grisuCachedPower(w.e, &mk);
+    const DiyFp scaledW = diyFpMultiply(w, tenMk);
+    const DiyFp low = diyFpMultiply(minus, tenMk);
+    const DiyFp high = diyFpMultiply(plus, tenMk);
+
+    quint64 unit = 1;
+    const quint64 tooLow = low.f - unit;
+    const quint64 tooHigh = high.f + unit;
+    quint64 unsafeInterval = tooHigh - tooLow;
+    const int shift = -scaledW.e;
+    const quint64 one = Q_UINT64_C(1) << shift;
+    quint32 integrals = quint32(tooHigh >> shift);
+    quint64 fractionals = tooHigh & (one - 1);
+    int kappa;
+    quint32 divisor = grisuBiggestPowerTen(integrals, 64 - shift, &kappa);
+
+    int len = 0;
+    while (kappa > 0) {
+        buffer[len++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --kappa;
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        if (rest < unsafeInterval) {
+            *length = len;
+            *decpt = len + kappa - mk;
+            return grisuRoundWeed(buffer, len, tooHigh - scaledW.f, unsafeInterval, rest,
+                                  quint64(divisor) << shift, unit);
+        }
+        divisor /= 10;
+    }
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[len++] = char('0' + (fractionals >> shift));
+        fractionals &= one - 1;
+        --kappa;
+        if (fractionals < unsafeInterval) {
+            *length = len;
+            *decpt = len + kappa - mk;
+            return grisuRoundWeed(buffer, len, (tooHigh - scaledW.f) * unit, unsafeInterval,
+                                  fractionals, one, unit);
+        }
+    }
+}
+
+// Generates requested correctly rounded significant digits of v > 0, or, if
+// fixed is set, as many as are needed for requested digits after the decimal
+// point. Trailing zeros are removed.
+static bool grisuCounted(double v, int requested, bool fixed, char *buffer, int bufSize,
+                         int *length, int *decpt)
+{
+    const DiyFp w = diyFpNormalize(diyFpFromDouble(v));
+    int mk;
+    const DiyFp scaledW = diyFpMultiply(w, grisuCachedPower(w.e, &mk));
+
+    quint64 wError = 1;
+    const int shift = -scaledW.e;
+    const quint64 one = Q_UINT64_C(1) << shift;
+    quint32 integrals = quint32(scaledW.f >> shift);
+    quint64 fractionals = scaledW.f & (one - 1);
+    int kappa;
+    quint32 divisor = grisuBiggestPowerTen(integrals, 64 - shift, &kappa);
+
+    if (fixed) {
+        // v has kappa - mk digits before the decimal point, unless the error
+        // in scaledW could hide it crossing a power of ten
+        if ((integrals == divisor && fractionals <= wError)
+            || (integrals == quint64(divisor) * 10 - 1 && fractionals >= one - 1 - wError)) {
+            return false;
+        }
+        requested += kappa - mk;
+    }
+    if (requested <= 0 || requested > bufSize)
+        return false;
+
+    int len = 0;
+    bool weeded;
+    while (kappa > 0) {
+        buffer[len++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --kappa;
+        if (--requested == 0)
+            break;
+        divisor /= 10;
+    }
+    if (requested == 0) {
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        weeded = grisuRoundWeedCounted(buffer, len, rest, quint64(divisor) << shift, wError, &kappa);
+    } else {
+        while (requested > 0 && fractionals > wError) {
+            fractionals *= 10;
+            wError *= 10;
+            buffer[len++] = char('0' + (fractionals >> shift));
+            fractionals &= one - 1;
+            --kappa;
+            --requested;
+        }
+        if (requested != 0)
+            return false;
+        weeded = grisuRoundWeedCounted(buffer, len, fractionals, one, wError, &kappa);
+    }
+    if (!weeded)
+        return false;
+
+    *decpt = len + kappa - mk;
+    while (len > 1 && buffer[len - 1] == '0')
+        --len;
+    *length = len;
+    return true;
+}
+
+/*
+    Writes the decimal digits of the finite number \a d to \a buf, without a
+    terminating '\\0', and sets \a length to their number and \a decpt to the
+    position of the decimal point relative to the first digit. At most
+    \a bufSize digits are written; the caller sizes \a buf so that this is
+    enough for \a form and \a precision.
+
+    With QLocale::FloatingPointShortest as \a precision, the digits are the
+    shortest ones that read back as \a d. Otherwise \a precision has the
+    meaning it has for \a form in QLocaleData::doubleToString(). As with
+    qdtoa(), trailing zeros are not included.
+*/
+void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision,
+                      char *buf, int bufSize, bool &sign, int &length, int &decpt)
+{
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    sign = bits >> 63;
+    const double v = sign ? -d : d;
+
+    if (v == 0) {
+        buf[0] = '0';
+        length = 1;
+        decpt = 1;
+        return;
+    }
+
+    const bool shortest = precision == QLocale::FloatingPointShortest;
+    int ndigits;
+    if (shortest) {
+        ndigits = 0;
+        if (bufSize >= 18 && grisuShortest(v, buf, &length, &decpt))
+            return;
+    } else {
+        /* In DFExponent form, the precision is the number of digits after
+           the decimal point, which is always after the first digit; so we
+           want precision+1 significant digits. */
+        ndigits = form == QLocaleData::DFExponent ? precision + 1 : precision;
+        if (precision >= 0
+            && grisuCounted(v, form == QLocaleData::DFSignificantDigits ? qMax(ndigits, 1) : ndigits,
+                            form == QLocaleData::DFDecimal, buf, bufSize, &length, &decpt)) {
+            return;
+        }
+    }
+
+    const int mode = shortest ? 0 : form == QLocaleData::DFDecimal ? 3 : 2;
+    int qsign;
+    char *rve = 0;
+    char *buff = 0;
+    QT_TRY {
+        const char *digits = qdtoa(d, mode, ndigits, &decpt, &qsign, &rve, &buff);
+        length = qMin(int(qstrlen(digits)), bufSize);
+        memcpy(buf, digits, length);
+        // qdtoa() misses some when rounding ties to even
+        while (length > 1 && buf[length - 1] == '0')
+            --length;
+    } QT_CATCH(...) {
+        if (buff != 0)
+            free(buff);
+        QT_RETHROW;
+    }
+    if (buff != 0)
+        free(buff);
+}
+
+// Whether double arithmetic rounds each operation to double precision, which
+// the fast path in qt_asciiToDouble() relies on.
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+#  define QT_ASCIITODOUBLE_FAST_PATH
+#endif
+
+#ifdef QT_ASCIITODOUBLE_FAST_PATH
+/*
+    Converts numbers of at most 19 significant digits whose mantissa and power
+    of ten are both exactly representable as doubles. The result is then the
+    correctly rounded product or quotient of the two (W. D. Clinger, "How to
+    Read Floating Point Numbers Accurately", PLDI 1990).
+*/
+static bool fastAsciiToDouble(const char *num, int numLen, double *d)
+{
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = num;
+    const char *const end = num + numLen;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    quint64 mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+    for (; p < end && uint(*p - '0') < 10; ++p) {
+        anyDigits = true;
+        if (mantissa == 0 && *p == '0')
+            continue;
+        if (++significant > 19)
+            return false;
+        mantissa = mantissa * 10 + uint(*p - '0');
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && uint(*p - '0') < 10; ++p) {
+            anyDigits = true;
+            --exponent;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            if (++significant > 19)
+                return false;
+            mantissa = mantissa * 10 + uint(*p - '0');
+        }
+    }
+    if (!anyDigits)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+        if (p == end)
+            return false;
+        int e = 0;
+        for (; p < end && uint(*p - '0') < 10; ++p) {
+            e = e * 10 + (*p - '0');
+            if (e >= 1000)
+                return false;
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (p != end)
+        return false;
+
+    double r = 0;
+    if (mantissa != 0) {
+        if (mantissa > (Q_UINT64_C(1) << 53) || exponent < -22 || exponent > 22)
+            return false;
+        r = double(mantissa);
+        if (exponent < 0)
+            r /= powersOfTen[-exponent];
+        else
+            r *= powersOfTen[exponent];
+    }
+    *d = negative ? -r : r;
+    return true;
+}
+#endif
+
+/*
+    Converts the first \a numLen characters of \a num, which need not be
+    '\\0'-terminated, the way qstrtod() does. \a processed is set to the
+    number of characters that were used.
+*/
+double qt_asciiToDouble(const char *num, int numLen, bool &ok, int &processed)
+{
+#ifdef QT_ASCIITODOUBLE_FAST_PATH
+    double d;
+    if (fastAsciiToDouble(num, numLen, &d)) {
+        ok = true;
+        processed = numLen;
+        return d;
+    }
+#endif
+
+    QVarLengthArray<char, 128> buf(numLen + 1);
+    memcpy(buf.data(), num, numLen);
+    buf[numLen] = '\0';
+    const char *endptr;
+    const double r = qstrtod(buf.constData(), &endptr, &ok);
+    processed = int(endptr - buf.constData());
+    return r;
+}
+
 /*        From: NetBSD: strtod.c,v 1.26 1998/02/03 18:44:21 perry Exp */
 /* $FreeBSD: src/lib/libc/stdlib/netbsd_strtod.c,v 1.2.2.2 2001/03/02 17:14:15 tegge Exp $        */
 
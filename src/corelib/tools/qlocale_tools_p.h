@@ -69,6 +69,38 @@ QT_BEGIN_NAMESPACE
 QString qulltoa(qulonglong l, int base, const QChar _zero);
 QString qlltoa(qlonglong l, int base, const QChar zero);
 
+extern const char qt_digitPairs[200];
+
+// Writes the digits of l in the given base backwards, ending just before p,
+// and returns a pointer to the first one. There must be room for 64 digits.
+template <typename Char>
+inline Char *qulltoaBackwards(Char *p, qulonglong l, int base)
+{
+    if (base == 10) {
+        while (l >= 100) {
+            const uint pair = uint(l % 100) * 2;
+            l /= 100;
+            *--p = qt_digitPairs[pair + 1];
+            *--p = qt_digitPairs[pair];
+        }
+        if (l >= 10) {
+            const uint pair = uint(l) * 2;
+            *--p = qt_digitPairs[pair + 1];
+            *--p = qt_digitPairs[pair];
+        } else {
+            *--p = '0' + uint(l);
+        }
+        return p;
+    }
+
+    do {
+        const uint c = uint(l % base);
+        l /= base;
+        *--p = c + (c < 10 ? '0' : 'a' - 10);
+    } while (l);
+    return p;
+}
+
 enum PrecisionMode {
     PMDecimalDigits =             0x01,
     PMSignificantDigits =   0x02,
@@ -99,6 +131,10 @@ inline bool isZero(double d)
 Q_CORE_EXPORT char *qdtoa(double d, int mode, int ndigits, int *decpt,
                           int *sign, char **rve, char **digits_str);
 Q_CORE_EXPORT double qstrtod(const char *s00, char const **se, bool *ok);
+
+void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision,
+                      char *buf, int bufSize, bool &sign, int &length, int &decpt);
+double qt_asciiToDouble(const char *num, int numLen, bool &ok, int &processed);
 qlonglong qstrtoll(const char *nptr, const char **endptr, int base, bool *ok);
 qulonglong qstrtoull(const char *nptr, const char **endptr, int base, bool *ok);
 
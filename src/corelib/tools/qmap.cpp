@@ -32,6 +32,7 @@
 ****************************************************************************/
 
 #include "qmap.h"
+#include "qbtreemap.h"
 
 #include <stdlib.h>
 
@@ -43,6 +44,7 @@
 QT_BEGIN_NAMESPACE
 
 const QMapDataBase QMapDataBase::shared_null = { Q_REFCOUNT_INITIALIZE_STATIC, 0, { 0, 0, 0 }, 0 };
+const QBTreeMapData QBTreeMapData::shared_null = { Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 0, 0, 0 };
 
 const QMapNodeBase *QMapNodeBase::nextNode() const
 {
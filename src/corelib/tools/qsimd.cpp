@@ -35,6 +35,7 @@
 #include "qsimd_p.h"
 #include <QByteArray>
 #include <stdio.h>
+#include <string.h>
 
 #if defined(Q_OS_WIN)
 #  if defined(Q_OS_WINCE)
@@ -304,6 +305,8 @@ static inline uint detectProcessorFeatures()
         features |= HLE; // Hardware Lock Ellision
     if (cpuid0700EBX & (1u << 11))
         features |= RTM; // Restricted Transactional Memory
+    if (cpuid0700EBX & (1u << 29))
+        features |= SHA; // SHA-1 and SHA-256 extensions
 
     return features;
 }
@@ -467,6 +470,7 @@ static inline uint detectProcessorFeatures()
  rtm
  dsp
  dspr2
+ sha
   */
 
 // begin generated
@@ -484,11 +488,12 @@ static const char features_string[] =
     " rtm\0"
     " dsp\0"
     " dspr2\0"
+    " sha\0"
     "\0";
 
 static const int features_indices[] = {
     0,    1,    7,   13,   19,   26,   34,   42,
-   47,   53,   58,   63,   68,   -1
+   47,   53,   58,   63,   68,   75,   -1
 };
 // end generated
 
@@ -546,8 +551,10 @@ void qDetectCpuFeatures()
     QByteArray disable = qgetenv("QT_NO_CPU_FEATURE");
     if (!disable.isEmpty()) {
         disable.prepend(' ');
+        // use strstr() rather than QByteArray::contains(): the latter may
+        // dispatch on the very features we are detecting here
         for (int i = 0; i < features_count; ++i) {
-            if (disable.contains(features_string + features_indices[i]))
+            if (strstr(disable.constData(), features_string + features_indices[i]))
                 f &= ~(1 << i);
         }
     }
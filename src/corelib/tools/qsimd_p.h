@@ -217,6 +217,17 @@
 #  endif
 #endif
 
+// SHA extensions; every processor that has them also supports SSE4.1
+#define QT_FUNCTION_TARGET_STRING_SHA       "sha,sse4.1"
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_PROCESSOR_X86)
+#  if QT_COMPILER_SUPPORTS_HERE(SSE4_1) \
+    && (defined(__SHA__) || (defined(Q_CC_MSVC) && _MSC_VER >= 1900) \
+        || (defined(Q_CC_GNU) && !defined(Q_CC_CLANG) && !defined(Q_CC_INTEL) && Q_CC_GNU >= 500))
+#    define QT_COMPILER_SUPPORTS_SHA 1
+#    include <immintrin.h>
+#  endif
+#endif
+
 // other x86 intrinsics
 #if defined(Q_PROCESSOR_X86) && ((defined(Q_CC_GNU) && (Q_CC_GNU >= 404)) \
     || (defined(Q_CC_CLANG) && (Q_CC_CLANG >= 208)) \
@@ -256,6 +267,7 @@ enum CPUFeatures {
     RTM         = 0x400,
     DSP         = 0x800,
     DSPR2       = 0x1000,
+    SHA         = 0x2000,
 
     // used only to indicate that the CPU detection was initialised
     QSimdInitialized = 0x80000000
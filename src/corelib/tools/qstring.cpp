@@ -50,6 +50,7 @@
 #include "qstringmatcher.h"
 #include "qvarlengtharray.h"
 #include "qtools_p.h"
+#include "qarraydataarena_p.h"
 #include "qdebug.h"
 #include "qendian.h"
 #include "qcollator.h"
@@ -308,6 +309,54 @@ static inline __m128i mergeQuestionMarks(__m128i chunk)
 }
 #endif
 
+#if defined(__SSE2__)
+// Folds the US-ASCII upper case letters in \a chunk to lower case and
+// leaves all other code units alone. The comparisons are signed, so code
+// units from 0x8000 up are never mistaken for letters.
+static inline __m128i foldCaseAscii(__m128i chunk)
+{
+    const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi16(chunk, _mm_set1_epi16('A' - 1)),
+                                          _mm_cmplt_epi16(chunk, _mm_set1_epi16('Z' + 1)));
+    return _mm_add_epi16(chunk, _mm_and_si128(isUpper, _mm_set1_epi16(0x20)));
+}
+
+// Returns the byte mask (as _mm_movemask_epi8) of the code units in
+// \a chunk that are not US-ASCII
+static inline uint nonAsciiMask(__m128i chunk)
+{
+    const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(chunk, _mm_set1_epi16(short(0xff80))),
+                                          _mm_setzero_si128());
+    return ~_mm_movemask_epi8(ascii) & 0xffff;
+}
+
+// Returns the byte mask of the code units in \a chunk that are equal to
+// \a lower or \a upper, or that are not US-ASCII: those might still fold to
+// an ASCII letter, like U+212A KELVIN SIGN does.
+static inline uint foldCaseCandidates(__m128i chunk, __m128i lower, __m128i upper)
+{
+    const __m128i match = _mm_or_si128(_mm_cmpeq_epi16(chunk, lower), _mm_cmpeq_epi16(chunk, upper));
+    const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(chunk, _mm_set1_epi16(short(0xff80))),
+                                          _mm_setzero_si128());
+    return ~_mm_movemask_epi8(_mm_andnot_si128(match, ascii)) & 0xffff;
+}
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static inline uint foldCaseCandidates(__m256i chunk, __m256i lower, __m256i upper)
+{
+    const __m256i match = _mm256_or_si256(_mm256_cmpeq_epi16(chunk, lower), _mm256_cmpeq_epi16(chunk, upper));
+    const __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(chunk, _mm256_set1_epi16(short(0xff80))),
+                                             _mm256_setzero_si256());
+    return ~uint(_mm256_movemask_epi8(_mm256_andnot_si256(match, ascii)));
+}
+#  endif
+
+static inline ushort toUpperAscii(ushort c)
+{
+    return (c >= 'a' && c <= 'z') ? c - 0x20 : c;
+}
+#endif
+
 static void qt_to_latin1(uchar *dst, const ushort *src, int length)
 {
 #if defined(__SSE2__)
@@ -384,6 +433,33 @@ static int ucstricmp(const ushort *a, const ushort *ae, const ushort *b, const u
 
     uint alast = 0;
     uint blast = 0;
+#ifdef __SSE2__
+    // compare blocks of US-ASCII characters without looking up the case
+    // folding tables; blocks with other characters take the slow path
+    for ( ; e - a >= 8; ) {
+        const __m128i a_data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+        const __m128i b_data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+        if (nonAsciiMask(_mm_or_si128(a_data, b_data))) {
+            for (const ushort *blockEnd = a + 8; a < blockEnd; ++a, ++b) {
+                int diff = foldCase(*a, alast) - foldCase(*b, blast);
+                if ((diff))
+                    return diff;
+            }
+            continue;
+        }
+
+        const __m128i result = _mm_cmpeq_epi16(foldCaseAscii(a_data), foldCaseAscii(b_data));
+        const uint mask = ~_mm_movemask_epi8(result) & 0xffff;
+        if (mask) {
+            const uint idx = uint(_bit_scan_forward(mask)) / 2;
+            return foldCase(a[idx]) - foldCase(b[idx]);
+        }
+        a += 8;
+        b += 8;
+        // the previous characters are not high surrogates anymore
+        alast = blast = 0;
+    }
+#endif
     while (a < e) {
 //         qDebug() << hex << alast << blast;
 //         qDebug() << hex << "*a=" << *a << "alast=" << alast << "folded=" << foldCase (*a, alast);
@@ -417,6 +493,31 @@ static int ucstricmp(const ushort *a, const ushort *ae, const uchar *b, const uc
     if (be - b < ae - a)
         e = a + (be - b);
 
+#ifdef __SSE2__
+    // same as above, but the Latin 1 characters need to be expanded first
+    for ( ; e - a >= 8; ) {
+        const __m128i a_data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+        const __m128i b_data = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(b)),
+                                                 _mm_setzero_si128());
+        if (nonAsciiMask(_mm_or_si128(a_data, b_data))) {
+            for (const ushort *blockEnd = a + 8; a < blockEnd; ++a, ++b) {
+                int diff = foldCase(*a) - foldCase(*b);
+                if ((diff))
+                    return diff;
+            }
+            continue;
+        }
+
+        const __m128i result = _mm_cmpeq_epi16(foldCaseAscii(a_data), foldCaseAscii(b_data));
+        const uint mask = ~_mm_movemask_epi8(result) & 0xffff;
+        if (mask) {
+            const uint idx = uint(_bit_scan_forward(mask)) / 2;
+            return foldCase(a[idx]) - foldCase(ushort(b[idx]));
+        }
+        a += 8;
+        b += 8;
+    }
+#endif
     while (a < e) {
         int diff = foldCase(*a) - foldCase(*b);
         if ((diff))
@@ -648,6 +749,28 @@ static int ucstrcmp(const QChar *a, int alen, const uchar *b, int blen)
     return cmp ? cmp : (alen-blen);
 }
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+// Scans \a n for the US-ASCII character \a c, which must be case folded
+// already, 16 positions at a time. Returns the match, or null with \a n left
+// at the first position that was not compared yet.
+QT_FUNCTION_TARGET(AVX2)
+static const ushort *findCharCaseInsensitiveAsciiAvx2(const ushort *&n, const ushort *e, ushort c)
+{
+    const __m256i lower = _mm256_set1_epi16(c);
+    const __m256i upper = _mm256_set1_epi16(toUpperAscii(c));
+    for (const ushort *next = n + 16; next <= e; n = next, next += 16) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(n));
+        for (uint mask = foldCaseCandidates(data, lower, upper); mask; ) {
+            const uint idx = uint(_bit_scan_forward(mask));
+            if (foldCase(n[idx / 2]) == c)
+                return n + idx / 2;
+            mask &= ~(3U << idx);
+        }
+    }
+    return Q_NULLPTR;
+}
+#endif
+
 /*!
     \internal
 
@@ -695,6 +818,28 @@ static int findChar(const QChar *str, int len, QChar ch, int from,
                     return  n - s;
         } else {
             c = foldCase(c);
+#ifdef __SSE2__
+            if (c < 0x80) {
+                // only the non-ASCII candidates need the case folding tables
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+                if (qCpuHasFeature(AVX2)) {
+                    if (const ushort *match = findCharCaseInsensitiveAsciiAvx2(n, e, c))
+                        return match - s;
+                }
+#  endif
+                const __m128i lower = _mm_set1_epi16(c);
+                const __m128i upper = _mm_set1_epi16(toUpperAscii(c));
+                for (const ushort *next = n + 8; next <= e; n = next, next += 8) {
+                    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n));
+                    for (uint mask = foldCaseCandidates(data, lower, upper); mask; ) {
+                        const uint idx = uint(_bit_scan_forward(mask));
+                        if (foldCase(n[idx / 2]) == c)
+                            return n - s + idx / 2;
+                        mask &= ~(3U << idx);
+                    }
+                }
+            }
+#endif
             --n;
             while (++n != e)
                 if (foldCase(*n) == c)
@@ -704,6 +849,185 @@ static int findChar(const QChar *str, int len, QChar ch, int from,
     return -1;
 }
 
+#ifdef __SSE2__
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+// The AVX2 part of findStringCaseInsensitiveAscii(): returns the match, or
+// null with \a h left at the first position that was not compared yet.
+QT_FUNCTION_TARGET(AVX2)
+static const ushort *findStringCaseInsensitiveAsciiAvx2(const ushort *&h, const ushort *end,
+                                                        const ushort *needle, int needleLen)
+{
+    const int sl_minus_1 = needleLen - 1;
+    const ushort first = foldCase(needle[0]);
+    const ushort last = foldCase(needle[sl_minus_1]);
+    const __m256i firstLower = _mm256_set1_epi16(first);
+    const __m256i firstUpper = _mm256_set1_epi16(toUpperAscii(first));
+    const __m256i lastLower = _mm256_set1_epi16(last);
+    const __m256i lastUpper = _mm256_set1_epi16(toUpperAscii(last));
+    // we're going to read h[0..15] and h[sl_minus_1..sl_minus_1+15]
+    for ( ; end - h >= 15; h += 16) {
+        const __m256i firstData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h));
+        const __m256i lastData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + sl_minus_1));
+        uint mask = foldCaseCandidates(firstData, firstLower, firstUpper)
+                & foldCaseCandidates(lastData, lastLower, lastUpper);
+        while (mask) {
+            const uint idx = uint(_bit_scan_forward(mask));
+            if (ucstrnicmp(needle, h + idx / 2, needleLen) == 0)
+                return h + idx / 2;
+            mask &= ~(3U << idx);
+        }
+    }
+    return Q_NULLPTR;
+}
+#  endif
+
+/*!
+    \internal
+
+    Returns the index position of the first case-insensitive occurrence of
+    \a needle in \a haystack, searching forward from index position \a from.
+    Returns -1 if \a needle could not be found.
+
+    The first and the last character of \a needle must fold to US-ASCII
+    characters, see canFindStringCaseInsensitiveAscii(). Only those two are
+    compared for 8 (or 16, with AVX2) positions at once, and the candidates
+    are then verified with ucstrnicmp(). The AVX2 version is chosen at run
+    time.
+*/
+static int findStringCaseInsensitiveAscii(const ushort *haystack, int haystackLen, int from,
+                                          const ushort *needle, int needleLen)
+{
+    const int sl_minus_1 = needleLen - 1;
+    if (from > haystackLen - needleLen)
+        return -1;
+
+    const ushort first = foldCase(needle[0]);
+    const ushort last = foldCase(needle[sl_minus_1]);
+    const ushort *h = haystack + from;
+    // the last position where needle could start
+    const ushort *end = haystack + haystackLen - needleLen;
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        if (const ushort *match = findStringCaseInsensitiveAsciiAvx2(h, end, needle, needleLen))
+            return match - haystack;
+    }
+#  endif
+
+    const __m128i firstLower = _mm_set1_epi16(first);
+    const __m128i firstUpper = _mm_set1_epi16(toUpperAscii(first));
+    const __m128i lastLower = _mm_set1_epi16(last);
+    const __m128i lastUpper = _mm_set1_epi16(toUpperAscii(last));
+    // we're going to read h[0..7] and h[sl_minus_1..sl_minus_1+7]
+    for ( ; end - h >= 7; h += 8) {
+        const __m128i firstData = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h));
+        const __m128i lastData = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + sl_minus_1));
+        uint mask = foldCaseCandidates(firstData, firstLower, firstUpper)
+                & foldCaseCandidates(lastData, lastLower, lastUpper);
+        while (mask) {
+            const uint idx = uint(_bit_scan_forward(mask));
+            if (ucstrnicmp(needle, h + idx / 2, needleLen) == 0)
+                return h - haystack + idx / 2;
+            mask &= ~(3U << idx);
+        }
+    }
+
+    for ( ; h <= end; ++h) {
+        if (ucstrnicmp(needle, h, needleLen) == 0)
+            return h - haystack;
+    }
+    return -1;
+}
+
+static bool canFindStringCaseInsensitiveAscii(const ushort *needle, int needleLen)
+{
+    return needleLen > 0 && foldCase(needle[0]) < 0x80 && foldCase(needle[needleLen - 1]) < 0x80;
+}
+
+/*
+    Case-sensitive counterpart of findStringCaseInsensitiveAscii(), for any
+    needle of at least 2 characters: the first and the last character are
+    compared with 8 (or 16, with AVX2) positions at once, and the others
+    only at the positions where both of them match. The AVX2 version is
+    chosen at run time. See also simd_find() in qbytearraymatcher.cpp.
+*/
+static inline int findStringCaseSensitiveTail(const ushort *haystack, const ushort *h, const ushort *end,
+                                              const ushort *needle, int needleLen)
+{
+    for ( ; h <= end; ++h) {
+        if (*h == *needle && h[needleLen - 1] == needle[needleLen - 1]
+                && memcmp(h + 1, needle + 1, (needleLen - 2) * sizeof(ushort)) == 0)
+            return h - haystack;
+    }
+    return -1;
+}
+
+static int findStringCaseSensitiveSse2(const ushort *haystack, int haystackLen, int from,
+                                       const ushort *needle, int needleLen)
+{
+    const ushort *h = haystack + from;
+    // the last position where needle could start
+    const ushort *end = haystack + haystackLen - needleLen;
+    const __m128i first = _mm_set1_epi16(needle[0]);
+    const __m128i last = _mm_set1_epi16(needle[needleLen - 1]);
+
+    // we're going to read h[0..7] and h[needleLen-1..needleLen+6]
+    for ( ; end - h >= 7; h += 8) {
+        const __m128i firstData = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h));
+        const __m128i lastData = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + needleLen - 1));
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(firstData, first),
+                                                    _mm_cmpeq_epi16(lastData, last)));
+        while (mask) {
+            const uint idx = uint(_bit_scan_forward(mask));
+            if (memcmp(h + idx / 2 + 1, needle + 1, (needleLen - 2) * sizeof(ushort)) == 0)
+                return h - haystack + idx / 2;
+            mask &= ~(3U << idx);
+        }
+    }
+    return findStringCaseSensitiveTail(haystack, h, end, needle, needleLen);
+}
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static int findStringCaseSensitiveAvx2(const ushort *haystack, int haystackLen, int from,
+                                       const ushort *needle, int needleLen)
+{
+    const ushort *h = haystack + from;
+    const ushort *end = haystack + haystackLen - needleLen;
+    const __m256i first = _mm256_set1_epi16(needle[0]);
+    const __m256i last = _mm256_set1_epi16(needle[needleLen - 1]);
+
+    // we're going to read h[0..15] and h[needleLen-1..needleLen+14]
+    for ( ; end - h >= 15; h += 16) {
+        const __m256i firstData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h));
+        const __m256i lastData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + needleLen - 1));
+        uint mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi16(firstData, first),
+                                                          _mm256_cmpeq_epi16(lastData, last)));
+        while (mask) {
+            const uint idx = uint(_bit_scan_forward(mask));
+            if (memcmp(h + idx / 2 + 1, needle + 1, (needleLen - 2) * sizeof(ushort)) == 0)
+                return h - haystack + idx / 2;
+            mask &= ~(3U << idx);
+        }
+    }
+    return findStringCaseSensitiveTail(haystack, h, end, needle, needleLen);
+}
+#  endif
+
+static int findStringCaseSensitive(const ushort *haystack, int haystackLen, int from,
+                                   const ushort *needle, int needleLen)
+{
+    Q_ASSERT(needleLen >= 2);
+    if (from > haystackLen - needleLen)
+        return -1;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return findStringCaseSensitiveAvx2(haystack, haystackLen, from, needle, needleLen);
+#  endif
+    return findStringCaseSensitiveSse2(haystack, haystackLen, from, needle, needleLen);
+}
+#endif
+
 #define REHASH(a) \
     if (sl_minus_1 < (int)sizeof(int) * CHAR_BIT)       \
         hashHaystack -= (a) << sl_minus_1; \
@@ -1091,7 +1415,9 @@ const QString::Null QString::null = { };
     the 'e', 'E', and 'f' formats, the \e precision represents the
     number of digits \e after the decimal point. For the 'g' and 'G'
     formats, the \e precision represents the maximum number of
-    significant digits (trailing zeroes are omitted).
+    significant digits (trailing zeroes are omitted). With
+    QLocale::FloatingPointShortest as \e precision, the shortest
+    representation that reads back as the same number is used.
 
     \section1 More Efficient String Construction
 
@@ -1689,7 +2015,8 @@ void QString::reallocData(uint alloc, bool grow)
         alloc = qAllocMore(alloc * sizeof(QChar), sizeof(Data)) / sizeof(QChar);
     }
 
-    if (d->ref.isShared() || IS_RAW_DATA(d)) {
+    // arena blocks cannot be resized in place
+    if (d->ref.isShared() || IS_RAW_DATA(d) || QArrayDataArena::isArenaBlock(d)) {
         Data::AllocationOptions allocOptions(d->capacityReserved ? Data::CapacityReserved : 0);
         Data *x = Data::allocate(alloc, allocOptions);
         Q_CHECK_PTR(x);
@@ -2976,6 +3303,17 @@ int qFindString(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle0[0], from, cs);
 
+#ifdef __SSE2__
+    if (cs == Qt::CaseSensitive) {
+        return findStringCaseSensitive(reinterpret_cast<const ushort *>(haystack0), l, from,
+                                       reinterpret_cast<const ushort *>(needle0), sl);
+    }
+    if (canFindStringCaseInsensitiveAscii(reinterpret_cast<const ushort *>(needle0), sl)) {
+        return findStringCaseInsensitiveAscii(reinterpret_cast<const ushort *>(haystack0), l, from,
+                                              reinterpret_cast<const ushort *>(needle0), sl);
+    }
+#endif
+
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
@@ -35,6 +35,15 @@
 
 QT_BEGIN_NAMESPACE
 
+#ifdef __SSE2__
+// in qstring.cpp
+static bool canFindStringCaseInsensitiveAscii(const ushort *needle, int needleLen);
+static int findStringCaseInsensitiveAscii(const ushort *haystack, int haystackLen, int from,
+                                          const ushort *needle, int needleLen);
+static int findStringCaseSensitive(const ushort *haystack, int haystackLen, int from,
+                                   const ushort *needle, int needleLen);
+#endif
+
 static void bm_init_skiptable(const ushort *uc, int len, uchar *skiptable, Qt::CaseSensitivity cs)
 {
     int l = qMin(len, 255);
@@ -64,6 +73,11 @@ static inline int bm_find(const ushort *uc, uint l, int index, const ushort *puc
     const ushort *current = uc + index + pl_minus_one;
     const ushort *end = uc + l;
     if (cs == Qt::CaseSensitive) {
+#ifdef __SSE2__
+        // see simd_find() in qbytearraymatcher.cpp
+        if (pl >= 2)
+            return findStringCaseSensitive(uc, l, index, puc, pl);
+#endif
         while (current < end) {
             uint skip = skiptable[*current & 0xff];
             if (!skip) {
@@ -88,6 +102,13 @@ static inline int bm_find(const ushort *uc, uint l, int index, const ushort *puc
             current += skip;
         }
     } else {
+#ifdef __SSE2__
+        // comparing the first and the last character of the pattern for
+        // several positions at once beats skipping, unless they need the
+        // case folding tables
+        if (canFindStringCaseInsensitiveAscii(puc, pl))
+            return findStringCaseInsensitiveAscii(uc, l, index, puc, pl);
+#endif
         while (current < end) {
             uint skip = skiptable[foldCase(current, uc) & 0xff];
             if (!skip) {
@@ -611,6 +611,30 @@ int QTimeZone::offsetFromUtc(const QDateTime &atDateTime) const
         return 0;
 }
 
+/*!
+    \since 5.6
+
+    Returns the total effective offsets from UTC, as returned by
+    offsetFromUtc(), for each of the times in \a msecsSinceEpoch, given as
+    the number of milliseconds since 1970-01-01T00:00:00 UTC.
+
+    This is considerably faster than calling offsetFromUtc() for each time
+    individually, in particular when the times are sorted or clustered, as
+    is usually the case when converting the timestamps of a log.
+
+    If the time zone is not valid, all returned offsets are 0.
+
+    \sa offsetFromUtc()
+*/
+
+QVector<int> QTimeZone::offsetsFromUtc(const QVector<qint64> &msecsSinceEpoch) const
+{
+    QVector<int> offsets(msecsSinceEpoch.size());
+    if (isValid())
+        d->offsetsFromUtc(msecsSinceEpoch.constData(), offsets.data(), msecsSinceEpoch.size());
+    return offsets;
+}
+
 /*!
     Returns the standard time offset at the given \a atDateTime, i.e. the
     number of seconds to add to UTC to obtain the local Standard Time.  This
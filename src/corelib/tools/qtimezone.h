@@ -103,6 +103,7 @@ public:
     QString abbreviation(const QDateTime &atDateTime) const;
 
     int offsetFromUtc(const QDateTime &atDateTime) const;
+    QVector<int> offsetsFromUtc(const QVector<qint64> &msecsSinceEpoch) const;
     int standardTimeOffset(const QDateTime &atDateTime) const;
     int daylightTimeOffset(const QDateTime &atDateTime) const;
 
@@ -212,6 +212,12 @@ int QTimeZonePrivate::offsetFromUtc(qint64 atMSecsSinceEpoch) const
     return standardTimeOffset(atMSecsSinceEpoch) + daylightTimeOffset(atMSecsSinceEpoch);
 }
 
+void QTimeZonePrivate::offsetsFromUtc(const qint64 *atMSecsSinceEpoch, int *offsets, int count) const
+{
+    for (int i = 0; i < count; ++i)
+        offsets[i] = offsetFromUtc(atMSecsSinceEpoch[i]);
+}
+
 int QTimeZonePrivate::standardTimeOffset(qint64 atMSecsSinceEpoch) const
 {
     Q_UNUSED(atMSecsSinceEpoch)
@@ -112,6 +112,7 @@ public:
     virtual int offsetFromUtc(qint64 atMSecsSinceEpoch) const;
     virtual int standardTimeOffset(qint64 atMSecsSinceEpoch) const;
     virtual int daylightTimeOffset(qint64 atMSecsSinceEpoch) const;
+    virtual void offsetsFromUtc(const qint64 *atMSecsSinceEpoch, int *offsets, int count) const;
 
     virtual bool hasDaylightTime() const;
     virtual bool isDaylightTime(qint64 atMSecsSinceEpoch) const;
@@ -308,6 +309,7 @@ public:
     int offsetFromUtc(qint64 atMSecsSinceEpoch) const Q_DECL_OVERRIDE;
     int standardTimeOffset(qint64 atMSecsSinceEpoch) const Q_DECL_OVERRIDE;
     int daylightTimeOffset(qint64 atMSecsSinceEpoch) const Q_DECL_OVERRIDE;
+    void offsetsFromUtc(const qint64 *atMSecsSinceEpoch, int *offsets, int count) const Q_DECL_OVERRIDE;
 
     bool hasDaylightTime() const Q_DECL_OVERRIDE;
     bool isDaylightTime(qint64 atMSecsSinceEpoch) const Q_DECL_OVERRIDE;
@@ -327,6 +329,9 @@ private:
     void init(const QByteArray &ianaId);
 
     Data dataForTzTransition(QTzTransitionTime tran) const;
+    int transitionIndex(qint64 atMSecsSinceEpoch) const;
+    bool usePosixRule(qint64 atMSecsSinceEpoch) const;
+    const QTzTransitionRule *ruleFor(qint64 atMSecsSinceEpoch) const;
     QVector<QTzTransitionTime> m_tranTimes;
     QVector<QTzTransitionRule> m_tranRules;
     QList<QByteArray> m_abbreviations;
@@ -334,6 +339,7 @@ private:
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif // QT_USE_ICU
     QByteArray m_posixRule;
+    bool m_hasDaylightTime;
 };
 #endif // Q_OS_UNIX
 
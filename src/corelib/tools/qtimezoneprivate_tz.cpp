@@ -36,8 +36,10 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QHash>
+#include <QtCore/QCache>
 #include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
+#include <QtCore/QMutex>
 
 #include <qdebug.h>
 
@@ -510,8 +512,11 @@ static QVector<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArra
 // Create the system default time zone
 QTzTimeZonePrivate::QTzTimeZonePrivate()
 #ifdef QT_USE_ICU
-    : m_icu(0)
+    : m_icu(0),
+#else
+    :
 #endif // QT_USE_ICU
+      m_hasDaylightTime(false)
 {
     init(systemTimeZoneId());
 }
@@ -519,8 +524,11 @@ QTzTimeZonePrivate::QTzTimeZonePrivate()
 // Create a named time zone
 QTzTimeZonePrivate::QTzTimeZonePrivate(const QByteArray &ianaId)
 #ifdef QT_USE_ICU
-    : m_icu(0)
+    : m_icu(0),
+#else
+    :
 #endif // QT_USE_ICU
+      m_hasDaylightTime(false)
 {
     init(ianaId);
 }
@@ -531,7 +539,8 @@ QTzTimeZonePrivate::QTzTimeZonePrivate(const QTzTimeZonePrivate &other)
 #ifdef QT_USE_ICU
                     m_icu(other.m_icu),
 #endif // QT_USE_ICU
-                    m_posixRule(other.m_posixRule)
+                    m_posixRule(other.m_posixRule),
+                    m_hasDaylightTime(other.m_hasDaylightTime)
 {
 }
 
@@ -544,21 +553,34 @@ QTimeZonePrivate *QTzTimeZonePrivate::clone()
     return new QTzTimeZonePrivate(*this);
 }
 
-void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+// Parsed contents of a TZif file, shared by all QTzTimeZonePrivate instances
+// for the same zone
+struct QTzTimeZoneCacheEntry
+{
+    QTzTimeZoneCacheEntry() : m_hasDaylightTime(false) {}
+
+    QVector<QTzTransitionTime> m_tranTimes;
+    QVector<QTzTransitionRule> m_tranRules;
+    QList<QByteArray> m_abbreviations;
+    QByteArray m_posixRule;
+    bool m_hasDaylightTime;
+};
+
+static bool parseTzFile(const QByteArray &ianaId, QTzTimeZoneCacheEntry *entry)
 {
     QFile tzif;
     if (ianaId.isEmpty()) {
         // Open system tz
         tzif.setFileName(QStringLiteral("/etc/localtime"));
         if (!tzif.open(QIODevice::ReadOnly))
-            return;
+            return false;
     } else {
         // Open named tz, try modern path first, if fails try legacy path
         tzif.setFileName(QLatin1String("/usr/share/zoneinfo/") + QString::fromLocal8Bit(ianaId));
         if (!tzif.open(QIODevice::ReadOnly)) {
             tzif.setFileName(QLatin1String("/usr/lib/zoneinfo/") + QString::fromLocal8Bit(ianaId));
             if (!tzif.open(QIODevice::ReadOnly))
-                return;
+                return false;
         }
     }
 
@@ -568,53 +590,53 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
     bool ok = false;
     QTzHeader hdr = parseTzHeader(ds, &ok);
     if (!ok || ds.status() != QDataStream::Ok)
-        return;
+        return false;
     QVector<QTzTransition> tranList = parseTzTransitions(ds, hdr.tzh_timecnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return false;
     QVector<QTzType> typeList = parseTzTypes(ds, hdr.tzh_typecnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return false;
     QMap<int, QByteArray> abbrevMap = parseTzAbbreviations(ds, hdr.tzh_charcnt, typeList);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return false;
     parseTzLeapSeconds(ds, hdr.tzh_leapcnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return false;
     typeList = parseTzIndicators(ds, typeList, hdr.tzh_ttisstdcnt, hdr.tzh_ttisgmtcnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return false;
 
     // If version 2 then parse the second block of data
     if (hdr.tzh_version == '2' || hdr.tzh_version == '3') {
         ok = false;
         QTzHeader hdr2 = parseTzHeader(ds, &ok);
         if (!ok || ds.status() != QDataStream::Ok)
-            return;
+            return false;
         tranList = parseTzTransitions(ds, hdr2.tzh_timecnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return false;
         typeList = parseTzTypes(ds, hdr2.tzh_typecnt);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return false;
         abbrevMap = parseTzAbbreviations(ds, hdr2.tzh_charcnt, typeList);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return false;
         parseTzLeapSeconds(ds, hdr2.tzh_leapcnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return false;
         typeList = parseTzIndicators(ds, typeList, hdr2.tzh_ttisstdcnt, hdr2.tzh_ttisgmtcnt);
         if (ds.status() != QDataStream::Ok)
-            return;
-        m_posixRule = parseTzPosixRule(ds);
+            return false;
+        entry->m_posixRule = parseTzPosixRule(ds);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return false;
     }
 
     // Translate the TZ file into internal format
 
     // Translate the array index based tz_abbrind into list index
-    m_abbreviations = abbrevMap.values();
+    entry->m_abbreviations = abbrevMap.values();
     QList<int> abbrindList = abbrevMap.keys();
     for (int i = 0; i < typeList.size(); ++i)
         typeList[i].tz_abbrind = abbrindList.indexOf(typeList.at(i).tz_abbrind);
@@ -630,6 +652,7 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
     }
 
     // Now for each transition time calculate our rule and save them
+    entry->m_tranTimes.reserve(tranList.size());
     foreach (const QTzTransition &tz_tran, tranList) {
         QTzTransitionTime tran;
         QTzTransitionRule rule;
@@ -642,13 +665,15 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         rule.dstOffset = tz_type.tz_gmtoff - utcOffset;
         rule.abbreviationIndex = tz_type.tz_abbrind;
         // If the rule already exist then use that, otherwise add it
-        int ruleIndex = m_tranRules.indexOf(rule);
+        int ruleIndex = entry->m_tranRules.indexOf(rule);
         if (ruleIndex == -1) {
-            m_tranRules.append(rule);
-            tran.ruleIndex = m_tranRules.size() - 1;
+            entry->m_tranRules.append(rule);
+            tran.ruleIndex = entry->m_tranRules.size() - 1;
         } else {
             tran.ruleIndex = ruleIndex;
         }
+        if (rule.dstOffset != 0)
+            entry->m_hasDaylightTime = true;
 
         // TODO convert to UTC if not in UTC
         if (tz_type.tz_ttisgmt)
@@ -658,9 +683,63 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         else
             tran.atMSecsSinceEpoch = tz_tran.tz_time * 1000;
 
-        m_tranTimes.append(tran);
+        entry->m_tranTimes.append(tran);
     }
 
+    return true;
+}
+
+// Process-wide cache of parsed zones, so that creating a QTimeZone for a zone
+// that was used before doesn't read and parse its TZif file again.
+class QTzTimeZoneCache
+{
+public:
+    QTzTimeZoneCache() : m_cache(100) {}
+
+    bool fetchEntry(const QByteArray &ianaId, QTzTimeZoneCacheEntry *entry);
+
+private:
+    QCache<QByteArray, QTzTimeZoneCacheEntry> m_cache;
+    QMutex m_mutex;
+};
+
+bool QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId, QTzTimeZoneCacheEntry *entry)
+{
+    // The system zone may be replaced while we run, don't cache it
+    if (ianaId.isEmpty())
+        return parseTzFile(ianaId, entry);
+
+    QMutexLocker locker(&m_mutex);
+    if (const QTzTimeZoneCacheEntry *cached = m_cache.object(ianaId)) {
+        *entry = *cached;
+        return true;
+    }
+    locker.unlock();
+
+    // Parse without holding the lock; if two threads race for the same
+    // zone, the second insert just replaces an identical entry.
+    if (!parseTzFile(ianaId, entry))
+        return false;
+
+    locker.relock();
+    m_cache.insert(ianaId, new QTzTimeZoneCacheEntry(*entry));
+    return true;
+}
+
+Q_GLOBAL_STATIC(QTzTimeZoneCache, tzCache)
+
+void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+{
+    QTzTimeZoneCacheEntry entry;
+    if (!tzCache()->fetchEntry(ianaId, &entry))
+        return;
+
+    m_tranTimes = entry.m_tranTimes;
+    m_tranRules = entry.m_tranRules;
+    m_abbreviations = entry.m_abbreviations;
+    m_posixRule = entry.m_posixRule;
+    m_hasDaylightTime = entry.m_hasDaylightTime;
+
     if (ianaId.isEmpty())
         m_id = systemTimeZoneId();
     else
@@ -765,28 +844,68 @@ QString QTzTimeZonePrivate::abbreviation(qint64 atMSecsSinceEpoch) const
 
 int QTzTimeZonePrivate::offsetFromUtc(qint64 atMSecsSinceEpoch) const
 {
+    // Avoid building the full Data, and its abbreviation, for the common case
+    if (const QTzTransitionRule *rule = ruleFor(atMSecsSinceEpoch))
+        return rule->stdOffset + rule->dstOffset;
     const QTimeZonePrivate::Data tran = data(atMSecsSinceEpoch);
     return tran.standardTimeOffset + tran.daylightTimeOffset;
 }
 
 int QTzTimeZonePrivate::standardTimeOffset(qint64 atMSecsSinceEpoch) const
 {
+    if (const QTzTransitionRule *rule = ruleFor(atMSecsSinceEpoch))
+        return rule->stdOffset;
     return data(atMSecsSinceEpoch).standardTimeOffset;
 }
 
 int QTzTimeZonePrivate::daylightTimeOffset(qint64 atMSecsSinceEpoch) const
 {
+    if (const QTzTransitionRule *rule = ruleFor(atMSecsSinceEpoch))
+        return rule->dstOffset;
     return data(atMSecsSinceEpoch).daylightTimeOffset;
 }
 
-bool QTzTimeZonePrivate::hasDaylightTime() const
+void QTzTimeZonePrivate::offsetsFromUtc(const qint64 *atMSecsSinceEpoch, int *offsets, int count) const
 {
-    // TODO Perhaps cache as frequently accessed?
-    foreach (const QTzTransitionRule &rule, m_tranRules) {
-        if (rule.dstOffset != 0)
-            return true;
+    // Timestamps converted in bulk tend to be close to each other, so first
+    // check whether the next one falls between the same two transitions as
+    // the previous one before searching the table again.
+    qint64 intervalStart = 0;
+    qint64 intervalEnd = 0;
+    int intervalOffset = 0;
+    bool haveInterval = false;
+
+    for (int i = 0; i < count; ++i) {
+        const qint64 msecs = atMSecsSinceEpoch[i];
+        if (haveInterval && msecs >= intervalStart && msecs < intervalEnd) {
+            offsets[i] = intervalOffset;
+            continue;
+        }
+
+        if (m_tranTimes.isEmpty() || usePosixRule(msecs)) {
+            offsets[i] = offsetFromUtc(msecs);
+            haveInterval = false;
+            continue;
+        }
+
+        const int index = transitionIndex(msecs);
+        const QTzTransitionRule &rule = m_tranRules.at(m_tranTimes.at(qMax(index, 0)).ruleIndex);
+        intervalOffset = rule.stdOffset + rule.dstOffset;
+        intervalStart = index < 0 ? minMSecs() : m_tranTimes.at(index).atMSecsSinceEpoch;
+        if (index + 1 < m_tranTimes.size())
+            intervalEnd = m_tranTimes.at(index + 1).atMSecsSinceEpoch;
+        else if (m_posixRule.isEmpty())
+            intervalEnd = maxMSecs();
+        else
+            intervalEnd = intervalStart + 1; // later times are governed by the POSIX rule
+        haveInterval = true;
+        offsets[i] = intervalOffset;
     }
-    return false;
+}
+
+bool QTzTimeZonePrivate::hasDaylightTime() const
+{
+    return m_hasDaylightTime;
 }
 
 bool QTzTimeZonePrivate::isDaylightTime(qint64 atMSecsSinceEpoch) const
@@ -806,11 +925,47 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
     return data;
 }
 
+namespace {
+struct QTzTransitionTimeLessThan
+{
+    bool operator()(qint64 msecs, const QTzTransitionTime &tran) const
+    { return msecs < tran.atMSecsSinceEpoch; }
+    bool operator()(const QTzTransitionTime &tran, qint64 msecs) const
+    { return tran.atMSecsSinceEpoch < msecs; }
+};
+}
+
+// Returns the index of the last transition at or before the given time, or -1 if none
+int QTzTimeZonePrivate::transitionIndex(qint64 atMSecsSinceEpoch) const
+{
+    const QVector<QTzTransitionTime>::const_iterator it
+        = std::upper_bound(m_tranTimes.constBegin(), m_tranTimes.constEnd(),
+                           atMSecsSinceEpoch, QTzTransitionTimeLessThan());
+    return int(it - m_tranTimes.constBegin()) - 1;
+}
+
+// Returns true if the given time is after the last transition and covered by the POSIX rule
+bool QTzTimeZonePrivate::usePosixRule(qint64 atMSecsSinceEpoch) const
+{
+    return m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < atMSecsSinceEpoch
+           && !m_posixRule.isEmpty() && atMSecsSinceEpoch >= 0;
+}
+
+// Returns the transition rule in effect at the given time, or 0 if it has to be
+// calculated from the POSIX rule or the zone has no transitions at all
+const QTzTransitionRule *QTzTimeZonePrivate::ruleFor(qint64 atMSecsSinceEpoch) const
+{
+    if (m_tranTimes.isEmpty() || usePosixRule(atMSecsSinceEpoch))
+        return 0;
+    // Before the first transition, use the earliest one we have, as data() does
+    const int index = qMax(transitionIndex(atMSecsSinceEpoch), 0);
+    return &m_tranRules.at(m_tranTimes.at(index).ruleIndex);
+}
+
 QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
 {
     // If the required time is after the last transition and we have a POSIX rule then use it
-    if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch
-        &&!m_posixRule.isEmpty() && forMSecsSinceEpoch >= 0) {
+    if (usePosixRule(forMSecsSinceEpoch)) {
         const int year = QDateTime::fromMSecsSinceEpoch(forMSecsSinceEpoch, Qt::UTC).date().year();
         const int lastMSecs = (m_tranTimes.size() > 0) ? m_tranTimes.last().atMSecsSinceEpoch : 0;
         QVector<QTimeZonePrivate::Data> posixTrans = calculatePosixTransitions(m_posixRule, year - 1,
@@ -825,18 +980,11 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
         }
     }
 
-    // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
-            Data data = dataForTzTransition(m_tranTimes.at(i));
-            data.atMSecsSinceEpoch = forMSecsSinceEpoch;
-            return data;
-        }
-    }
-
-    // Otherwise use the earliest transition we have
+    // Otherwise if we can find a valid tran then use its rule,
+    // or else use the earliest transition we have
     if (m_tranTimes.size() > 0) {
-        Data data = dataForTzTransition(m_tranTimes.at(0));
+        const int index = qMax(transitionIndex(forMSecsSinceEpoch), 0);
+        Data data = dataForTzTransition(m_tranTimes.at(index));
         data.atMSecsSinceEpoch = forMSecsSinceEpoch;
         return data;
     }
@@ -853,8 +1001,7 @@ bool QTzTimeZonePrivate::hasTransitions() const
 QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSinceEpoch) const
 {
     // If the required time is after the last transition and we have a POSIX rule then use it
-    if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < afterMSecsSinceEpoch
-        &&!m_posixRule.isEmpty() && afterMSecsSinceEpoch >= 0) {
+    if (usePosixRule(afterMSecsSinceEpoch)) {
         const int year = QDateTime::fromMSecsSinceEpoch(afterMSecsSinceEpoch, Qt::UTC).date().year();
         const int lastMSecs = (m_tranTimes.size() > 0) ? m_tranTimes.last().atMSecsSinceEpoch : 0;
         QVector<QTimeZonePrivate::Data> posixTrans = calculatePosixTransitions(m_posixRule, year - 1,
@@ -866,11 +1013,9 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = 0; i < m_tranTimes.size(); ++i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const int next = transitionIndex(afterMSecsSinceEpoch) + 1;
+    if (next < m_tranTimes.size())
+        return dataForTzTransition(m_tranTimes.at(next));
 
     // Otherwise we have no rule, or there is no next transition, so return invalid data
     return invalidData();
@@ -892,11 +1037,11 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecs
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const QVector<QTzTransitionTime>::const_iterator it
+        = std::lower_bound(m_tranTimes.constBegin(), m_tranTimes.constEnd(),
+                           beforeMSecsSinceEpoch, QTzTransitionTimeLessThan());
+    if (it != m_tranTimes.constBegin())
+        return dataForTzTransition(*(it - 1));
 
     // Otherwise we have no rule, so return invalid data
     return invalidData();
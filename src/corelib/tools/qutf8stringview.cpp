@@ -0,0 +1,944 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qutf8stringview.h"
+
+#include "qvarlengtharray.h"
+#include "qvector.h"
+#include "private/qlocale_p.h"
+#include "private/qsimd_p.h"
+#include "private/qstringalgorithms_p.h"
+#include "private/qstringiterator_p.h"
+#include "private/qutfcodec_p.h"
+
+QT_BEGIN_NAMESPACE
+
+int qFindByteArray(
+    const char *haystack0, int haystackLen, int from,
+    const char *needle0, int needleLen);
+
+namespace {
+// The readers below return one code point at a time. Invalid UTF-8 decodes
+// to one U+FFFD per offending byte, as in QString::fromUtf8().
+struct Utf8Reader
+{
+    const uchar *ptr;
+    const uchar *end;
+
+    Utf8Reader(const char *data, int size)
+        : ptr(reinterpret_cast<const uchar *>(data)), end(ptr + size) {}
+
+    bool hasNext() const { return ptr < end; }
+    uint next()
+    {
+        const uchar b = *ptr++;
+        if (b < 0x80)
+            return b;
+        uint uc;
+        uint *dst = &uc;
+        if (QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, ptr, end) < 0)
+            return QChar::ReplacementCharacter;
+        return uc;
+    }
+};
+
+struct Latin1Reader
+{
+    const uchar *ptr;
+    const uchar *end;
+
+    explicit Latin1Reader(QLatin1String s)
+        : ptr(reinterpret_cast<const uchar *>(s.data())), end(ptr + s.size()) {}
+
+    bool hasNext() const { return ptr < end; }
+    uint next() { return *ptr++; }
+};
+
+struct Utf16Reader
+{
+    QStringIterator it;
+
+    explicit Utf16Reader(const QString &s) : it(s) {}
+
+    bool hasNext() const { return it.hasNext(); }
+    uint next() { return it.next(); }
+};
+} // unnamed namespace
+
+static inline uint foldCase(uint c)
+{
+    if (c < 0x80)
+        return c - 'A' < 26u ? c + 0x20 : c;
+    return QChar::toCaseFolded(c);
+}
+
+template <typename Reader1, typename Reader2>
+static int compareCodePoints(Reader1 a, Reader2 b, Qt::CaseSensitivity cs)
+{
+    while (a.hasNext() && b.hasNext()) {
+        uint ca = a.next();
+        uint cb = b.next();
+        if (ca != cb && cs == Qt::CaseInsensitive) {
+            ca = foldCase(ca);
+            cb = foldCase(cb);
+        }
+        if (ca != cb)
+            return ca < cb ? -1 : 1;
+    }
+    return int(a.hasNext()) - int(b.hasNext());
+}
+
+// Returns the number of bytes at the start of \a data that match \a needle
+// case-insensitively, or -1 if they don't. That's not necessarily the size
+// of the needle: U+212A KELVIN SIGN takes three bytes and matches 'k'.
+static int matchCaseInsensitive(const char *data, int size, QUtf8StringView needle)
+{
+    Utf8Reader h(data, size);
+    Utf8Reader n(needle.data(), needle.size());
+    while (n.hasNext()) {
+        if (!h.hasNext())
+            return -1;
+        const uint ch = h.next();
+        const uint cn = n.next();
+        if (ch != cn && foldCase(ch) != foldCase(cn))
+            return -1;
+    }
+    return int(h.ptr - reinterpret_cast<const uchar *>(data));
+}
+
+static int findCaseInsensitive(const char *data, int size, int from, QUtf8StringView needle,
+                               int *matchLength)
+{
+    Q_ASSERT(!needle.isEmpty());
+
+    // If the needle starts with an ASCII character, only that character in
+    // either case can start a match, unless it is one of the two letters
+    // that non-ASCII characters fold to as well.
+    uchar lower = 0;
+    uchar upper = 0;
+    const uchar first = uchar(needle.at(0));
+    if (first < 0x80) {
+        lower = uchar(foldCase(first));
+        upper = uint(lower - 'a') < 26u ? lower - 0x20 : lower;
+        if (lower == 'k' || lower == 's')
+            lower = upper = 0;
+    }
+
+    int i = from;
+#ifdef __SSE2__
+    if (lower) {
+        const __m128i lowerMask = _mm_set1_epi8(lower);
+        const __m128i upperMask = _mm_set1_epi8(upper);
+        for ( ; i + 16 <= size; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            uint mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, lowerMask),
+                                                       _mm_cmpeq_epi8(chunk, upperMask)));
+            while (mask) {
+                const int idx = i + _bit_scan_forward(mask);
+                const int len = matchCaseInsensitive(data + idx, size - idx, needle);
+                if (len >= 0) {
+                    if (matchLength)
+                        *matchLength = len;
+                    return idx;
+                }
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+
+    for ( ; i < size; ++i) {
+        const uchar c = uchar(data[i]);
+        if (lower) {
+            if (c != lower && c != upper)
+                continue;
+        } else if (QUtf8Functions::isContinuationByte(c)) {
+            continue;
+        }
+        const int len = matchCaseInsensitive(data + i, size - i, needle);
+        if (len >= 0) {
+            if (matchLength)
+                *matchLength = len;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*!
+    \class QUtf8StringView
+    \inmodule QtCore
+    \since 5.6
+    \brief The QUtf8StringView class is a non-owning view of UTF-8 encoded text.
+
+    \ingroup tools
+    \ingroup shared
+    \ingroup string-processing
+    \reentrant
+
+    Data that arrives from files and sockets is usually UTF-8. Most of the
+    time it is only compared, searched, split or parsed into numbers before
+    being passed on, and converting it to a QString for that first costs a
+    pass over the data and twice the memory for ASCII text. QUtf8StringView
+    does these operations directly on the UTF-8 bytes.
+
+    A QUtf8StringView refers to a range of bytes it does not own, like
+    QLatin1String. The bytes must stay valid for as long as the view, or any
+    view obtained from it with left(), mid(), split() and so on, is used.
+
+    Indexes and sizes are in bytes, not characters. Case-sensitive operations
+    work on the raw bytes and are as fast as their QByteArray counterparts.
+    Case-insensitive operations, comparisons with QLatin1String and QString,
+    and toString() decode the text, treating malformed sequences the way
+    QString::fromUtf8() does. Comparisons order strings by Unicode code
+    point, which for UTF-8 is the order of the bytes; QString::compare()
+    orders by UTF-16 code unit instead, which only differs for characters
+    outside the Basic Multilingual Plane compared to characters from U+E000
+    to U+FFFF.
+
+    qHash() of a QUtf8StringView is the same as that of a QByteArray with
+    the same contents.
+
+    \sa QLatin1String, QByteArray, QString::fromUtf8()
+*/
+
+/*!
+    \typedef QUtf8StringView::const_iterator
+
+    A pointer to the bytes of the view.
+*/
+
+/*!
+    \typedef QUtf8StringView::iterator
+
+    Same as const_iterator; the bytes of a view can't be modified.
+*/
+
+/*!
+    \fn QUtf8StringView::QUtf8StringView()
+
+    Constructs a null view.
+
+    \sa isNull()
+*/
+
+/*!
+    \fn QUtf8StringView::QUtf8StringView(const char *s)
+
+    Constructs a view of the '\\0'-terminated string \a s.
+*/
+
+/*!
+    \fn QUtf8StringView::QUtf8StringView(const char *s, int size)
+
+    Constructs a view of the \a size bytes starting at \a s.
+*/
+
+/*!
+    \fn QUtf8StringView::QUtf8StringView(const QByteArray &ba)
+
+    Constructs a view of the contents of \a ba. The view is invalidated
+    when \a ba is modified or destroyed.
+*/
+
+/*!
+    \fn const char *QUtf8StringView::data() const
+
+    Returns a pointer to the first byte of the view. The bytes are not
+    necessarily '\\0'-terminated.
+*/
+
+/*!
+    \fn int QUtf8StringView::size() const
+
+    Returns the number of bytes in the view.
+*/
+
+/*!
+    \fn bool QUtf8StringView::isNull() const
+
+    Returns \c true if the view doesn't refer to any data.
+
+    \sa isEmpty()
+*/
+
+/*!
+    \fn bool QUtf8StringView::isEmpty() const
+
+    Returns \c true if the view has no bytes.
+
+    \sa isNull()
+*/
+
+/*!
+    \fn char QUtf8StringView::at(int i) const
+
+    Returns the byte at index position \a i, which must be a valid index
+    position in the view.
+*/
+
+/*!
+    \fn char QUtf8StringView::operator[](int i) const
+
+    Same as at(\a i).
+*/
+
+/*!
+    \fn QUtf8StringView::const_iterator QUtf8StringView::begin() const
+
+    Returns a pointer to the first byte of the view.
+*/
+
+/*!
+    \fn QUtf8StringView::const_iterator QUtf8StringView::cbegin() const
+
+    Same as begin().
+*/
+
+/*!
+    \fn QUtf8StringView::const_iterator QUtf8StringView::end() const
+
+    Returns a pointer just past the last byte of the view.
+*/
+
+/*!
+    \fn QUtf8StringView::const_iterator QUtf8StringView::cend() const
+
+    Same as end().
+*/
+
+/*!
+    Returns a view of the first \a n bytes, or of all of them if \a n is
+    negative or greater than size().
+*/
+QUtf8StringView QUtf8StringView::left(int n) const
+{
+    if (uint(n) >= uint(m_size))
+        return *this;
+    return QUtf8StringView(m_data, n);
+}
+
+/*!
+    Returns a view of the last \a n bytes, or of all of them if \a n is
+    negative or greater than size().
+*/
+QUtf8StringView QUtf8StringView::right(int n) const
+{
+    if (uint(n) >= uint(m_size))
+        return *this;
+    return QUtf8StringView(m_data + m_size - n, n);
+}
+
+/*!
+    Returns a view of \a n bytes starting at position \a pos, or of all the
+    bytes from \a pos on if \a n is -1 (the default) or if there are fewer
+    than \a n bytes left.
+*/
+QUtf8StringView QUtf8StringView::mid(int pos, int n) const
+{
+    using namespace QtPrivate;
+    switch (QContainerImplHelper::mid(m_size, &pos, &n)) {
+    case QContainerImplHelper::Null:
+        return QUtf8StringView();
+    case QContainerImplHelper::Empty:
+        return QUtf8StringView(m_data + m_size, 0);
+    case QContainerImplHelper::Full:
+        return *this;
+    case QContainerImplHelper::Subset:
+        break;
+    }
+    return QUtf8StringView(m_data + pos, n);
+}
+
+/*!
+    Returns a view with the ASCII whitespace removed from the start and the
+    end, like QByteArray::trimmed().
+*/
+QUtf8StringView QUtf8StringView::trimmed() const
+{
+    const char *begin = m_data;
+    const char *end = m_data + m_size;
+    QStringAlgorithms<const QByteArray>::trimmed_helper_positions(begin, end);
+    return QUtf8StringView(begin, int(end - begin));
+}
+
+/*!
+    Returns \c true if the view holds well-formed UTF-8.
+*/
+bool QUtf8StringView::isValidUtf8() const Q_DECL_NOTHROW
+{
+    return QUtf8::isValidUtf8(m_data, m_size);
+}
+
+/*!
+    Compares this view with \a other and returns a negative integer, zero or
+    a positive integer if it is less than, equal to or greater than \a other.
+
+    If \a cs is Qt::CaseSensitive (the default), the bytes are compared.
+    Otherwise the case-folded characters are, as in QString::compare().
+*/
+int QUtf8StringView::compare(QUtf8StringView other, Qt::CaseSensitivity cs) const Q_DECL_NOTHROW
+{
+    if (cs == Qt::CaseSensitive) {
+        const int len = qMin(m_size, other.m_size);
+        const int r = len ? memcmp(m_data, other.m_data, len) : 0;
+        return r ? r : m_size - other.m_size;
+    }
+    return compareCodePoints(Utf8Reader(m_data, m_size), Utf8Reader(other.m_data, other.m_size), cs);
+}
+
+/*!
+    \overload
+
+    Compares this view with the Latin 1 string \a other, without converting
+    either of them.
+*/
+int QUtf8StringView::compare(QLatin1String other, Qt::CaseSensitivity cs) const Q_DECL_NOTHROW
+{
+    return compareCodePoints(Utf8Reader(m_data, m_size), Latin1Reader(other), cs);
+}
+
+/*!
+    \overload
+
+    Compares this view with \a other, without converting either of them.
+*/
+int QUtf8StringView::compare(const QString &other, Qt::CaseSensitivity cs) const Q_DECL_NOTHROW
+{
+    return compareCodePoints(Utf8Reader(m_data, m_size), Utf16Reader(other), cs);
+}
+
+/*!
+    Returns \c true if the view starts with \a str; otherwise returns
+    \c false. The comparison is case-insensitive if \a cs is
+    Qt::CaseInsensitive.
+*/
+bool QUtf8StringView::startsWith(QUtf8StringView str, Qt::CaseSensitivity cs) const Q_DECL_NOTHROW
+{
+    if (cs == Qt::CaseSensitive)
+        return str.m_size <= m_size && left(str.m_size) == str;
+    return matchCaseInsensitive(m_data, m_size, str) >= 0;
+}
+
+/*!
+    \fn bool QUtf8StringView::startsWith(char c) const
+    \overload
+
+    Returns \c true if the first byte of the view is \a c.
+*/
+
+/*!
+    Returns \c true if the view ends with \a str; otherwise returns
+    \c false. The comparison is case-insensitive if \a cs is
+    Qt::CaseInsensitive.
+*/
+bool QUtf8StringView::endsWith(QUtf8StringView str, Qt::CaseSensitivity cs) const Q_DECL_NOTHROW
+{
+    if (cs == Qt::CaseSensitive)
+        return str.m_size <= m_size && right(str.m_size) == str;
+
+    // str's characters match at most four bytes each
+    const int first = qMax(0, m_size - 4 * str.m_size);
+    for (int i = m_size; i >= first; --i) {
+        if (i < m_size && QUtf8Functions::isContinuationByte(uchar(m_data[i])))
+            continue;
+        if (matchCaseInsensitive(m_data + i, m_size - i, str) == m_size - i)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \fn bool QUtf8StringView::endsWith(char c) const
+    \overload
+
+    Returns \c true if the last byte of the view is \a c.
+*/
+
+/*!
+    Returns the index position of the first occurrence of \a str in the
+    view, searching forward from index position \a from. Returns -1 if
+    \a str is not found. If \a from is negative, it counts from the end of
+    the view.
+
+    The search is case-insensitive if \a cs is Qt::CaseInsensitive.
+
+    \sa lastIndexOf(), contains()
+*/
+int QUtf8StringView::indexOf(QUtf8StringView str, int from, Qt::CaseSensitivity cs) const Q_DECL_NOTHROW
+{
+    if (from < 0)
+        from = qMax(from + m_size, 0);
+    if (str.isEmpty())
+        return from <= m_size ? from : -1;
+    if (cs == Qt::CaseSensitive)
+        return qFindByteArray(m_data, m_size, from, str.m_data, str.m_size);
+    return findCaseInsensitive(m_data, m_size, from, str, Q_NULLPTR);
+}
+
+/*!
+    \overload
+
+    Returns the index position of the first occurrence of the byte \a c,
+    searching forward from index position \a from.
+*/
+int QUtf8StringView::indexOf(char c, int from) const Q_DECL_NOTHROW
+{
+    if (from < 0)
+        from = qMax(from + m_size, 0);
+    if (from >= m_size)
+        return -1;
+    const char *n = static_cast<const char *>(memchr(m_data + from, c, m_size - from));
+    return n ? int(n - m_data) : -1;
+}
+
+/*!
+    Returns the index position of the last occurrence of \a str in the view,
+    searching backward from index position \a from. If \a from is -1 (the
+    default), the search starts at the last byte. Returns -1 if \a str is
+    not found.
+
+    \sa indexOf()
+*/
+int QUtf8StringView::lastIndexOf(QUtf8StringView str, int from) const Q_DECL_NOTHROW
+{
+    if (from < 0)
+        from += m_size;
+    if (from > m_size - str.m_size)
+        from = m_size - str.m_size;
+    if (from < 0)
+        return -1;
+    if (!str.m_size)
+        return from;
+    for (int i = from; i >= 0; --i) {
+        if (m_data[i] == str.m_data[0] && memcmp(m_data + i + 1, str.m_data + 1, str.m_size - 1) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/*!
+    \overload
+
+    Returns the index position of the last occurrence of the byte \a c,
+    searching backward from index position \a from.
+*/
+int QUtf8StringView::lastIndexOf(char c, int from) const Q_DECL_NOTHROW
+{
+    if (from < 0)
+        from += m_size;
+    else if (from >= m_size)
+        from = m_size - 1;
+    for (int i = from; i >= 0; --i) {
+        if (m_data[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+/*!
+    \fn bool QUtf8StringView::contains(QUtf8StringView str, Qt::CaseSensitivity cs) const
+
+    Returns \c true if the view contains \a str; otherwise returns \c false.
+    The search is case-insensitive if \a cs is Qt::CaseInsensitive.
+*/
+
+/*!
+    \fn bool QUtf8StringView::contains(char c) const
+    \overload
+
+    Returns \c true if the view contains the byte \a c.
+*/
+
+/*!
+    Splits the view into views of the parts separated by \a sep. Empty parts
+    are left out if \a behavior is QString::SkipEmptyParts.
+
+    No data is copied: the parts refer to the same bytes as this view.
+
+    \sa QString::split()
+*/
+QVector<QUtf8StringView> QUtf8StringView::split(char sep, QString::SplitBehavior behavior) const
+{
+    QVector<QUtf8StringView> list;
+    int start = 0;
+    int end;
+    while ((end = indexOf(sep, start)) != -1) {
+        if (start != end || behavior == QString::KeepEmptyParts)
+            list.append(QUtf8StringView(m_data + start, end - start));
+        start = end + 1;
+    }
+    if (start != m_size || behavior == QString::KeepEmptyParts)
+        list.append(QUtf8StringView(m_data + start, m_size - start));
+    return list;
+}
+
+/*!
+    \overload
+
+    The separator is matched case-insensitively if \a cs is
+    Qt::CaseInsensitive.
+*/
+QVector<QUtf8StringView> QUtf8StringView::split(QUtf8StringView sep, QString::SplitBehavior behavior,
+                                                Qt::CaseSensitivity cs) const
+{
+    QVector<QUtf8StringView> list;
+    int start = 0;
+    int extra = 0;
+    int end;
+    int sepLength = sep.m_size;
+    while (true) {
+        if (cs == Qt::CaseSensitive || sep.isEmpty())
+            end = indexOf(sep, start + extra);
+        else
+            end = findCaseInsensitive(m_data, m_size, start + extra, sep, &sepLength);
+        if (end == -1)
+            break;
+        if (start != end || behavior == QString::KeepEmptyParts)
+            list.append(QUtf8StringView(m_data + start, end - start));
+        start = end + sepLength;
+        extra = sepLength ? 0 : 1;
+    }
+    if (start != m_size || behavior == QString::KeepEmptyParts)
+        list.append(QUtf8StringView(m_data + start, m_size - start));
+    return list;
+}
+
+namespace {
+// the number conversion functions of QLocaleData need '\0'-terminated input
+class NulTerminated
+{
+public:
+    explicit NulTerminated(QUtf8StringView s)
+        : buffer(s.size() + 1)
+    {
+        if (s.size())
+            memcpy(buffer.data(), s.data(), s.size());
+        buffer[s.size()] = '\0';
+    }
+
+    const char *constData() const { return buffer.constData(); }
+
+private:
+    QVarLengthArray<char, 64> buffer;
+};
+} // unnamed namespace
+
+static qlonglong toIntegral_helper(const char *data, bool *ok, int base, qlonglong)
+{
+    return QLocaleData::bytearrayToLongLong(data, base, ok);
+}
+
+static qulonglong toIntegral_helper(const char *data, bool *ok, int base, qulonglong)
+{
+    return QLocaleData::bytearrayToUnsLongLong(data, base, ok);
+}
+
+template <typename T> static inline
+T toIntegral_helper(QUtf8StringView s, bool *ok, int base)
+{
+    const bool isUnsigned = T(0) < T(-1);
+    typedef typename QtPrivate::QConditional<isUnsigned, qulonglong, qlonglong>::Type Int64;
+
+#if defined(QT_CHECK_RANGE)
+    if (base != 0 && (base < 2 || base > 36)) {
+        qWarning("QUtf8StringView::toIntegral: Invalid base %d", base);
+        base = 10;
+    }
+#endif
+
+    // we select the right overload by the last, unused parameter
+    Int64 val = toIntegral_helper(NulTerminated(s).constData(), ok, base, Int64());
+    if (T(val) != val) {
+        if (ok)
+            *ok = false;
+        val = 0;
+    }
+    return T(val);
+}
+
+/*!
+    Returns the view converted to a \c short using base \a base, which is 10
+    by default and must be between 2 and 36, or 0. The view is parsed
+    exactly like QByteArray::toShort() parses a byte array.
+
+    Returns 0 if the conversion fails. If \a ok is not 0, *\a{ok} is set to
+    \c false if a conversion error occurs and to \c true otherwise.
+*/
+short QUtf8StringView::toShort(bool *ok, int base) const
+{
+    return toIntegral_helper<short>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c {unsigned short}, like toShort().
+*/
+ushort QUtf8StringView::toUShort(bool *ok, int base) const
+{
+    return toIntegral_helper<ushort>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c int, like toShort().
+*/
+int QUtf8StringView::toInt(bool *ok, int base) const
+{
+    return toIntegral_helper<int>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c {unsigned int}, like toShort().
+*/
+uint QUtf8StringView::toUInt(bool *ok, int base) const
+{
+    return toIntegral_helper<uint>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to a \c long, like toShort().
+*/
+long QUtf8StringView::toLong(bool *ok, int base) const
+{
+    return toIntegral_helper<long>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c {unsigned long}, like toShort().
+*/
+ulong QUtf8StringView::toULong(bool *ok, int base) const
+{
+    return toIntegral_helper<ulong>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to a \c {long long}, like toShort().
+*/
+qlonglong QUtf8StringView::toLongLong(bool *ok, int base) const
+{
+    return toIntegral_helper<qlonglong>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to an \c {unsigned long long}, like toShort().
+*/
+qulonglong QUtf8StringView::toULongLong(bool *ok, int base) const
+{
+    return toIntegral_helper<qulonglong>(*this, ok, base);
+}
+
+/*!
+    Returns the view converted to a \c double, parsed like
+    QByteArray::toDouble() does.
+
+    Returns 0.0 if the conversion fails. If \a ok is not 0, *\a{ok} is set
+    to \c false if a conversion error occurs and to \c true otherwise.
+*/
+double QUtf8StringView::toDouble(bool *ok) const
+{
+    return QLocaleData::bytearrayToDouble(NulTerminated(*this).constData(), ok);
+}
+
+/*!
+    Returns the view converted to a \c float, like toDouble().
+*/
+float QUtf8StringView::toFloat(bool *ok) const
+{
+    return QLocaleData::convertDoubleToFloat(toDouble(ok), ok);
+}
+
+/*!
+    Returns the contents of the view decoded into a QString.
+
+    \sa toByteArray(), QString::fromUtf8()
+*/
+QString QUtf8StringView::toString() const
+{
+    return QString::fromUtf8(m_data, m_size);
+}
+
+/*!
+    \fn QByteArray QUtf8StringView::toByteArray() const
+
+    Returns a copy of the bytes of the view.
+
+    \sa toString()
+*/
+
+/*!
+    \fn bool operator==(QUtf8StringView lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+
+    Returns \c true if \a lhs and \a rhs hold the same bytes.
+*/
+
+/*!
+    \fn bool operator!=(QUtf8StringView lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+
+    Returns \c true if \a lhs and \a rhs hold different bytes.
+*/
+
+/*!
+    \fn bool operator<(QUtf8StringView lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+
+    Returns \c true if \a lhs is lexically less than \a rhs.
+
+    \sa QUtf8StringView::compare()
+*/
+
+/*!
+    \fn bool operator<=(QUtf8StringView lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+
+    Returns \c true if \a lhs is lexically less than or equal to \a rhs.
+*/
+
+/*!
+    \fn bool operator>(QUtf8StringView lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+
+    Returns \c true if \a lhs is lexically greater than \a rhs.
+*/
+
+/*!
+    \fn bool operator>=(QUtf8StringView lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+
+    Returns \c true if \a lhs is lexically greater than or equal to \a rhs.
+*/
+
+/*!
+    \fn bool operator==(QUtf8StringView lhs, const QByteArray &rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator!=(QUtf8StringView lhs, const QByteArray &rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(const QByteArray &lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator!=(const QByteArray &lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(QUtf8StringView lhs, const char *rhs)
+    \relates QUtf8StringView
+    \overload
+
+    \a rhs is taken to be '\\0'-terminated UTF-8.
+*/
+
+/*!
+    \fn bool operator!=(QUtf8StringView lhs, const char *rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(const char *lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator!=(const char *lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(QUtf8StringView lhs, QLatin1String rhs)
+    \relates QUtf8StringView
+    \overload
+
+    Returns \c true if \a lhs and \a rhs hold the same characters.
+*/
+
+/*!
+    \fn bool operator!=(QUtf8StringView lhs, QLatin1String rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(QLatin1String lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator!=(QLatin1String lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(QUtf8StringView lhs, const QString &rhs)
+    \relates QUtf8StringView
+    \overload
+
+    Returns \c true if \a lhs and \a rhs hold the same characters.
+*/
+
+/*!
+    \fn bool operator!=(QUtf8StringView lhs, const QString &rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator==(const QString &lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+/*!
+    \fn bool operator!=(const QString &lhs, QUtf8StringView rhs)
+    \relates QUtf8StringView
+    \overload
+*/
+
+QT_END_NAMESPACE
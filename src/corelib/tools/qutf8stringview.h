@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QUTF8STRINGVIEW_H
+#define QUTF8STRINGVIEW_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QUtf8StringView
+{
+public:
+    typedef const char *const_iterator;
+    typedef const_iterator iterator;
+
+    Q_DECL_CONSTEXPR inline QUtf8StringView() Q_DECL_NOTHROW : m_size(0), m_data(Q_NULLPTR) {}
+    inline explicit QUtf8StringView(const char *s) Q_DECL_NOTHROW : m_size(s ? int(strlen(s)) : 0), m_data(s) {}
+    Q_DECL_CONSTEXPR inline QUtf8StringView(const char *s, int size) Q_DECL_NOTHROW : m_size(size), m_data(s) {}
+    inline explicit QUtf8StringView(const QByteArray &ba) Q_DECL_NOTHROW : m_size(ba.size()), m_data(ba.constData()) {}
+
+    Q_DECL_CONSTEXPR inline const char *data() const Q_DECL_NOTHROW { return m_data; }
+    Q_DECL_CONSTEXPR inline int size() const Q_DECL_NOTHROW { return m_size; }
+    Q_DECL_CONSTEXPR inline bool isNull() const Q_DECL_NOTHROW { return !m_data; }
+    Q_DECL_CONSTEXPR inline bool isEmpty() const Q_DECL_NOTHROW { return !m_size; }
+
+    inline char at(int i) const { Q_ASSERT(uint(i) < uint(m_size)); return m_data[i]; }
+    inline char operator[](int i) const { return at(i); }
+
+    inline const_iterator begin() const Q_DECL_NOTHROW { return m_data; }
+    inline const_iterator cbegin() const Q_DECL_NOTHROW { return m_data; }
+    inline const_iterator end() const Q_DECL_NOTHROW { return m_data + m_size; }
+    inline const_iterator cend() const Q_DECL_NOTHROW { return m_data + m_size; }
+
+    QUtf8StringView left(int n) const Q_REQUIRED_RESULT;
+    QUtf8StringView right(int n) const Q_REQUIRED_RESULT;
+    QUtf8StringView mid(int pos, int n = -1) const Q_REQUIRED_RESULT;
+    QUtf8StringView trimmed() const Q_REQUIRED_RESULT;
+
+    bool isValidUtf8() const Q_DECL_NOTHROW;
+
+    int compare(QUtf8StringView other, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW;
+    int compare(QLatin1String other, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW;
+    int compare(const QString &other, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW;
+
+    bool startsWith(QUtf8StringView str, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW;
+    inline bool startsWith(char c) const Q_DECL_NOTHROW { return m_size && m_data[0] == c; }
+    bool endsWith(QUtf8StringView str, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW;
+    inline bool endsWith(char c) const Q_DECL_NOTHROW { return m_size && m_data[m_size - 1] == c; }
+
+    int indexOf(QUtf8StringView str, int from = 0, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW;
+    int indexOf(char c, int from = 0) const Q_DECL_NOTHROW;
+    int lastIndexOf(QUtf8StringView str, int from = -1) const Q_DECL_NOTHROW;
+    int lastIndexOf(char c, int from = -1) const Q_DECL_NOTHROW;
+    inline bool contains(QUtf8StringView str, Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_DECL_NOTHROW
+    { return indexOf(str, 0, cs) != -1; }
+    inline bool contains(char c) const Q_DECL_NOTHROW
+    { return indexOf(c) != -1; }
+
+    QVector<QUtf8StringView> split(char sep, QString::SplitBehavior behavior = QString::KeepEmptyParts) const Q_REQUIRED_RESULT;
+    QVector<QUtf8StringView> split(QUtf8StringView sep, QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                                   Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
+
+    short toShort(bool *ok = Q_NULLPTR, int base = 10) const;
+    ushort toUShort(bool *ok = Q_NULLPTR, int base = 10) const;
+    int toInt(bool *ok = Q_NULLPTR, int base = 10) const;
+    uint toUInt(bool *ok = Q_NULLPTR, int base = 10) const;
+    long toLong(bool *ok = Q_NULLPTR, int base = 10) const;
+    ulong toULong(bool *ok = Q_NULLPTR, int base = 10) const;
+    qlonglong toLongLong(bool *ok = Q_NULLPTR, int base = 10) const;
+    qulonglong toULongLong(bool *ok = Q_NULLPTR, int base = 10) const;
+    float toFloat(bool *ok = Q_NULLPTR) const;
+    double toDouble(bool *ok = Q_NULLPTR) const;
+
+    QString toString() const Q_REQUIRED_RESULT;
+    inline QByteArray toByteArray() const Q_REQUIRED_RESULT;
+
+private:
+    int m_size;
+    const char *m_data;
+};
+Q_DECLARE_TYPEINFO(QUtf8StringView, Q_PRIMITIVE_TYPE);
+
+inline QByteArray QUtf8StringView::toByteArray() const
+{ return QByteArray(m_data, m_size); }
+
+inline bool operator==(QUtf8StringView lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return lhs.size() == rhs.size() && (!lhs.size() || memcmp(lhs.data(), rhs.data(), lhs.size()) == 0); }
+inline bool operator!=(QUtf8StringView lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return !(lhs == rhs); }
+inline bool operator<(QUtf8StringView lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) < 0; }
+inline bool operator<=(QUtf8StringView lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) <= 0; }
+inline bool operator>(QUtf8StringView lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) > 0; }
+inline bool operator>=(QUtf8StringView lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) >= 0; }
+
+inline bool operator==(QUtf8StringView lhs, const QByteArray &rhs) Q_DECL_NOTHROW
+{ return lhs == QUtf8StringView(rhs); }
+inline bool operator!=(QUtf8StringView lhs, const QByteArray &rhs) Q_DECL_NOTHROW
+{ return lhs != QUtf8StringView(rhs); }
+inline bool operator==(const QByteArray &lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return QUtf8StringView(lhs) == rhs; }
+inline bool operator!=(const QByteArray &lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return QUtf8StringView(lhs) != rhs; }
+
+inline bool operator==(QUtf8StringView lhs, const char *rhs) Q_DECL_NOTHROW
+{ return lhs == QUtf8StringView(rhs); }
+inline bool operator!=(QUtf8StringView lhs, const char *rhs) Q_DECL_NOTHROW
+{ return lhs != QUtf8StringView(rhs); }
+inline bool operator==(const char *lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return QUtf8StringView(lhs) == rhs; }
+inline bool operator!=(const char *lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return QUtf8StringView(lhs) != rhs; }
+
+inline bool operator==(QUtf8StringView lhs, QLatin1String rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) == 0; }
+inline bool operator!=(QUtf8StringView lhs, QLatin1String rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) != 0; }
+inline bool operator==(QLatin1String lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return rhs.compare(lhs) == 0; }
+inline bool operator!=(QLatin1String lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return rhs.compare(lhs) != 0; }
+
+inline bool operator==(QUtf8StringView lhs, const QString &rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) == 0; }
+inline bool operator!=(QUtf8StringView lhs, const QString &rhs) Q_DECL_NOTHROW
+{ return lhs.compare(rhs) != 0; }
+inline bool operator==(const QString &lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return rhs.compare(lhs) == 0; }
+inline bool operator!=(const QString &lhs, QUtf8StringView rhs) Q_DECL_NOTHROW
+{ return rhs.compare(lhs) != 0; }
+
+QT_END_NAMESPACE
+
+#endif // QUTF8STRINGVIEW_H
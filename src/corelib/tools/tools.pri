@@ -5,9 +5,11 @@ intel_icc: QMAKE_CXXFLAGS += -fp-model strict
 HEADERS +=  \
         tools/qalgorithms.h \
         tools/qarraydata.h \
+        tools/qarraydataarena_p.h \
         tools/qarraydataops.h \
         tools/qarraydatapointer.h \
         tools/qbitarray.h \
+        tools/qbtreemap.h \
         tools/qbytearray.h \
         tools/qbytearraylist.h \
         tools/qbytearraymatcher.h \
@@ -24,6 +26,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdatetimeparser_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -72,6 +75,7 @@ HEADERS +=  \
         tools/qelapsedtimer.h \
         tools/qunicodetables_p.h \
         tools/qunicodetools_p.h \
+        tools/qutf8stringview.h \
         tools/qvarlengtharray.h \
         tools/qvector.h \
         tools/qversionnumber_p.h
@@ -79,6 +83,7 @@ HEADERS +=  \
 
 SOURCES += \
         tools/qarraydata.cpp \
+        tools/qarraydataarena.cpp \
         tools/qbitarray.cpp \
         tools/qbytearray.cpp \
         tools/qbytearraylist.cpp \
@@ -118,6 +123,7 @@ SOURCES += \
         tools/qtimezone.cpp \
         tools/qtimezoneprivate.cpp \
         tools/qunicodetools.cpp \
+        tools/qutf8stringview.cpp \
         tools/qvector.cpp \
         tools/qvsnprintf.cpp \
         tools/qversionnumber.cpp
@@ -161,6 +167,9 @@ contains(QT_CONFIG, zlib) {
     include($$PWD/../../3rdparty/zlib_dependency.pri)
 }
 
+# decoder for zstd-compressed resources
+!contains(DEFINES, QT_NO_ZSTD): include($$PWD/../../3rdparty/zstd.pri)
+
 contains(QT_CONFIG,icu) {
     include($$PWD/../../3rdparty/icu_dependency.pri)
 
@@ -134,12 +134,18 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption compressOption(QStringLiteral("compress"), QStringLiteral("Compress input files by <level>."), QStringLiteral("level"));
     parser.addOption(compressOption);
 
+    QCommandLineOption compressionAlgoOption(QStringLiteral("compress-algo"), QStringLiteral("Compress input files using algorithm <algo> (zlib, zstd or none)."), QStringLiteral("algo"));
+    parser.addOption(compressionAlgoOption);
+
     QCommandLineOption nocompressOption(QStringLiteral("no-compress"), QStringLiteral("Disable all compression."));
     parser.addOption(nocompressOption);
 
     QCommandLineOption thresholdOption(QStringLiteral("threshold"), QStringLiteral("Threshold to consider compressing files."), QStringLiteral("level"));
     parser.addOption(thresholdOption);
 
+    QCommandLineOption formatVersionOption(QStringLiteral("format-version"), QStringLiteral("The RCC format version to write (1 to 3)."), QStringLiteral("number"));
+    parser.addOption(formatVersionOption);
+
     QCommandLineOption binaryOption(QStringLiteral("binary"), QStringLiteral("Output a binary file for use as a dynamic resource."));
     parser.addOption(binaryOption);
 
@@ -176,10 +182,24 @@ int runRcc(int argc, char *argv[])
     }
     if (parser.isSet(compressOption))
         library.setCompressLevel(parser.value(compressOption).toInt());
+    if (parser.isSet(compressionAlgoOption)) {
+        bool ok;
+        library.setCompressionAlgorithm(RCCResourceLibrary::parseCompressionAlgorithm(parser.value(compressionAlgoOption), &ok));
+        if (!ok)
+            errorMsg = QLatin1String("Unsupported compression algorithm: ") + parser.value(compressionAlgoOption);
+    }
     if (parser.isSet(nocompressOption))
         library.setCompressLevel(-2);
     if (parser.isSet(thresholdOption))
         library.setCompressThreshold(parser.value(thresholdOption).toInt());
+    if (parser.isSet(formatVersionOption)) {
+        bool ok;
+        const int version = parser.value(formatVersionOption).toInt(&ok);
+        if (ok && version >= 1 && version <= 3)
+            library.setFormatVersion(version);
+        else
+            errorMsg = QLatin1String("Unsupported format version: ") + parser.value(formatVersionOption);
+    }
     if (parser.isSet(binaryOption))
         library.setFormat(RCCResourceLibrary::Binary);
     if (parser.isSet(passOption)) {
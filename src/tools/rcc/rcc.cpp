@@ -46,6 +46,10 @@
 
 #include <algorithm>
 
+#ifndef QT_NO_ZSTD
+#include <zstd.h>
+#endif
+
 // Note: A copy of this file is used in Qt Designer (qttools/src/designer/src/lib/shared/rcc.cpp)
 
 QT_BEGIN_NAMESPACE
@@ -53,6 +57,9 @@ QT_BEGIN_NAMESPACE
 enum {
     CONSTANT_USENAMESPACE = 1,
     CONSTANT_COMPRESSLEVEL_DEFAULT = -1,
+    // zstd decodes equally fast at any level; this one still compresses
+    // large resource sets in reasonable time
+    CONSTANT_ZSTDCOMPRESSLEVEL_DEFAULT = 14,
     CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70
 };
 
@@ -95,13 +102,15 @@ public:
     {
         NoFlags = 0x00,
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedZstd = 0x04
     };
 
     RCCFileInfo(const QString &name = QString(), const QFileInfo &fileInfo = QFileInfo(),
                 QLocale::Language language = QLocale::C,
                 QLocale::Country country = QLocale::AnyCountry,
                 uint flags = NoFlags,
+                RCCResourceLibrary::CompressionAlgorithm compressionAlgo = RCCResourceLibrary::Zlib,
                 int compressLevel = CONSTANT_COMPRESSLEVEL_DEFAULT,
                 int compressThreshold = CONSTANT_COMPRESSTHRESHOLD_DEFAULT);
     ~RCCFileInfo();
@@ -120,17 +129,19 @@ public:
     QFileInfo m_fileInfo;
     RCCFileInfo *m_parent;
     QHash<QString, RCCFileInfo*> m_children;
+    RCCResourceLibrary::CompressionAlgorithm m_compressionAlgo;
     int m_compressLevel;
     int m_compressThreshold;
 
     qint64 m_nameOffset;
     qint64 m_dataOffset;
     qint64 m_childOffset;
+    int m_nodeIndex;
 };
 
 RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     QLocale::Language language, QLocale::Country country, uint flags,
-    int compressLevel, int compressThreshold)
+    RCCResourceLibrary::CompressionAlgorithm compressionAlgo, int compressLevel, int compressThreshold)
 {
     m_name = name;
     m_fileInfo = fileInfo;
@@ -141,6 +152,8 @@ RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     m_nameOffset = 0;
     m_dataOffset = 0;
     m_childOffset = 0;
+    m_nodeIndex = 0;
+    m_compressionAlgo = compressionAlgo;
     m_compressLevel = compressLevel;
     m_compressThreshold = compressThreshold;
 }
@@ -229,19 +242,55 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     }
     QByteArray data = file.readAll();
 
-#ifndef QT_NO_COMPRESS
     // Check if compression is useful for this file
     if (m_compressLevel != 0 && data.size() != 0) {
-        QByteArray compressed =
-            qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
+        QByteArray compressed;
+        uint compressedFlag = NoFlags;
+        switch (m_compressionAlgo) {
+        case RCCResourceLibrary::Zlib:
+#ifndef QT_NO_COMPRESS
+            compressed = qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
+            compressedFlag = Compressed;
+#endif
+            break;
+        case RCCResourceLibrary::Zstd: {
+#ifndef QT_NO_ZSTD
+            if (lib.m_formatVersion < 2) {
+                *errorMessage = QString::fromLatin1("Unable to compress %1: zstd compression requires format version 2 or later\n")
+                        .arg(m_fileInfo.absoluteFilePath());
+                return 0;
+            }
+            const int level = m_compressLevel < 0 ? int(CONSTANT_ZSTDCOMPRESSLEVEL_DEFAULT)
+                                                  : qMin(m_compressLevel, ZSTD_maxCLevel());
+            compressed.resize(int(ZSTD_compressBound(data.size())));
+            const size_t n = ZSTD_compress(compressed.data(), compressed.size(),
+                                           data.constData(), data.size(), level);
+            if (ZSTD_isError(n)) {
+                *errorMessage = QString::fromLatin1("Unable to compress %1: %2\n")
+                        .arg(m_fileInfo.absoluteFilePath(), QLatin1String(ZSTD_getErrorName(n)));
+                return 0;
+            }
+            compressed.truncate(int(n));
+            compressedFlag = CompressedZstd;
+#endif
+            break;
+        }
+        case RCCResourceLibrary::NoCompression:
+            break;
+        }
 
-        int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
-        if (compressRatio >= m_compressThreshold) {
-            data = compressed;
-            m_flags |= Compressed;
+        if (compressedFlag != NoFlags) {
+            int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
+            if (compressRatio >= m_compressThreshold) {
+                data = compressed;
+                m_flags |= compressedFlag;
+                // older versions of QtCore would take zstd data for
+                // uncompressed data; make them reject the resources instead
+                if (compressedFlag == CompressedZstd)
+                    lib.m_requiredFormatVersion = qMax(lib.m_requiredFormatVersion, 2);
+            }
         }
     }
-#endif // QT_NO_COMPRESS
 
     // some info
     if (text || pass1) {
@@ -336,7 +385,8 @@ RCCResourceLibrary::Strings::Strings() :
    ATTRIBUTE_PREFIX(QLatin1String("prefix")),
    ATTRIBUTE_ALIAS(QLatin1String("alias")),
    ATTRIBUTE_THRESHOLD(QLatin1String("threshold")),
-   ATTRIBUTE_COMPRESS(QLatin1String("compress"))
+   ATTRIBUTE_COMPRESS(QLatin1String("compress")),
+   ATTRIBUTE_COMPRESSION_ALGORITHM(QLatin1String("compression-algorithm"))
 {
 }
 
@@ -344,11 +394,14 @@ RCCResourceLibrary::RCCResourceLibrary()
   : m_root(0),
     m_format(C_Code),
     m_verbose(false),
+    m_compressionAlgo(Zlib),
     m_compressLevel(CONSTANT_COMPRESSLEVEL_DEFAULT),
     m_compressThreshold(CONSTANT_COMPRESSTHRESHOLD_DEFAULT),
     m_treeOffset(0),
     m_namesOffset(0),
     m_dataOffset(0),
+    m_formatVersion(3),
+    m_requiredFormatVersion(1),
     m_useNameSpace(CONSTANT_USENAMESPACE),
     m_errorDevice(0),
     m_outDevice(0)
@@ -382,6 +435,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
     QLocale::Language language = QLocale::c().language();
     QLocale::Country country = QLocale::c().country();
     QString alias;
+    CompressionAlgorithm compressionAlgo = m_compressionAlgo;
     int compressLevel = m_compressLevel;
     int compressThreshold = m_compressThreshold;
 
@@ -439,6 +493,15 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESS))
                         compressLevel = attributes.value(m_strings.ATTRIBUTE_COMPRESS).toString().toInt();
 
+                    compressionAlgo = m_compressionAlgo;
+                    if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESSION_ALGORITHM)) {
+                        bool ok;
+                        compressionAlgo = parseCompressionAlgorithm(
+                                attributes.value(m_strings.ATTRIBUTE_COMPRESSION_ALGORITHM).toString(), &ok);
+                        if (!ok)
+                            reader.raiseError(QLatin1String("unsupported compression algorithm"));
+                    }
+
                     compressThreshold = m_compressThreshold;
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_THRESHOLD))
                         compressThreshold = attributes.value(m_strings.ATTRIBUTE_THRESHOLD).toString().toInt();
@@ -511,6 +574,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                             language,
                                             country,
                                             RCCFileInfo::NoFlags,
+                                            compressionAlgo,
                                             compressLevel,
                                             compressThreshold)
                                 );
@@ -540,6 +604,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                                     language,
                                                     country,
                                                     child.isDir() ? RCCFileInfo::Directory : RCCFileInfo::NoFlags,
+                                                    compressionAlgo,
                                                     compressLevel,
                                                     compressThreshold)
                                         );
@@ -634,6 +699,22 @@ void RCCResourceLibrary::reset()
     }
     m_errorDevice = 0;
     m_failedResources.clear();
+    m_requiredFormatVersion = 1;
+}
+
+RCCResourceLibrary::CompressionAlgorithm RCCResourceLibrary::parseCompressionAlgorithm(const QString &name, bool *ok)
+{
+    *ok = true;
+    if (name == QLatin1String("zlib"))
+        return Zlib;
+#ifndef QT_NO_ZSTD
+    if (name == QLatin1String("zstd"))
+        return Zstd;
+#endif
+    if (name == QLatin1String("none"))
+        return NoCompression;
+    *ok = false;
+    return Zlib;
 }
 
 
@@ -954,6 +1035,8 @@ bool RCCResourceLibrary::writeDataStructure()
         return false;
 
     //calculate the child offsets (flat)
+    QVector<RCCFileInfo*> nodes;
+    nodes.append(m_root);
     pending.push(m_root);
     int offset = 1;
     while (!pending.isEmpty()) {
@@ -967,12 +1050,19 @@ bool RCCResourceLibrary::writeDataStructure()
         //write out the actual data now
         for (int i = 0; i < m_children.size(); ++i) {
             RCCFileInfo *child = m_children.at(i);
+            child->m_nodeIndex = offset;
+            nodes.append(child);
             ++offset;
             if (child->m_flags & RCCFileInfo::Directory)
                 pending.push(child);
         }
     }
 
+    // the root has no name; from version 3 on its name offset gives the
+    // number of nodes, which is where the path index starts
+    const bool writeIndex = m_formatVersion >= 3;
+    m_root->m_nameOffset = writeIndex ? nodes.size() : 0;
+
     //write out the structure (ie iterate again!)
     pending.push(m_root);
     m_root->writeDataInfo(*this);
@@ -991,12 +1081,83 @@ bool RCCResourceLibrary::writeDataStructure()
                 pending.push(child);
         }
     }
+
+    if (writeIndex) {
+        writeDataIndex(nodes);
+        m_requiredFormatVersion = 3;
+    }
+
     if (m_format == C_Code || m_format == Pass1)
         writeString("\n};\n\n");
 
     return true;
 }
 
+/*
+    The path index lets QResource find a node with a single hash lookup
+    instead of searching every level of the tree. It follows the tree
+    nodes and consists of
+
+    - the parent node of every node, so that a match can be verified;
+    - the size of the hash table, a power of two;
+    - the hash table itself, using linear probing, of (hash, node) pairs.
+      The hash is qt_hash() of the node's path, without the leading slash;
+      as its low bits depend on the last few characters only, lookups start
+      at qt_resource_index_slot() of it. Node 0, the root, marks unused
+      slots. Locale variants of a file are all in the table, in node order.
+
+    QResourceRoot in qresource.cpp has to agree on all of this.
+*/
+static inline quint32 qt_resource_index_slot(quint32 h, quint32 mask)
+{
+    h ^= h >> 15;
+    h *= 0x2c1b3c6dU;
+    h ^= h >> 12;
+    return h & mask;
+}
+
+void RCCResourceLibrary::writeDataIndex(const QVector<RCCFileInfo*> &nodes)
+{
+    const bool text = m_format == C_Code || m_format == Pass1;
+
+    if (text)
+        writeString("  // parent nodes\n  ");
+    for (int i = 0; i < nodes.size(); ++i) {
+        if (text && i && i % 4 == 0)
+            writeString("\n  ");
+        const RCCFileInfo *parent = nodes.at(i)->m_parent;
+        writeNumber4(parent ? parent->m_nodeIndex : 0);
+    }
+
+    // keep the table at most half full
+    quint32 tableSize = 2;
+    while (tableSize < 2 * quint32(nodes.size()))
+        tableSize *= 2;
+    const quint32 mask = tableSize - 1;
+    QVector<quint32> hashes(tableSize);
+    QVector<quint32> tableNodes(tableSize);
+    for (int i = 1; i < nodes.size(); ++i) {
+        const uint h = qt_hash(nodes.at(i)->resourceName().mid(2));
+        quint32 slot = qt_resource_index_slot(h, mask);
+        while (tableNodes.at(slot))
+            slot = (slot + 1) & mask;
+        hashes[slot] = h;
+        tableNodes[slot] = i;
+    }
+
+    if (text)
+        writeString("\n  // path index\n  ");
+    writeNumber4(tableSize);
+    for (quint32 i = 0; i < tableSize; ++i) {
+        if (text && i % 2 == 0)
+            writeString("\n  ");
+        writeNumber4(hashes.at(i));
+        writeNumber4(tableNodes.at(i));
+    }
+    if (text)
+        writeChar('\n');
+}
+
 void RCCResourceLibrary::writeMangleNamespaceFunction(const QByteArray &name)
 {
     if (m_useNameSpace) {
@@ -1076,7 +1237,8 @@ bool RCCResourceLibrary::writeInitializer()
         if (m_root) {
             writeString("    ");
             writeAddNamespaceFunction("qRegisterResourceData");
-            writeString("\n        (0x01, qt_resource_struct, "
+            writeByteArray("\n        (0x" + QByteArray::number(m_requiredFormatVersion, 16).rightJustified(2, '0')
+                           + ", qt_resource_struct, "
                        "qt_resource_name, qt_resource_data);\n");
         }
         writeString("    return 1;\n");
@@ -1097,7 +1259,8 @@ bool RCCResourceLibrary::writeInitializer()
         if (m_root) {
             writeString("    ");
             writeAddNamespaceFunction("qUnregisterResourceData");
-            writeString("\n       (0x01, qt_resource_struct, "
+            writeByteArray("\n       (0x" + QByteArray::number(m_requiredFormatVersion, 16).rightJustified(2, '0')
+                           + ", qt_resource_struct, "
                       "qt_resource_name, qt_resource_data);\n");
         }
         writeString("    return 1;\n");
@@ -1114,10 +1277,10 @@ bool RCCResourceLibrary::writeInitializer()
     } else if (m_format == Binary) {
         int i = 4;
         char *p = m_out.data();
-        p[i++] = 0; // 0x01
         p[i++] = 0;
         p[i++] = 0;
-        p[i++] = 1;
+        p[i++] = 0;
+        p[i++] = m_requiredFormatVersion;
 
         p[i++] = (m_treeOffset >> 24) & 0xff;
         p[i++] = (m_treeOffset >> 16) & 0xff;
@@ -39,6 +39,7 @@
 #include <qstringlist.h>
 #include <qhash.h>
 #include <qstring.h>
+#include <qvector.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -82,6 +83,14 @@ public:
     void setOutputName(const QString &name) { m_outputName = name; }
     QString outputName() const { return m_outputName; }
 
+    enum CompressionAlgorithm { Zlib, Zstd, NoCompression };
+    static CompressionAlgorithm parseCompressionAlgorithm(const QString &name, bool *ok);
+    void setCompressionAlgorithm(CompressionAlgorithm algo) { m_compressionAlgo = algo; }
+    CompressionAlgorithm compressionAlgorithm() const { return m_compressionAlgo; }
+
+    void setFormatVersion(int v) { m_formatVersion = v; }
+    int formatVersion() const { return m_formatVersion; }
+
     void setCompressLevel(int c) { m_compressLevel = c; }
     int compressLevel() const { return m_compressLevel; }
 
@@ -107,6 +116,7 @@ private:
         const QString ATTRIBUTE_ALIAS;
         const QString ATTRIBUTE_THRESHOLD;
         const QString ATTRIBUTE_COMPRESS;
+        const QString ATTRIBUTE_COMPRESSION_ALGORITHM;
     };
     friend class RCCFileInfo;
     void reset();
@@ -117,6 +127,7 @@ private:
     bool writeDataBlobs();
     bool writeDataNames();
     bool writeDataStructure();
+    void writeDataIndex(const QVector<RCCFileInfo*> &nodes);
     bool writeInitializer();
     void writeMangleNamespaceFunction(const QByteArray &name);
     void writeAddNamespaceFunction(const QByteArray &name);
@@ -135,11 +146,14 @@ private:
     QString m_outputName;
     Format m_format;
     bool m_verbose;
+    CompressionAlgorithm m_compressionAlgo;
     int m_compressLevel;
     int m_compressThreshold;
     int m_treeOffset;
     int m_namesOffset;
     int m_dataOffset;
+    int m_formatVersion;
+    int m_requiredFormatVersion;
     bool m_useNameSpace;
     QStringList m_failedResources;
     QIODevice *m_errorDevice;
@@ -1,3 +1,8 @@
 INCLUDEPATH += $$PWD
 HEADERS += $$PWD/rcc.h
 SOURCES += $$PWD/rcc.cpp
+
+!contains(DEFINES, QT_NO_ZSTD) {
+    CONFIG += zstd_compress
+    include(../../3rdparty/zstd.pri)
+}
@@ -34,6 +34,7 @@
 
 #include <qtextcodec.h>
 #include <qsharedpointer.h>
+#include <qutf8stringview.h>
 
 static const char utf8bom[] = "\xEF\xBB\xBF";
 
@@ -65,6 +66,8 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void longMixedText();
 };
 
 void tst_Utf8::initTestCase()
@@ -301,5 +304,89 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+void tst_Utf8::longMixedText()
+{
+    // Text long enough for the vectorised decoder, which does blocks of one
+    // to three byte sequences, with everything it leaves to the scalar code
+    // mixed in.
+    struct Piece {
+        const char *utf8;
+        ushort utf16[5];
+        bool valid;
+        bool truncated;
+    };
+    static const Piece pieces[] = {
+        { "a", { 'a' }, true, false },
+        { " ", { ' ' }, true, false },
+        { "\xc3\xa9", { 0xe9 }, true, false },
+        { "\xd0\x96", { 0x416 }, true, false },
+        { "\xc2\x80", { 0x80 }, true, false },
+        { "\xdf\xbf", { 0x7ff }, true, false },
+        { "\xe0\xa0\x80", { 0x800 }, true, false },
+        { "\xe4\xb8\xad", { 0x4e2d }, true, false },
+        { "\xed\x9f\xbf", { 0xd7ff }, true, false },
+        { "\xee\x80\x80", { 0xe000 }, true, false },
+        { "\xef\xbb\xbf", { 0xfeff }, true, false },
+        { "\xef\xbf\xbf", { 0xffff }, true, false },
+        { "\xf0\x9f\x98\x80", { 0xd83d, 0xde00 }, true, false },
+        { "\xf4\x8f\xbf\xbf", { 0xdbff, 0xdfff }, true, false },
+        // invalid ones from here on
+        { "\x80", { 0xfffd }, false, false },
+        { "\xbf", { 0xfffd }, false, false },
+        { "\xc0\x80", { 0xfffd, 0xfffd }, false, false },
+        { "\xc1\xbf", { 0xfffd, 0xfffd }, false, false },
+        { "\xe0\x9f\xbf", { 0xfffd, 0xfffd, 0xfffd }, false, false },
+        { "\xed\xa0\x80", { 0xfffd, 0xfffd, 0xfffd }, false, false },
+        { "\xf4\x90\x80\x80", { 0xfffd, 0xfffd, 0xfffd, 0xfffd }, false, false },
+        { "\xf0\x8f\xbf\xbf", { 0xfffd, 0xfffd, 0xfffd, 0xfffd }, false, false },
+        { "\xf8", { 0xfffd }, false, false },
+        { "\xe4\xb8", { 0xfffd, 0xfffd }, false, true },
+        { "\xf0\x9f\x98", { 0xfffd, 0xfffd, 0xfffd }, false, true }
+    };
+    const int validCount = 14;
+    const int pieceCount = int(sizeof pieces / sizeof pieces[0]);
+    QTextCodec *utf8Codec = QTextCodec::codecForMib(106);
+
+    uint seed = 1;
+    for (int round = 0; round < 1000; ++round) {
+        QByteArray utf8("x");
+        QString utf16(QLatin1Char('x'));
+        bool valid = true;
+        bool afterTruncated = false;
+        const int count = int((seed = seed * 1103515245 + 12345) >> 16) % 100;
+        for (int i = 0; i < count; ++i) {
+            int which = int((seed = seed * 1103515245 + 12345) >> 16) % 64;
+            if (which >= validCount && (round % 2 == 0 || which >= pieceCount))
+                which %= validCount;
+            const Piece &piece = pieces[which];
+            if (afterTruncated && (uchar(piece.utf8[0]) & 0xc0) == 0x80) {
+                utf8 += 'a';
+                utf16 += QLatin1Char('a');
+            }
+            utf8 += piece.utf8;
+            for (const ushort *u = piece.utf16; *u; ++u)
+                utf16 += QChar(*u);
+            valid = valid && piece.valid;
+            afterTruncated = piece.truncated;
+        }
+        utf8 += '.';
+        utf16 += QLatin1Char('.');
+
+        QCOMPARE(QString::fromUtf8(utf8), utf16);
+        QCOMPARE(utf8Codec->toUnicode(utf8), utf16);
+        QCOMPARE(QUtf8StringView(utf8).isValidUtf8(), valid);
+
+        if (valid) {
+            QSharedPointer<QTextDecoder> decoder(utf8Codec->makeDecoder());
+            QString decoded;
+            for (int i = 0; i < utf8.size(); i += 37)
+                decoded += decoder->toUnicode(utf8.constData() + i, qMin(37, utf8.size() - i));
+            QVERIFY(!decoder->hasFailure());
+            QCOMPARE(decoded, utf16);
+            QCOMPARE(utf16.toUtf8(), utf8);
+        }
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
@@ -34,6 +34,12 @@
 #include <QCoreApplication>
 #include <QLoggingCategory>
 
+#ifdef Q_OS_UNIX
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #ifdef Q_CC_GNU
 #define NEVER_INLINE __attribute__((__noinline__))
 #else
@@ -80,6 +86,19 @@ int main(int argc, char **argv)
     QLoggingCategory cat("category");
     qCWarning(cat) << "qDebug with category";
 
+#ifdef Q_OS_UNIX
+    if (app.arguments().contains(QLatin1String("fork"))) {
+        const pid_t child = fork();
+        if (child == 0) {
+            qDebug("child");
+            exit(0);
+        }
+        if (child > 0)
+            waitpid(child, 0, 0);
+        qDebug("parent");
+    }
+#endif
+
     qSetMessagePattern(QString());
 
     qDebug("qDebug2");
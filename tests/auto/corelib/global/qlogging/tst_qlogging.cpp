@@ -62,6 +62,8 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asyncLogging();
+    void asyncLoggingFork();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -725,16 +727,16 @@ void tst_qmessagehandler::qMessagePattern_data()
 
     // %{file} is tricky because of shadow builds
     QTest::newRow("basic") << "%{type} %{appname} %{line} %{function} %{message}" << true << (QList<QByteArray>()
-            << "debug  44 T::T static constructor"
+            << "debug  50 T::T static constructor"
             //  we can't be sure whether the QT_MESSAGE_PATTERN is already destructed
             << "static destructor"
-            << "debug tst_qlogging 65 MyClass::myFunction from_a_function 34"
-            << "debug tst_qlogging 75 main qDebug"
-            << "info tst_qlogging 76 main qInfo"
-            << "warning tst_qlogging 77 main qWarning"
-            << "critical tst_qlogging 78 main qCritical"
-            << "warning tst_qlogging 81 main qDebug with category"
-            << "debug tst_qlogging 85 main qDebug2");
+            << "debug tst_qlogging 71 MyClass::myFunction from_a_function 34"
+            << "debug tst_qlogging 81 main qDebug"
+            << "info tst_qlogging 82 main qInfo"
+            << "warning tst_qlogging 83 main qWarning"
+            << "critical tst_qlogging 84 main qCritical"
+            << "warning tst_qlogging 87 main qDebug with category"
+            << "debug tst_qlogging 104 main qDebug2");
 
 
     QTest::newRow("invalid") << "PREFIX: %{unknown} %{message}" << false << (QList<QByteArray>()
@@ -889,6 +891,72 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // !QT_NO_PROCESS
 }
 
+void tst_qmessagehandler::asyncLogging()
+{
+#ifdef QT_NO_PROCESS
+    QSKIP("This test requires QProcess support");
+#else
+    // the output must be the same as without QT_LOGGING_ASYNC, including
+    // everything logged right before the application exits
+    QProcess process;
+    const QString appExe = m_appDir + "/app";
+
+    QStringList environment = m_baseEnvironment;
+    environment.prepend("QT_LOGGING_ASYNC=1");
+    process.setEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+
+    QByteArray output = process.readAllStandardError();
+    QByteArray expected = "static constructor\n"
+            "[debug] qDebug\n"
+            "[info] qInfo\n"
+            "[warning] qWarning\n"
+            "[critical] qCritical\n"
+            "[warning] qDebug with category\n";
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    QCOMPARE(QString::fromLatin1(output), QString::fromLatin1(expected));
+#endif // !QT_NO_PROCESS
+}
+
+void tst_qmessagehandler::asyncLoggingFork()
+{
+#if defined(QT_NO_PROCESS) || !defined(Q_OS_UNIX)
+    QSKIP("This test requires QProcess and fork()");
+#else
+    // the child must not wait for the writer thread, which only exists in
+    // the parent, and what was logged before fork() is written only once
+    QProcess process;
+    const QString appExe = m_appDir + "/app";
+
+    QStringList environment = m_baseEnvironment;
+    environment.prepend("QT_LOGGING_ASYNC=1");
+    process.setEnvironment(environment);
+
+    process.start(appExe, QStringList("fork"));
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    QVERIFY(process.waitForFinished(10000));
+
+    QByteArray output = process.readAllStandardError();
+    QByteArray expected = "static constructor\n"
+            "[debug] qDebug\n"
+            "[info] qInfo\n"
+            "[warning] qWarning\n"
+            "[critical] qCritical\n"
+            "[warning] qDebug with category\n"
+            "[debug] child\n"
+            "[debug] static destructor\n"
+            "[debug] parent\n";
+    QCOMPARE(QString::fromLatin1(output), QString::fromLatin1(expected));
+#endif
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -186,6 +186,10 @@ private slots:
 
     void floatingPointNaN();
 
+    void arrays_data();
+    void arrays();
+    void arraysReadPastEnd();
+
 private:
     void writebool(QDataStream *s);
     void writeQBitArray(QDataStream *s);
@@ -3188,6 +3192,186 @@ void tst_QDataStream::floatingPointPrecision()
 
 }
 
+void tst_QDataStream::arrays_data()
+{
+    QTest::addColumn<int>("version");
+    QTest::addColumn<int>("byteOrder");
+    QTest::addColumn<int>("precision");
+
+    const int versions[] = { QDataStream::Qt_3_0, QDataStream::Qt_4_5, QDataStream::Qt_DefaultCompiledVersion };
+    for (int v = 0; v < 3; ++v) {
+        for (int p = QDataStream::SinglePrecision; p <= QDataStream::DoublePrecision; ++p) {
+            const QByteArray name = QByteArray::number(versions[v])
+                    + (p == QDataStream::SinglePrecision ? "-single" : "-double");
+            QTest::newRow(name + "-big") << versions[v] << int(QDataStream::BigEndian) << p;
+            QTest::newRow(name + "-little") << versions[v] << int(QDataStream::LittleEndian) << p;
+        }
+    }
+}
+
+template <typename Container>
+static void checkArray(const Container &values, int version, int byteOrder, int precision)
+{
+    // the expected format is that of the elements written one by one
+    QByteArray expected;
+    {
+        QDataStream stream(&expected, QIODevice::WriteOnly);
+        stream.setVersion(version);
+        stream.setByteOrder(QDataStream::ByteOrder(byteOrder));
+        stream.setFloatingPointPrecision(QDataStream::FloatingPointPrecision(precision));
+        stream << quint32(values.size());
+        for (int i = 0; i < values.size(); ++i)
+            stream << values.at(i);
+    }
+
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(version);
+        stream.setByteOrder(QDataStream::ByteOrder(byteOrder));
+        stream.setFloatingPointPrecision(QDataStream::FloatingPointPrecision(precision));
+        stream << values;
+        QCOMPARE(stream.status(), QDataStream::Ok);
+    }
+    QCOMPARE(data.toHex(), expected.toHex());
+
+    QDataStream stream(data);
+    stream.setVersion(version);
+    stream.setByteOrder(QDataStream::ByteOrder(byteOrder));
+    stream.setFloatingPointPrecision(QDataStream::FloatingPointPrecision(precision));
+    Container read;
+    stream >> read;
+    QCOMPARE(stream.status(), QDataStream::Ok);
+    QVERIFY(stream.atEnd());
+
+    // values that are written with less precision are expected to change
+    Container roundTripped;
+    {
+        QDataStream in(expected);
+        in.setVersion(version);
+        in.setByteOrder(QDataStream::ByteOrder(byteOrder));
+        in.setFloatingPointPrecision(QDataStream::FloatingPointPrecision(precision));
+        quint32 count;
+        in >> count;
+        for (quint32 i = 0; i < count; ++i) {
+            typename Container::value_type value;
+            in >> value;
+            roundTripped.append(value);
+        }
+    }
+    QCOMPARE(read, roundTripped);
+}
+
+void tst_QDataStream::arrays()
+{
+    QFETCH(int, version);
+    QFETCH(int, byteOrder);
+    QFETCH(int, precision);
+
+    QVector<qint8> int8s;
+    QVector<quint16> uint16s;
+    QVector<qint32> int32s;
+    QVector<qint64> int64s;
+    QVector<float> floats;
+    QVector<double> doubles;
+    QVector<QPointF> points;
+    QList<int> intList;
+    QList<qint64> int64List;
+    QList<double> doubleList;
+    QList<QPointF> pointList;
+    // large enough to need several blocks
+    for (int i = 0; i < 3000; ++i) {
+        int8s << qint8(i * 7);
+        uint16s << quint16(i * 1021);
+        int32s << i * -104729;
+        int64s << qint64(i) * Q_INT64_C(0x123456789);
+        floats << i * 0.37f;
+        doubles << i / 3.0;
+        points << QPointF(i / 7.0, -i * 1.5);
+        intList << i * 17;
+        int64List << qint64(i) << Q_INT64_C(-1);
+        doubleList << i * 1e10;
+        pointList << QPointF(i, i / 9.0);
+    }
+
+    checkArray(int8s, version, byteOrder, precision);
+    checkArray(uint16s, version, byteOrder, precision);
+    checkArray(int32s, version, byteOrder, precision);
+    checkArray(int64s, version, byteOrder, precision);
+    checkArray(floats, version, byteOrder, precision);
+    checkArray(doubles, version, byteOrder, precision);
+    checkArray(points, version, byteOrder, precision);
+    checkArray(intList, version, byteOrder, precision);
+    checkArray(int64List, version, byteOrder, precision);
+    checkArray(doubleList, version, byteOrder, precision);
+    checkArray(pointList, version, byteOrder, precision);
+    checkArray(QVector<double>(), version, byteOrder, precision);
+    checkArray(QList<int>(), version, byteOrder, precision);
+}
+
+void tst_QDataStream::arraysReadPastEnd()
+{
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << (QVector<double>() << 1.0 << 2.0 << 3.0);
+    }
+
+    // an incomplete element reads as zero, like the missing ones
+    {
+        QDataStream stream(data.left(4 + 8 + 5));
+        QVector<double> vector;
+        stream >> vector;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QCOMPARE(vector, QVector<double>() << 1.0 << 0.0 << 0.0);
+    }
+
+    // lists stop at the end of the data
+    {
+        QDataStream stream(data.left(4 + 8 + 8));
+        QList<double> list;
+        stream >> list;
+        QCOMPARE(stream.status(), QDataStream::Ok);
+        QCOMPARE(list, QList<double>() << 1.0 << 2.0);
+    }
+    {
+        QDataStream stream(data.left(4 + 8 + 3));
+        QList<double> list;
+        stream >> list;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QCOMPARE(list, QList<double>() << 1.0 << 0.0);
+    }
+    {
+        QDataStream stream(data.left(4));
+        QList<double> list;
+        stream >> list;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QCOMPARE(list, QList<double>() << 0.0);
+    }
+
+    // but the coordinates of an incomplete point that were read completely
+    // are kept, as when reading them one by one
+    QByteArray points;
+    {
+        QDataStream stream(&points, QIODevice::WriteOnly);
+        stream << (QVector<QPointF>() << QPointF(1, 2) << QPointF(3, 4));
+    }
+    {
+        QDataStream stream(points.left(4 + 16 + 8 + 3));
+        QVector<QPointF> vector;
+        stream >> vector;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QCOMPARE(vector, QVector<QPointF>() << QPointF(1, 2) << QPointF(3, 0));
+    }
+    {
+        QDataStream stream(points.left(4 + 16 + 8));
+        QList<QPointF> list;
+        stream >> list;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QCOMPARE(list, QList<QPointF>() << QPointF(1, 2) << QPointF(3, 0));
+    }
+}
+
 QTEST_MAIN(tst_QDataStream)
 #include "tst_qdatastream.moc"
 
@@ -92,11 +92,16 @@ private: // convenience functions
         return false;
     }
 
+    void iterateRelativeDirectory_impl(QDirIterator::IteratorFlags extraFlags);
+
 private slots:
     void initTestCase();
     void cleanupTestCase();
     void iterateRelativeDirectory_data();
     void iterateRelativeDirectory();
+    void iterateRelativeDirectoryParallel_data() { iterateRelativeDirectory_data(); }
+    void iterateRelativeDirectoryParallel();
+    void parallelTree();
     void iterateResource_data();
     void iterateResource();
     void stopLinkLoop();
@@ -350,6 +355,16 @@ void tst_QDirIterator::iterateRelativeDirectory_data()
 }
 
 void tst_QDirIterator::iterateRelativeDirectory()
+{
+    iterateRelativeDirectory_impl(QDirIterator::NoIteratorFlags);
+}
+
+void tst_QDirIterator::iterateRelativeDirectoryParallel()
+{
+    iterateRelativeDirectory_impl(QDirIterator::Parallel);
+}
+
+void tst_QDirIterator::iterateRelativeDirectory_impl(QDirIterator::IteratorFlags extraFlags)
 {
     QFETCH(QString, dirName);
     QFETCH(QDirIterator::IteratorFlags, flags);
@@ -357,7 +372,7 @@ void tst_QDirIterator::iterateRelativeDirectory()
     QFETCH(QStringList, nameFilters);
     QFETCH(QStringList, entries);
 
-    QDirIterator it(dirName, nameFilters, filters, flags);
+    QDirIterator it(dirName, nameFilters, filters, flags | extraFlags);
     QStringList list;
     while (it.hasNext()) {
         QString next = it.next();
@@ -395,6 +410,63 @@ void tst_QDirIterator::iterateRelativeDirectory()
     QCOMPARE(list, sortedEntries);
 }
 
+static QStringList walk(const QString &path, QDir::Filters filters, QDirIterator::IteratorFlags flags)
+{
+    QStringList list;
+    QDirIterator it(path, filters, flags);
+    while (it.hasNext()) {
+        it.next();
+        // which of several links to a directory gets followed depends on
+        // the order the entries are found in
+        list << ((flags & QDirIterator::FollowSymlinks) ? it.fileInfo().canonicalFilePath()
+                                                        : it.filePath());
+    }
+    list.sort();
+    return list;
+}
+
+void tst_QDirIterator::parallelTree()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString root = tempDir.path();
+
+    QDir dir(root);
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            const QString subdir = QString::fromLatin1("dir%1/sub%2").arg(i).arg(j);
+            QVERIFY(dir.mkpath(subdir));
+            for (int k = 0; k < 30; ++k) {
+                QFile file(root + QLatin1Char('/') + subdir + QString::fromLatin1("/file%1").arg(k));
+                QVERIFY(file.open(QIODevice::WriteOnly));
+            }
+        }
+    }
+#if !defined(Q_NO_SYMLINKS) && !defined(Q_NO_SYMLINKS_TO_DIRS) && !defined(Q_OS_WIN)
+    // several links into the same directory, which must only be walked once
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(QFile::link(root + QLatin1String("/dir3"),
+                            root + QString::fromLatin1("/dir%1/link").arg(10 + i)));
+#endif
+
+    const QDir::Filters filters = QDir::AllEntries | QDir::NoDotAndDotDot;
+    const QDirIterator::IteratorFlags flags = QDirIterator::Subdirectories;
+    QStringList expected = walk(root, filters, flags);
+    QVERIFY(expected.size() >= 20 * 5 * 31);
+    QCOMPARE(walk(root, filters, flags | QDirIterator::Parallel), expected);
+
+    expected = walk(root, QDir::Files, flags | QDirIterator::FollowSymlinks);
+    QCOMPARE(walk(root, QDir::Files, flags | QDirIterator::FollowSymlinks | QDirIterator::Parallel),
+             expected);
+
+    // destroying the iterator before the walk has finished
+    for (int n = 0; n < 100; n += 10) {
+        QDirIterator it(root, filters, flags | QDirIterator::Parallel);
+        for (int i = 0; i < n && it.hasNext(); ++i)
+            QVERIFY(!it.next().isEmpty());
+    }
+}
+
 void tst_QDirIterator::iterateResource_data()
 {
     QTest::addColumn<QString>("dirName"); // relative from current path or abs
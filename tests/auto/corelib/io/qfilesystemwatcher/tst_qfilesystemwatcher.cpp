@@ -77,6 +77,13 @@ private slots:
 
     void signalsEmittedAfterFileMoved();
 
+    void recursiveWatch_data() { basicTest_data(); }
+    void recursiveWatch();
+    void removeRecursivePath();
+    void removeRecursivePathKeepsNestedTrees();
+    void removePathInRecursiveWatch();
+    void coalescing();
+
 private:
     QString m_tempDirPattern;
 #endif // QT_NO_FILESYSTEMWATCHER
@@ -736,6 +743,194 @@ void tst_QFileSystemWatcher::signalsEmittedAfterFileMoved()
     QVERIFY2(changedSpy.count() <= fileCount, changedSpy.receivedFilesMessage());
     QTRY_COMPARE(changedSpy.count(), fileCount);
 }
+
+void tst_QFileSystemWatcher::recursiveWatch()
+{
+    QFETCH(QString, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b/c"));
+    const QString nested = testDir.filePath("a/b/c");
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_") + backend);
+    QVERIFY(watcher.addRecursivePath(testDir.path()));
+    QVERIFY(!watcher.addRecursivePath(testDir.path()));
+    QCOMPARE(watcher.recursiveDirectories(), QStringList(QDir::cleanPath(testDir.path())));
+    QVERIFY(watcher.directories().isEmpty());
+
+    QSignalSpy changedSpy(&watcher, &QFileSystemWatcher::directoryChanged);
+    QVERIFY(changedSpy.isValid());
+
+    // a change deep in the tree
+    QFile file(nested + QLatin1String("/file"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << nested));
+
+    // a new subdirectory is watched as well
+    QVERIFY(testDir.mkpath("a/b/c/new"));
+    const QString created = nested + QLatin1String("/new");
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << nested));
+    changedSpy.clear();
+    QTest::qWait(backend == QLatin1String("poller") ? 1500 : 100);
+    QFile createdFile(created + QLatin1String("/file"));
+    QVERIFY(createdFile.open(QIODevice::WriteOnly));
+    createdFile.close();
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << created));
+
+    // directories of a tree can be watched explicitly too
+    QVERIFY(watcher.addPath(nested));
+    QCOMPARE(watcher.directories(), QStringList(nested));
+    QVERIFY(watcher.removePath(nested));
+    QVERIFY(watcher.directories().isEmpty());
+    changedSpy.clear();
+    QVERIFY(QFile::remove(created + QLatin1String("/file")));
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << created));
+}
+
+void tst_QFileSystemWatcher::removeRecursivePath()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b"));
+    const QString outer = QDir::cleanPath(testDir.path());
+    const QString inner = outer + QLatin1String("/a");
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addRecursivePath(outer));
+    QVERIFY(watcher.addRecursivePath(inner));
+    QVERIFY(watcher.addPath(outer + QLatin1String("/a/b")));
+    QSignalSpy changedSpy(&watcher, &QFileSystemWatcher::directoryChanged);
+    QVERIFY(changedSpy.isValid());
+
+    // the outer tree still covers the inner one
+    QVERIFY(watcher.removeRecursivePath(inner));
+    QVERIFY(!watcher.removeRecursivePath(inner));
+    QCOMPARE(watcher.recursiveDirectories(), QStringList(outer));
+    QVERIFY(testDir.mkdir("a/one"));
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << inner));
+
+    // directories added with addPath() stay watched
+    QVERIFY(watcher.removeRecursivePath(outer));
+    QVERIFY(watcher.recursiveDirectories().isEmpty());
+    QCOMPARE(watcher.directories(), QStringList(outer + QLatin1String("/a/b")));
+    changedSpy.clear();
+    QVERIFY(testDir.mkdir("a/two"));
+    QVERIFY(testDir.mkdir("a/b/three"));
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << outer + QLatin1String("/a/b")));
+    QTest::qWait(100);
+    QCOMPARE(changedSpy.count(), 1);
+}
+
+void tst_QFileSystemWatcher::removeRecursivePathKeepsNestedTrees()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b/c"));
+    const QString outer = QDir::cleanPath(testDir.filePath("a"));
+    const QString inner = outer + QLatin1String("/b");
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addRecursivePath(outer));
+    QVERIFY(watcher.addRecursivePath(inner));
+    QSignalSpy changedSpy(&watcher, &QFileSystemWatcher::directoryChanged);
+    QVERIFY(changedSpy.isValid());
+
+    // the inner tree is still watched without the outer one
+    QVERIFY(watcher.removeRecursivePath(outer));
+    QCOMPARE(watcher.recursiveDirectories(), QStringList(inner));
+    QFile file(inner + QLatin1String("/c/file"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << inner + QLatin1String("/c")));
+
+    // but not the rest of the outer one
+    changedSpy.clear();
+    QVERIFY(testDir.mkdir("a/one"));
+    QTest::qWait(100);
+    QVERIFY(!changedSpy.contains(QVariantList() << outer));
+
+    QVERIFY(watcher.removeRecursivePath(inner));
+    QVERIFY(watcher.recursiveDirectories().isEmpty());
+}
+
+void tst_QFileSystemWatcher::removePathInRecursiveWatch()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b"));
+    const QString root = QDir::cleanPath(testDir.filePath("a"));
+    const QString subdirectory = root + QLatin1String("/b");
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addRecursivePath(root));
+    QSignalSpy changedSpy(&watcher, &QFileSystemWatcher::directoryChanged);
+    QVERIFY(changedSpy.isValid());
+
+    // the subdirectory was never added with addPath()
+    QVERIFY(!watcher.removePath(subdirectory));
+    QCOMPARE(watcher.removePaths(QStringList(subdirectory)), QStringList(subdirectory));
+    QCOMPARE(watcher.recursiveDirectories(), QStringList(root));
+
+    // and is still watched
+    QFile file(subdirectory + QLatin1String("/file"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << subdirectory));
+
+    // while one that was also added explicitly only loses that
+    QVERIFY(watcher.addPath(subdirectory));
+    QVERIFY(watcher.removePath(subdirectory));
+    QVERIFY(watcher.directories().isEmpty());
+    changedSpy.clear();
+    QVERIFY(file.remove());
+    QTRY_VERIFY(changedSpy.contains(QVariantList() << subdirectory));
+}
+
+void tst_QFileSystemWatcher::coalescing()
+{
+    const int fileCount = 50;
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    QDir testDir(temporaryDirectory.path());
+
+    QFileSystemWatcher watcher;
+    QCOMPARE(watcher.coalescingInterval(), 0);
+    watcher.setCoalescingInterval(200);
+    QCOMPARE(watcher.coalescingInterval(), 200);
+    QVERIFY(watcher.addPath(testDir.path()));
+
+    QSignalSpy changedSpy(&watcher, &QFileSystemWatcher::directoryChanged);
+    QSignalSpy pathsSpy(&watcher, &QFileSystemWatcher::pathsChanged);
+    QVERIFY(changedSpy.isValid());
+    QVERIFY(pathsSpy.isValid());
+
+    for (int i = 0; i < fileCount; ++i) {
+        QFile f(testDir.filePath(QString("test%1.txt").arg(i)));
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.close();
+        if (i == fileCount / 2)
+            QCoreApplication::processEvents();
+    }
+
+    QTRY_COMPARE(pathsSpy.count(), 1);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(pathsSpy.at(0).at(0).toStringList(), QStringList(testDir.path()));
+
+    // with coalescing turned off, pending changes are delivered at once
+    QVERIFY(QFile::remove(testDir.filePath("test0.txt")));
+    QTest::qWait(100);
+    QCOMPARE(changedSpy.count(), 1);
+    watcher.setCoalescingInterval(0);
+    QCOMPARE(pathsSpy.count(), 2);
+    QCOMPARE(changedSpy.count(), 2);
+}
 #endif // QT_NO_FILESYSTEMWATCHER
 
 QTEST_MAIN(tst_QFileSystemWatcher)
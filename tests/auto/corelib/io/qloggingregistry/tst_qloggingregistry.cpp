@@ -131,6 +131,8 @@ private slots:
                 << QString("*.io") << QString("qt.ios") << QtDebugMsg << NoMatch;
         QTest::newRow("_star_.io-qt.io.x")
                 << QString("*.io") << QString("qt.io.x") << QtDebugMsg << NoMatch;
+        QTest::newRow("_star_.io-qt.io.io")
+                << QString("*.io") << QString("qt.io.io") << QtDebugMsg << Match;
         QTest::newRow("_star_.io.debug-qt.io")
                 << QString("*.io.debug") << QString("qt.io") << QtDebugMsg << Match;
         QTest::newRow("_star_.io.warning-qt.io")
@@ -172,6 +174,55 @@ private slots:
             }
         }
         QCOMPARE(state, result);
+
+        // the compiled rule set must agree with QLoggingRule::pass()
+        QLoggingRuleSet ruleSet;
+        ruleSet.setRules(QVector<QLoggingRule>() << rule);
+        bool enabled[4] = { false, false, false, false };
+        ruleSet.apply(category.toLatin1().constData(),
+                      &enabled[0], &enabled[1], &enabled[2], &enabled[3]);
+        const int slot = msgType == QtDebugMsg ? 0 : msgType == QtInfoMsg ? 1
+                       : msgType == QtWarningMsg ? 2 : 3;
+        QCOMPARE(enabled[slot], result == Match);
+    }
+
+    void QLoggingRuleSet_priorities()
+    {
+        QLoggingSettingsParser parser;
+        parser.setSection(QStringLiteral("Rules"));
+        parser.setContent("*=false\n"
+                          "qt.*=true\n"
+                          "*.io=false\n"
+                          "*core*.warning=true\n"
+                          "qt.core.io.debug=true\n"
+                          "*.fs.critical=true\n"
+                          "qt.core.*.critical=false\n");
+        const QVector<QLoggingRule> rules = parser.rules();
+        QCOMPARE(rules.size(), 7);
+
+        QLoggingRuleSet ruleSet;
+        ruleSet.setRules(rules);
+
+        const char *const names[] = {
+            "", "qt", "qt.io", "qt.core", "qt.core.io", "qt.core.fs",
+            "app.core.io", "app.fs", "app.io.fs", "qt.core.io.io"
+        };
+        const QtMsgType types[] = { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg };
+        for (uint i = 0; i < sizeof names / sizeof *names; ++i) {
+            bool enabled[4] = { true, false, true, false };
+            ruleSet.apply(names[i], &enabled[0], &enabled[1], &enabled[2], &enabled[3]);
+            for (int t = 0; t < 4; ++t) {
+                // the last rule that decides wins
+                bool expected = (t == 0 || t == 2);
+                foreach (const QLoggingRule &rule, rules) {
+                    const int pass = rule.pass(QLatin1String(names[i]), types[t]);
+                    if (pass != 0)
+                        expected = pass > 0;
+                }
+                QVERIFY2(enabled[t] == expected,
+                         qPrintable(QString::fromLatin1("%1, type %2").arg(QLatin1String(names[i])).arg(t)));
+            }
+        }
     }
 
     void QLoggingSettingsParser_iniStyle()
@@ -43,6 +43,10 @@
 #include <QtNetwork/QHostInfo>
 #include <stdlib.h>
 
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
 #ifndef QT_NO_PROCESS
 # include <private/qprocess_p.h>    // only so we get QPROCESS_USE_SPAWN
 # if defined(Q_OS_WIN)
@@ -125,6 +129,9 @@ private slots:
 #ifdef Q_OS_WIN
     void setWorkingDirectory();
 #endif // Q_OS_WIN
+#ifdef Q_OS_UNIX
+    void setupChildProcess();
+#endif
 #endif // not Q_OS_WINCE
 
     void exitStatus_data();
@@ -2187,6 +2194,37 @@ void tst_QProcess::setWorkingDirectory()
 }
 #endif
 
+//-----------------------------------------------------------------------------
+#ifdef Q_OS_UNIX
+class SetupChildProcess : public QProcess
+{
+protected:
+    void setupChildProcess() Q_DECL_OVERRIDE
+    {
+        // standard output is already redirected at this point
+        static const char marker[] = "setup ";
+        ::write(STDOUT_FILENO, marker, sizeof(marker) - 1);
+    }
+};
+
+// a reimplemented setupChildProcess() must still be called, even though
+// plain QProcess objects start their children without forking
+void tst_QProcess::setupChildProcess()
+{
+    SetupChildProcess process;
+    process.start("testProcessEcho/testProcessEcho");
+    QVERIFY2(process.waitForStarted(), qPrintable(process.errorString()));
+    process.write("echo");
+    process.closeWriteChannel();
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.readAll(), QByteArray("setup echo"));
+
+    process.start("testProcessEcho/doesNotExist");
+    QVERIFY(!process.waitForStarted());
+    QCOMPARE(process.error(), QProcess::FailedToStart);
+}
+#endif
+
 //-----------------------------------------------------------------------------
 void tst_QProcess::startFinishStartFinish()
 {
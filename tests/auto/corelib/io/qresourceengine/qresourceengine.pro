@@ -3,19 +3,25 @@ TARGET = tst_qresourceengine
 load(resources)
 QT = core testlib
 SOURCES = tst_qresourceengine.cpp
-RESOURCES += testqrc/test.qrc
+RESOURCES += testqrc/test.qrc testqrc/compressed.qrc
 
 runtime_resource.target = runtime_resource.rcc
 runtime_resource.depends = $$PWD/testqrc/test.qrc
-runtime_resource.commands = $$QMAKE_RCC -root /runtime_resource/ -binary $${runtime_resource.depends} -o $${runtime_resource.target}
-QMAKE_EXTRA_TARGETS = runtime_resource
-PRE_TARGETDEPS += $${runtime_resource.target}
-QMAKE_DISTCLEAN += $${runtime_resource.target}
+# format version 1 has no path index, so lookups walk the tree
+runtime_resource.commands = $$QMAKE_RCC -format-version 1 -root /runtime_resource/ -binary $${runtime_resource.depends} -o $${runtime_resource.target}
+
+compressed_resource.target = compressed_resource.rcc
+compressed_resource.depends = $$PWD/testqrc/compressed.qrc
+compressed_resource.commands = $$QMAKE_RCC -root /runtime_compressed/ -binary $${compressed_resource.depends} -o $${compressed_resource.target}
+
+QMAKE_EXTRA_TARGETS = runtime_resource compressed_resource
+PRE_TARGETDEPS += $${runtime_resource.target} $${compressed_resource.target}
+QMAKE_DISTCLEAN += $${runtime_resource.target} $${compressed_resource.target}
 
 TESTDATA += \
     parentdir.txt \
     testqrc/*
-GENERATED_TESTDATA = $${runtime_resource.target}
+GENERATED_TESTDATA = $${runtime_resource.target} $${compressed_resource.target}
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
 
 android:!android-no-sdk {
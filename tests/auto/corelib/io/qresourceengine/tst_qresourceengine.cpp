@@ -60,6 +60,9 @@ private slots:
     void searchPath();
     void doubleSlashInRoot();
     void setLocale();
+    void compressedResource_data();
+    void compressedResource();
+    void concurrentLookup();
 
 private:
     const QString m_runtimeResourceRcc;
@@ -116,6 +119,7 @@ void tst_QResourceEngine::checkStructure_data()
 
     QStringList rootContents;
     rootContents << QLatin1String("aliasdir")
+                 << QLatin1String("compressed")
                  << QLatin1String("otherdir")
                  << QLatin1String("qt-project.org")
                  << QLatin1String("runtime_resource")
@@ -494,6 +498,100 @@ void tst_QResourceEngine::setLocale()
     QLocale::setDefault(QLocale::system());
 }
 
+void tst_QResourceEngine::compressedResource_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("compression");
+
+    QTest::newRow("zlib") << QString("zlib.txt") << int(QResource::ZlibCompression);
+    QTest::newRow("zstd") << QString("zstd.txt") << int(QResource::ZstdCompression);
+    QTest::newRow("none") << QString("none.txt") << int(QResource::NoCompression);
+}
+
+void tst_QResourceEngine::compressedResource()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, compression);
+
+    QFile source(QFINDTESTDATA("testqrc/compressed/compressible.txt"));
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    const QByteArray contents = source.readAll();
+
+    const QString rcc = QFINDTESTDATA("compressed_resource.rcc");
+    QVERIFY(!rcc.isEmpty());
+    QVERIFY(QResource::registerResource(rcc));
+
+    const QStringList paths = QStringList() << QString(":/compressed/") + fileName
+                                            << QString(":/runtime_compressed/compressed/") + fileName;
+    foreach (const QString &path, paths) {
+        QResource resource(path);
+        QVERIFY2(resource.isValid(), qPrintable(path));
+        QCOMPARE(int(resource.compressionAlgorithm()), compression);
+        QCOMPARE(resource.isCompressed(), compression != QResource::NoCompression);
+        if (resource.isCompressed())
+            QVERIFY(resource.size() < contents.size());
+        else
+            QCOMPARE(resource.size(), qint64(contents.size()));
+        QCOMPARE(resource.uncompressedSize(), qint64(contents.size()));
+        QCOMPARE(resource.uncompressedData(), contents);
+
+        QFile file(path);
+        QCOMPARE(file.size(), qint64(contents.size()));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.size(), qint64(contents.size()));
+        QCOMPARE(file.readAll(), contents);
+
+        uchar *mapped = file.map(0, file.size());
+        QVERIFY(mapped);
+        QCOMPARE(QByteArray(reinterpret_cast<const char *>(mapped), int(file.size())), contents);
+        QVERIFY(file.unmap(mapped));
+    }
+
+    QVERIFY(QResource::unregisterResource(rcc));
+}
+
+class ResourceLookupThread : public QThread
+{
+public:
+    ResourceLookupThread() : failures(0) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        while (!stop.load()) {
+            if (!QFile::exists(QStringLiteral(":/search_file.txt")))
+                failures.ref();
+            QFile file(QStringLiteral(":/concurrent/runtime_resource/search_file.txt"));
+            if (file.open(QIODevice::ReadOnly))
+                file.readAll();
+        }
+    }
+
+    QAtomicInt stop;
+    QAtomicInt failures;
+};
+
+void tst_QResourceEngine::concurrentLookup()
+{
+    ResourceLookupThread threads[4];
+    for (int i = 0; i < 4; ++i)
+        threads[i].start();
+
+    // lookups in other threads must not stall or crash while the
+    // registered resources change
+    for (int i = 0; i < 200; ++i) {
+        QVERIFY(QResource::registerResource(m_runtimeResourceRcc, "/concurrent/"));
+        QVERIFY(QFile::exists(":/concurrent/runtime_resource/search_file.txt"));
+        QResource::unregisterResource(m_runtimeResourceRcc, "/concurrent/");
+        QVERIFY(!QFile::exists(":/concurrent/runtime_resource/search_file.txt"));
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        threads[i].stop.store(1);
+        QVERIFY(threads[i].wait());
+        QCOMPARE(threads[i].failures.load(), 0);
+    }
+}
+
 QTEST_MAIN(tst_QResourceEngine)
 
 #include "tst_qresourceengine.moc"
@@ -134,6 +134,8 @@ private slots:
 #if !defined(Q_OS_WIN) && !defined(QT_QSETTINGS_ALWAYS_CASE_SENSITIVE_AND_FORGET_ORIGINAL_KEY_ORDER)
     void dontReorderIniKeysNeedlessly();
 #endif
+    void dontRewriteUntouchedIniSections();
+    void removeAfterExternalWrite();
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
     void consistentRegistryStorage();
 #endif
@@ -3350,6 +3352,92 @@ void tst_QSettings::dontReorderIniKeysNeedlessly()
 }
 #endif
 
+void tst_QSettings::dontRewriteUntouchedIniSections()
+{
+    // Sections without modified keys are written back as they were read,
+    // without being parsed, so their formatting and comments survive
+    QTemporaryFile outFile;
+    QVERIFY(outFile.open());
+    outFile.write("[alpha]\n"
+                  "; a comment\n"
+                  "x = 1\n"
+                  "b=2\n"
+                  "\n"
+                  "[beta]\n"
+                  "y=3\n");
+    const QString fileName = outFile.fileName();
+    outFile.close();
+
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        settings.setValue("beta/z", 4);
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QByteArray contents = file.readAll();
+        contents.replace("\r\n", "\n");
+        QCOMPARE(contents, QByteArray("[alpha]\n"
+                                      "; a comment\n"
+                                      "x = 1\n"
+                                      "b=2\n"
+                                      "\n"
+                                      "[beta]\n"
+                                      "y=3\n"
+                                      "z=4\n"));
+
+        // the section can still be read after having been written back
+        QCOMPARE(settings.value("alpha/x").toInt(), 1);
+        settings.setValue("alpha/b", 5);
+        settings.sync();
+    }
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    QCOMPARE(settings.value("alpha/x").toInt(), 1);
+    QCOMPARE(settings.value("alpha/b").toInt(), 5);
+    QCOMPARE(settings.value("beta/y").toInt(), 3);
+    QCOMPARE(settings.value("beta/z").toInt(), 4);
+}
+
+void tst_QSettings::removeAfterExternalWrite()
+{
+    // sync() reads the file again when it changed on disk; keys removed
+    // from its sections must still be removed when it is written back
+    QTemporaryFile outFile;
+    QVERIFY(outFile.open());
+    outFile.write("[alpha]\n"
+                  "x=1\n"
+                  "[beta]\n"
+                  "y=2\n");
+    const QString fileName = outFile.fileName();
+    outFile.close();
+
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        QCOMPARE(settings.value("alpha/x").toInt(), 1);
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("[alpha]\n"
+                   "x=1\n"
+                   "w=3\n"
+                   "[beta]\n"
+                   "y=2\n");
+        file.close();
+
+        settings.remove("alpha/x");
+        settings.remove("beta");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    QVERIFY(!settings.contains("alpha/x"));
+    QCOMPARE(settings.value("alpha/w").toInt(), 3);
+    QVERIFY(!settings.contains("beta/y"));
+}
+
 void tst_QSettings::rainersSyncBugOnMac_data()
 {
     ctor_data();
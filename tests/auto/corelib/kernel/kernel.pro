@@ -14,6 +14,7 @@ SUBDIRS=\
     qobject \
     qpointer \
     qsharedmemory \
+    qsharedmemorychannel \
     qsignalblocker \
     qsignalmapper \
     qsocketnotifier \
@@ -39,3 +40,6 @@ SUBDIRS=\
 !win32*|winrt: SUBDIRS -= qwineventnotifier
 
 android|ios: SUBDIRS -= qsharedmemory qsystemsemaphore
+
+# only implemented on Unix
+!unix|android: SUBDIRS -= qsharedmemorychannel
@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QSharedMemoryChannel>
+#include <QtCore/QThread>
+
+#include <sys/stat.h>
+
+class tst_QSharedMemoryChannel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void createAndAttach();
+    void messages();
+    void wrapAround();
+    void full();
+    void zeroCopy();
+    void notifications();
+    void blockingThreads();
+    void foreignFifo();
+
+private:
+    QString uniqueKey();
+    int m_keyCount;
+
+public:
+    tst_QSharedMemoryChannel() : m_keyCount(0) {}
+};
+
+QString tst_QSharedMemoryChannel::uniqueKey()
+{
+    return QString::fromLatin1("tst_qsharedmemorychannel_%1_%2")
+            .arg(QCoreApplication::applicationPid()).arg(++m_keyCount);
+}
+
+static QByteArray message(int index, int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char(index * 31 + i);
+    return data;
+}
+
+void tst_QSharedMemoryChannel::createAndAttach()
+{
+    const QString key = uniqueKey();
+
+    QSharedMemoryChannel consumer(key);
+    QVERIFY(!consumer.attach(QSharedMemoryChannel::Consumer));
+    QCOMPARE(consumer.error(), QSharedMemoryChannel::NotFound);
+
+    QSharedMemoryChannel producer(key);
+    QVERIFY(!producer.create(QSharedMemoryChannel::Producer, 0));
+    QCOMPARE(producer.error(), QSharedMemoryChannel::InvalidSize);
+    QVERIFY2(producer.create(QSharedMemoryChannel::Producer, 10000), qPrintable(producer.errorString()));
+    QVERIFY(producer.isAttached());
+    QCOMPARE(producer.role(), QSharedMemoryChannel::Producer);
+    QCOMPARE(producer.capacity(), 16384);
+    QCOMPARE(producer.maximumMessageSize(), 8192 - 8);
+
+    QSharedMemoryChannel other(key);
+    QVERIFY(!other.create(QSharedMemoryChannel::Producer, 4096));
+    QCOMPARE(other.error(), QSharedMemoryChannel::AlreadyExists);
+
+    QVERIFY2(consumer.attach(QSharedMemoryChannel::Consumer), qPrintable(consumer.errorString()));
+    QCOMPARE(consumer.role(), QSharedMemoryChannel::Consumer);
+    QCOMPARE(consumer.capacity(), 16384);
+    QVERIFY(!consumer.attach(QSharedMemoryChannel::Consumer));
+    QCOMPARE(consumer.error(), QSharedMemoryChannel::AlreadyExists);
+
+    consumer.detach();
+    QVERIFY(!consumer.isAttached());
+    QCOMPARE(consumer.capacity(), 0);
+    producer.detach();
+    QVERIFY(!consumer.attach(QSharedMemoryChannel::Consumer));
+}
+
+void tst_QSharedMemoryChannel::messages()
+{
+    const QString key = uniqueKey();
+    QSharedMemoryChannel producer(key);
+    QVERIFY(producer.create(QSharedMemoryChannel::Producer, 65536));
+    QSharedMemoryChannel consumer(key);
+    QVERIFY(consumer.attach(QSharedMemoryChannel::Consumer));
+
+    QVERIFY(!consumer.hasPendingMessage());
+    QVERIFY(consumer.readMessage().isNull());
+
+    const int sizes[] = { 0, 1, 7, 8, 9, 100, 1000 };
+    for (int i = 0; i < 7; ++i)
+        QVERIFY(producer.writeMessage(message(i, sizes[i])));
+
+    for (int i = 0; i < 7; ++i) {
+        QVERIFY(consumer.hasPendingMessage());
+        QCOMPARE(consumer.readMessage(), message(i, sizes[i]));
+    }
+    QVERIFY(!consumer.hasPendingMessage());
+}
+
+void tst_QSharedMemoryChannel::wrapAround()
+{
+    const QString key = uniqueKey();
+    QSharedMemoryChannel producer(key);
+    QVERIFY(producer.create(QSharedMemoryChannel::Producer, 4096));
+    QSharedMemoryChannel consumer(key);
+    QVERIFY(consumer.attach(QSharedMemoryChannel::Consumer));
+
+    // sizes that don't divide the capacity, so records wrap at every offset
+    int written = 0;
+    int read = 0;
+    while (read < 2000) {
+        while (written < 2000 && producer.writeMessage(message(written, 13 + written % 1500)))
+            ++written;
+        QVERIFY(consumer.hasPendingMessage());
+        while (consumer.hasPendingMessage()) {
+            QCOMPARE(consumer.readMessage(), message(read, 13 + read % 1500));
+            ++read;
+        }
+    }
+    QCOMPARE(written, 2000);
+}
+
+void tst_QSharedMemoryChannel::full()
+{
+    const QString key = uniqueKey();
+    QSharedMemoryChannel producer(key);
+    QVERIFY(producer.create(QSharedMemoryChannel::Producer, 4096));
+    QSharedMemoryChannel consumer(key);
+    QVERIFY(consumer.attach(QSharedMemoryChannel::Consumer));
+
+    QVERIFY(!producer.writeMessage(message(0, producer.maximumMessageSize() + 1)));
+    QCOMPARE(producer.error(), QSharedMemoryChannel::MessageTooLarge);
+    QVERIFY(producer.writeMessage(message(0, producer.maximumMessageSize())));
+    QCOMPARE(consumer.readMessage(), message(0, producer.maximumMessageSize()));
+
+    // 120 bytes of payload take 128 bytes of the ring
+    int count = 0;
+    while (producer.writeMessage(message(count, 120)))
+        ++count;
+    QCOMPARE(count, 4096 / 128);
+    QVERIFY(!producer.waitForSpace(120, 10));
+
+    QCOMPARE(consumer.readMessage(), message(0, 120));
+    QVERIFY(producer.waitForSpace(120, 0));
+    QVERIFY(producer.writeMessage(message(count, 120)));
+    QVERIFY(!producer.writeMessage(message(count + 1, 120)));
+
+    for (int i = 1; i <= count; ++i)
+        QCOMPARE(consumer.readMessage(), message(i, 120));
+    QVERIFY(!consumer.hasPendingMessage());
+}
+
+void tst_QSharedMemoryChannel::zeroCopy()
+{
+    const QString key = uniqueKey();
+    QSharedMemoryChannel producer(key);
+    QVERIFY(producer.create(QSharedMemoryChannel::Producer, 4096));
+    QSharedMemoryChannel consumer(key);
+    QVERIFY(consumer.attach(QSharedMemoryChannel::Consumer));
+
+    QVERIFY(!producer.commitMessage());
+    char *buffer = producer.reserveMessage(5);
+    QVERIFY(buffer);
+    memcpy(buffer, "hello", 5);
+    QVERIFY(!consumer.hasPendingMessage());
+    QVERIFY(producer.commitMessage());
+    QVERIFY(!producer.commitMessage());
+
+    int size = -1;
+    const char *data = consumer.peekMessage(&size);
+    QVERIFY(data);
+    QCOMPARE(QByteArray(data, size), QByteArray("hello"));
+    QCOMPARE(consumer.peekMessage(&size), data);
+    consumer.releaseMessage();
+    QVERIFY(!consumer.peekMessage(&size));
+}
+
+void tst_QSharedMemoryChannel::notifications()
+{
+    const QString key = uniqueKey();
+    QSharedMemoryChannel producer(key);
+    QVERIFY(producer.create(QSharedMemoryChannel::Producer, 4096));
+    QSharedMemoryChannel consumer(key);
+    QVERIFY(consumer.attach(QSharedMemoryChannel::Consumer));
+    QSignalSpy messageSpy(&consumer, SIGNAL(messageAvailable()));
+    QSignalSpy spaceSpy(&producer, SIGNAL(spaceAvailable()));
+
+    QVERIFY(producer.writeMessage("first"));
+    QTRY_COMPARE(messageSpy.count(), 1);
+    QCOMPARE(consumer.readMessage(), QByteArray("first"));
+
+    // no more notifications until the consumer found the channel empty
+    QVERIFY(producer.writeMessage("second"));
+    QVERIFY(producer.writeMessage("third"));
+    QTRY_COMPARE(messageSpy.count(), 2);
+    QTest::qWait(20);
+    QCOMPARE(messageSpy.count(), 2);
+    QCOMPARE(consumer.readMessage(), QByteArray("second"));
+    QCOMPARE(consumer.readMessage(), QByteArray("third"));
+
+    while (producer.writeMessage(message(0, 500)))
+        ;
+    QTest::qWait(20);
+    QCOMPARE(spaceSpy.count(), 0);
+    consumer.readMessage();
+    QTRY_COMPARE(spaceSpy.count(), 1);
+    QVERIFY(producer.writeMessage(message(0, 500)));
+}
+
+class ConsumerThread : public QThread
+{
+public:
+    ConsumerThread(const QString &key, int count) : key(key), count(count), received(0) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QSharedMemoryChannel consumer(key);
+        if (!consumer.attach(QSharedMemoryChannel::Consumer))
+            return;
+        while (received < count && consumer.waitForMessage(10000)) {
+            if (consumer.readMessage() != message(received, 1 + received % 3000))
+                return;
+            ++received;
+        }
+    }
+
+    QString key;
+    int count;
+    int received;
+};
+
+void tst_QSharedMemoryChannel::blockingThreads()
+{
+    const QString key = uniqueKey();
+    QSharedMemoryChannel producer(key);
+    QVERIFY(producer.create(QSharedMemoryChannel::Producer, 8192));
+
+    const int count = 5000;
+    ConsumerThread thread(key, count);
+    thread.start();
+    for (int i = 0; i < count; ++i) {
+        const QByteArray data = message(i, 1 + i % 3000);
+        QVERIFY(producer.waitForSpace(data.size(), 10000));
+        QVERIFY(producer.writeMessage(data));
+    }
+    QVERIFY(thread.wait(30000));
+    QCOMPARE(thread.received, count);
+}
+
+void tst_QSharedMemoryChannel::foreignFifo()
+{
+    // anyone can create files in the temporary directory: what is found
+    // there instead of the FIFO must not be used
+    const QString key = uniqueKey();
+    const QString fifo = QDir::tempPath() + QLatin1String("/qipc_channel_")
+            + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()
+            + QLatin1String("_producer");
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString target = dir.path() + QLatin1String("/fifo");
+    QCOMPARE(::mkfifo(QFile::encodeName(target).constData(), 0600), 0);
+
+    QSharedMemoryChannel producer(key);
+    QVERIFY(QFile::link(target, fifo));
+    QVERIFY(!producer.create(QSharedMemoryChannel::Producer, 4096));
+    QCOMPARE(producer.error(), QSharedMemoryChannel::PermissionDenied);
+    QFile::remove(fifo);
+
+    QFile file(fifo);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QVERIFY(!producer.create(QSharedMemoryChannel::Producer, 4096));
+    QCOMPARE(producer.error(), QSharedMemoryChannel::PermissionDenied);
+    QFile::remove(fifo);
+
+    QVERIFY2(producer.create(QSharedMemoryChannel::Producer, 4096), qPrintable(producer.errorString()));
+}
+
+QTEST_MAIN(tst_QSharedMemoryChannel)
+#include "tst_qsharedmemorychannel.moc"
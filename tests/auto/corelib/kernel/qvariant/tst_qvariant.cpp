@@ -247,6 +247,8 @@ private slots:
     void numericalConvert();
     void moreCustomTypes();
     void movabilityTest();
+    void fromValueMove();
+    void largeCustomTypeStorage();
     void variantInVariant();
     void userConversion();
     void modelIndexConversion();
@@ -3717,6 +3719,112 @@ void tst_QVariant::movabilityTest()
     QVERIFY(!MyNotMovable::count);
 }
 
+struct MoveCounter
+{
+    static int copies;
+    static int moves;
+    QVector<int> payload;
+    MoveCounter() {}
+    MoveCounter(const MoveCounter &o) : payload(o.payload) { ++copies; }
+#ifdef Q_COMPILER_RVALUE_REFS
+    MoveCounter(MoveCounter &&o) : payload(std::move(o.payload)) { ++moves; }
+#endif
+    MoveCounter &operator=(const MoveCounter &o) { payload = o.payload; ++copies; return *this; }
+};
+int MoveCounter::copies = 0;
+int MoveCounter::moves = 0;
+
+QT_BEGIN_NAMESPACE
+Q_DECLARE_TYPEINFO(MoveCounter, Q_MOVABLE_TYPE);
+QT_END_NAMESPACE
+Q_DECLARE_METATYPE(MoveCounter);
+
+void tst_QVariant::fromValueMove()
+{
+#ifndef Q_COMPILER_RVALUE_REFS
+    QSKIP("This test requires C++11 rvalue reference support");
+#else
+    MoveCounter::copies = MoveCounter::moves = 0;
+
+    MoveCounter source;
+    source.payload << 1 << 2 << 3;
+    const int *payloadData = source.payload.constData();
+
+    QVariant v = QVariant::fromValue(std::move(source));
+    QCOMPARE(MoveCounter::copies, 0);
+    QCOMPARE(MoveCounter::moves, 1);
+    QCOMPARE(v.userType(), qMetaTypeId<MoveCounter>());
+    QVERIFY(!v.isNull());
+    QCOMPARE(v.value<MoveCounter>().payload, QVector<int>() << 1 << 2 << 3);
+    QCOMPARE(static_cast<const MoveCounter *>(v.constData())->payload.constData(), payloadData);
+
+    // lvalues must still be copied
+    MoveCounter::copies = MoveCounter::moves = 0;
+    MoveCounter lvalue;
+    QVariant v2 = QVariant::fromValue(lvalue);
+    QCOMPARE(MoveCounter::copies, 1);
+    QCOMPARE(MoveCounter::moves, 0);
+    const MoveCounter &constLvalue = lvalue;
+    v2 = QVariant::fromValue(constLvalue);
+    QCOMPARE(MoveCounter::copies, 2);
+
+    // a moved-from QVariant is not wrapped into another variant
+    QVariant inner(42);
+    QVariant outer = QVariant::fromValue(std::move(inner));
+    QCOMPARE(outer.type(), QVariant::Int);
+    QCOMPARE(outer.toInt(), 42);
+
+    // builtin types
+    QString str = QStringLiteral("hello");
+    QVariant v3 = QVariant::fromValue(std::move(str));
+    QCOMPARE(v3.type(), QVariant::String);
+    QCOMPARE(v3.toString(), QStringLiteral("hello"));
+
+    // pointers
+    QObject *ptr = this;
+    QVariant v4 = QVariant::fromValue(std::move(ptr));
+    QCOMPARE(v4.value<QObject *>(), static_cast<QObject *>(this));
+#endif
+}
+
+struct LargeCustomType
+{
+    double values[5];
+    char tag;
+};
+Q_DECLARE_METATYPE(LargeCustomType);
+
+void tst_QVariant::largeCustomTypeStorage()
+{
+    // custom types not fitting into the internal space are stored out of
+    // line; make sure they are aligned and survive copies and detaching
+    Q_STATIC_ASSERT(sizeof(LargeCustomType) > sizeof(QVariant::Private::Data));
+    LargeCustomType value;
+    for (int i = 0; i < 5; ++i)
+        value.values[i] = i * 1.5;
+    value.tag = 'x';
+
+    QVariant v = QVariant::fromValue(value);
+    QVERIFY(v.data_ptr().is_shared);
+    QCOMPARE(quintptr(v.constData()) % Q_ALIGNOF(LargeCustomType), quintptr(0));
+    QCOMPARE(quintptr(v.constData()) % Q_ALIGNOF(double), quintptr(0));
+
+    QVariant copy = v;
+    QCOMPARE(copy.constData(), v.constData());
+    LargeCustomType *data = static_cast<LargeCustomType *>(copy.data());
+    QVERIFY(copy.constData() != v.constData());
+    data->tag = 'y';
+
+    QCOMPARE(v.value<LargeCustomType>().tag, 'x');
+    QCOMPARE(copy.value<LargeCustomType>().tag, 'y');
+    for (int i = 0; i < 5; ++i)
+        QCOMPARE(copy.value<LargeCustomType>().values[i], i * 1.5);
+
+    copy.clear();
+    QVERIFY(!copy.isValid());
+    QCOMPARE(v.value<LargeCustomType>().values[4], 6.0);
+}
+
 void tst_QVariant::variantInVariant()
 {
     QVariant var1 = 5;
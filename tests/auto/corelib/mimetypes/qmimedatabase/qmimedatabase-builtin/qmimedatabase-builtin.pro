@@ -0,0 +1,9 @@
+CONFIG += testcase parallel_test
+
+TARGET = tst_qmimedatabase-builtin
+
+QT = core testlib
+
+SOURCES = tst_qmimedatabase-builtin.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,206 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qmimedatabase.h>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+static void initializeEnvironment()
+{
+    qputenv("LC_ALL", "");
+    qputenv("LANG", "C");
+    qunsetenv("QT_NO_MIME_CACHE");
+}
+
+// Set the environment before QCoreApplication is created
+Q_CONSTRUCTOR_FUNCTION(initializeEnvironment)
+
+// Tests the database built into QtCore, which is used when there is no
+// shared-mime-info installation at all
+class tst_QMimeDatabaseBuiltin : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void mimeTypeForName();
+    void mimeTypeForFileName_data();
+    void mimeTypeForFileName();
+    void mimeTypeForData();
+    void aliases();
+    void inheritance();
+    void allMimeTypes();
+    void installDatabaseLater(); // must be last, it leaves a database installed
+
+private:
+    QTemporaryDir m_emptyXdgDir;
+};
+
+void tst_QMimeDatabaseBuiltin::initTestCase()
+{
+    QVERIFY(m_emptyXdgDir.isValid());
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(m_emptyXdgDir.path()));
+    qputenv("XDG_DATA_HOME", QFile::encodeName(m_emptyXdgDir.path()));
+}
+
+void tst_QMimeDatabaseBuiltin::mimeTypeForName()
+{
+    QMimeDatabase db;
+    QMimeType zeroSize = db.mimeTypeForName(QStringLiteral("application/x-zerosize"));
+    QVERIFY(zeroSize.isValid());
+    QCOMPARE(zeroSize.comment(), QStringLiteral("empty document"));
+
+    // application/rdf+xml has the english comment after the other ones
+    QMimeType rdf = db.mimeTypeForName(QStringLiteral("application/rdf+xml"));
+    QVERIFY(rdf.isValid());
+    QCOMPARE(rdf.comment(), QStringLiteral("RDF file"));
+
+    QMimeType pdf = db.mimeTypeForName(QStringLiteral("application/pdf"));
+    QVERIFY(pdf.isValid());
+    QCOMPARE(pdf.globPatterns(), QStringList(QStringLiteral("*.pdf")));
+    QCOMPARE(pdf.preferredSuffix(), QStringLiteral("pdf"));
+    QCOMPARE(pdf.genericIconName(), QStringLiteral("x-office-document"));
+
+    QVERIFY(db.mimeTypeForName(QStringLiteral("application/octet-stream")).isDefault());
+    QVERIFY(!db.mimeTypeForName(QStringLiteral("foobar/x-doesnot-exist")).isValid());
+}
+
+void tst_QMimeDatabaseBuiltin::mimeTypeForFileName_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QString>("expectedMimeType");
+
+    QTest::newRow("text") << "textfile.txt" << "text/plain";
+    QTest::newRow("case-insensitive search") << "textfile.TxT" << "text/plain";
+    QTest::newRow("case-sensitive uppercase match") << "textfile.C" << "text/x-c++src";
+    QTest::newRow("case-sensitive lowercase match") << "textfile.c" << "text/x-csrc";
+    QTest::newRow("double-extension file") << "foo.tar.bz2" << "application/x-bzip-compressed-tar";
+    QTest::newRow("glob that uses [] syntax") << "Makefile" << "text/x-makefile";
+    QTest::newRow("glob that ends with *") << "README" << "text/x-readme";
+    QTest::newRow("no match") << "foo.doesnotexist" << "application/octet-stream";
+}
+
+void tst_QMimeDatabaseBuiltin::mimeTypeForFileName()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QString, expectedMimeType);
+    QMimeDatabase db;
+    QCOMPARE(db.mimeTypeForFile(fileName, QMimeDatabase::MatchExtension).name(), expectedMimeType);
+}
+
+void tst_QMimeDatabaseBuiltin::mimeTypeForData()
+{
+    QMimeDatabase db;
+    QCOMPARE(db.mimeTypeForData(QByteArray("%PDF-1.4")).name(), QStringLiteral("application/pdf"));
+    QCOMPARE(db.mimeTypeForData(QByteArray("\x89PNG\r\n\x1a\n")).name(), QStringLiteral("image/png"));
+    QCOMPARE(db.mimeTypeForData(QByteArray("hello world")).name(), QStringLiteral("text/plain"));
+}
+
+void tst_QMimeDatabaseBuiltin::aliases()
+{
+    QMimeDatabase db;
+    QCOMPARE(db.mimeTypeForName(QStringLiteral("application/x-pdf")).name(), QStringLiteral("application/pdf"));
+    QVERIFY(db.mimeTypeForName(QStringLiteral("text/x-csrc")).aliases().contains(QStringLiteral("text/x-c")));
+}
+
+void tst_QMimeDatabaseBuiltin::inheritance()
+{
+    QMimeDatabase db;
+    const QMimeType cSource = db.mimeTypeForName(QStringLiteral("text/x-csrc"));
+    QVERIFY(cSource.inherits(QStringLiteral("text/plain")));
+    QVERIFY(cSource.inherits(QStringLiteral("application/octet-stream")));
+    QCOMPARE(cSource.parentMimeTypes(), QStringList(QStringLiteral("text/plain")));
+}
+
+void tst_QMimeDatabaseBuiltin::allMimeTypes()
+{
+    QFile types(QStringLiteral(":/qt-project.org/qmime/types"));
+    QVERIFY(types.open(QIODevice::ReadOnly));
+    const int count = types.readAll().count('\n');
+
+    QMimeDatabase db;
+    const QList<QMimeType> lst = db.allMimeTypes();
+    QCOMPARE(lst.count(), count);
+    foreach (const QMimeType &mime, lst)
+        QVERIFY(mime.isValid());
+}
+
+QT_BEGIN_NAMESPACE
+extern Q_CORE_EXPORT int qmime_secondsBetweenChecks; // see qmimeprovider.cpp
+QT_END_NAMESPACE
+
+// a database installed after the built-in one was loaded is picked up
+void tst_QMimeDatabaseBuiltin::installDatabaseLater()
+{
+#ifdef QT_NO_PROCESS
+    QSKIP("This test requires QProcess support");
+#else
+    qmime_secondsBetweenChecks = 0;
+    QMimeDatabase db;
+    QVERIFY(db.mimeTypeForName(QStringLiteral("application/pdf")).isValid());
+    QVERIFY(!db.mimeTypeForName(QStringLiteral("text/x-qt-builtin-test")).isValid());
+
+    const QString mimeDir = m_emptyXdgDir.path() + QLatin1String("/mime");
+    QVERIFY(QDir().mkpath(mimeDir + QLatin1String("/packages")));
+    QFile package(mimeDir + QLatin1String("/packages/test.xml"));
+    QVERIFY(package.open(QIODevice::WriteOnly));
+    package.write("<?xml version=\"1.0\"?>\n"
+                  "<mime-info xmlns=\"http://www.freedesktop.org/standards/shared-mime-info\">\n"
+                  "  <mime-type type=\"text/x-qt-builtin-test\">\n"
+                  "    <comment>Installed later</comment>\n"
+                  "    <glob pattern=\"*.qtbuiltintest\"/>\n"
+                  "  </mime-type>\n"
+                  "</mime-info>\n");
+    package.close();
+
+    QProcess process;
+    process.start(QStringLiteral("update-mime-database"), QStringList(mimeDir));
+    if (!process.waitForStarted())
+        QSKIP("shared-mime-info not found");
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitCode(), 0);
+
+    const QMimeType installed = db.mimeTypeForName(QStringLiteral("text/x-qt-builtin-test"));
+    QVERIFY(installed.isValid());
+    QCOMPARE(installed.comment(), QStringLiteral("Installed later"));
+    QCOMPARE(db.mimeTypeForFile(QStringLiteral("foo.qtbuiltintest"), QMimeDatabase::MatchExtension).name(),
+             QStringLiteral("text/x-qt-builtin-test"));
+#endif
+}
+
+QTEST_GUILESS_MAIN(tst_QMimeDatabaseBuiltin)
+#include "tst_qmimedatabase-builtin.moc"
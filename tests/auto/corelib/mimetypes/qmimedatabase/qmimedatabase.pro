@@ -1,3 +1,3 @@
 TEMPLATE = subdirs
-SUBDIRS = qmimedatabase-xml
+SUBDIRS = qmimedatabase-xml qmimedatabase-builtin
 unix:!mac:!qnx: SUBDIRS += qmimedatabase-cache
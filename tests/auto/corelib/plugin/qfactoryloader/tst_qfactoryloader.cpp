@@ -34,7 +34,10 @@
 #include <QtTest/qtest.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
+#include <private/qpluginmetadatacache_p.h>
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
 
@@ -46,6 +49,11 @@ public slots:
 
 private slots:
     void usingTwoFactoriesFromSameDir();
+    void metaDataCache();
+    void metaDataCacheInvalidation();
+
+private:
+    QTemporaryDir m_cacheDir;
 };
 
 static const char binFolderC[] = "bin";
@@ -56,6 +64,10 @@ void tst_QFactoryLoader::initTestCase()
     QVERIFY2(!binFolder.isEmpty(), "Unable to locate 'bin' folder");
 
     QCoreApplication::setLibraryPaths(QStringList(QFileInfo(binFolder).absolutePath()));
+
+    // keep the plugin metadata cache out of the user's cache directory
+    QVERIFY(m_cacheDir.isValid());
+    qputenv("QT_PLUGIN_CACHE_PATH", QFile::encodeName(m_cacheDir.path()));
 }
 
 void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
@@ -79,5 +91,93 @@ void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
     QCOMPARE(plugin2->pluginName(), QLatin1String("Plugin2 ok"));
 }
 
+void tst_QFactoryLoader::metaDataCache()
+{
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    const QString pluginDir = QCoreApplication::libraryPaths().first() + suffix;
+
+    QList<QJsonObject> metaData;
+    {
+        QFactoryLoader loader(PluginInterface1_iid, suffix);
+        metaData = loader.metaData();
+    }
+    QCOMPARE(metaData.size(), 1);
+
+    // every file of the directory is cached, plugin or not
+    QPluginMetaDataCache cache(pluginDir);
+    QVERIFY(QFile::exists(cache.fileName()));
+    bool foundPlugin = false;
+    foreach (const QFileInfo &info, QDir(pluginDir).entryInfoList(QDir::Files)) {
+        QJsonObject cached;
+        QVERIFY2(cache.find(info.canonicalFilePath(), &cached), qPrintable(info.fileName()));
+        if (cached == metaData.first())
+            foundPlugin = true;
+    }
+    QVERIFY(foundPlugin);
+
+    // a second loader gets the same answer from the cache
+    {
+        QFactoryLoader loader(PluginInterface1_iid, suffix);
+        QCOMPARE(loader.metaData(), metaData);
+        QVERIFY(qobject_cast<PluginInterface1 *>(loader.instance(0)));
+    }
+
+    // and a broken cache is ignored
+    QFile cacheFile(cache.fileName());
+    QVERIFY(cacheFile.open(QIODevice::WriteOnly));
+    cacheFile.write("garbage");
+    cacheFile.close();
+    {
+        QFactoryLoader loader(PluginInterface1_iid, suffix);
+        QCOMPARE(loader.metaData(), metaData);
+    }
+    QPluginMetaDataCache rewritten(pluginDir);
+    QVERIFY(QFileInfo(rewritten.fileName()).size() > 7);
+}
+
+void tst_QFactoryLoader::metaDataCacheInvalidation()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString plugin = dir.path() + QLatin1String("/libplugin.so");
+    const QString other = dir.path() + QLatin1String("/libother.so");
+    QFile file(plugin);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not really a plugin");
+    file.close();
+    QVERIFY(QFile::copy(plugin, other));
+
+    QJsonObject metaData;
+    metaData.insert(QStringLiteral("IID"), QStringLiteral("org.qt-project.test"));
+    {
+        QPluginMetaDataCache cache(dir.path());
+        QVERIFY(cache.isEnabled());
+        QJsonObject cached;
+        QVERIFY(!cache.find(plugin, &cached));
+        cache.insert(plugin, metaData);
+        cache.insert(other, QJsonObject());
+        QVERIFY(cache.save());
+    }
+
+    QPluginMetaDataCache cache(dir.path());
+    QJsonObject cached;
+    QVERIFY(cache.find(plugin, &cached));
+    QCOMPARE(cached, metaData);
+    QVERIFY(cache.find(other, &cached));
+    QVERIFY(cached.isEmpty());
+    QVERIFY(!cache.find(dir.path() + QLatin1String("/libnew.so"), &cached));
+
+    // a changed file has to be parsed again
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(" anymore");
+    file.close();
+    QVERIFY(!cache.find(plugin, &cached));
+    QVERIFY(cache.find(other, &cached));
+
+    // the cache belongs to one directory
+    QPluginMetaDataCache otherDir(dir.path() + QLatin1String("/sub"));
+    QVERIFY(!otherDir.find(other, &cached));
+}
+
 QTEST_MAIN(tst_QFactoryLoader)
 #include "tst_qfactoryloader.moc"
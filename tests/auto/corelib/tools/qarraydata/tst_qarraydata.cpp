@@ -35,6 +35,8 @@
 #include <QtTest/QtTest>
 #include <QtCore/QString>
 #include <QtCore/qarraydata.h>
+#include <QtCore/QThread>
+#include <QtCore/private/qarraydataarena_p.h>
 
 #include "simplevector.h"
 
@@ -88,6 +90,10 @@ private slots:
     void rValueReferences();
 #endif
     void grow();
+    void arena();
+    void arenaEscape();
+    void arenaNesting();
+    void arenaCrossThread();
 };
 
 template <class T> const T &const_(const T &t) { return t; }
@@ -1773,5 +1779,140 @@ void tst_QArrayData::grow()
     }
 }
 
+static bool arenaSupported()
+{
+    QArrayDataArena probe;
+    return QArrayDataArena::current() == &probe;
+}
+
+void tst_QArrayData::arena()
+{
+    if (!arenaSupported())
+        QSKIP("QArrayDataArena requires thread_local support");
+
+    QArrayDataArena arena;
+    QCOMPARE(QArrayDataArena::current(), &arena);
+
+    QString str = QString::number(42);
+    QVERIFY(QArrayDataArena::isArenaBlock(str.data_ptr()));
+    QByteArray ba("arena");
+    QVERIFY(QArrayDataArena::isArenaBlock(ba.data_ptr()));
+    QCOMPARE(arena.allocationCount(), 2);
+
+    // growing moves the data out of the block instead of reallocating it
+    for (int i = 0; i < 100; ++i) {
+        str += QLatin1String("abcdefgh");
+        ba += "abcdefgh";
+    }
+    QCOMPARE(str.size(), 2 + 800);
+    QCOMPARE(ba.size(), 5 + 800);
+    QVERIFY(str.startsWith(QLatin1String("42abcdefghabcdefgh")));
+    QVERIFY(ba.endsWith("abcdefghabcdefgh"));
+    QVERIFY(QArrayDataArena::isArenaBlock(str.data_ptr()));
+    str.squeeze();
+    ba.squeeze();
+    QCOMPARE(str.capacity(), str.size());
+    QCOMPARE(ba.capacity(), ba.size());
+    QVERIFY(str.endsWith(QLatin1String("abcdefgh")));
+
+    // large blocks go to the heap
+    QByteArray large(QArrayDataArena::MaxBlockSize, 'x');
+    QVERIFY(!QArrayDataArena::isArenaBlock(large.data_ptr()));
+
+    const int chunksBefore = arena.chunkCount();
+    QVector<QString> strings;
+    for (int i = 0; i < 10000; ++i)
+        strings.append(QString::number(i));
+    QVERIFY(arena.chunkCount() > chunksBefore);
+    for (int i = 0; i < strings.size(); ++i)
+        QCOMPARE(strings.at(i).toInt(), i);
+}
+
+void tst_QArrayData::arenaEscape()
+{
+    if (!arenaSupported())
+        QSKIP("QArrayDataArena requires thread_local support");
+
+    QString escaped;
+    QByteArray shared;
+    {
+        QArrayDataArena arena;
+        QStringList temporaries;
+        for (int i = 0; i < 5000; ++i)
+            temporaries << QString::number(i * 3);
+        escaped = temporaries.at(1234);
+        shared = QByteArray("escaping byte array");
+        QVERIFY(QArrayDataArena::isArenaBlock(escaped.data_ptr()));
+    }
+    QVERIFY(!QArrayDataArena::current());
+
+    QCOMPARE(escaped, QString::number(1234 * 3));
+    QCOMPARE(shared, QByteArray("escaping byte array"));
+    QVERIFY(QArrayDataArena::isArenaBlock(escaped.data_ptr()));
+
+    // detaching after the arena is gone moves the data to the heap
+    escaped.append(QLatin1String(" and more"));
+    QVERIFY(!QArrayDataArena::isArenaBlock(escaped.data_ptr()));
+    QCOMPARE(escaped, QString::number(1234 * 3) + QLatin1String(" and more"));
+
+    shared.clear();
+    escaped.clear();
+    QVERIFY(!QArrayDataArena::isArenaBlock(QString::number(1).data_ptr()));
+}
+
+void tst_QArrayData::arenaNesting()
+{
+    if (!arenaSupported())
+        QSKIP("QArrayDataArena requires thread_local support");
+
+    QArrayDataArena outer;
+    QString a = QString::number(1);
+    {
+        QArrayDataArena inner;
+        QCOMPARE(QArrayDataArena::current(), &inner);
+        QString b = QString::number(2);
+        QCOMPARE(inner.allocationCount(), 1);
+        a += b;
+    }
+    QCOMPARE(QArrayDataArena::current(), &outer);
+    QCOMPARE(outer.allocationCount(), 1);
+    QCOMPARE(a, QString("12"));
+}
+
+class ArenaReleaseThread : public QThread
+{
+public:
+    QStringList strings;
+    bool sawArena;
+    void run() Q_DECL_OVERRIDE
+    {
+        sawArena = QArrayDataArena::current();
+        strings.clear();
+    }
+};
+
+void tst_QArrayData::arenaCrossThread()
+{
+    if (!arenaSupported())
+        QSKIP("QArrayDataArena requires thread_local support");
+
+    ArenaReleaseThread thread;
+    {
+        QArrayDataArena arena;
+        for (int i = 0; i < 1000; ++i)
+            thread.strings << QString::number(i);
+        thread.start();
+        QVERIFY(thread.wait());
+        QVERIFY(!thread.sawArena);
+        QVERIFY(thread.strings.isEmpty());
+
+        for (int i = 0; i < 1000; ++i)
+            thread.strings << QString::number(i);
+    }
+    thread.start();
+    QVERIFY(thread.wait());
+    QVERIFY(thread.strings.isEmpty());
+}
+
 QTEST_APPLESS_MAIN(tst_QArrayData)
 #include "tst_qarraydata.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qbtreemap
+QT = core testlib
+SOURCES = tst_qbtreemap.cpp
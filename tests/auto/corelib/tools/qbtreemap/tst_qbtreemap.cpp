@@ -0,0 +1,496 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qbtreemap.h>
+#include <map>
+
+class tst_QBTreeMap : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insert();
+    void insertDescending();
+    void remove();
+    void take();
+    void operator_bracket();
+    void bounds();
+    void iteration();
+    void erase();
+    void implicitSharing();
+    void compare();
+    void complexTypes();
+    void fromSorted_data();
+    void fromSorted();
+    void againstStdMap_data();
+    void againstStdMap();
+    void firstLast();
+    void initializerList();
+};
+
+struct Counted
+{
+    Counted(int v = 0) : value(v) { ++count; }
+    Counted(const Counted &other) : value(other.value) { ++count; }
+    ~Counted() { --count; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+
+    int value;
+    static int count;
+};
+int Counted::count = 0;
+
+inline bool operator<(const Counted &a, const Counted &b) { return a.value < b.value; }
+inline bool operator==(const Counted &a, const Counted &b) { return a.value == b.value; }
+
+QT_BEGIN_NAMESPACE
+Q_DECLARE_TYPEINFO(Counted, Q_MOVABLE_TYPE);
+QT_END_NAMESPACE
+
+// not movable, so that the items are moved by copying
+struct Static
+{
+    Static(int v = 0) : value(v), self(this) {}
+    Static(const Static &other) : value(other.value), self(this) {}
+    ~Static() { Q_ASSERT(self == this); }
+    Static &operator=(const Static &other) { value = other.value; return *this; }
+    bool isValid() const { return self == this; }
+
+    int value;
+    Static *self;
+};
+
+inline bool operator<(const Static &a, const Static &b) { return a.value < b.value; }
+
+void tst_QBTreeMap::insert()
+{
+    QBTreeMap<int, int> map;
+    QVERIFY(map.isEmpty());
+    QCOMPARE(map.value(1), 0);
+    QVERIFY(!map.contains(1));
+
+    QBTreeMap<int, int>::iterator it = map.insert(1, 10);
+    QCOMPARE(it.key(), 1);
+    QCOMPARE(it.value(), 10);
+    map.insert(1, 11);
+    QCOMPARE(map.size(), 1);
+    QCOMPARE(map.value(1), 11);
+
+    for (int i = 0; i < 100000; ++i) {
+        it = map.insert(i, i * 2);
+        QCOMPARE(it.key(), i);
+    }
+    QCOMPARE(map.size(), 100000);
+    for (int i = 0; i < 100000; ++i)
+        QCOMPARE(map.value(i, -1), i * 2);
+    QVERIFY(!map.contains(-1));
+    QVERIFY(!map.contains(100000));
+    QCOMPARE(map.value(-1, 42), 42);
+}
+
+void tst_QBTreeMap::insertDescending()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 10000; i > 0; --i)
+        map.insert(i, i);
+    QCOMPARE(map.size(), 10000);
+    int expected = 1;
+    for (QBTreeMap<int, int>::const_iterator it = map.constBegin(); it != map.constEnd(); ++it, ++expected)
+        QCOMPARE(it.key(), expected);
+    QCOMPARE(expected, 10001);
+}
+
+void tst_QBTreeMap::remove()
+{
+    QBTreeMap<int, int> map;
+    QCOMPARE(map.remove(1), 0);
+
+    for (int i = 0; i < 10000; ++i)
+        map.insert(i, i);
+    for (int i = 0; i < 10000; i += 2)
+        QCOMPARE(map.remove(i), 1);
+    QCOMPARE(map.remove(0), 0);
+    QCOMPARE(map.size(), 5000);
+    for (int i = 0; i < 10000; ++i)
+        QCOMPARE(map.contains(i), (i % 2) == 1);
+
+    for (int i = 1; i < 10000; i += 2)
+        QCOMPARE(map.remove(i), 1);
+    QVERIFY(map.isEmpty());
+    QVERIFY(map.constBegin() == map.constEnd());
+
+    // and the map can be filled again
+    map.insert(5, 5);
+    QCOMPARE(map.firstKey(), 5);
+    QCOMPARE(map.size(), 1);
+}
+
+void tst_QBTreeMap::take()
+{
+    QBTreeMap<int, QString> map;
+    map.insert(1, QLatin1String("one"));
+    map.insert(2, QLatin1String("two"));
+
+    QCOMPARE(map.take(1), QString("one"));
+    QCOMPARE(map.take(1), QString());
+    QCOMPARE(map.size(), 1);
+    QCOMPARE(map.value(2), QString("two"));
+}
+
+void tst_QBTreeMap::operator_bracket()
+{
+    QBTreeMap<QString, int> map;
+    map[QLatin1String("a")] = 1;
+    ++map[QLatin1String("a")];
+    ++map[QLatin1String("b")];
+    QCOMPARE(map.size(), 2);
+    QCOMPARE(map.value(QLatin1String("a")), 2);
+    QCOMPARE(map.value(QLatin1String("b")), 1);
+
+    const QBTreeMap<QString, int> &constMap = map;
+    QCOMPARE(constMap[QLatin1String("c")], 0);
+    QCOMPARE(map.size(), 2);
+}
+
+void tst_QBTreeMap::bounds()
+{
+    QBTreeMap<int, int> map;
+    QVERIFY(map.lowerBound(1) == map.end());
+    QVERIFY(map.upperBound(1) == map.end());
+
+    // even keys only, spread over many leaves
+    for (int i = 0; i < 20000; i += 2)
+        map.insert(i, i);
+
+    const QBTreeMap<int, int> &c = map;
+    for (int i = -1; i < 20001; ++i) {
+        QBTreeMap<int, int>::const_iterator lb = c.lowerBound(i);
+        QBTreeMap<int, int>::const_iterator ub = c.upperBound(i);
+        if (i >= 19999) {
+            QVERIFY(lb == c.constEnd());
+        } else {
+            const int expected = i < 0 ? 0 : (i + 1) / 2 * 2;
+            QCOMPARE(lb.key(), expected);
+        }
+        if (i >= 19998) {
+            QVERIFY(ub == c.constEnd());
+        } else {
+            const int expected = i < 0 ? 0 : (i / 2 + 1) * 2;
+            QCOMPARE(ub.key(), expected);
+        }
+    }
+
+    // a range scan
+    int sum = 0;
+    for (QBTreeMap<int, int>::const_iterator it = c.lowerBound(1000); it != c.upperBound(2000); ++it)
+        sum += it.value();
+    QCOMPARE(sum, (1000 + 2000) * 501 / 2);
+}
+
+void tst_QBTreeMap::iteration()
+{
+    QBTreeMap<int, int> map;
+    QVERIFY(map.constBegin() == map.constEnd());
+    QVERIFY(map.begin() == map.end());
+
+    for (int i = 0; i < 10000; ++i)
+        map.insert((i * 7919) % 10000, i);
+
+    int expected = 0;
+    for (QBTreeMap<int, int>::const_iterator it = map.constBegin(); it != map.constEnd(); ++it)
+        QCOMPARE(it.key(), expected++);
+    QCOMPARE(expected, 10000);
+
+    // backwards
+    QBTreeMap<int, int>::const_iterator it = map.constEnd();
+    while (it != map.constBegin()) {
+        --it;
+        QCOMPARE(it.key(), --expected);
+    }
+    QCOMPARE(expected, 0);
+
+    for (QBTreeMap<int, int>::iterator it = map.begin(); it != map.end(); ++it)
+        *it = it.key() * 3;
+    QList<int> values = map.values();
+    QList<int> keys = map.keys();
+    QCOMPARE(values.size(), 10000);
+    for (int i = 0; i < 10000; ++i) {
+        QCOMPARE(keys.at(i), i);
+        QCOMPARE(values.at(i), i * 3);
+    }
+}
+
+void tst_QBTreeMap::erase()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 10000; ++i)
+        map.insert(i, i);
+
+    QBTreeMap<int, int>::iterator it = map.begin();
+    while (it != map.end()) {
+        if (it.key() % 3 == 0)
+            it = map.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(map.size(), 6666);
+    int expected = 1;
+    for (QBTreeMap<int, int>::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+        QCOMPARE(it.key(), expected);
+        expected += (expected % 3 == 1) ? 1 : 2;
+    }
+}
+
+void tst_QBTreeMap::implicitSharing()
+{
+    QBTreeMap<int, QString> map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, QString::number(i));
+
+    QBTreeMap<int, QString> copy = map;
+    QVERIFY(copy.isSharedWith(map));
+
+    copy.insert(1000, QLatin1String("1000"));
+    QVERIFY(!copy.isSharedWith(map));
+    QCOMPARE(map.size(), 1000);
+    QCOMPARE(copy.size(), 1001);
+    QCOMPARE(copy.value(500), QString("500"));
+    QCOMPARE(copy.lastKey(), 1000);
+    QCOMPARE(map.lastKey(), 999);
+
+    copy = map;
+    copy.remove(10);
+    QCOMPARE(map.value(10), QString("10"));
+    QVERIFY(!copy.contains(10));
+
+    copy = map;
+    *copy.find(7) = QLatin1String("seven");
+    QCOMPARE(map.value(7), QString("7"));
+    QCOMPARE(copy.value(7), QString("seven"));
+
+    map.clear();
+    QVERIFY(map.isEmpty());
+    QCOMPARE(copy.size(), 1000);
+}
+
+void tst_QBTreeMap::compare()
+{
+    QBTreeMap<int, QString> a;
+    QBTreeMap<int, QString> b;
+    QVERIFY(a == b);
+
+    for (int i = 0; i < 1000; ++i)
+        a.insert(i, QString::number(i));
+    for (int i = 1999; i >= 0; --i)
+        b.insert(i, QString::number(i));
+    for (int i = 1000; i < 2000; ++i)
+        b.remove(i);
+    QVERIFY(a == b);
+    QVERIFY(!(a != b));
+
+    b.insert(5, QLatin1String("five"));
+    QVERIFY(a != b);
+    b.remove(5);
+    QVERIFY(a != b);
+}
+
+void tst_QBTreeMap::complexTypes()
+{
+    QCOMPARE(Counted::count, 0);
+    {
+        QBTreeMap<Counted, Counted> map;
+        for (int i = 0; i < 5000; ++i)
+            map.insert(Counted((i * 7919) % 5000), Counted(i));
+        // the inner nodes hold copies of some of the keys
+        const int itemCount = Counted::count;
+        QVERIFY(itemCount >= 10000);
+
+        QBTreeMap<Counted, Counted> copy = map;
+        QCOMPARE(Counted::count, itemCount);
+        copy.remove(Counted(0));
+        QVERIFY(Counted::count > itemCount);
+
+        for (int i = 0; i < 5000; i += 2)
+            map.remove(Counted(i));
+        QCOMPARE(map.size(), 2500);
+    }
+    QCOMPARE(Counted::count, 0);
+
+    QBTreeMap<Static, Static> map;
+    for (int i = 0; i < 5000; ++i)
+        map.insert(Static((i * 7919) % 5000), Static(i));
+    for (int i = 0; i < 5000; i += 3)
+        map.remove(Static(i));
+    for (QBTreeMap<Static, Static>::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+        QVERIFY(it.key().isValid());
+        QVERIFY(it.value().isValid());
+        QVERIFY(it.key().value % 3 != 0);
+    }
+
+    // inserting an item from the map itself
+    QBTreeMap<QString, QString> strings;
+    strings.insert(QLatin1String("key"), QLatin1String("value"));
+    for (int i = 0; i < 1000; ++i) {
+        QBTreeMap<QString, QString>::const_iterator it = strings.constFind(QLatin1String("key"));
+        strings.insert(it.value() + QString::number(i), it.value());
+    }
+    QCOMPARE(strings.size(), 1001);
+    QCOMPARE(strings.value(QLatin1String("value999")), QString("value"));
+}
+
+void tst_QBTreeMap::fromSorted_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("0") << 0;
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("64") << 64;
+    QTest::newRow("65") << 65;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_QBTreeMap::fromSorted()
+{
+    QFETCH(int, count);
+
+    std::map<int, int> stdMap;
+    QMap<int, int> qmap;
+    for (int i = 0; i < count; ++i) {
+        stdMap[i * 2] = i;
+        qmap.insert(i * 2, i);
+    }
+
+    QBTreeMap<int, int> fromStd(stdMap);
+    QBTreeMap<int, int> fromQMap(qmap);
+    QCOMPARE(fromStd.size(), count);
+    QVERIFY(fromStd == fromQMap);
+    QCOMPARE(fromQMap.toMap(), qmap);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(fromStd.value(i * 2, -1), i);
+
+    // and it behaves like any other map afterwards
+    for (int i = 0; i < count; ++i)
+        fromStd.insert(i * 2 + 1, -i);
+    for (int i = 0; i < count; i += 3)
+        fromStd.remove(i * 2);
+    QCOMPARE(fromStd.size(), count * 2 - (count + 2) / 3);
+    int previous = -1;
+    for (QBTreeMap<int, int>::const_iterator it = fromStd.constBegin(); it != fromStd.constEnd(); ++it) {
+        QVERIFY(it.key() > previous);
+        previous = it.key();
+    }
+}
+
+void tst_QBTreeMap::againstStdMap_data()
+{
+    QTest::addColumn<int>("seed");
+    QTest::addColumn<int>("range");
+    QTest::newRow("dense") << 1 << 2000;
+    QTest::newRow("sparse") << 2 << 100000;
+    QTest::newRow("tiny") << 3 << 50;
+}
+
+void tst_QBTreeMap::againstStdMap()
+{
+    QFETCH(int, seed);
+    QFETCH(int, range);
+    qsrand(seed);
+
+    std::map<int, int> reference;
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 200000; ++i) {
+        const int key = qrand() % range;
+        switch (qrand() % 5) {
+        case 0:
+        case 1:
+            QCOMPARE(map.remove(key), int(reference.erase(key)));
+            break;
+        default:
+            map.insert(key, i);
+            reference[key] = i;
+            break;
+        }
+        if (i % 10000 == 0) {
+            QBTreeMap<int, int> copy = map;
+            QVERIFY(copy == (QBTreeMap<int, int>(reference)));
+        }
+    }
+
+    QCOMPARE(map.size(), int(reference.size()));
+    std::map<int, int>::const_iterator ref = reference.begin();
+    for (QBTreeMap<int, int>::const_iterator it = map.constBegin(); it != map.constEnd(); ++it, ++ref) {
+        QCOMPARE(it.key(), ref->first);
+        QCOMPARE(it.value(), ref->second);
+    }
+    QVERIFY(ref == reference.end());
+
+    for (int i = 0; i < 1000; ++i) {
+        const int key = qrand() % (range + 2) - 1;
+        QBTreeMap<int, int>::const_iterator lb = map.lowerBound(key);
+        std::map<int, int>::const_iterator rlb = reference.lower_bound(key);
+        QCOMPARE(lb == map.constEnd(), rlb == reference.end());
+        if (rlb != reference.end())
+            QCOMPARE(lb.key(), rlb->first);
+    }
+}
+
+void tst_QBTreeMap::firstLast()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 100; i < 10000; ++i)
+        map.insert(i, -i);
+    QCOMPARE(map.firstKey(), 100);
+    QCOMPARE(map.lastKey(), 9999);
+    QCOMPARE(map.first(), -100);
+    QCOMPARE(map.last(), -9999);
+    map.last() = 1;
+    QCOMPARE(map.value(9999), 1);
+}
+
+void tst_QBTreeMap::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QBTreeMap<int, QString> map = {{2, "initializer_list"}, {1, "bar"}, {1, "hello"}};
+    QCOMPARE(map.count(), 2);
+    QCOMPARE(map[1], QString("hello"));
+    QCOMPARE(map[2], QString("initializer_list"));
+    QCOMPARE(map.firstKey(), 1);
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_QBTreeMap)
+#include "tst_qbtreemap.moc"
@@ -48,6 +48,7 @@ class tst_QByteArrayMatcher : public QObject
 private slots:
     void interface();
     void indexIn();
+    void indexInAllPositions();
 };
 
 static QByteArrayMatcher matcher1;
@@ -117,5 +118,46 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 2), 5);
 }
 
+static int naiveIndexOf(const QByteArray &haystack, const QByteArray &needle, int from)
+{
+    for (int i = qMax(from, 0); i + needle.size() <= haystack.size(); ++i) {
+        if (memcmp(haystack.constData() + i, needle.constData(), needle.size()) == 0)
+            return i;
+    }
+    return -1;
+}
+
+void tst_QByteArrayMatcher::indexInAllPositions()
+{
+    // Put the needle at every offset around the block boundaries of the
+    // vectorised search, with near misses (first and last byte matching)
+    // in front of it.
+    for (int needleSize = 1; needleSize <= 40; ++needleSize) {
+        QByteArray needle;
+        for (int i = 0; i < needleSize; ++i)
+            needle += char('a' + i % 26);
+        QByteArray nearMiss = needle;
+        if (needleSize > 2)
+            nearMiss[needleSize / 2] = 'X';
+
+        QByteArrayMatcher m(needle);
+        for (int haystackSize = needleSize; haystackSize <= needleSize + 70; ++haystackSize) {
+            for (int pos = 0; pos + needleSize <= haystackSize; pos += 3) {
+                QByteArray haystack(haystackSize, '.');
+                if (pos >= needleSize)
+                    haystack.replace(0, needleSize, nearMiss);
+                haystack.replace(pos, needleSize, needle);
+
+                for (int from = 0; from <= pos + 1; from += 5) {
+                    const int expected = naiveIndexOf(haystack, needle, from);
+                    QCOMPARE(m.indexIn(haystack, from), expected);
+                    QCOMPARE(m.indexIn(haystack.constData(), haystack.size(), from), expected);
+                    QCOMPARE(haystack.indexOf(needle, from), expected);
+                }
+            }
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QByteArrayMatcher)
 #include "tst_qbytearraymatcher.moc"
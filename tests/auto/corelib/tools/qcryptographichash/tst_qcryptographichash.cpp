@@ -47,6 +47,13 @@ private slots:
     void sha3();
     void files_data();
     void files();
+    void largeFile_data();
+    void largeFile();
+    void shrinkingFile();
+    void chunks_data();
+    void chunks();
+    void batch_data();
+    void batch();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -258,6 +265,170 @@ void tst_QCryptographicHash::files()
     }
 }
 
+void tst_QCryptographicHash::largeFile_data()
+{
+    QTest::addColumn<int>("openMode");
+    QTest::addColumn<int>("start");
+    QTest::addColumn<bool>("unflushed");
+
+    QTest::newRow("readonly") << int(QIODevice::ReadOnly) << 0 << false;
+    QTest::newRow("unbuffered") << int(QIODevice::ReadOnly | QIODevice::Unbuffered) << 0 << false;
+    QTest::newRow("text") << int(QIODevice::ReadOnly | QIODevice::Text) << 0 << false;
+    QTest::newRow("offset") << int(QIODevice::ReadOnly) << 1000 << false;
+    QTest::newRow("readwrite-unflushed") << int(QIODevice::ReadWrite) << 0 << true;
+}
+
+// large files are read in big chunks
+void tst_QCryptographicHash::largeFile()
+{
+    QFETCH(int, openMode);
+    QFETCH(int, start);
+    QFETCH(bool, unflushed);
+
+    QByteArray contents(3 * 1024 * 1024 + 4321, Qt::Uninitialized);
+    for (int i = 0; i < contents.size(); ++i)
+        contents[i] = char(i * 13 % 253);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.path() + QLatin1String("/large"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    if (unflushed) {
+        // still in QFile's write buffer
+        file.write("tail");
+        contents += "tail";
+    } else {
+        file.close();
+        QVERIFY(file.open(QIODevice::OpenMode(openMode)));
+    }
+    QVERIFY(file.seek(start));
+    if (start)
+        QCOMPARE(file.read(10), contents.mid(start, 10)); // leaves data in QFile's read buffer
+    else
+        QVERIFY(file.seek(0));
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QVERIFY(hash.addData(&file));
+    QVERIFY(file.atEnd());
+    QByteArray expected = contents.mid(start ? start + 10 : 0);
+    if (openMode & QIODevice::Text)
+        expected.replace('\r', QByteArray()); // as read() does
+    else
+        QCOMPARE(file.pos(), qint64(contents.size()));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(expected, QCryptographicHash::Sha1));
+}
+
+class ShrinkingFile : public QFile
+{
+public:
+    ShrinkingFile(const QString &name, qint64 newSize)
+        : QFile(name), newSize(newSize) {}
+
+    // another process truncates the file right after we took its size
+    qint64 size() const Q_DECL_OVERRIDE
+    {
+        const qint64 oldSize = QFile::size();
+        if (newSize >= 0) {
+            QFile::resize(fileName(), newSize);
+            newSize = -1;
+        }
+        return oldSize;
+    }
+
+private:
+    mutable qint64 newSize;
+};
+
+void tst_QCryptographicHash::shrinkingFile()
+{
+    QByteArray contents(8 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < contents.size(); ++i)
+        contents[i] = char(i * 13 % 253);
+    const qint64 newSize = 1024 * 1024;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QLatin1String("/shrinking");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(contents), qint64(contents.size()));
+    }
+
+    ShrinkingFile file(fileName, newSize);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QVERIFY(hash.addData(&file));
+    QCOMPARE(file.pos(), newSize);
+    QCOMPARE(hash.result(), QCryptographicHash::hash(contents.left(newSize), QCryptographicHash::Sha1));
+}
+
+void tst_QCryptographicHash::chunks_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::addColumn<int>("chunkSize");
+
+    const int chunkSizes[] = { 1, 55, 63, 64, 65, 1000, 10007 };
+    for (uint i = 0; i < sizeof(chunkSizes) / sizeof(*chunkSizes); ++i) {
+        const QByteArray suffix = '-' + QByteArray::number(chunkSizes[i]);
+        QTest::newRow("sha1" + suffix) << QCryptographicHash::Sha1
+            << QByteArray("4ee79d40e3f92d5a4fb0970717fa8eb988ed0844") << chunkSizes[i];
+        QTest::newRow("sha224" + suffix) << QCryptographicHash::Sha224
+            << QByteArray("02dc44398a6bb3e8a2c5968a10be60d3a3aa4538e13bb0e1d797b50b") << chunkSizes[i];
+        QTest::newRow("sha256" + suffix) << QCryptographicHash::Sha256
+            << QByteArray("76534061b66a635988385c55f278074cd9cffededbd3684121dc0e906e3d4c3f") << chunkSizes[i];
+    }
+}
+
+// whole blocks may be hashed straight from the input, and partial ones buffered
+void tst_QCryptographicHash::chunks()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(QByteArray, expected);
+    QFETCH(int, chunkSize);
+
+    QByteArray data(10007, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7 % 251);
+
+    QCryptographicHash hash(algorithm);
+    for (int i = 0; i < data.size(); i += chunkSize)
+        hash.addData(data.constData() + i, qMin(chunkSize, data.size() - i));
+    QCOMPARE(hash.result().toHex(), expected);
+}
+
+void tst_QCryptographicHash::batch_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("maxSize");
+
+    QTest::newRow("empty") << QCryptographicHash::Sha1 << 0 << 0;
+    QTest::newRow("one") << QCryptographicHash::Sha256 << 1 << 100;
+    QTest::newRow("md5-small") << QCryptographicHash::Md5 << 100 << 100;
+    QTest::newRow("sha1-many") << QCryptographicHash::Sha1 << 5000 << 300;
+    QTest::newRow("sha256-many") << QCryptographicHash::Sha256 << 5000 << 300;
+    QTest::newRow("sha256-large") << QCryptographicHash::Sha256 << 20 << 200000;
+    QTest::newRow("sha3_512-many") << QCryptographicHash::Sha3_512 << 2000 << 300;
+}
+
+void tst_QCryptographicHash::batch()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, count);
+    QFETCH(int, maxSize);
+
+    QByteArrayList data;
+    for (int i = 0; i < count; ++i)
+        data << QByteArray(i * 7919 % (maxSize + 1), char('a' + i % 26));
+
+    const QByteArrayList results = QCryptographicHash::hash(data, algorithm);
+    QCOMPARE(results.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(results.at(i), QCryptographicHash::hash(data.at(i), algorithm));
+}
 
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
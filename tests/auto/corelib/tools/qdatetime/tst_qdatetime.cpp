@@ -714,6 +714,12 @@ void tst_QDateTime::toString_isoDate_data()
     QTest::newRow("negative non-integral OffsetFromUTC")
             << dt
             << QString("1978-11-09T13:28:34-00:15");
+    QTest::newRow("UTC, leading zeros")
+            << QDateTime(QDate(999, 2, 3), QTime(4, 5, 6), Qt::UTC)
+            << QString("0999-02-03T04:05:06Z");
+    QTest::newRow("UTC, end of year")
+            << QDateTime(QDate(2015, 12, 31), QTime(23, 59, 59), Qt::UTC)
+            << QString("2015-12-31T23:59:59Z");
     QTest::newRow("invalid")
             << QDateTime(QDate(-1, 11, 9), QTime(13, 28, 34), Qt::UTC)
             << QString();
@@ -2069,6 +2075,15 @@ void tst_QDateTime::fromStringDateFormat()
 
     QDateTime dateTime = QDateTime::fromString(dateTimeStr, dateFormat);
     QCOMPARE(dateTime, expected);
+
+    // The QLatin1String overload must agree with the QString one
+    const QByteArray latin1 = dateTimeStr.toLatin1();
+    if (QString::fromLatin1(latin1) == dateTimeStr) {
+        QDateTime latin1DateTime = QDateTime::fromString(QLatin1String(latin1), dateFormat);
+        QCOMPARE(latin1DateTime, expected);
+        QCOMPARE(latin1DateTime.timeSpec(), dateTime.timeSpec());
+        QCOMPARE(latin1DateTime.offsetFromUtc(), dateTime.offsetFromUtc());
+    }
 }
 
 void tst_QDateTime::fromStringStringFormat_data()
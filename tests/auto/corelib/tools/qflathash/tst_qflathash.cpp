@@ -0,0 +1,498 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insert();
+    void remove();
+    void removeAndReinsert();
+    void take();
+    void operator_bracket();
+    void erase();
+    void iteration();
+    void implicitSharing();
+    void copyOnWriteThroughIterators();
+    void reserve();
+    void squeeze();
+    void compare();
+    void complexTypes();
+    void colliding();
+    void againstQHash_data();
+    void againstQHash();
+    void initializerList();
+    void flatSet();
+};
+
+struct Counted
+{
+    Counted(int v = 0) : value(v) { ++count; }
+    Counted(const Counted &other) : value(other.value) { ++count; }
+    ~Counted() { --count; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+
+    int value;
+    static int count;
+};
+int Counted::count = 0;
+
+inline bool operator==(const Counted &a, const Counted &b) { return a.value == b.value; }
+inline uint qHash(const Counted &c, uint seed = 0) { return qHash(c.value, seed); }
+
+// every key hashes to the same value, so that all lookups have to probe
+struct Colliding
+{
+    Colliding(int v = 0) : value(v) {}
+    int value;
+};
+
+inline bool operator==(const Colliding &a, const Colliding &b) { return a.value == b.value; }
+inline uint qHash(const Colliding &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QCOMPARE(hash.value(1), 0);
+    QVERIFY(!hash.contains(1));
+
+    QFlatHash<int, int>::iterator it = hash.insert(1, 10);
+    QCOMPARE(it.key(), 1);
+    QCOMPARE(it.value(), 10);
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(1), 10);
+
+    // inserting an existing key replaces the value
+    hash.insert(1, 11);
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(1), 11);
+
+    for (int i = 0; i < 10000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 10000);
+    QVERIFY(hash.capacity() >= hash.size());
+    for (int i = 0; i < 10000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash.count(i), 1);
+    }
+    QVERIFY(!hash.contains(-1));
+    QCOMPARE(hash.value(-1, 42), 42);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.remove(1), 0);
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    for (int i = 0; i < 1000; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 500);
+
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), (i % 2) == 1);
+}
+
+void tst_QFlatHash::removeAndReinsert()
+{
+    // keeps the size constant while cycling through keys, so that the
+    // table fills up with deleted slots that have to be cleaned up
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 40; ++i)
+        hash.insert(i, i);
+    const int capacity = hash.capacity();
+
+    for (int i = 40; i < 100000; ++i) {
+        QCOMPARE(hash.remove(i - 40), 1);
+        hash.insert(i, i);
+    }
+    QCOMPARE(hash.size(), 40);
+    QCOMPARE(hash.capacity(), capacity);
+    for (int i = 100000 - 40; i < 100000; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QLatin1String("one"));
+    hash.insert(2, QLatin1String("two"));
+
+    QCOMPARE(hash.take(1), QString("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(2), QString("two"));
+}
+
+void tst_QFlatHash::operator_bracket()
+{
+    QFlatHash<QString, int> hash;
+    hash[QLatin1String("a")] = 1;
+    ++hash[QLatin1String("a")];
+    ++hash[QLatin1String("b")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(QLatin1String("a")), 2);
+    QCOMPARE(hash.value(QLatin1String("b")), 1);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QLatin1String("c")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), (i % 3) != 0);
+
+    it = hash.find(1);
+    QVERIFY(it != hash.end());
+    hash.erase(it);
+    QVERIFY(hash.find(1) == hash.end());
+    QVERIFY(hash.constFind(1) == hash.constEnd());
+    QCOMPARE(hash.size(), 665);
+}
+
+void tst_QFlatHash::iteration()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.constBegin() == hash.constEnd());
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, -i);
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), -it.key());
+        QVERIFY(!seen.contains(it.key()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 1000);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it = it.key();
+    foreach (int key, hash.keys())
+        QCOMPARE(hash.value(key), key);
+
+    QList<int> values = hash.values();
+    std::sort(values.begin(), values.end());
+    QCOMPARE(values.size(), 1000);
+    QCOMPARE(values.first(), 0);
+    QCOMPARE(values.last(), 999);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QLatin1String("one"));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(2, QLatin1String("two"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    copy = hash;
+    copy.remove(1);
+    QCOMPARE(hash.value(1), QString("one"));
+    QVERIFY(copy.isEmpty());
+
+    QFlatHash<int, QString> other;
+    other.swap(copy);
+    QVERIFY(copy.isEmpty());
+    QVERIFY(other.isEmpty());
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(1));
+}
+
+void tst_QFlatHash::copyOnWriteThroughIterators()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    QFlatHash<int, int> copy = hash;
+
+    // erasing through an iterator of the shared data must detach first
+    QFlatHash<int, int>::const_iterator it = copy.constFind(50);
+    QVERIFY(it != copy.constEnd());
+    copy.erase(it);
+    QCOMPARE(copy.size(), 99);
+    QVERIFY(!copy.contains(50));
+    QCOMPARE(hash.size(), 100);
+    QVERIFY(hash.contains(50));
+
+    copy = hash;
+    *copy.find(7) = 70;
+    QCOMPARE(copy.value(7), 70);
+    QCOMPARE(hash.value(7), 7);
+}
+
+void tst_QFlatHash::reserve()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    QVERIFY(hash.capacity() >= 1000);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    // never shrinks
+    hash.reserve(10);
+    QCOMPARE(hash.capacity(), capacity);
+    QCOMPARE(hash.size(), 1000);
+}
+
+void tst_QFlatHash::squeeze()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    const int capacity = hash.capacity();
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+
+    hash.remove(0);
+    for (int i = 1; i < 10; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<int, QString> a;
+    QFlatHash<int, QString> b;
+    QVERIFY(a == b);
+
+    // same contents, different insertion order and history
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, QString::number(i));
+    for (int i = 199; i >= 0; --i)
+        b.insert(i, QString::number(i));
+    for (int i = 100; i < 200; ++i)
+        b.remove(i);
+    QVERIFY(a == b);
+    QVERIFY(!(a != b));
+
+    b.insert(5, QLatin1String("five"));
+    QVERIFY(a != b);
+    b.remove(5);
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::complexTypes()
+{
+    QCOMPARE(Counted::count, 0);
+    {
+        QFlatHash<Counted, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(Counted(i), Counted(-i));
+        QCOMPARE(Counted::count, 2000);
+
+        QFlatHash<Counted, Counted> copy = hash;
+        QCOMPARE(Counted::count, 2000);
+        copy.remove(Counted(0));
+        QCOMPARE(Counted::count, 2000 + 2 * 999);
+
+        for (int i = 0; i < 500; ++i)
+            hash.remove(Counted(i));
+        QCOMPARE(Counted::count, 1000 + 2 * 999);
+        hash.squeeze();
+        QCOMPARE(Counted::count, 1000 + 2 * 999);
+        for (int i = 500; i < 1000; ++i)
+            QCOMPARE(hash.value(Counted(i)).value, -i);
+
+        // inserting an item from the hash itself while it grows
+        QFlatHash<QString, QString> strings;
+        strings.insert(QLatin1String("key"), QLatin1String("value"));
+        for (int i = 0; i < 100; ++i) {
+            QFlatHash<QString, QString>::const_iterator it = strings.constFind(QLatin1String("key"));
+            strings.insert(it.value() + QString::number(i), it.value());
+        }
+        QCOMPARE(strings.size(), 101);
+        QCOMPARE(strings.value(QLatin1String("value99")), QString("value"));
+    }
+    QCOMPARE(Counted::count, 0);
+}
+
+void tst_QFlatHash::colliding()
+{
+    QFlatHash<Colliding, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(Colliding(i), i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(Colliding(i), -1), i);
+    QVERIFY(!hash.contains(Colliding(200)));
+
+    for (int i = 0; i < 200; i += 2)
+        hash.remove(Colliding(i));
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.contains(Colliding(i)), (i % 2) == 1);
+    for (int i = 0; i < 200; i += 2)
+        hash.insert(Colliding(i), i);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(Colliding(i), -1), i);
+}
+
+void tst_QFlatHash::againstQHash_data()
+{
+    QTest::addColumn<int>("seed");
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("3") << 3;
+}
+
+void tst_QFlatHash::againstQHash()
+{
+    QFETCH(int, seed);
+    qsrand(seed);
+
+    QHash<int, int> reference;
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100000; ++i) {
+        const int key = qrand() % 5000;
+        switch (qrand() % 4) {
+        case 0:
+            QCOMPARE(hash.remove(key), reference.remove(key));
+            break;
+        case 1:
+            QCOMPARE(hash.take(key), reference.take(key));
+            break;
+        default:
+            hash.insert(key, i);
+            reference.insert(key, i);
+            break;
+        }
+    }
+
+    QCOMPARE(hash.size(), reference.size());
+    for (QHash<int, int>::const_iterator it = reference.constBegin(); it != reference.constEnd(); ++it)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+    int n = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it, ++n)
+        QCOMPARE(reference.value(it.key(), -1), it.value());
+    QCOMPARE(n, reference.size());
+}
+
+void tst_QFlatHash::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> hash = {{1, "bar"}, {1, "hello"}, {2, "initializer_list"}};
+    QCOMPARE(hash.count(), 2);
+    QCOMPARE(hash[1], QString("hello"));
+    QCOMPARE(hash[2], QString("initializer_list"));
+
+    QFlatSet<int> set = {1, 2, 3, 2};
+    QCOMPARE(set.size(), 3);
+    QVERIFY(set.contains(2));
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+void tst_QFlatHash::flatSet()
+{
+    QFlatSet<QString> set;
+    QVERIFY(set.isEmpty());
+    QVERIFY(set.constBegin() == set.constEnd());
+
+    QFlatSet<QString>::const_iterator it = set.insert(QLatin1String("one"));
+    QCOMPARE(*it, QString("one"));
+    set.insert(QLatin1String("two"));
+    set.insert(QLatin1String("one"));
+    QCOMPARE(set.size(), 2);
+    QVERIFY(set.contains(QLatin1String("one")));
+    QVERIFY(!set.contains(QLatin1String("three")));
+
+    QFlatSet<QString> copy = set;
+    QVERIFY(copy == set);
+    QVERIFY(copy.remove(QLatin1String("one")));
+    QVERIFY(!copy.remove(QLatin1String("one")));
+    QVERIFY(copy != set);
+    QCOMPARE(set.size(), 2);
+
+    QStringList values = set.values();
+    values.sort();
+    QCOMPARE(values, QStringList() << QLatin1String("one") << QLatin1String("two"));
+
+    it = set.find(QLatin1String("two"));
+    QVERIFY(it != set.constEnd());
+    it = set.erase(it);
+    QCOMPARE(set.size(), 1);
+    QVERIFY(!set.contains(QLatin1String("two")));
+
+    QFlatSet<int> ints;
+    for (int i = 0; i < 1000; ++i)
+        ints.insert(i);
+    int sum = 0;
+    for (QFlatSet<int>::const_iterator i = ints.constBegin(); i != ints.constEnd(); ++i)
+        sum += *i;
+    QCOMPARE(sum, 999 * 1000 / 2);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -42,6 +42,7 @@
 #include <qdatetime.h>
 #include <qprocess.h>
 #include <float.h>
+#include <limits>
 
 #include <qlocale.h>
 #include <private/qlocale_p.h>
@@ -148,6 +149,11 @@ private slots:
     void testInfAndNan();
     void fpExceptions();
     void negativeZero();
+    void floatingPointShortest_data();
+    void floatingPointShortest();
+    void doubleRoundTrip();
+    void toDoubleExact_data();
+    void toDoubleExact();
     void dayOfWeek();
     void dayOfWeek_data();
     void formatDate();
@@ -987,6 +993,126 @@ void tst_QLocale::negativeZero()
     QCOMPARE(s, QString("0"));
 }
 
+void tst_QLocale::floatingPointShortest_data()
+{
+    QTest::addColumn<double>("d");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("0.1 g") << 0.1 << 'g' << QString("0.1");
+    QTest::newRow("0.1 e") << 0.1 << 'e' << QString("1e-01");
+    QTest::newRow("0.1 f") << 0.1 << 'f' << QString("0.1");
+    QTest::newRow("1/3 g") << 1 / 3.0 << 'g' << QString("0.3333333333333333");
+    QTest::newRow("-1.5 g") << -1.5 << 'g' << QString("-1.5");
+    QTest::newRow("0 g") << 0.0 << 'g' << QString("0");
+    QTest::newRow("-0 g") << -0.0 << 'g' << QString("0");
+    QTest::newRow("100 g") << 100.0 << 'g' << QString("100");
+    QTest::newRow("100 e") << 100.0 << 'e' << QString("1e+02");
+    QTest::newRow("100 E") << 100.0 << 'E' << QString("1E+02");
+    QTest::newRow("100 f") << 100.0 << 'f' << QString("100");
+    QTest::newRow("123.456 e") << 123.456 << 'e' << QString("1.23456e+02");
+    QTest::newRow("123.456 f") << 123.456 << 'f' << QString("123.456");
+    QTest::newRow("0.0001 g") << 0.0001 << 'g' << QString("0.0001");
+    QTest::newRow("0.00001 g") << 0.00001 << 'g' << QString("1e-05");
+    QTest::newRow("1e16 g") << 1e16 << 'g' << QString("10000000000000000");
+    QTest::newRow("1e17 g") << 1e17 << 'g' << QString("1e+17");
+    QTest::newRow("1e23 g") << 1e23 << 'g' << QString("1e+23");
+    QTest::newRow("2^53 + 1 g") << 9007199254740993.0 << 'g' << QString("9007199254740992");
+    QTest::newRow("denorm_min g") << std::numeric_limits<double>::denorm_min() << 'g' << QString("5e-324");
+    QTest::newRow("min g") << std::numeric_limits<double>::min() << 'g' << QString("2.2250738585072014e-308");
+    QTest::newRow("max g") << std::numeric_limits<double>::max() << 'g' << QString("1.7976931348623157e+308");
+    QTest::newRow("epsilon g") << std::numeric_limits<double>::epsilon() << 'g' << QString("2.220446049250313e-16");
+}
+
+void tst_QLocale::floatingPointShortest()
+{
+    QFETCH(double, d);
+    QFETCH(char, format);
+    QFETCH(QString, expected);
+
+    QCOMPARE(QString::number(d, format, QLocale::FloatingPointShortest), expected);
+    QCOMPARE(QByteArray::number(d, format, QLocale::FloatingPointShortest), expected.toLatin1());
+    QLocale c(QLocale::C);
+    c.setNumberOptions(QLocale::OmitGroupSeparator);
+    QCOMPARE(c.toString(d, format, QLocale::FloatingPointShortest), expected);
+
+    QLocale de(QLocale::German);
+    de.setNumberOptions(QLocale::OmitGroupSeparator);
+    QCOMPARE(de.toString(d, format, QLocale::FloatingPointShortest),
+             QString(expected).replace(QLatin1Char('.'), QLatin1Char(',')));
+
+    QCOMPARE(expected.toDouble(), d);
+}
+
+void tst_QLocale::doubleRoundTrip()
+{
+    // random bit patterns, through both the shortest and the 17 digit conversions
+    quint64 state = Q_UINT64_C(0x9e3779b97f4a7c15);
+    for (int i = 0; i < 100000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        if (!qIsFinite(d))
+            continue;
+
+        bool ok;
+        const QString shortest = QString::number(d, 'g', QLocale::FloatingPointShortest);
+        const double shortestBack = shortest.toDouble(&ok);
+        QVERIFY2(ok && shortestBack == d, qPrintable(shortest));
+        const QByteArray full = QByteArray::number(d, 'e', 16);
+        const double fullBack = full.toDouble(&ok);
+        QVERIFY2(ok && fullBack == d, full.constData());
+        QVERIFY(shortest.length() <= QString::number(d, 'g', 17).length());
+    }
+}
+
+void tst_QLocale::toDoubleExact_data()
+{
+    QTest::addColumn<QByteArray>("str");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("0.1") << QByteArray("0.1") << 0.1;
+    QTest::newRow("-0") << QByteArray("-0") << -0.0;
+    QTest::newRow("+.5") << QByteArray("+.5") << 0.5;
+    QTest::newRow("5.") << QByteArray("5.") << 5.0;
+    QTest::newRow("0.000123e4") << QByteArray("0.000123e4") << 1.23;
+    QTest::newRow("1e22") << QByteArray("1e22") << 1e22;
+    QTest::newRow("1e23") << QByteArray("1e23") << 1e23;
+    QTest::newRow("1e-22") << QByteArray("1e-22") << 1e-22;
+    QTest::newRow("8.5e-22") << QByteArray("8.5e-22") << 8.5e-22;
+    QTest::newRow("2^53") << QByteArray("9007199254740992") << 9007199254740992.0;
+    QTest::newRow("2^53 + 1") << QByteArray("9007199254740993") << 9007199254740992.0;
+    QTest::newRow("19 digits") << QByteArray("1234567890123456789") << 1234567890123456789.0;
+    QTest::newRow("30 digits") << QByteArray("123456789012345678901234567890")
+                               << 123456789012345678901234567890.0;
+    QTest::newRow("leading zeros") << QByteArray("0000000000000000000000.5") << 0.5;
+    QTest::newRow("max") << QByteArray("1.7976931348623157e308") << std::numeric_limits<double>::max();
+    QTest::newRow("denorm_min") << QByteArray("4.9e-324") << std::numeric_limits<double>::denorm_min();
+}
+
+void tst_QLocale::toDoubleExact()
+{
+    QFETCH(QByteArray, str);
+    QFETCH(double, expected);
+
+    // compare the bits, for the sign of zero
+    bool ok;
+    double d = str.toDouble(&ok);
+    QVERIFY(ok);
+    QVERIFY(memcmp(&d, &expected, sizeof(d)) == 0);
+
+    d = QString::fromLatin1(str).toDouble(&ok);
+    QVERIFY(ok);
+    QVERIFY(memcmp(&d, &expected, sizeof(d)) == 0);
+
+    // not NUL-terminated
+    d = QByteArray::fromRawData(str.constData(), str.size()).toDouble(&ok);
+    QVERIFY(ok);
+    QVERIFY(memcmp(&d, &expected, sizeof(d)) == 0);
+}
+
 void tst_QLocale::dayOfWeek_data()
 {
     QTest::addColumn<QDate>("date");
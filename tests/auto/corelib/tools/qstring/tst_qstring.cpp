@@ -554,6 +554,7 @@ private slots:
     void nanAndInf();
     void compare_data();
     void compare();
+    void caseFoldedMatching();
     void resizeAfterFromRawData();
     void resizeAfterReserve();
     void resizeWithNegative() const;
@@ -5857,6 +5858,16 @@ void tst_QString::compare_data()
     lower += QChar(QChar::lowSurrogate(0x10428));
     QTest::newRow("data8") << upper << lower << -1 << 0;
 
+    // longer than one SIMD block
+    QTest::newRow("long-equal") << QString("The Quick Brown Fox Jumps") << QString("the quick brown fox jumps") << -1 << 0;
+    QTest::newRow("long-differ-at-end") << QString("abcdefghijklmnopQrstu") << QString("ABCDEFGHIJKLMNOPqrstx") << 1 << -1;
+    QTest::newRow("long-kelvin") << (QString("temperature in ") + QChar(0x212a) + QString("elvin"))
+                                 << QString("TEMPERATURE IN KELVIN") << 1 << 0;
+    QTest::newRow("long-long-s") << (QString("Ma") + QChar(0x17f) + QString("e ma") + QChar(0x17f) + QString("e mase"))
+                                 << QString("MASE MASE MASE") << 1 << 0;
+    QTest::newRow("long-surrogates") << (QString("abcdefg") + upper + QString("hijklmnopq"))
+                                     << (QString("ABCDEFG") + lower + QString("HIJKLMNOPQ")) << 1 << 0;
+
     // embedded nulls
     // These don't work as of now. It's OK that these don't work since \0 is not a valid unicode
     /*QTest::newRow("data10") << QString(QByteArray("\0", 1)) << QString(QByteArray("\0", 1)) << 0 << 0;
@@ -5936,6 +5947,50 @@ void tst_QString::compare()
     }
 }
 
+void tst_QString::caseFoldedMatching()
+{
+    // case-insensitive comparisons and searches must agree with comparing
+    // and searching the case folded strings, at any position
+    const ushort alphabet[] = { 'a', 'A', 'k', 'K', 's', 'S', 'z', ' ', 0xe9, 0xc9, 0x212a, 0x17f };
+    const int alphabetSize = int(sizeof alphabet / sizeof *alphabet);
+    uint seed = 42;
+
+    for (int length = 0; length < 48; ++length) {
+        for (int round = 0; round < 20; ++round) {
+            QString s1(length, Qt::Uninitialized);
+            QString s2(length, Qt::Uninitialized);
+            const int asciiOnly = round % 2 ? 8 : alphabetSize;
+            for (int i = 0; i < length; ++i) {
+                seed = seed * 1103515245 + 12345;
+                s1[i] = QChar(alphabet[(seed >> 16) % asciiOnly]);
+                // mostly equal up to case
+                seed = seed * 1103515245 + 12345;
+                s2[i] = (seed >> 16) % 16 ? s1.at(i).toCaseFolded() : QChar(alphabet[(seed >> 20) % asciiOnly]);
+                seed = seed * 1103515245 + 12345;
+                if ((seed >> 16) % 2 && s2.at(i).unicode() < 0x80)
+                    s2[i] = s2.at(i).toUpper();
+            }
+            const QString f1 = s1.toCaseFolded();
+            const QString f2 = s2.toCaseFolded();
+            QCOMPARE(sign(QString::compare(s1, s2, Qt::CaseInsensitive)), sign(QString::compare(f1, f2)));
+            if (isLatin(s2)) {
+                const QByteArray latin1 = s2.toLatin1();
+                QCOMPARE(sign(QString::compare(s1, QLatin1String(latin1), Qt::CaseInsensitive)),
+                         sign(QString::compare(f1, f2)));
+            }
+
+            for (int start = 0; start < length; start += 3) {
+                for (int needleLength = 1; start + needleLength <= length; needleLength += 4) {
+                    const QString needle = s2.mid(start, needleLength);
+                    const int expected = f1.indexOf(needle.toCaseFolded());
+                    QCOMPARE(s1.indexOf(needle, 0, Qt::CaseInsensitive), expected);
+                    QCOMPARE(QStringMatcher(needle, Qt::CaseInsensitive).indexIn(s1), expected);
+                }
+            }
+        }
+    }
+}
+
 void tst_QString::resizeAfterFromRawData()
 {
     QString buffer("hello world");
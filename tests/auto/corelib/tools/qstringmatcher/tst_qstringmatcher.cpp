@@ -46,6 +46,7 @@ private slots:
     void setCaseSensitivity_data();
     void setCaseSensitivity();
     void assignOperator();
+    void indexInAllPositions();
 };
 
 void tst_QStringMatcher::qstringmatcher()
@@ -109,6 +110,13 @@ void tst_QStringMatcher::setCaseSensitivity_data()
     QTest::newRow("overshot") << QString("foo") << QString("baFooz foo bar") << 14 << -1 << (int) Qt::CaseSensitive;
     QTest::newRow("sensitive") << QString("foo") << QString("baFooz foo bar") << 1 << 7 << (int) Qt::CaseSensitive;
     QTest::newRow("insensitive") << QString("foo") << QString("baFooz foo bar") << 1 << 2 << (int) Qt::CaseInsensitive;
+
+    const QString lorem = QString("lorem ipsum dolor sit amet, ").repeated(3) + QString("Qt rocks");
+    QTest::newRow("insensitive-long") << QString("QT ROCKS") << lorem << 0 << 84 << (int) Qt::CaseInsensitive;
+    QTest::newRow("insensitive-long-from") << QString("DOLOR") << lorem << 13 << 40 << (int) Qt::CaseInsensitive;
+    QTest::newRow("insensitive-long-overshot") << QString("qt rocks") << lorem << 85 << -1 << (int) Qt::CaseInsensitive;
+    const QString kelvin = QString(20, '.') + QString("300") + QChar(0x212a) + QString(20, '.');
+    QTest::newRow("insensitive-kelvin") << QString("300k") << kelvin << 0 << 20 << (int) Qt::CaseInsensitive;
 }
 
 void tst_QStringMatcher::setCaseSensitivity()
@@ -138,6 +146,43 @@ void tst_QStringMatcher::assignOperator()
     QCOMPARE(m2.indexIn(hayStack), 3);
 }
 
+void tst_QStringMatcher::indexInAllPositions()
+{
+    // Put the needle at every offset around the block boundaries of the
+    // vectorised search, with near misses (first and last character
+    // matching) in front of it.
+    for (int needleSize = 1; needleSize <= 24; ++needleSize) {
+        QString needle;
+        for (int i = 0; i < needleSize; ++i)
+            needle += QChar(i % 3 ? ushort('a' + i) : ushort(0x430 + i));
+        QString nearMiss = needle;
+        if (needleSize > 2)
+            nearMiss[needleSize / 2] = QLatin1Char('X');
+
+        QStringMatcher m(needle);
+        for (int haystackSize = needleSize; haystackSize <= needleSize + 40; ++haystackSize) {
+            for (int pos = 0; pos + needleSize <= haystackSize; pos += 3) {
+                QString haystack(haystackSize, QLatin1Char('.'));
+                if (pos >= needleSize)
+                    haystack.replace(0, needleSize, nearMiss);
+                haystack.replace(pos, needleSize, needle);
+
+                for (int from = 0; from <= pos + 1; from += 5) {
+                    int expected = -1;
+                    for (int i = from; i + needleSize <= haystackSize; ++i) {
+                        if (haystack.midRef(i, needleSize) == needle) {
+                            expected = i;
+                            break;
+                        }
+                    }
+                    QCOMPARE(m.indexIn(haystack, from), expected);
+                    QCOMPARE(haystack.indexOf(needle, from), expected);
+                }
+            }
+        }
+    }
+}
+
 QTEST_MAIN(tst_QStringMatcher)
 #include "tst_qstringmatcher.moc"
 
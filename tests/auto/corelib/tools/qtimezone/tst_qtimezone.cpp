@@ -50,6 +50,7 @@ private slots:
     void dataStreamTest();
     void isTimeZoneIdAvailable();
     void availableTimeZoneIds();
+    void offsetsFromUtc();
     void stressTest();
     void windowsId();
     void isValidId_data();
@@ -393,6 +394,41 @@ void tst_QTimeZone::availableTimeZoneIds()
     }
 }
 
+void tst_QTimeZone::offsetsFromUtc()
+{
+    // The batch conversion must agree with converting each time individually,
+    // including times before the first and after the last known transition
+    QVector<qint64> msecs;
+    const qint64 day = 24 * 60 * 60 * 1000;
+    const qint64 start = QDateTime(QDate(1850, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    const qint64 end = QDateTime(QDate(2100, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    for (qint64 ms = start; ms < end; ms += 7 * day + 3600 * 1000)
+        msecs.append(ms);
+    // some unordered and repeated times
+    for (int i = 0; i < 200; ++i)
+        msecs.append(msecs.at((i * 7919) % msecs.size()));
+
+    const QList<QByteArray> ids = QList<QByteArray>() << "UTC" << "Europe/Berlin"
+                                                      << "America/New_York" << "Australia/Sydney"
+                                                      << "Asia/Kolkata";
+    foreach (const QByteArray &id, ids) {
+        const QTimeZone tz(id);
+        if (!tz.isValid())
+            continue;
+        const QVector<int> offsets = tz.offsetsFromUtc(msecs);
+        QCOMPARE(offsets.size(), msecs.size());
+        for (int i = 0; i < msecs.size(); ++i) {
+            const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs.at(i), Qt::UTC);
+            if (offsets.at(i) != tz.offsetFromUtc(dt))
+                QFAIL(qPrintable(QString::fromLatin1("%1: mismatch at %2").arg(QString::fromLatin1(id),
+                                                                             dt.toString(Qt::ISODate))));
+        }
+    }
+
+    QCOMPARE(QTimeZone().offsetsFromUtc(msecs), QVector<int>(msecs.size(), 0));
+    QVERIFY(QTimeZone("Europe/Berlin").offsetsFromUtc(QVector<qint64>()).isEmpty());
+}
+
 void tst_QTimeZone::stressTest()
 {
     QList<QByteArray> idList = QTimeZone::availableTimeZoneIds();
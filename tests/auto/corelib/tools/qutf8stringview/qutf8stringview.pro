@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qutf8stringview
+QT = core testlib
+SOURCES = tst_qutf8stringview.cpp
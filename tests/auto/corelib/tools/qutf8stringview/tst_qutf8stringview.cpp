@@ -0,0 +1,415 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qutf8stringview.h>
+
+Q_DECLARE_METATYPE(Qt::CaseSensitivity)
+Q_DECLARE_METATYPE(QString::SplitBehavior)
+
+class tst_QUtf8StringView : public QObject
+{
+    Q_OBJECT
+private slots:
+    void construction();
+    void leftRightMid();
+    void trimmed();
+    void isValidUtf8_data();
+    void isValidUtf8();
+    void compare_data();
+    void compare();
+    void startsWithEndsWith_data();
+    void startsWithEndsWith();
+    void indexOf_data();
+    void indexOf();
+    void lastIndexOf();
+    void caseInsensitiveMatching();
+    void split_data();
+    void split();
+    void numbers();
+    void hash();
+};
+
+static inline int sign(int x)
+{
+    return x < 0 ? -1 : x > 0 ? 1 : 0;
+}
+
+void tst_QUtf8StringView::construction()
+{
+    QUtf8StringView null;
+    QVERIFY(null.isNull());
+    QVERIFY(null.isEmpty());
+    QCOMPARE(null.size(), 0);
+
+    QUtf8StringView empty("");
+    QVERIFY(!empty.isNull());
+    QVERIFY(empty.isEmpty());
+
+    const QByteArray ba("gr\xc3\xbc\xc3\x9f" "e");
+    QUtf8StringView view(ba);
+    QCOMPARE(view.data(), ba.constData());
+    QCOMPARE(view.size(), 7);
+    QCOMPARE(view.at(0), 'g');
+    QCOMPARE(view[6], 'e');
+    QCOMPARE(int(view.end() - view.begin()), 7);
+    QCOMPARE(view.toByteArray(), ba);
+    QCOMPARE(view.toString(), QString::fromUtf8(ba));
+    QVERIFY(view == ba);
+    QVERIFY(view == "gr\xc3\xbc\xc3\x9f" "e");
+    QVERIFY(view == QString::fromUtf8(ba));
+    QVERIFY(view == QLatin1String("gr\xfc\xdf" "e"));
+    QVERIFY(view != QLatin1String(ba));
+}
+
+void tst_QUtf8StringView::leftRightMid()
+{
+    QUtf8StringView view("abcdef");
+    QCOMPARE(view.left(2), QUtf8StringView("ab"));
+    QCOMPARE(view.left(-1), view);
+    QCOMPARE(view.left(10), view);
+    QCOMPARE(view.right(2), QUtf8StringView("ef"));
+    QCOMPARE(view.right(-1), view);
+    QCOMPARE(view.mid(2), QUtf8StringView("cdef"));
+    QCOMPARE(view.mid(2, 3), QUtf8StringView("cde"));
+    QCOMPARE(view.mid(4, 10), QUtf8StringView("ef"));
+    QVERIFY(view.mid(6).isEmpty());
+    QVERIFY(!view.mid(6).isNull());
+    QVERIFY(view.mid(7).isNull());
+}
+
+void tst_QUtf8StringView::trimmed()
+{
+    QCOMPARE(QUtf8StringView(" \t abc \n").trimmed(), QUtf8StringView("abc"));
+    QCOMPARE(QUtf8StringView("a b").trimmed(), QUtf8StringView("a b"));
+    QVERIFY(QUtf8StringView("  ").trimmed().isEmpty());
+}
+
+void tst_QUtf8StringView::isValidUtf8_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("empty") << QByteArray() << true;
+    QTest::newRow("ascii") << QByteArray("hello") << true;
+    QTest::newRow("two-byte") << QByteArray("\xc3\xa9") << true;
+    QTest::newRow("three-byte") << QByteArray("\xe2\x82\xac") << true;
+    QTest::newRow("four-byte") << QByteArray("\xf0\x9f\x98\x80") << true;
+    QTest::newRow("truncated") << QByteArray("\xe2\x82") << false;
+    QTest::newRow("stray-continuation") << QByteArray("a\x80") << false;
+    QTest::newRow("overlong") << QByteArray("\xc0\xaf") << false;
+    QTest::newRow("surrogate") << QByteArray("\xed\xa0\x80") << false;
+    QTest::newRow("too-large") << QByteArray("\xf4\x90\x80\x80") << false;
+}
+
+void tst_QUtf8StringView::isValidUtf8()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, valid);
+    QCOMPARE(QUtf8StringView(data).isValidUtf8(), valid);
+}
+
+void tst_QUtf8StringView::compare_data()
+{
+    QTest::addColumn<QByteArray>("s1");
+    QTest::addColumn<QByteArray>("s2");
+    QTest::addColumn<int>("csr"); // case-sensitive result
+    QTest::addColumn<int>("cir"); // case-insensitive result
+
+    QTest::newRow("null") << QByteArray() << QByteArray() << 0 << 0;
+    QTest::newRow("null-empty") << QByteArray() << QByteArray("") << 0 << 0;
+    QTest::newRow("prefix") << QByteArray("abc") << QByteArray("abcd") << -1 << -1;
+    QTest::newRow("ascii-case") << QByteArray("abc") << QByteArray("ABC") << 1 << 0;
+    QTest::newRow("ascii-less") << QByteArray("abc") << QByteArray("ABD") << 1 << -1;
+    QTest::newRow("latin1-case") << QByteArray("\xc3\xa9t\xc3\xa9") << QByteArray("\xc3\x89T\xc3\x89") << 1 << 0;
+    QTest::newRow("greek-case") << QByteArray("\xce\xb1\xce\xb2") << QByteArray("\xce\x91\xce\x92") << 1 << 0;
+    QTest::newRow("kelvin") << QByteArray("\xe2\x84\xaa") << QByteArray("k") << 1 << 0;
+    QTest::newRow("long-s") << QByteArray("\xc5\xbf") << QByteArray("S") << 1 << 0;
+    QTest::newRow("length-differs") << QByteArray("\xe2\x84\xaa" "a") << QByteArray("kA") << 1 << 0;
+    QTest::newRow("non-bmp") << QByteArray("\xf0\x9f\x98\x80") << QByteArray("\xf0\x9f\x98\x81") << -1 << -1;
+    QTest::newRow("non-bmp-vs-bmp") << QByteArray("\xf0\x9f\x98\x80") << QByteArray("\xef\xbf\xbd") << 1 << 1;
+}
+
+void tst_QUtf8StringView::compare()
+{
+    QFETCH(QByteArray, s1);
+    QFETCH(QByteArray, s2);
+    QFETCH(int, csr);
+    QFETCH(int, cir);
+
+    const QUtf8StringView v1(s1);
+    const QUtf8StringView v2(s2);
+    QCOMPARE(sign(v1.compare(v2)), csr);
+    QCOMPARE(sign(v2.compare(v1)), -csr);
+    QCOMPARE(sign(v1.compare(v2, Qt::CaseInsensitive)), cir);
+    QCOMPARE(sign(v2.compare(v1, Qt::CaseInsensitive)), -cir);
+    QCOMPARE(v1 == v2, csr == 0);
+    QCOMPARE(v1 < v2, csr < 0);
+    QCOMPARE(v1 >= v2, csr >= 0);
+
+    const QString str2 = QString::fromUtf8(s2);
+    QCOMPARE(sign(v1.compare(str2)), csr);
+    QCOMPARE(sign(v1.compare(str2, Qt::CaseInsensitive)), cir);
+    QCOMPARE(v1 == str2, csr == 0);
+
+    bool isLatin1 = true;
+    for (int i = 0; i < str2.size(); ++i)
+        isLatin1 = isLatin1 && str2.at(i).unicode() < 0x100;
+    if (isLatin1) {
+        const QByteArray latin1 = str2.toLatin1();
+        QCOMPARE(sign(v1.compare(QLatin1String(latin1))), csr);
+        QCOMPARE(sign(v1.compare(QLatin1String(latin1), Qt::CaseInsensitive)), cir);
+    }
+}
+
+void tst_QUtf8StringView::startsWithEndsWith_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+    QTest::addColumn<bool>("startsWith");
+    QTest::addColumn<bool>("endsWith");
+
+    QTest::newRow("empty") << QByteArray("abc") << QByteArray() << Qt::CaseSensitive << true << true;
+    QTest::newRow("whole") << QByteArray("abc") << QByteArray("abc") << Qt::CaseSensitive << true << true;
+    QTest::newRow("longer") << QByteArray("abc") << QByteArray("abcd") << Qt::CaseSensitive << false << false;
+    QTest::newRow("start") << QByteArray("abcd") << QByteArray("ab") << Qt::CaseSensitive << true << false;
+    QTest::newRow("end") << QByteArray("abcd") << QByteArray("cd") << Qt::CaseSensitive << false << true;
+    QTest::newRow("case") << QByteArray("abcd") << QByteArray("CD") << Qt::CaseSensitive << false << false;
+    QTest::newRow("ci-start") << QByteArray("abcd") << QByteArray("AB") << Qt::CaseInsensitive << true << false;
+    QTest::newRow("ci-end") << QByteArray("abcd") << QByteArray("CD") << Qt::CaseInsensitive << false << true;
+    QTest::newRow("ci-utf8") << QByteArray("\xc3\xa9t\xc3\xa9") << QByteArray("\xc3\x89")
+                             << Qt::CaseInsensitive << true << true;
+    QTest::newRow("ci-kelvin") << QByteArray("\xe2\x84\xaa" "elvin") << QByteArray("k")
+                               << Qt::CaseInsensitive << true << false;
+    QTest::newRow("ci-kelvin-end") << QByteArray("100 \xe2\x84\xaa") << QByteArray(" K")
+                                   << Qt::CaseInsensitive << false << true;
+}
+
+void tst_QUtf8StringView::startsWithEndsWith()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+    QFETCH(bool, startsWith);
+    QFETCH(bool, endsWith);
+
+    const QUtf8StringView view(haystack);
+    QCOMPARE(view.startsWith(QUtf8StringView(needle), cs), startsWith);
+    QCOMPARE(view.endsWith(QUtf8StringView(needle), cs), endsWith);
+    QCOMPARE(view.startsWith('a'), haystack.startsWith('a'));
+    QCOMPARE(view.endsWith('d'), haystack.endsWith('d'));
+}
+
+void tst_QUtf8StringView::indexOf_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+    QTest::addColumn<int>("from");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+    QTest::addColumn<int>("index");
+
+    const QByteArray text("Gr\xc3\xbc\xc3\x9f" "e aus K\xc3\xb6ln, gr\xc3\x9c\xc3\x9f" "e aus k\xc3\x96ln");
+    QTest::newRow("empty") << text << QByteArray() << 3 << Qt::CaseSensitive << 3;
+    QTest::newRow("empty-end") << text << QByteArray() << text.size() << Qt::CaseSensitive << text.size();
+    QTest::newRow("empty-past-end") << text << QByteArray() << text.size() + 1 << Qt::CaseSensitive << -1;
+    QTest::newRow("char") << text << QByteArray("e") << 0 << Qt::CaseSensitive << 6;
+    QTest::newRow("utf8") << text << QByteArray("K\xc3\xb6ln") << 0 << Qt::CaseSensitive << 12;
+    QTest::newRow("utf8-from") << text << QByteArray("K\xc3\xb6ln") << 13 << Qt::CaseSensitive << -1;
+    QTest::newRow("negative-from") << text << QByteArray("aus") << -10 << Qt::CaseSensitive << 27;
+    QTest::newRow("ci") << text << QByteArray("GR\xc3\x9c\xc3\x9f") << 1 << Qt::CaseInsensitive << 19;
+    QTest::newRow("ci-first") << text << QByteArray("gr\xc3\xbc\xc3\x9f") << 0 << Qt::CaseInsensitive << 0;
+    QTest::newRow("ci-utf8-first") << text << QByteArray("\xc3\x9c") << 0 << Qt::CaseInsensitive << 2;
+    QTest::newRow("ci-kelvin") << text << QByteArray("\xe2\x84\xaa\xc3\xb6ln") << 0 << Qt::CaseInsensitive << 12;
+    QTest::newRow("ci-not-found") << text << QByteArray("bonn") << 0 << Qt::CaseInsensitive << -1;
+    QTest::newRow("kelvin-in-haystack") << QByteArray("10 \xe2\x84\xaa") << QByteArray("k") << 0
+                                        << Qt::CaseInsensitive << 3;
+}
+
+void tst_QUtf8StringView::indexOf()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+    QFETCH(int, from);
+    QFETCH(Qt::CaseSensitivity, cs);
+    QFETCH(int, index);
+
+    const QUtf8StringView view(haystack);
+    QCOMPARE(view.indexOf(QUtf8StringView(needle), from, cs), index);
+    QCOMPARE(view.contains(QUtf8StringView(needle), cs), view.indexOf(QUtf8StringView(needle), 0, cs) != -1);
+    if (cs == Qt::CaseSensitive && !needle.isEmpty()) {
+        QCOMPARE(view.indexOf(QUtf8StringView(needle), from), haystack.indexOf(needle, from));
+        if (needle.size() == 1)
+            QCOMPARE(view.indexOf(needle.at(0), from), index);
+    }
+}
+
+void tst_QUtf8StringView::lastIndexOf()
+{
+    const QByteArray text("abcabcabc");
+    const QUtf8StringView view(text);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("abc")), 6);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("abc"), 5), 3);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("abc"), -4), 3);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("abc"), 0), 0);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("abd")), -1);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("abcabcabcabc")), -1);
+    QCOMPARE(view.lastIndexOf(QUtf8StringView("")), 8);
+    QCOMPARE(view.lastIndexOf('b'), 7);
+    QCOMPARE(view.lastIndexOf('b', 6), 4);
+    QCOMPARE(view.lastIndexOf('b', 100), 7);
+    QCOMPARE(view.lastIndexOf('x'), -1);
+}
+
+void tst_QUtf8StringView::caseInsensitiveMatching()
+{
+    // Compare against QString for random strings over an alphabet that
+    // includes characters which fold to ASCII.
+    static const ushort alphabet[] = {
+        'a', 'A', 'k', 'K', 's', 'S', 0xe9, 0xc9, 0x3b1, 0x391, 0x212a, 0x17f
+    };
+    const int alphabetSize = int(sizeof alphabet / sizeof alphabet[0]);
+    uint seed = 1;
+    for (int round = 0; round < 2000; ++round) {
+        QString haystack;
+        QString needle;
+        const int haystackSize = int((seed = seed * 1103515245 + 12345) >> 16) % 24;
+        for (int i = 0; i < haystackSize; ++i)
+            haystack += QChar(alphabet[((seed = seed * 1103515245 + 12345) >> 16) % alphabetSize]);
+        const int needleSize = 1 + int((seed = seed * 1103515245 + 12345) >> 16) % 3;
+        for (int i = 0; i < needleSize; ++i)
+            needle += QChar(alphabet[((seed = seed * 1103515245 + 12345) >> 16) % alphabetSize]);
+
+        const QByteArray haystack8 = haystack.toUtf8();
+        const QByteArray needle8 = needle.toUtf8();
+        const QUtf8StringView view(haystack8);
+        const QUtf8StringView needleView(needle8);
+
+        const int index = haystack.indexOf(needle, 0, Qt::CaseInsensitive);
+        const int expected = index == -1 ? -1 : haystack.left(index).toUtf8().size();
+        QCOMPARE(view.indexOf(needleView, 0, Qt::CaseInsensitive), expected);
+        QCOMPARE(view.startsWith(needleView, Qt::CaseInsensitive),
+                 haystack.startsWith(needle, Qt::CaseInsensitive));
+        QCOMPARE(view.endsWith(needleView, Qt::CaseInsensitive),
+                 haystack.endsWith(needle, Qt::CaseInsensitive));
+        QCOMPARE(sign(view.compare(needleView, Qt::CaseInsensitive)),
+                 sign(haystack.compare(needle, Qt::CaseInsensitive)));
+    }
+}
+
+void tst_QUtf8StringView::split_data()
+{
+    QTest::addColumn<QByteArray>("text");
+    QTest::addColumn<QByteArray>("sep");
+    QTest::addColumn<QString::SplitBehavior>("behavior");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    QTest::newRow("char") << QByteArray("a,b,,c,") << QByteArray(",") << QString::KeepEmptyParts << Qt::CaseSensitive;
+    QTest::newRow("char-skip") << QByteArray(",a,b,,c,") << QByteArray(",") << QString::SkipEmptyParts << Qt::CaseSensitive;
+    QTest::newRow("empty-text") << QByteArray() << QByteArray(",") << QString::KeepEmptyParts << Qt::CaseSensitive;
+    QTest::newRow("string") << QByteArray("a::b::::c") << QByteArray("::") << QString::KeepEmptyParts << Qt::CaseSensitive;
+    QTest::newRow("utf8") << QByteArray("\xc3\xa9\xe2\x82\xac\xc3\xa9\xe2\x82\xac") << QByteArray("\xe2\x82\xac")
+                          << QString::KeepEmptyParts << Qt::CaseSensitive;
+    QTest::newRow("empty-sep") << QByteArray("abc") << QByteArray() << QString::KeepEmptyParts << Qt::CaseSensitive;
+    QTest::newRow("ci") << QByteArray("aXbxc") << QByteArray("x") << QString::KeepEmptyParts << Qt::CaseInsensitive;
+    QTest::newRow("ci-kelvin") << QByteArray("a\xe2\x84\xaa" "bkc") << QByteArray("K")
+                               << QString::KeepEmptyParts << Qt::CaseInsensitive;
+}
+
+void tst_QUtf8StringView::split()
+{
+    QFETCH(QByteArray, text);
+    QFETCH(QByteArray, sep);
+    QFETCH(QString::SplitBehavior, behavior);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QStringList expected = QString::fromUtf8(text).split(QString::fromUtf8(sep), behavior, cs);
+    const QVector<QUtf8StringView> parts = QUtf8StringView(text).split(QUtf8StringView(sep), behavior, cs);
+    QCOMPARE(parts.size(), expected.size());
+    for (int i = 0; i < parts.size(); ++i)
+        QCOMPARE(parts.at(i).toString(), expected.at(i));
+
+    if (sep.size() == 1 && cs == Qt::CaseSensitive) {
+        const QVector<QUtf8StringView> charParts = QUtf8StringView(text).split(sep.at(0), behavior);
+        QCOMPARE(charParts, parts);
+    }
+}
+
+void tst_QUtf8StringView::numbers()
+{
+    const QByteArray data("1234 -56 0x1f 3.5 99999 abc");
+    const QVector<QUtf8StringView> fields = QUtf8StringView(data).split(' ');
+    QCOMPARE(fields.size(), 6);
+
+    bool ok;
+    QCOMPARE(fields.at(0).toInt(&ok), 1234);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(1).toLongLong(&ok), Q_INT64_C(-56));
+    QVERIFY(ok);
+    QCOMPARE(fields.at(1).toUInt(&ok), 0u);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(2).toInt(&ok, 0), 31);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(2).toInt(&ok, 16), 31);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(3).toDouble(&ok), 3.5);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(3).toFloat(&ok), 3.5f);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(4).toShort(&ok), short(0));
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(4).toULong(&ok), 99999ul);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(5).toInt(&ok), 0);
+    QVERIFY(!ok);
+
+    // the parts are not '\0'-terminated; make sure nothing reads past them
+    QCOMPARE(QUtf8StringView(data).left(2).toInt(), 12);
+    QCOMPARE(QUtf8StringView(data).mid(5, 2).toInt(), -5);
+
+    const QByteArray longNumber = QByteArray(100, '0') + "42";
+    QCOMPARE(QUtf8StringView(longNumber).toInt(&ok), 42);
+    QVERIFY(ok);
+}
+
+void tst_QUtf8StringView::hash()
+{
+    const QByteArray data("gr\xc3\xbc\xc3\x9f" "e");
+    QCOMPARE(qHash(QUtf8StringView(data)), qHash(data));
+    QCOMPARE(qHash(QUtf8StringView(data), 42), qHash(data, 42));
+    QCOMPARE(qHash(QUtf8StringView(data).left(2)), qHash(QByteArray("gr")));
+}
+
+QTEST_APPLESS_MAIN(tst_QUtf8StringView)
+#include "tst_qutf8stringview.moc"
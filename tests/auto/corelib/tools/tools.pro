@@ -5,6 +5,7 @@ SUBDIRS=\
     qarraydata \
     qarraydata_strictiterators \
     qbitarray \
+    qbtreemap \
     qbytearray \
     qbytearraylist \
     qbytearraymatcher \
@@ -20,6 +21,7 @@ SUBDIRS=\
     qeasingcurve \
     qelapsedtimer \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -59,6 +61,7 @@ SUBDIRS=\
     qtime \
     qtimezone \
     qtimeline \
+    qutf8stringview \
     qvarlengtharray \
     qvector \
     qvector_strictiterators \
@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTextCodec>
+#include <QUtf8StringView>
+#include <qtest.h>
+
+class tst_Utf8 : public QObject
+{
+    Q_OBJECT
+private slots:
+    void fromUtf8_data();
+    void fromUtf8();
+    void toUnicode_data() { fromUtf8_data(); }
+    void toUnicode();
+    void isValidUtf8_data() { fromUtf8_data(); }
+    void isValidUtf8();
+};
+
+static QByteArray repeated(const char *text)
+{
+    QByteArray result;
+    while (result.size() < 64 * 1024)
+        result += text;
+    return result;
+}
+
+void tst_Utf8::fromUtf8_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("ascii") << repeated("The quick brown fox jumps over the lazy dog. ");
+    QTest::newRow("latin") << repeated("Fran\xc3\xa7" "ais, \xc3\xa9t\xc3\xa9 \xc3\xa0 l'h\xc3\xb4tel, "
+                                       "M\xc3\xbcller stra\xc3\x9f" "e. ");
+    QTest::newRow("cyrillic") << repeated("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82, "
+                                          "\xd0\xbc\xd0\xb8\xd1\x80! "
+                                          "\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5. ");
+    QTest::newRow("cjk") << repeated("\xe4\xbd\xa0\xe5\xa5\xbd\xef\xbc\x8c\xe4\xb8\x96\xe7\x95\x8c\xe3\x80\x82"
+                                     "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe3\x83\x86"
+                                     "\xe3\x82\xad\xe3\x82\xb9\xe3\x83\x88\xe3\x80\x82");
+    QTest::newRow("mixed") << repeated("<p class=\"note\">\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 "
+                                       "\xe4\xbd\xa0\xe5\xa5\xbd caf\xc3\xa9 42</p>\n");
+    QTest::newRow("emoji") << repeated("ok \xf0\x9f\x98\x80 \xf0\x9f\x91\x8d fine ");
+}
+
+void tst_Utf8::fromUtf8()
+{
+    QFETCH(QByteArray, data);
+
+    QBENCHMARK {
+        QString s = QString::fromUtf8(data);
+        Q_UNUSED(s);
+    }
+}
+
+void tst_Utf8::toUnicode()
+{
+    QFETCH(QByteArray, data);
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+
+    QBENCHMARK {
+        QTextDecoder decoder(codec);
+        QString s = decoder.toUnicode(data);
+        Q_UNUSED(s);
+    }
+}
+
+void tst_Utf8::isValidUtf8()
+{
+    QFETCH(QByteArray, data);
+    const QUtf8StringView view(data);
+
+    QBENCHMARK {
+        QVERIFY(view.isValidUtf8());
+    }
+}
+
+QTEST_MAIN(tst_Utf8)
+
+#include "main.moc"
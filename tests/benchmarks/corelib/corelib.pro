@@ -1,5 +1,6 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        global \
         io \
         json \
         mimetypes \
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QLoggingCategory>
+#include <QTemporaryFile>
+#include <QThread>
+#include <qtest.h>
+#include <private/qlogging_p.h>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(lcBench, "bench.logging")
+
+class tst_qlogging : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void throughput_data();
+    void throughput();
+
+private:
+    QTemporaryFile m_output;
+    int m_stderr;
+};
+
+class LoggingThread : public QThread
+{
+public:
+    explicit LoggingThread(int messages) : messages(messages) {}
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < messages; ++i)
+            qCDebug(lcBench) << "processed work item" << i << "of" << messages;
+    }
+private:
+    int messages;
+};
+
+void tst_qlogging::initTestCase()
+{
+#ifdef Q_OS_UNIX
+    // log to a file, like a service with redirected output does
+    QVERIFY(m_output.open());
+    m_stderr = ::dup(STDERR_FILENO);
+    QVERIFY(m_stderr != -1);
+#else
+    QSKIP("This benchmark redirects stderr, which is only implemented for Unix");
+#endif
+}
+
+void tst_qlogging::cleanupTestCase()
+{
+#ifdef Q_OS_UNIX
+    ::close(m_stderr);
+#endif
+}
+
+void tst_qlogging::throughput_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("async");
+
+    const int threadCounts[] = { 1, 32 };
+    for (int i = 0; i < int(sizeof(threadCounts) / sizeof(threadCounts[0])); ++i) {
+        const QByteArray threads = QByteArray::number(threadCounts[i]) + "-threads";
+        QTest::newRow(threads + "-sync") << threadCounts[i] << false;
+        QTest::newRow(threads + "-async") << threadCounts[i] << true;
+    }
+}
+
+// many threads logging with a category, including the time until all
+// messages are written
+void tst_qlogging::throughput()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(int, threadCount);
+    QFETCH(bool, async);
+    const int messagesPerThread = 1000;
+
+    qt_set_async_logging(async);
+    fflush(stderr);
+    QVERIFY(::dup2(m_output.handle(), STDERR_FILENO) != -1);
+
+    QBENCHMARK {
+        QVector<LoggingThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads << new LoggingThread(messagesPerThread);
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->start();
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->wait();
+        qDeleteAll(threads);
+        qt_flush_async_logging();
+    }
+
+    qt_set_async_logging(false);
+    fflush(stderr);
+    ::dup2(m_stderr, STDERR_FILENO);
+    m_output.resize(0);
+
+    // messages that did not fit into the buffers are not written at all
+    const quint64 dropped = qt_async_logging_dropped_messages();
+    if (dropped)
+        qDebug("%llu messages dropped so far", dropped);
+#endif
+}
+
+QTEST_MAIN(tst_qlogging)
+
+#include "main.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_bench_qlogging
+QT = core-private testlib
+CONFIG += release
+SOURCES += main.cpp
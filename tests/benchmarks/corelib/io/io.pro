@@ -1,11 +1,16 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qdatastream \
         qdir \
         qdiriterator \
         qfile \
         qfileinfo \
+        qfilesystemwatcher \
         qiodevice \
+        qloggingcategory \
         qprocess \
+        qresource \
+        qsettings \
         qtemporaryfile \
         qtextstream
 
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QDataStream>
+#include <QList>
+#include <QPointF>
+#include <QVector>
+#include <qtest.h>
+
+class tst_qdatastream : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void writeVector_data();
+    void writeVector();
+    void readVector_data();
+    void readVector();
+
+private:
+    template <typename Container> void write(const Container &values);
+    template <typename Container> void read(const Container &values);
+
+    QVector<double> m_doubles;
+    QVector<qint32> m_ints;
+    QVector<QPointF> m_points;
+    QList<qint32> m_intList;
+};
+
+void tst_qdatastream::initTestCase()
+{
+    for (int i = 0; i < 1000000; ++i) {
+        m_doubles << i / 3.0;
+        m_ints << i * 7;
+        m_intList << i * 7;
+        if (i < 500000)
+            m_points << QPointF(i, i / 3.0);
+    }
+}
+
+static void addRows()
+{
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<int>("byteOrder");
+
+    const char *const types[] = { "QVector<double>", "QVector<qint32>", "QVector<QPointF>", "QList<qint32>" };
+    for (int i = 0; i < 4; ++i) {
+        QTest::newRow(QByteArray(types[i]) + ", big endian")
+                << QString::fromLatin1(types[i]) << int(QDataStream::BigEndian);
+        QTest::newRow(QByteArray(types[i]) + ", little endian")
+                << QString::fromLatin1(types[i]) << int(QDataStream::LittleEndian);
+    }
+}
+
+template <typename Container>
+void tst_qdatastream::write(const Container &values)
+{
+    QFETCH(int, byteOrder);
+    QByteArray data;
+    data.reserve(16 * 1024 * 1024);
+
+    QBENCHMARK {
+        data.resize(0);
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::ByteOrder(byteOrder));
+        stream << values;
+    }
+}
+
+template <typename Container>
+void tst_qdatastream::read(const Container &values)
+{
+    QFETCH(int, byteOrder);
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::ByteOrder(byteOrder));
+        stream << values;
+    }
+
+    Container result;
+    QBENCHMARK {
+        QDataStream stream(data);
+        stream.setByteOrder(QDataStream::ByteOrder(byteOrder));
+        stream >> result;
+    }
+    QCOMPARE(result, values);
+}
+
+void tst_qdatastream::writeVector_data()
+{
+    addRows();
+}
+
+// sending large arrays of numbers over IPC channels
+void tst_qdatastream::writeVector()
+{
+    QFETCH(QString, type);
+    if (type == QLatin1String("QVector<double>"))
+        write(m_doubles);
+    else if (type == QLatin1String("QVector<qint32>"))
+        write(m_ints);
+    else if (type == QLatin1String("QVector<QPointF>"))
+        write(m_points);
+    else
+        write(m_intList);
+}
+
+void tst_qdatastream::readVector_data()
+{
+    addRows();
+}
+
+void tst_qdatastream::readVector()
+{
+    QFETCH(QString, type);
+    if (type == QLatin1String("QVector<double>"))
+        read(m_doubles);
+    else if (type == QLatin1String("QVector<qint32>"))
+        read(m_ints);
+    else if (type == QLatin1String("QVector<QPointF>"))
+        read(m_points);
+    else
+        read(m_intList);
+}
+
+QTEST_MAIN(tst_qdatastream)
+
+#include "main.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_bench_qdatastream
+QT = core testlib
+CONFIG += release
+SOURCES += main.cpp
@@ -56,6 +56,8 @@ private slots:
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriteratorParallel();
+    void diriteratorParallel_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
     void data();
@@ -212,6 +214,28 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::diriteratorParallel()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        int c = 0;
+
+        QDirIterator dir(dirpath,
+            QDir::Files,
+            QDirIterator::Subdirectories | QDirIterator::Parallel);
+
+        while (dir.hasNext()) {
+            dir.next();
+            ++c;
+        }
+        count = c;
+    }
+    qDebug() << count;
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <qtest.h>
+
+class tst_qfilesystemwatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void addPaths_data();
+    void addPaths();
+    void addRecursivePath_data();
+    void addRecursivePath();
+    void burst_data();
+    void burst();
+};
+
+static void createFiles(const QString &directory, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        QFile f(directory + QString::fromLatin1("/file%1").arg(i));
+        if (f.open(QIODevice::WriteOnly))
+            f.close();
+    }
+}
+
+void tst_qfilesystemwatcher::addPaths_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("5000") << 5000;
+}
+
+void tst_qfilesystemwatcher::addPaths()
+{
+    QFETCH(int, count);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    createFiles(dir.path(), count);
+    QStringList paths;
+    for (int i = 0; i < count; ++i)
+        paths << dir.path() + QString::fromLatin1("/file%1").arg(i);
+
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPaths(paths).isEmpty());
+    }
+}
+
+void tst_qfilesystemwatcher::addRecursivePath_data()
+{
+    QTest::addColumn<int>("breadth");
+    // breadth^3 directories below the root
+    QTest::newRow("1000") << 10;
+    QTest::newRow("4096") << 16;
+}
+
+void tst_qfilesystemwatcher::addRecursivePath()
+{
+    QFETCH(int, breadth);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir root(dir.path());
+    for (int i = 0; i < breadth; ++i) {
+        for (int j = 0; j < breadth; ++j) {
+            for (int k = 0; k < breadth; ++k)
+                QVERIFY(root.mkpath(QString::fromLatin1("%1/%2/%3").arg(i).arg(j).arg(k)));
+        }
+    }
+
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addRecursivePath(dir.path()));
+    }
+}
+
+void tst_qfilesystemwatcher::burst_data()
+{
+    QTest::addColumn<int>("interval");
+    QTest::newRow("immediate") << 0;
+    QTest::newRow("coalesced") << 50;
+}
+
+// Files written across a watched tree, as a build would, with the event
+// loop keeping up; the time includes delivering every signal, and the
+// number of signals is printed.
+void tst_qfilesystemwatcher::burst()
+{
+    QFETCH(int, interval);
+    const int directoryCount = 20;
+    const int fileCount = 50;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir root(dir.path());
+    for (int i = 0; i < directoryCount; ++i)
+        QVERIFY(root.mkdir(QString::number(i)));
+
+    QFileSystemWatcher watcher;
+    watcher.setCoalescingInterval(interval);
+    QVERIFY(watcher.addRecursivePath(dir.path()));
+    QSignalSpy spy(&watcher, &QFileSystemWatcher::directoryChanged);
+
+    int round = 0;
+    QBENCHMARK {
+        spy.clear();
+        for (int j = 0; j < fileCount; ++j) {
+            for (int i = 0; i < directoryCount; ++i) {
+                QFile f(root.filePath(QString::fromLatin1("%1/%2-%3").arg(i).arg(round).arg(j)));
+                QVERIFY(f.open(QIODevice::WriteOnly));
+                f.close();
+            }
+            QCoreApplication::processEvents();
+        }
+        ++round;
+        QTest::qWait(interval + 10);
+    }
+    qDebug("%d directoryChanged signals", spy.count());
+}
+
+QTEST_MAIN(tst_qfilesystemwatcher)
+
+#include "main.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_bench_qfilesystemwatcher
+QT = core testlib
+CONFIG += release
+SOURCES += main.cpp
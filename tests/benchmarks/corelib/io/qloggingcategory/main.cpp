@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QLoggingCategory>
+#include <qtest.h>
+
+Q_LOGGING_CATEGORY(lcDisabled, "bench.disabled")
+
+class tst_qloggingcategory : public QObject
+{
+    Q_OBJECT
+private slots:
+    void cleanup();
+    void setFilterRules_data();
+    void setFilterRules();
+    void createCategories_data();
+    void createCategories();
+    void disabledDebug();
+
+private:
+    void createCategories(int count);
+    QStringList filterRules(int count) const;
+
+    QList<QByteArray> m_names;
+    QList<QLoggingCategory *> m_categories;
+};
+
+// names as large applications with many modules and plugins use them
+void tst_qloggingcategory::createCategories(int count)
+{
+    static const char *const modules[] = { "core", "gui", "network", "qml", "multimedia" };
+    static const char *const parts[] = { "io", "render", "cache", "input", "plugin", "model" };
+    for (int i = m_categories.size(); i < count; ++i) {
+        m_names << QByteArray("app.") + modules[i % 5] + '.' + parts[(i / 5) % 6]
+                   + ".item" + QByteArray::number(i);
+        m_categories << new QLoggingCategory(m_names.last().constData());
+    }
+}
+
+QStringList tst_qloggingcategory::filterRules(int count) const
+{
+    QStringList rules;
+    for (int i = 0; i < count; ++i) {
+        switch (i % 4) {
+        case 0: rules << QString::fromLatin1("app.core.item%1.debug=true").arg(i); break;
+        case 1: rules << QString::fromLatin1("app.gui.render.*=false"); break;
+        case 2: rules << QString::fromLatin1("*.item%1.warning=false").arg(i); break;
+        case 3: rules << QString::fromLatin1("*cache*.debug=true"); break;
+        }
+    }
+    return rules;
+}
+
+void tst_qloggingcategory::cleanup()
+{
+    qDeleteAll(m_categories);
+    m_categories.clear();
+    m_names.clear();
+    QLoggingCategory::setFilterRules(QString());
+}
+
+void tst_qloggingcategory::setFilterRules_data()
+{
+    QTest::addColumn<int>("categories");
+    QTest::addColumn<int>("rules");
+
+    QTest::newRow("1000 categories, 4 rules") << 1000 << 4;
+    QTest::newRow("1000 categories, 40 rules") << 1000 << 40;
+    QTest::newRow("5000 categories, 40 rules") << 5000 << 40;
+}
+
+// changing the rules at runtime re-evaluates every registered category
+void tst_qloggingcategory::setFilterRules()
+{
+    QFETCH(int, categories);
+    QFETCH(int, rules);
+    createCategories(categories);
+    const QString first = filterRules(rules).join(QLatin1Char('\n'));
+    const QString second = filterRules(rules + 1).join(QLatin1Char('\n'));
+
+    bool toggle = false;
+    QBENCHMARK {
+        QLoggingCategory::setFilterRules(toggle ? first : second);
+        toggle = !toggle;
+    }
+}
+
+void tst_qloggingcategory::createCategories_data()
+{
+    QTest::addColumn<int>("rules");
+
+    QTest::newRow("no rules") << 0;
+    QTest::newRow("40 rules") << 40;
+}
+
+// every new category is matched against the rules in effect
+void tst_qloggingcategory::createCategories()
+{
+    QFETCH(int, rules);
+    QLoggingCategory::setFilterRules(filterRules(rules).join(QLatin1Char('\n')));
+    createCategories(1000);
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QLoggingCategory category(m_names.at(i).constData());
+    }
+}
+
+void tst_qloggingcategory::disabledDebug()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("bench.disabled.debug=false"));
+    QVERIFY(!lcDisabled().isDebugEnabled());
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            qCDebug(lcDisabled) << "disabled" << i;
+    }
+}
+
+QTEST_MAIN(tst_qloggingcategory)
+
+#include "main.moc"
@@ -42,6 +42,8 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+    void startLatency_data();
+    void startLatency();
 
 #endif // QT_NO_PROCESS
 };
@@ -93,6 +95,44 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+// reimplementing setupChildProcess() makes QProcess fork the child
+class ForkingProcess : public QProcess
+{
+protected:
+    void setupChildProcess() Q_DECL_OVERRIDE {}
+};
+
+void tst_QProcess::startLatency_data()
+{
+    QTest::addColumn<int>("heapSize");
+    QTest::addColumn<bool>("subclass");
+
+    const int sizes[] = { 0, 256, 1024 };
+    for (int i = 0; i < int(sizeof(sizes) / sizeof(sizes[0])); ++i) {
+        const QByteArray size = QByteArray::number(sizes[i]) + "MB";
+        QTest::newRow(size + "-QProcess") << sizes[i] << false;
+        QTest::newRow(size + "-subclass") << sizes[i] << true;
+    }
+}
+
+// starting short-lived helpers from a process with a large, touched heap
+void tst_QProcess::startLatency()
+{
+    QFETCH(int, heapSize);
+    QFETCH(bool, subclass);
+
+    const QByteArray heap(heapSize * 1024 * 1024, 'x');
+    QCOMPARE(heap.size(), heapSize * 1024 * 1024);
+
+    QBENCHMARK {
+        QScopedPointer<QProcess> process(subclass ? new ForkingProcess : new QProcess);
+        process->start("testProcessLoopback/testProcessLoopback");
+        QVERIFY(process->waitForStarted());
+        process->closeWriteChannel();
+        QVERIFY(process->waitForFinished());
+    }
+}
+
 #endif // QT_NO_PROCESS && Q_OS_WINCE
 
 QTEST_MAIN(tst_QProcess)
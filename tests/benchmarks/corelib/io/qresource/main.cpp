@@ -0,0 +1,230 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QPair>
+#include <QLibraryInfo>
+#include <QProcess>
+#include <QResource>
+#include <QTemporaryDir>
+#include <qtest.h>
+
+class tst_qresource : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void read_data();
+    void read();
+    void lookup_data();
+    void lookup();
+
+private:
+    bool createRcc(const QString &qrcFile, const QString &output, const QStringList &options);
+    bool registerRcc(const QString &rcc, const QString &mapRoot = QString());
+
+    QTemporaryDir m_dir;
+    QList<QPair<QString, QString> > m_registered;
+};
+
+// roughly as compressible as typical QML and JavaScript sources
+static QByteArray sourceLikeData(int size)
+{
+    static const char *const words[] = {
+        "import", "QtQuick", "2.5", "Item", "{", "}", "id:", "width:", "height:",
+        "anchors.fill:", "parent", "property", "var", "function", "return",
+        "onClicked:", "Rectangle", "color:", "\"steelblue\"", "Text", "text:",
+        "qsTr(\"Hello\")", "if", "(", ")", "else", "model.count", "index", ";"
+    };
+    const int wordCount = int(sizeof(words) / sizeof(words[0]));
+    QByteArray data;
+    data.reserve(size);
+    quint32 seed = 42;
+    while (data.size() < size) {
+        seed = seed * 1103515245 + 12345;
+        data += words[(seed >> 16) % wordCount];
+        data += ((seed >> 8) & 7) ? ' ' : '\n';
+        if (!((seed >> 4) & 63))
+            data += QByteArray::number(seed);
+    }
+    data.truncate(size);
+    return data;
+}
+
+static bool writeFile(const QString &fileName, const QByteArray &contents)
+{
+    QDir().mkpath(QFileInfo(fileName).path());
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+bool tst_qresource::createRcc(const QString &qrcFile, const QString &output, const QStringList &options)
+{
+    const QString rcc = QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/rcc");
+    QProcess process;
+    process.setWorkingDirectory(m_dir.path());
+    process.start(rcc, QStringList() << QLatin1String("-binary") << options
+                  << QLatin1String("-o") << output << qrcFile);
+    return process.waitForFinished() && process.exitStatus() == QProcess::NormalExit
+            && process.exitCode() == 0;
+}
+
+bool tst_qresource::registerRcc(const QString &rcc, const QString &mapRoot)
+{
+    if (!QResource::registerResource(rcc, mapRoot))
+        return false;
+    m_registered << qMakePair(rcc, mapRoot);
+    return true;
+}
+
+void tst_qresource::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    const int sizes[] = { 4 * 1024, 64 * 1024, 1024 * 1024 };
+    QByteArray qrc = "<RCC><qresource>\n";
+    for (int i = 0; i < int(sizeof(sizes) / sizeof(sizes[0])); ++i) {
+        const QString name = QString::number(sizes[i]) + QLatin1String(".txt");
+        QFile file(m_dir.path() + QLatin1Char('/') + name);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(sourceLikeData(sizes[i]));
+        qrc += "<file>" + name.toLatin1() + "</file>\n";
+    }
+    qrc += "</qresource></RCC>\n";
+    QFile qrcFile(m_dir.path() + QLatin1String("/bench.qrc"));
+    QVERIFY(qrcFile.open(QIODevice::WriteOnly));
+    qrcFile.write(qrc);
+    qrcFile.close();
+
+    const char *const algorithms[] = { "none", "zlib", "zstd" };
+    for (int i = 0; i < 3; ++i) {
+        const QString algo = QLatin1String(algorithms[i]);
+        const QString output = m_dir.path() + QLatin1Char('/') + algo + QLatin1String(".rcc");
+        QVERIFY(createRcc(qrcFile.fileName(), output, QStringList()
+                          << QLatin1String("-compress-algo") << algo
+                          << QLatin1String("-root") << QLatin1Char('/') + algo + QLatin1Char('/')));
+        QVERIFY(registerRcc(output));
+    }
+
+    // a QML module sized tree, registered many times over as applications
+    // with many plugins and modules do
+    QByteArray treeQrc = "<RCC><qresource>\n";
+    for (int dir = 0; dir < 10; ++dir) {
+        for (int sub = 0; sub < 5; ++sub) {
+            for (int file = 0; file < 10; ++file) {
+                const QString name = QString::fromLatin1("tree/dir%1/sub%2/file%3.qml").arg(dir).arg(sub).arg(file);
+                QVERIFY(writeFile(m_dir.path() + QLatin1Char('/') + name, "Item {}\n"));
+                treeQrc += "<file>" + name.toLatin1() + "</file>\n";
+            }
+        }
+    }
+    treeQrc += "</qresource></RCC>\n";
+    const QString treeQrcFile = m_dir.path() + QLatin1String("/tree.qrc");
+    QVERIFY(writeFile(treeQrcFile, treeQrc));
+
+    for (int version = 1; version <= 3; version += 2) {
+        const QString output = m_dir.path() + QString::fromLatin1("/tree%1.rcc").arg(version);
+        QVERIFY(createRcc(treeQrcFile, output, QStringList()
+                          << QLatin1String("-format-version") << QString::number(version)));
+        for (int copy = 0; copy < 30; ++copy)
+            QVERIFY(registerRcc(output, QString::fromLatin1("/v%1/copy%2").arg(version).arg(copy)));
+    }
+}
+
+void tst_qresource::cleanupTestCase()
+{
+    for (int i = 0; i < m_registered.size(); ++i)
+        QResource::unregisterResource(m_registered.at(i).first, m_registered.at(i).second);
+}
+
+void tst_qresource::read_data()
+{
+    QTest::addColumn<QString>("path");
+
+    const char *const algorithms[] = { "none", "zlib", "zstd" };
+    const char *const files[] = { "4096", "65536", "1048576" };
+    for (int f = 0; f < 3; ++f) {
+        for (int a = 0; a < 3; ++a) {
+            QTest::newRow(QByteArray(algorithms[a]) + '-' + files[f])
+                    << QString::fromLatin1(":/%1/%2.txt").arg(QLatin1String(algorithms[a]), QLatin1String(files[f]));
+        }
+    }
+}
+
+// opens and reads a resource, as QML and image loading do; run with
+// QT_RESOURCE_CACHE_SIZE set to measure repeated opens of cached data
+void tst_qresource::read()
+{
+    QFETCH(QString, path);
+    QVERIFY(QFile::exists(path));
+
+    QBENCHMARK {
+        QFile file(path);
+        file.open(QIODevice::ReadOnly);
+        file.readAll();
+    }
+}
+
+void tst_qresource::lookup_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<bool>("exists");
+
+    for (int version = 1; version <= 3; version += 2) {
+        const QByteArray prefix = 'v' + QByteArray::number(version) + '-';
+        const QString copy = QString::fromLatin1(":/v%1/copy29/").arg(version);
+        QTest::newRow(prefix + "file") << copy + QLatin1String("tree/dir9/sub4/file9.qml") << true;
+        QTest::newRow(prefix + "directory") << copy + QLatin1String("tree/dir9/sub4") << true;
+        QTest::newRow(prefix + "missing") << copy + QLatin1String("tree/dir9/sub4/missing.qml") << false;
+    }
+}
+
+// finding resources, as happens for every QFile or QFileInfo on a
+// resource path, with many registered resource files
+void tst_qresource::lookup()
+{
+    QFETCH(QString, path);
+    QFETCH(bool, exists);
+    QCOMPARE(QResource(path).isValid(), exists);
+
+    QBENCHMARK {
+        QResource resource(path);
+        resource.isValid();
+    }
+}
+
+QTEST_MAIN(tst_qresource)
+
+#include "main.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_bench_qresource
+QT = core testlib
+CONFIG += release
+SOURCES += main.cpp
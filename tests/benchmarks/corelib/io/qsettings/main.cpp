@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QSettings>
+#include <QTemporaryDir>
+#include <qtest.h>
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void init();
+    void value_data();
+    void value();
+    void setValueAndSync_data() { value_data(); }
+    void setValueAndSync();
+    void allKeys_data() { value_data(); }
+    void allKeys();
+
+private:
+    QString m_fileName;
+    QTemporaryDir m_dir;
+};
+
+static const int sectionCount = 1000;
+
+void tst_QSettings::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_fileName = m_dir.path() + QLatin1String("/large.ini");
+}
+
+// Each test starts from a freshly written file of 1000 sections
+void tst_QSettings::init()
+{
+    QFETCH(int, keysPerSection);
+
+    QFile::remove(m_fileName);
+    QFile file(m_fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    for (int s = 0; s < sectionCount; ++s) {
+        file.write("[section" + QByteArray::number(s) + "]\n");
+        for (int k = 0; k < keysPerSection; ++k)
+            file.write("key" + QByteArray::number(k) + "=some value " + QByteArray::number(s * k) + '\n');
+        file.write("\n");
+    }
+}
+
+void tst_QSettings::value_data()
+{
+    QTest::addColumn<int>("keysPerSection");
+    QTest::newRow("10k keys") << 10;
+    QTest::newRow("100k keys") << 100;
+}
+
+void tst_QSettings::value()
+{
+    QFETCH(int, keysPerSection);
+
+    QSettings settings(m_fileName, QSettings::IniFormat);
+    int section = 0;
+    QBENCHMARK {
+        const QString key = QLatin1String("section") + QString::number(section++ % sectionCount)
+                + QLatin1String("/key") + QString::number(keysPerSection / 2);
+        QVERIFY(settings.value(key).isValid());
+    }
+}
+
+void tst_QSettings::setValueAndSync()
+{
+    QSettings settings(m_fileName, QSettings::IniFormat);
+    int n = 0;
+    QBENCHMARK {
+        settings.setValue(QLatin1String("section42/key0"), ++n);
+        settings.sync();
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+void tst_QSettings::allKeys()
+{
+    QFETCH(int, keysPerSection);
+
+    QBENCHMARK {
+        QSettings settings(m_fileName, QSettings::IniFormat);
+        QCOMPARE(settings.allKeys().size(), sectionCount * keysPerSection);
+    }
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "main.moc"
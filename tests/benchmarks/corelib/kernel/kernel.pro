@@ -4,9 +4,12 @@ SUBDIRS = \
         qmetaobject \
         qmetatype \
         qobject \
+        qsharedmemorychannel \
         qvariant \
         qcoreapplication
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
     qobject
+
+!unix|android: SUBDIRS -= qsharedmemorychannel
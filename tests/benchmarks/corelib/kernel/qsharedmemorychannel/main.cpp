@@ -0,0 +1,300 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QSharedMemoryChannel>
+#include <QThread>
+#include <qtest.h>
+#ifdef QT_NETWORK_LIB
+#include <QLocalServer>
+#include <QLocalSocket>
+#endif
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+class tst_qsharedmemorychannel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void throughput_data();
+    void throughput();
+    void latency_data();
+    void latency();
+};
+
+static const int TotalBytes = 64 * 1024 * 1024;
+static const int PingSize = 64;
+static const int PingCount = 1000;
+
+static QString channelKey(const char *name)
+{
+    return QString::fromLatin1("tst_bench_qsharedmemorychannel_%1_%2")
+            .arg(QCoreApplication::applicationPid()).arg(QLatin1String(name));
+}
+
+static bool writeAll(int fd, const char *data, int size)
+{
+    while (size > 0) {
+        const ssize_t n = ::write(fd, data, size);
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= int(n);
+    }
+    return true;
+}
+
+static bool readAll(int fd, char *data, int size)
+{
+    while (size > 0) {
+        const ssize_t n = ::read(fd, data, size);
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= int(n);
+    }
+    return true;
+}
+
+// sends frames, copying each one in as a renderer or decoder would
+class ChannelProducer : public QThread
+{
+public:
+    ChannelProducer(int frameSize, int count) : frame(frameSize, 'x'), count(count) {}
+    void run() Q_DECL_OVERRIDE
+    {
+        QSharedMemoryChannel channel(channelKey("throughput"));
+        if (!channel.attach(QSharedMemoryChannel::Producer))
+            return;
+        for (int i = 0; i < count; ++i) {
+            if (!channel.waitForSpace(frame.size(), 10000))
+                return;
+            memcpy(channel.reserveMessage(frame.size()), frame.constData(), frame.size());
+            channel.commitMessage();
+        }
+    }
+    QByteArray frame;
+    int count;
+};
+
+class SocketProducer : public QThread
+{
+public:
+    SocketProducer(int fd, int frameSize, int count) : fd(fd), frame(frameSize, 'x'), count(count) {}
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i) {
+            if (!writeAll(fd, frame.constData(), frame.size()))
+                return;
+        }
+    }
+    int fd;
+    QByteArray frame;
+    int count;
+};
+
+class ChannelEcho : public QThread
+{
+public:
+    void run() Q_DECL_OVERRIDE
+    {
+        QSharedMemoryChannel in(channelKey("ping"));
+        QSharedMemoryChannel out(channelKey("pong"));
+        if (!in.attach(QSharedMemoryChannel::Consumer) || !out.attach(QSharedMemoryChannel::Producer))
+            return;
+        for (int i = 0; i < PingCount; ++i) {
+            if (!in.waitForMessage(10000))
+                return;
+            int size;
+            const char *data = in.peekMessage(&size);
+            out.writeMessage(data, size);
+            in.releaseMessage();
+        }
+    }
+};
+
+class SocketEcho : public QThread
+{
+public:
+    explicit SocketEcho(int fd) : fd(fd) {}
+    void run() Q_DECL_OVERRIDE
+    {
+        char buffer[PingSize];
+        for (int i = 0; i < PingCount; ++i) {
+            if (!readAll(fd, buffer, PingSize) || !writeAll(fd, buffer, PingSize))
+                return;
+        }
+    }
+    int fd;
+};
+
+void tst_qsharedmemorychannel::throughput_data()
+{
+    QTest::addColumn<QString>("transport");
+    QTest::addColumn<int>("frameSize");
+
+    const int sizes[] = { 64 * 1024, 1024 * 1024, 8 * 1024 * 1024 };
+    const char *const transports[] = { "channel", "socketpair"
+#ifdef QT_NETWORK_LIB
+        , "QLocalSocket"
+#endif
+    };
+    for (uint t = 0; t < sizeof(transports) / sizeof(*transports); ++t) {
+        for (int s = 0; s < 3; ++s) {
+            QTest::newRow(QByteArray(transports[t]) + ", " + QByteArray::number(sizes[s] / 1024) + " KB")
+                    << QString::fromLatin1(transports[t]) << sizes[s];
+        }
+    }
+}
+
+// passing 64 MB in frames of the given size to another thread
+void tst_qsharedmemorychannel::throughput()
+{
+    QFETCH(QString, transport);
+    QFETCH(int, frameSize);
+    const int count = TotalBytes / frameSize;
+    qint64 checksum = 0;
+
+    if (transport == QLatin1String("channel")) {
+        QSharedMemoryChannel channel(channelKey("throughput"));
+        QVERIFY2(channel.create(QSharedMemoryChannel::Consumer, 4 * frameSize),
+                 qPrintable(channel.errorString()));
+        QBENCHMARK {
+            ChannelProducer producer(frameSize, count);
+            producer.start();
+            for (int i = 0; i < count; ++i) {
+                QVERIFY(channel.waitForMessage(10000));
+                int size;
+                const char *frame = channel.peekMessage(&size);
+                checksum += frame[size - 1];
+                channel.releaseMessage();
+            }
+            producer.wait();
+        }
+    } else if (transport == QLatin1String("socketpair")) {
+        int fds[2];
+        QCOMPARE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        QByteArray frame(frameSize, Qt::Uninitialized);
+        QBENCHMARK {
+            SocketProducer producer(fds[0], frameSize, count);
+            producer.start();
+            for (int i = 0; i < count; ++i) {
+                QVERIFY(readAll(fds[1], frame.data(), frameSize));
+                checksum += frame.at(frameSize - 1);
+            }
+            producer.wait();
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+#ifdef QT_NETWORK_LIB
+    else {
+        QLocalServer server;
+        QVERIFY(server.listen(channelKey("socket")));
+        QLocalSocket client;
+        client.connectToServer(server.serverName());
+        QVERIFY(client.waitForConnected());
+        QVERIFY(server.waitForNewConnection(10000));
+        QLocalSocket *receiver = server.nextPendingConnection();
+        QByteArray frame(frameSize, 'x');
+        QByteArray buffer(frameSize, Qt::Uninitialized);
+        QBENCHMARK {
+            qint64 sent = 0;
+            qint64 received = 0;
+            while (received < qint64(count) * frameSize) {
+                if (sent < qint64(count) * frameSize && client.bytesToWrite() < 4 * frameSize) {
+                    client.write(frame);
+                    sent += frameSize;
+                }
+                client.waitForBytesWritten(0);
+                if (receiver->bytesAvailable() || receiver->waitForReadyRead(10)) {
+                    const qint64 n = receiver->read(buffer.data(), frameSize);
+                    checksum += n;
+                    received += n;
+                }
+            }
+        }
+    }
+#endif
+    QVERIFY(checksum != 0);
+}
+
+void tst_qsharedmemorychannel::latency_data()
+{
+    QTest::addColumn<QString>("transport");
+    QTest::newRow("channel") << QStringLiteral("channel");
+    QTest::newRow("socketpair") << QStringLiteral("socketpair");
+}
+
+// round trips of small messages to another thread
+void tst_qsharedmemorychannel::latency()
+{
+    QFETCH(QString, transport);
+    const QByteArray ping(PingSize, 'p');
+
+    if (transport == QLatin1String("channel")) {
+        QSharedMemoryChannel out(channelKey("ping"));
+        QSharedMemoryChannel in(channelKey("pong"));
+        QVERIFY(out.create(QSharedMemoryChannel::Producer, 4096));
+        QVERIFY(in.create(QSharedMemoryChannel::Consumer, 4096));
+        QBENCHMARK {
+            ChannelEcho echo;
+            echo.start();
+            for (int i = 0; i < PingCount; ++i) {
+                QVERIFY(out.writeMessage(ping));
+                QVERIFY(in.waitForMessage(10000));
+                QCOMPARE(in.readMessage().size(), PingSize);
+            }
+            echo.wait();
+        }
+    } else {
+        int fds[2];
+        QCOMPARE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        char buffer[PingSize];
+        QBENCHMARK {
+            SocketEcho echo(fds[1]);
+            echo.start();
+            for (int i = 0; i < PingCount; ++i) {
+                QVERIFY(writeAll(fds[0], ping.constData(), PingSize));
+                QVERIFY(readAll(fds[0], buffer, PingSize));
+            }
+            echo.wait();
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+
+QTEST_MAIN(tst_qsharedmemorychannel)
+
+#include "main.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qsharedmemorychannel
+QT = core testlib
+qtHaveModule(network): QT += network
+CONFIG += release
+SOURCES += main.cpp
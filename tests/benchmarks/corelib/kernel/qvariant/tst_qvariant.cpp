@@ -51,6 +51,9 @@ private slots:
     void stringListVariantCreation();
     void bigClassVariantCreation();
     void smallClassVariantCreation();
+    void mediumClassVariantCreation();
+    void stringListVariantMoveCreation();
+    void bigListVariantMoveCreation();
 
     void doubleVariantSetValue();
     void floatVariantSetValue();
@@ -97,6 +100,18 @@ Q_DECLARE_TYPEINFO(SmallClass, Q_MOVABLE_TYPE);
 QT_END_NAMESPACE
 Q_DECLARE_METATYPE(SmallClass);
 
+// a trivially copyable type just too large for the inline storage,
+// e.g. a pair of QPointF or a QRectF with a tag
+struct MediumClass
+{
+    double x, y, z;
+};
+Q_STATIC_ASSERT(sizeof(MediumClass) > sizeof(QVariant::Private::Data));
+QT_BEGIN_NAMESPACE
+Q_DECLARE_TYPEINFO(MediumClass, Q_PRIMITIVE_TYPE);
+QT_END_NAMESPACE
+Q_DECLARE_METATYPE(MediumClass);
+
 void tst_qvariant::testBound()
 {
     qreal d = qreal(.5);
@@ -138,6 +153,16 @@ void variantCreation<SmallClass>(SmallClass val)
 }
 
 
+template <>
+void variantCreation<MediumClass>(MediumClass val)
+{
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i) {
+            QVariant::fromValue(val);
+        }
+    }
+}
+
 void tst_qvariant::doubleVariantCreation()
 {
     variantCreation<double>(0.0);
@@ -178,6 +203,37 @@ void tst_qvariant::smallClassVariantCreation()
     variantCreation<SmallClass>(SmallClass());
 }
 
+void tst_qvariant::mediumClassVariantCreation()
+{
+    variantCreation<MediumClass>(MediumClass());
+}
+
+// Measures QVariant::fromValue(T &&); compare with the copying
+// overload benchmarked by variantCreation().
+template <typename T>
+static void variantMoveCreation(const T &val)
+{
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i) {
+            T copy = val;
+            QVariant::fromValue(std::move(copy));
+        }
+    }
+}
+
+void tst_qvariant::stringListVariantMoveCreation()
+{
+    variantMoveCreation<QStringList>(QStringList() << QStringLiteral("a") << QStringLiteral("b"));
+}
+
+void tst_qvariant::bigListVariantMoveCreation()
+{
+    QList<BigClass> list;
+    for (int i = 0; i < 16; ++i)
+        list.append(BigClass());
+    variantMoveCreation<QList<BigClass> >(list);
+}
+
 template <typename T>
 static void variantSetValue(T d)
 {
@@ -32,6 +32,10 @@
 ****************************************************************************/
 
 #include <QtTest/QtTest>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+
+#include <stdio.h>
 
 class tst_QMimeDatabase: public QObject
 {
@@ -39,9 +43,61 @@ class tst_QMimeDatabase: public QObject
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void inheritsPerformance();
+    void startupTime_data();
+    void startupTime();
+    void startupMemory_data();
+    void startupMemory();
+
+private:
+    bool runStartupChild(qint64 *msecs, qint64 *bytes);
+
+    QTemporaryDir m_emptyXdgDir;
 };
 
+// Resident memory that is not backed by files (i.e. not library pages)
+static qint64 privateResidentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 3)
+        return -1;
+    return (fields.at(1).toLongLong() - fields.at(2).toLongLong()) * 4096;
+#else
+    return -1;
+#endif
+}
+
+// The database is loaded once per process, so the startup cost is measured
+// in a child process, started with the environment of the current row.
+static int startupChild()
+{
+    const qint64 residentBefore = privateResidentBytes();
+    QElapsedTimer timer;
+    timer.start();
+
+    QMimeDatabase db;
+    if (db.mimeTypeForFile(QStringLiteral("archive.tar.bz2"), QMimeDatabase::MatchExtension).name()
+            != QLatin1String("application/x-bzip-compressed-tar")
+        || db.mimeTypeForData(QByteArray("%PDF-1.4")).name() != QLatin1String("application/pdf")
+        || db.mimeTypeForName(QStringLiteral("text/plain")).comment().isEmpty()) {
+        return 1;
+    }
+
+    const qint64 msecs = timer.elapsed();
+    printf("%lld %lld\n", msecs, privateResidentBytes() - residentBefore);
+    return 0;
+}
+
+void tst_QMimeDatabase::initTestCase()
+{
+    QVERIFY(m_emptyXdgDir.isValid());
+}
+
 void tst_QMimeDatabase::inheritsPerformance()
 {
     // Check performance of inherits().
@@ -75,5 +131,76 @@ void tst_QMimeDatabase::inheritsPerformance()
     // parsing XML, and then keeps being around 4.5 MB for all the in-memory hashes.
 }
 
-QTEST_MAIN(tst_QMimeDatabase)
+void tst_QMimeDatabase::startupTime_data()
+{
+    QTest::addColumn<bool>("xml");
+
+    // No shared-mime-info installation: either the mime.cache built into QtCore
+    // or, as before, freedesktop.org.xml parsed by the XML provider
+    QTest::newRow("builtin-cache") << false;
+    QTest::newRow("xml") << true;
+}
+
+bool tst_QMimeDatabase::runStartupChild(qint64 *msecs, qint64 *bytes)
+{
+#ifdef QT_NO_PROCESS
+    Q_UNUSED(msecs);
+    Q_UNUSED(bytes);
+    return false;
+#else
+    QFETCH(bool, xml);
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("XDG_DATA_DIRS"), m_emptyXdgDir.path());
+    env.insert(QStringLiteral("XDG_DATA_HOME"), m_emptyXdgDir.path());
+    if (xml)
+        env.insert(QStringLiteral("QT_NO_MIME_CACHE"), QStringLiteral("1"));
+    else
+        env.remove(QStringLiteral("QT_NO_MIME_CACHE"));
+
+    QProcess child;
+    child.setProcessEnvironment(env);
+    child.start(QCoreApplication::applicationFilePath(), QStringList(QStringLiteral("-startup-child")));
+    if (!child.waitForFinished() || child.exitCode() != 0)
+        return false;
+    const QList<QByteArray> result = child.readAllStandardOutput().trimmed().split(' ');
+    if (result.size() != 2)
+        return false;
+    *msecs = result.at(0).toLongLong();
+    *bytes = result.at(1).toLongLong();
+    return true;
+#endif
+}
+
+void tst_QMimeDatabase::startupTime()
+{
+    qint64 msecs, bytes;
+    if (!runStartupChild(&msecs, &bytes))
+        QSKIP("Cannot run the child process");
+    QTest::setBenchmarkResult(msecs, QTest::WalltimeMilliseconds);
+}
+
+void tst_QMimeDatabase::startupMemory_data()
+{
+    startupTime_data();
+}
+
+void tst_QMimeDatabase::startupMemory()
+{
+    qint64 msecs, bytes;
+    if (!runStartupChild(&msecs, &bytes))
+        QSKIP("Cannot run the child process");
+    if (bytes < 0)
+        QSKIP("Memory usage is not available on this platform");
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (argc > 1 && qstrcmp(argv[1], "-startup-child") == 0)
+        return startupChild();
+    tst_QMimeDatabase tc;
+    return QTest::qExec(&tc, argc, argv);
+}
 #include "main.moc"
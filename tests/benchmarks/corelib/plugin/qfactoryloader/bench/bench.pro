@@ -0,0 +1,5 @@
+TARGET = ../tst_bench_qfactoryloader
+QT = core-private testlib
+CONFIG += release
+SOURCES += main.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
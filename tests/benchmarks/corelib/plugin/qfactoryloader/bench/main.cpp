@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
+#include <QtTest/qtest.h>
+#include <private/qfactoryloader_p.h>
+
+// Creating a QFactoryLoader for a directory of plugins, as an application
+// does at startup for each plugin type it uses; with and without the
+// plugin metadata cache.
+class tst_QFactoryLoader : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void create_data();
+    void create();
+
+private:
+    QTemporaryDir m_libraryDir;
+    QTemporaryDir m_cacheDir;
+};
+
+static const char pluginIid[] = "org.qt-project.Qt.benchmarks.qfactoryloader";
+
+void tst_QFactoryLoader::initTestCase()
+{
+    QVERIFY(m_libraryDir.isValid());
+    QVERIFY(m_cacheDir.isValid());
+
+    QDir bin(QCoreApplication::applicationDirPath() + QLatin1String("/bin"));
+    const QStringList built = bin.entryList(QDir::Files);
+    QVERIFY2(!built.isEmpty(), "Unable to locate the test plugin");
+    const QString plugin = bin.filePath(built.first());
+
+    // enough plugins for a directory of image format or SQL drivers
+    QDir root(m_libraryDir.path());
+    QVERIFY(root.mkdir("plugins"));
+    for (int i = 0; i < 40; ++i)
+        QVERIFY(QFile::copy(plugin, root.filePath(QString::fromLatin1("plugins/libplugin%1.so").arg(i))));
+    QCoreApplication::setLibraryPaths(QStringList(m_libraryDir.path()));
+}
+
+void tst_QFactoryLoader::create_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("parse") << false;
+    QTest::newRow("cached") << true;
+}
+
+void tst_QFactoryLoader::create()
+{
+    QFETCH(bool, cached);
+    if (cached) {
+        qunsetenv("QT_NO_PLUGIN_CACHE");
+        qputenv("QT_PLUGIN_CACHE_PATH", QFile::encodeName(m_cacheDir.path()));
+    } else {
+        qputenv("QT_NO_PLUGIN_CACHE", "1");
+    }
+
+    {
+        // fill the cache
+        QFactoryLoader loader(pluginIid, QLatin1String("/plugins"));
+        QCOMPARE(loader.metaData().size(), 40);
+    }
+    QBENCHMARK {
+        QFactoryLoader loader(pluginIid, QLatin1String("/plugins"));
+    }
+}
+
+QTEST_MAIN(tst_QFactoryLoader)
+
+#include "main.moc"
@@ -0,0 +1,255 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QBTreeMap>
+#include <QMap>
+
+#include <limits>
+#include <map>
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+#  include <malloc.h>
+#  define HAVE_MALLINFO
+#endif
+
+enum Container { QMapContainer, StdMapContainer, QBTreeMapContainer };
+
+typedef QMap<qint64, qint64> QMapType;
+typedef std::map<qint64, qint64> StdMapType;
+typedef QBTreeMap<qint64, qint64> QBTreeMapType;
+
+// a little adaptor layer, so that the same benchmark code runs on all three
+static inline void insert(QMapType &m, qint64 k, qint64 v) { m.insert(k, v); }
+static inline void insert(StdMapType &m, qint64 k, qint64 v) { m[k] = v; }
+static inline void insert(QBTreeMapType &m, qint64 k, qint64 v) { m.insert(k, v); }
+static inline qint64 value(const QMapType &m, qint64 k) { return m.value(k); }
+static inline qint64 value(const StdMapType &m, qint64 k)
+{ StdMapType::const_iterator it = m.find(k); return it == m.end() ? 0 : it->second; }
+static inline qint64 value(const QBTreeMapType &m, qint64 k) { return m.value(k); }
+static inline QMapType::const_iterator lowerBound(const QMapType &m, qint64 k) { return m.lowerBound(k); }
+static inline StdMapType::const_iterator lowerBound(const StdMapType &m, qint64 k) { return m.lower_bound(k); }
+static inline QBTreeMapType::const_iterator lowerBound(const QBTreeMapType &m, qint64 k) { return m.lowerBound(k); }
+static inline qint64 valueOf(QMapType::const_iterator it) { return it.value(); }
+static inline qint64 valueOf(StdMapType::const_iterator it) { return it->second; }
+static inline qint64 valueOf(QBTreeMapType::const_iterator it) { return it.value(); }
+
+// timestamps in random order
+static inline qint64 randomKey(int i)
+{
+    return qint64(quint32(uint(i) * 2654435761U)) * 1000;
+}
+
+class tst_QBTreeMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertRandom_data() { containers(); }
+    void insertRandom();
+    void insertSorted_data() { containers(); }
+    void insertSorted();
+    void fromSorted_data() { containers(); }
+    void fromSorted();
+    void lookup_data() { containers(); }
+    void lookup();
+    void rangeScan_data() { containers(); }
+    void rangeScan();
+    void iterate_data() { containers(); }
+    void iterate();
+    void memory_data() { containers(); }
+    void memory();
+
+private:
+    void containers();
+};
+
+void tst_QBTreeMap::containers()
+{
+    QTest::addColumn<int>("container");
+    QTest::addColumn<int>("count");
+
+    const int counts[] = { 1000, 100000, 1000000 };
+    for (uint i = 0; i < sizeof counts / sizeof *counts; ++i) {
+        const QByteArray n = QByteArray::number(counts[i]);
+        QTest::newRow("QMap, " + n) << int(QMapContainer) << counts[i];
+        QTest::newRow("std::map, " + n) << int(StdMapContainer) << counts[i];
+        QTest::newRow("QBTreeMap, " + n) << int(QBTreeMapContainer) << counts[i];
+    }
+}
+
+template <typename Map>
+static void fill(Map &map, int count)
+{
+    for (int i = 0; i < count; ++i)
+        insert(map, randomKey(i), i);
+}
+
+#define DISPATCH(function) \
+    do { \
+        QFETCH(int, container); \
+        QFETCH(int, count); \
+        switch (container) { \
+        case QMapContainer: function<QMapType>(count); break; \
+        case StdMapContainer: function<StdMapType>(count); break; \
+        case QBTreeMapContainer: function<QBTreeMapType>(count); break; \
+        } \
+    } while (0)
+
+template <typename Map>
+static void insertRandom(int count)
+{
+    QBENCHMARK {
+        Map map;
+        fill(map, count);
+    }
+}
+
+void tst_QBTreeMap::insertRandom()
+{
+    DISPATCH(::insertRandom);
+}
+
+template <typename Map>
+static void insertSorted(int count)
+{
+    QBENCHMARK {
+        Map map;
+        for (int i = 0; i < count; ++i)
+            insert(map, qint64(i) * 1000, i);
+    }
+}
+
+void tst_QBTreeMap::insertSorted()
+{
+    DISPATCH(::insertSorted);
+}
+
+template <typename Map>
+static void fromSorted(int count)
+{
+    StdMapType source;
+    fill(source, count);
+    QBENCHMARK {
+        Map map(source);
+        QCOMPARE(int(map.size()), count);
+    }
+}
+
+void tst_QBTreeMap::fromSorted()
+{
+    DISPATCH(::fromSorted);
+}
+
+template <typename Map>
+static void lookup(int count)
+{
+    Map map;
+    fill(map, count);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            sum += value(map, randomKey(i));
+    }
+    QVERIFY(sum);
+}
+
+void tst_QBTreeMap::lookup()
+{
+    DISPATCH(::lookup);
+}
+
+// looks up 1000 random time ranges of 100 items each
+template <typename Map>
+static void rangeScan(int count)
+{
+    Map map;
+    fill(map, count);
+    const qint64 maxKey = qint64(std::numeric_limits<quint32>::max()) * 1000;
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            typename Map::const_iterator it = lowerBound(map, randomKey(i * 7) % maxKey);
+            for (int j = 0; j < 100 && it != map.end(); ++j, ++it)
+                sum += valueOf(it);
+        }
+    }
+    QVERIFY(sum);
+}
+
+void tst_QBTreeMap::rangeScan()
+{
+    DISPATCH(::rangeScan);
+}
+
+template <typename Map>
+static void iterate(int count)
+{
+    Map map;
+    fill(map, count);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+            sum += valueOf(it);
+    }
+    QVERIFY(sum);
+}
+
+void tst_QBTreeMap::iterate()
+{
+    DISPATCH(::iterate);
+}
+
+template <typename Map>
+static void memory(int count)
+{
+#ifdef HAVE_MALLINFO
+    const int before = mallinfo().uordblks;
+    Map map;
+    fill(map, count);
+    const struct mallinfo after = mallinfo();
+    QTest::setBenchmarkResult(qint64(after.uordblks) + after.hblkhd - before, QTest::BytesAllocated);
+#else
+    Q_UNUSED(count);
+    QSKIP("Needs mallinfo()");
+#endif
+}
+
+void tst_QBTreeMap::memory()
+{
+    DISPATCH(::memory);
+}
+
+QTEST_MAIN(tst_QBTreeMap)
+
+#include "main.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qbtreemap
+QT = core testlib
+CONFIG += release
+SOURCES += main.cpp
@@ -34,6 +34,7 @@
 #include <QIODevice>
 #include <QFile>
 #include <QString>
+#include <QByteArrayMatcher>
 
 #include <qtest.h>
 
@@ -52,6 +53,12 @@ private slots:
     void latin1Uppercasing_xlate_checked();
     void latin1Uppercasing_category();
     void latin1Uppercasing_bitcheck();
+
+    void indexOf_data();
+    void indexOf();
+    void matcher_data() { indexOf_data(); }
+    void matcher();
+    void indexOfChar();
 };
 
 void tst_qbytearray::initTestCase()
@@ -263,6 +270,70 @@ void tst_qbytearray::latin1Uppercasing_bitcheck()
 }
 
 
+void tst_qbytearray::indexOf_data()
+{
+    QTest::addColumn<QByteArray>("needle");
+
+    // none of these occur in the log, so the whole log is scanned
+    QTest::newRow("2") << QByteArray("#!");
+    QTest::newRow("4") << QByteArray("warn");
+    QTest::newRow("8") << QByteArray("timeout:");
+    QTest::newRow("16") << QByteArray("connection reset");
+    QTest::newRow("32") << QByteArray("qt.network: connection to 10.1.");
+    QTest::newRow("64") << QByteArray("2016-03-01 12:34:56.789 [info] qt.network: connection estab 443");
+}
+
+// 1 MB of log file
+static QByteArray logData()
+{
+    QByteArray log;
+    log.reserve(1024 * 1024 + 128);
+    for (int i = 0; log.size() < 1024 * 1024; ++i) {
+        log += "2016-03-01 12:34:56.789 [info] qt.network: connection established to host 10.0.";
+        log += QByteArray::number(i % 256);
+        log += '.';
+        log += QByteArray::number(i % 251);
+        log += " port 443\n";
+    }
+    return log;
+}
+
+void tst_qbytearray::indexOf()
+{
+    QFETCH(QByteArray, needle);
+    const QByteArray log = logData();
+
+    int result = 0;
+    QBENCHMARK {
+        result += log.indexOf(needle);
+    }
+    QVERIFY(result < 0);
+}
+
+void tst_qbytearray::matcher()
+{
+    QFETCH(QByteArray, needle);
+    const QByteArray log = logData();
+    const QByteArrayMatcher matcher(needle);
+
+    int result = 0;
+    QBENCHMARK {
+        result += matcher.indexIn(log);
+    }
+    QVERIFY(result < 0);
+}
+
+void tst_qbytearray::indexOfChar()
+{
+    const QByteArray log = logData();
+
+    int result = 0;
+    QBENCHMARK {
+        result += log.indexOf('#');
+    }
+    QVERIFY(result < 0);
+}
+
 QTEST_MAIN(tst_qbytearray)
 
 #include "main.moc"
@@ -35,6 +35,7 @@
 #include <QCryptographicHash>
 #include <QFile>
 #include <QString>
+#include <QTemporaryDir>
 #include <QtTest>
 
 #include <time.h>
@@ -63,6 +64,16 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashBatch_data();
+    void hashBatch();
+    void addDataFile_data();
+    void addDataFile();
+
+private:
+    QString largeFile();
+
+    QTemporaryDir tempDir;
+    QString largeFileName;
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -173,6 +184,113 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::hashBatch_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("blobSize");
+    QTest::addColumn<bool>("batch");
+
+    static const int blobSizes[] = { 64, 1024, 65536 };
+    static const int algorithms[] = {
+        QCryptographicHash::Md5, QCryptographicHash::Sha1, QCryptographicHash::Sha256, QCryptographicHash::Sha3_256
+    };
+    for (uint i = 0; i < sizeof(blobSizes)/sizeof(blobSizes[0]); ++i) {
+        for (uint a = 0; a < sizeof(algorithms)/sizeof(algorithms[0]); ++a) {
+            const QByteArray name = algoname(algorithms[a]) + QByteArray::number(blobSizes[i]);
+            QTest::newRow(name + "-serial") << algorithms[a] << blobSizes[i] << false;
+            QTest::newRow(name + "-batch") << algorithms[a] << blobSizes[i] << true;
+        }
+    }
+}
+
+// hashing 16 MB worth of independent blobs, one at a time or as a batch
+void tst_bench_QCryptographicHash::hashBatch()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, blobSize);
+    QFETCH(bool, batch);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QByteArrayList blobs;
+    for (int i = 0; i < 16 * 1024 * 1024 / blobSize; ++i)
+        blobs << QByteArray::fromRawData(blockOfData.constData() + i % (MaxBlockSize - blobSize + 1), blobSize);
+
+    if (batch) {
+        QBENCHMARK {
+            QCryptographicHash::hash(blobs, algo);
+        }
+    } else {
+        QBENCHMARK {
+            QByteArrayList results;
+            results.reserve(blobs.size());
+            for (int i = 0; i < blobs.size(); ++i)
+                results << QCryptographicHash::hash(blobs.at(i), algo);
+        }
+    }
+}
+
+// set TMPDIR to compare tmpfs and disk, and QT_BENCH_HASH_FILE_MB for the size
+QString tst_bench_QCryptographicHash::largeFile()
+{
+    if (!largeFileName.isEmpty())
+        return largeFileName;
+
+    bool ok;
+    int megabytes = qgetenv("QT_BENCH_HASH_FILE_MB").toInt(&ok);
+    if (!ok || megabytes <= 0)
+        megabytes = 256;
+    QFile file(tempDir.path() + QLatin1String("/large"));
+    if (!file.open(QIODevice::WriteOnly))
+        return QString();
+    for (int i = 0; i < megabytes * (1024 * 1024 / MaxBlockSize); ++i) {
+        if (file.write(blockOfData) != blockOfData.size())
+            return QString();
+    }
+    largeFileName = file.fileName();
+    return largeFileName;
+}
+
+void tst_bench_QCryptographicHash::addDataFile_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<bool>("device");
+
+    static const int algorithms[] = {
+        QCryptographicHash::Md5, QCryptographicHash::Sha1, QCryptographicHash::Sha256
+    };
+    for (uint a = 0; a < sizeof(algorithms)/sizeof(algorithms[0]); ++a) {
+        const QByteArray name = algoname(algorithms[a]);
+        QTest::newRow(name + "addData(QIODevice*)") << algorithms[a] << true;
+        QTest::newRow(name + "read-1k") << algorithms[a] << false;
+    }
+}
+
+// hashing a large file through addData(QIODevice*) and, for comparison,
+// through reads of 1 KB
+void tst_bench_QCryptographicHash::addDataFile()
+{
+    QFETCH(int, algorithm);
+    QFETCH(bool, device);
+
+    const QString fileName = largeFile();
+    QVERIFY(!fileName.isEmpty());
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCryptographicHash hash(algo);
+        if (device) {
+            QVERIFY(hash.addData(&file));
+        } else {
+            char buffer[1024];
+            qint64 length;
+            while ((length = file.read(buffer, sizeof(buffer))) > 0)
+                hash.addData(buffer, int(length));
+        }
+        hash.result();
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
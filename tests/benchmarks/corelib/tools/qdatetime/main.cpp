@@ -80,6 +80,7 @@ private Q_SLOTS:
     void toString();
     void toStringTextFormat();
     void toStringIsoFormat();
+    void toStringIsoFormatOffset();
     void addDays();
     void addDaysTz();
     void addMSecs();
@@ -100,6 +101,8 @@ private Q_SLOTS:
     void fromString();
     void fromStringText();
     void fromStringIso();
+    void fromStringIsoLatin1();
+    void fromStringIsoOffset();
     void fromMSecsSinceEpoch();
     void fromMSecsSinceEpochUtc();
     void fromMSecsSinceEpochTz();
@@ -362,6 +365,18 @@ void tst_QDateTime::toStringIsoFormat()
     }
 }
 
+void tst_QDateTime::toStringIsoFormatOffset()
+{
+    QList<QDateTime> list;
+    for (int jd = JULIAN_DAY_2010; jd < JULIAN_DAY_2011; ++jd)
+        list.append(QDateTime(QDate::fromJulianDay(jd), QTime::fromMSecsSinceStartOfDay(0),
+                              Qt::OffsetFromUTC, 19800));
+    QBENCHMARK {
+        foreach (const QDateTime &test, list)
+            test.toString(Qt::ISODate);
+    }
+}
+
 void tst_QDateTime::addDays()
 {
     QList<QDateTime> list;
@@ -578,6 +593,24 @@ void tst_QDateTime::fromStringIso()
     }
 }
 
+void tst_QDateTime::fromStringIsoLatin1()
+{
+    QLatin1String input("2010-01-01T13:28:34.999Z");
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, Qt::ISODate);
+    }
+}
+
+void tst_QDateTime::fromStringIsoOffset()
+{
+    QString input = "2010-01-01T13:28:34.999+05:30";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, Qt::ISODate);
+    }
+}
+
 void tst_QDateTime::fromMSecsSinceEpoch()
 {
     QBENCHMARK {
@@ -0,0 +1,254 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QFlatHash>
+#include <QHash>
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+#  include <malloc.h>
+#  define HAVE_MALLINFO
+#endif
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertInt_data() { sizes(); }
+    void insertInt();
+    void lookupInt_data() { sizes(); }
+    void lookupInt();
+    void lookupMissInt_data() { sizes(); }
+    void lookupMissInt();
+    void iterateInt_data() { sizes(); }
+    void iterateInt();
+    void insertByteArray_data() { sizes(); }
+    void insertByteArray();
+    void lookupByteArray_data() { sizes(); }
+    void lookupByteArray();
+    void memoryInt_data() { sizes(); }
+    void memoryInt();
+
+private:
+    void sizes();
+    static QVector<QByteArray> byteArrayKeys(int count);
+};
+
+void tst_QFlatHash::sizes()
+{
+    QTest::addColumn<bool>("flat");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("QHash, 1000") << false << 1000;
+    QTest::newRow("QFlatHash, 1000") << true << 1000;
+    QTest::newRow("QHash, 100000") << false << 100000;
+    QTest::newRow("QFlatHash, 100000") << true << 100000;
+    QTest::newRow("QHash, 1000000") << false << 1000000;
+    QTest::newRow("QFlatHash, 1000000") << true << 1000000;
+}
+
+QVector<QByteArray> tst_QFlatHash::byteArrayKeys(int count)
+{
+    QVector<QByteArray> keys;
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i)
+        keys.append("/usr/share/some/path/" + QByteArray::number(i * 7919));
+    return keys;
+}
+
+// spreads consecutive numbers over the whole int range, like real ids
+static inline int scramble(int i)
+{
+    return int(uint(i) * 2654435761U);
+}
+
+template <typename Hash>
+static void insertInt(int count)
+{
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < count; ++i)
+            hash.insert(scramble(i), i);
+    }
+}
+
+void tst_QFlatHash::insertInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    if (flat)
+        ::insertInt<QFlatHash<int, int> >(count);
+    else
+        ::insertInt<QHash<int, int> >(count);
+}
+
+template <typename Hash>
+static void lookupInt(int count, int offset)
+{
+    Hash hash;
+    for (int i = 0; i < count; ++i)
+        hash.insert(scramble(i), i);
+
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            sum += hash.value(scramble(i + offset));
+    }
+    QVERIFY(sum || offset);
+}
+
+void tst_QFlatHash::lookupInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    if (flat)
+        ::lookupInt<QFlatHash<int, int> >(count, 0);
+    else
+        ::lookupInt<QHash<int, int> >(count, 0);
+}
+
+void tst_QFlatHash::lookupMissInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    if (flat)
+        ::lookupInt<QFlatHash<int, int> >(count, count);
+    else
+        ::lookupInt<QHash<int, int> >(count, count);
+}
+
+template <typename Hash>
+static void iterateInt(int count)
+{
+    Hash hash;
+    for (int i = 0; i < count; ++i)
+        hash.insert(scramble(i), i);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (typename Hash::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum);
+}
+
+void tst_QFlatHash::iterateInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    if (flat)
+        ::iterateInt<QFlatHash<int, int> >(count);
+    else
+        ::iterateInt<QHash<int, int> >(count);
+}
+
+template <typename Hash>
+static void insertByteArray(const QVector<QByteArray> &keys)
+{
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < keys.size(); ++i)
+            hash.insert(keys.at(i), i);
+    }
+}
+
+void tst_QFlatHash::insertByteArray()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    const QVector<QByteArray> keys = byteArrayKeys(count);
+    if (flat)
+        ::insertByteArray<QFlatHash<QByteArray, int> >(keys);
+    else
+        ::insertByteArray<QHash<QByteArray, int> >(keys);
+}
+
+template <typename Hash>
+static void lookupByteArray(const QVector<QByteArray> &keys)
+{
+    Hash hash;
+    for (int i = 0; i < keys.size(); ++i)
+        hash.insert(keys.at(i), i);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < keys.size(); ++i)
+            sum += hash.value(keys.at(i));
+    }
+    QVERIFY(sum);
+}
+
+void tst_QFlatHash::lookupByteArray()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    const QVector<QByteArray> keys = byteArrayKeys(count);
+    if (flat)
+        ::lookupByteArray<QFlatHash<QByteArray, int> >(keys);
+    else
+        ::lookupByteArray<QHash<QByteArray, int> >(keys);
+}
+
+template <typename Hash>
+static qint64 memoryInt(int count)
+{
+#ifdef HAVE_MALLINFO
+    const int before = mallinfo().uordblks;
+    Hash hash;
+    for (int i = 0; i < count; ++i)
+        hash.insert(scramble(i), i);
+    // mmap'ed blocks aren't counted in uordblks
+    const struct mallinfo after = mallinfo();
+    return qint64(after.uordblks) + after.hblkhd - before;
+#else
+    Q_UNUSED(count);
+    return 0;
+#endif
+}
+
+void tst_QFlatHash::memoryInt()
+{
+#ifndef HAVE_MALLINFO
+    QSKIP("Needs mallinfo()");
+#endif
+    QFETCH(bool, flat);
+    QFETCH(int, count);
+    const qint64 bytes = flat ? ::memoryInt<QFlatHash<int, int> >(count)
+                              : ::memoryInt<QHash<int, int> >(count);
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
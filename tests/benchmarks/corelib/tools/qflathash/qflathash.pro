@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qflathash
+QT = core testlib
+CONFIG += release
+SOURCES += main.cpp
@@ -42,6 +42,11 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void number_double_data();
+    void number_double();
+    void number_qlonglong();
+    void toDouble_data();
+    void toDouble();
 };
 
 static QString data()
@@ -70,6 +75,49 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+void tst_QLocale::number_double_data()
+{
+    QTest::addColumn<double>("d");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("0.1 g 6") << 0.1 << 'g' << 6;
+    QTest::newRow("1234.5678 f 2") << 1234.5678 << 'f' << 2;
+    QTest::newRow("1e-10 e 6") << 1e-10 << 'e' << 6;
+    QTest::newRow("pi g 17") << 3.141592653589793 << 'g' << 17;
+    QTest::newRow("pi shortest") << 3.141592653589793 << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("1e300 shortest") << 1e300 << 'g' << int(QLocale::FloatingPointShortest);
+}
+
+void tst_QLocale::number_double()
+{
+    QFETCH(double, d);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    QBENCHMARK { LOOP(QString::number(d, format, precision)) }
+}
+
+void tst_QLocale::number_qlonglong()
+{
+    QBENCHMARK { LOOP(QString::number(Q_INT64_C(7919) * i - 1000000)) }
+}
+
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<QString>("string");
+
+    QTest::newRow("integer") << QString("123456789");
+    QTest::newRow("decimal") << QString("3.14159");
+    QTest::newRow("exponent") << QString("6.02214076e23");
+    QTest::newRow("max") << QString("1.7976931348623157e308");
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(QString, string);
+    QBENCHMARK { LOOP(string.toDouble()) }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
@@ -33,6 +33,7 @@
 #include <QStringList>
 #include <QFile>
 #include <QtTest/QtTest>
+#include <private/qarraydataarena_p.h>
 
 class tst_QString: public QObject
 {
@@ -54,6 +55,19 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void compareCaseInsensitive_data();
+    void compareCaseInsensitive();
+    void compareLatin1CaseInsensitive_data() { compareCaseInsensitive_data(); }
+    void compareLatin1CaseInsensitive();
+    void indexOfCaseInsensitive_data();
+    void indexOfCaseInsensitive();
+    void matcherCaseInsensitive_data() { indexOfCaseInsensitive_data(); }
+    void matcherCaseInsensitive();
+    void filterCaseInsensitive();
+
+    void splitRecords_data();
+    void splitRecords();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -193,6 +207,167 @@ void tst_QString::toCaseFolded()
     }
 }
 
+void tst_QString::compareCaseInsensitive_data()
+{
+    QTest::addColumn<QString>("s1");
+    QTest::addColumn<QString>("s2");
+
+    const QString ascii = QStringLiteral("The Quick Brown Fox Jumps Over The Lazy Dog. ");
+    const QString latin1 = QString::fromLatin1("Voil\xe0 \xc9t\xe9, Gar\xe7on! Fa\xe7ade, Na\xefve. ");
+    const QString mixed = ascii + latin1;
+
+    QTest::newRow("ascii-short") << QStringLiteral("Application") << QStringLiteral("aPPLICATION");
+    QTest::newRow("ascii-equal") << (ascii + ascii).toUpper() << (ascii + ascii).toLower();
+    QTest::newRow("ascii-differ-at-end") << (ascii + ascii + 'x') << (ascii + ascii + 'y');
+    QTest::newRow("latin1-equal") << (latin1 + latin1).toUpper() << (latin1 + latin1).toLower();
+    QTest::newRow("mixed-equal") << (mixed + mixed).toUpper() << (mixed + mixed).toLower();
+}
+
+void tst_QString::compareCaseInsensitive()
+{
+    QFETCH(QString, s1);
+    QFETCH(QString, s2);
+
+    int result = 0;
+    QBENCHMARK {
+        result += QString::compare(s1, s2, Qt::CaseInsensitive);
+    }
+    Q_UNUSED(result);
+}
+
+void tst_QString::compareLatin1CaseInsensitive()
+{
+    QFETCH(QString, s1);
+    QFETCH(QString, s2);
+    const QByteArray latin1 = s2.toLatin1();
+
+    int result = 0;
+    QBENCHMARK {
+        result += s1.compare(QLatin1String(latin1), Qt::CaseInsensitive);
+    }
+    Q_UNUSED(result);
+}
+
+void tst_QString::indexOfCaseInsensitive_data()
+{
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QString>("needle");
+
+    QString ascii;
+    while (ascii.size() < 4000)
+        ascii += QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+                                "tempor incididunt ut labore et dolore magna aliqua. ");
+    QString german;
+    while (german.size() < 4000)
+        german += QString::fromUtf8("Fix, Schwyz! qu\xc3\xa4kt J\xc3\xbcrgen bl\xc3\xb6""d vom Pa\xc3\x9f. "
+                                    "Zw\xc3\xb6lf Boxk\xc3\xa4mpfer jagen Viktor quer \xc3\xbc""ber den Sylter Deich. ");
+    QString russian;
+    while (russian.size() < 4000)
+        russian += QString::fromUtf8("\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 "
+                                     "\xd0\xb5\xd1\x89\xd1\x91 \xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 "
+                                     "\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85 Qt. ");
+
+    QTest::newRow("ascii-1") << ascii << QStringLiteral("K");
+    QTest::newRow("ascii-3") << ascii << QStringLiteral("QT5");
+    QTest::newRow("ascii-8") << ascii << QStringLiteral("Qt Rocks");
+    QTest::newRow("ascii-20") << ascii << QStringLiteral("LABORE ET DOLORE QT5");
+    QTest::newRow("german-4") << german << QStringLiteral("QT 5");
+    QTest::newRow("german-8") << german << QString::fromUtf8("QU\xc3\x84KT QT");
+    QTest::newRow("russian-4") << russian << QStringLiteral("QT 5");
+}
+
+void tst_QString::indexOfCaseInsensitive()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+
+    int result = 0;
+    QBENCHMARK {
+        result += haystack.indexOf(needle, 0, Qt::CaseInsensitive);
+    }
+    QCOMPARE(result < 0, true);
+}
+
+void tst_QString::matcherCaseInsensitive()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    const QStringMatcher matcher(needle, Qt::CaseInsensitive);
+
+    int result = 0;
+    QBENCHMARK {
+        result += matcher.indexIn(haystack);
+    }
+    QCOMPARE(result < 0, true);
+}
+
+// search-as-you-type over a list of names
+void tst_QString::filterCaseInsensitive()
+{
+    QStringList names;
+    for (int i = 0; i < 100000; ++i)
+        names << QStringLiteral("Customer %1, Business Account #%2 (Active)").arg(i * 7919 % 100003).arg(i);
+    const QString term = QStringLiteral("account #123");
+
+    int count = 0;
+    QBENCHMARK {
+        foreach (const QString &name, names)
+            count += name.contains(term, Qt::CaseInsensitive);
+    }
+    QVERIFY(count);
+}
+
+void tst_QString::splitRecords_data()
+{
+    QTest::addColumn<bool>("useArena");
+    QTest::newRow("heap") << false;
+    QTest::newRow("arena") << true;
+}
+
+// Parses CSV-like records the way a typical loader does, creating and
+// discarding a handful of small strings per field.
+static qlonglong parseRecords(const QStringList &lines)
+{
+    qlonglong total = 0;
+    foreach (const QString &line, lines) {
+        const QStringList fields = line.split(QLatin1Char(','));
+        total += fields.at(0).toInt() + fields.at(2).toInt();
+        total += fields.at(1).toUpper().size() + fields.at(4).trimmed().size();
+    }
+    return total;
+}
+
+void tst_QString::splitRecords()
+{
+    QFETCH(bool, useArena);
+
+    QStringList lines;
+    for (int i = 0; i < 2000; ++i)
+        lines << QString::fromLatin1("%1,item %2,%3,category-%4, %5 ")
+                 .arg(i).arg(i * 7).arg(i % 97).arg(i % 13)
+                 .arg(QString(600, QLatin1Char('a' + i % 26)));
+
+    // an arena counts the buffers it hands out; without one, each of them
+    // is a malloc(), while with one only its chunks are. QBENCHMARK runs
+    // this function several times, so report once per row.
+    static bool reported[2] = { false, false };
+    if (!reported[useArena]) {
+        reported[useArena] = true;
+        QArrayDataArena arena;
+        QVERIFY(parseRecords(lines) > 0);
+        qDebug("%d malloc() calls for %d string buffers per pass",
+               useArena ? arena.chunkCount() : arena.allocationCount(),
+               arena.allocationCount());
+    }
+
+    qlonglong total = 0;
+    QBENCHMARK {
+        QScopedPointer<QArrayDataArena> arena(useArena ? new QArrayDataArena : 0);
+        total += parseRecords(lines);
+    }
+    QVERIFY(total > 0);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
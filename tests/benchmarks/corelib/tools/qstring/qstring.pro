@@ -1,6 +1,6 @@
 TARGET = tst_bench_qstring
 QT -= gui
-QT += core testlib
+QT += core-private testlib
 SOURCES += main.cpp
 
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QTest>
+#include <QVector>
+
+class tst_QTimeZone : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void create_data();
+    void create();
+    void offsetFromUtc_data();
+    void offsetFromUtc();
+    void offsetsFromUtc_data();
+    void offsetsFromUtc();
+    void hasDaylightTime();
+    void transitions();
+
+private:
+    static QVector<qint64> timestamps(bool sorted);
+};
+
+static const int TimestampCount = 100000;
+
+static void addZoneRows()
+{
+    QTest::addColumn<QByteArray>("zone");
+    QTest::newRow("UTC") << QByteArray("UTC");
+    QTest::newRow("Europe/Berlin") << QByteArray("Europe/Berlin");
+    QTest::newRow("America/New_York") << QByteArray("America/New_York");
+    QTest::newRow("Australia/Sydney") << QByteArray("Australia/Sydney");
+}
+
+// One timestamp roughly every five minutes, covering about a year of logs
+QVector<qint64> tst_QTimeZone::timestamps(bool sorted)
+{
+    const qint64 start = QDateTime(QDate(2015, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    QVector<qint64> result;
+    result.reserve(TimestampCount);
+    for (int i = 0; i < TimestampCount; ++i)
+        result.append(start + qint64(i) * 317 * 1000);
+    if (!sorted) {
+        // deterministic shuffle
+        for (int i = result.size() - 1; i > 0; --i)
+            qSwap(result[i], result[(i * 7919) % (i + 1)]);
+    }
+    return result;
+}
+
+void tst_QTimeZone::create_data()
+{
+    addZoneRows();
+}
+
+void tst_QTimeZone::create()
+{
+    QFETCH(QByteArray, zone);
+    QBENCHMARK {
+        QTimeZone tz(zone);
+        Q_UNUSED(tz);
+    }
+}
+
+void tst_QTimeZone::offsetFromUtc_data()
+{
+    addZoneRows();
+}
+
+void tst_QTimeZone::offsetFromUtc()
+{
+    QFETCH(QByteArray, zone);
+    const QTimeZone tz(zone);
+    const QVector<qint64> msecs = timestamps(false);
+    QVector<QDateTime> dateTimes;
+    dateTimes.reserve(msecs.size());
+    foreach (qint64 ms, msecs)
+        dateTimes.append(QDateTime::fromMSecsSinceEpoch(ms, Qt::UTC));
+
+    int sum = 0;
+    QBENCHMARK {
+        foreach (const QDateTime &dt, dateTimes)
+            sum += tz.offsetFromUtc(dt);
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_QTimeZone::offsetsFromUtc_data()
+{
+    QTest::addColumn<QByteArray>("zone");
+    QTest::addColumn<bool>("sorted");
+    QTest::newRow("Europe/Berlin, sorted") << QByteArray("Europe/Berlin") << true;
+    QTest::newRow("Europe/Berlin, shuffled") << QByteArray("Europe/Berlin") << false;
+    QTest::newRow("America/New_York, sorted") << QByteArray("America/New_York") << true;
+    QTest::newRow("America/New_York, shuffled") << QByteArray("America/New_York") << false;
+}
+
+void tst_QTimeZone::offsetsFromUtc()
+{
+    QFETCH(QByteArray, zone);
+    QFETCH(bool, sorted);
+    const QTimeZone tz(zone);
+    const QVector<qint64> msecs = timestamps(sorted);
+
+    QVector<int> offsets;
+    QBENCHMARK {
+        offsets = tz.offsetsFromUtc(msecs);
+    }
+    QCOMPARE(offsets.size(), msecs.size());
+}
+
+void tst_QTimeZone::hasDaylightTime()
+{
+    const QTimeZone tz("Europe/Berlin");
+    bool result = false;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            result ^= tz.hasDaylightTime();
+    }
+    Q_UNUSED(result);
+}
+
+void tst_QTimeZone::transitions()
+{
+    const QTimeZone tz("Europe/Berlin");
+    const QDateTime from(QDate(1990, 1, 1), QTime(0, 0), Qt::UTC);
+    const QDateTime to(QDate(2030, 1, 1), QTime(0, 0), Qt::UTC);
+    QBENCHMARK {
+        QTimeZone::OffsetDataList list = tz.transitions(from, to);
+        Q_UNUSED(list);
+    }
+}
+
+QTEST_MAIN(tst_QTimeZone)
+
+#include "main.moc"
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QUtf8StringView>
+
+// Each benchmark runs once on QUtf8StringView and once converting the
+// UTF-8 data to QString first, which is what code had to do before.
+enum Mode { Utf8View, RoundTrip };
+Q_DECLARE_METATYPE(Mode)
+
+// a few kilobytes of mostly ASCII log lines, with some non-ASCII names
+static QByteArray logData()
+{
+    static const char *const names[] = {
+        "anna", "J\xc3\xbcrgen", "bj\xc3\xb6rn", "zo\xc3\xab", "marek", "\xc5\x81ukasz"
+    };
+    QByteArray log;
+    for (int i = 0; i < 100; ++i) {
+        log += "2015-11-03 12:";
+        log += QByteArray::number(10 + i % 50);
+        log += " INFO request from ";
+        log += names[i % 6];
+        log += " served in ";
+        log += QByteArray::number(i * 7 % 300);
+        log += " ms\n";
+    }
+    return log;
+}
+
+// CSV records of ASCII fields and numbers
+static QByteArray csvData()
+{
+    QByteArray csv;
+    for (int i = 0; i < 1000; ++i) {
+        csv += QByteArray::number(i);
+        csv += ",sensor-";
+        csv += QByteArray::number(i % 17);
+        csv += ',';
+        csv += QByteArray::number(i * 37 % 1000);
+        csv += ',';
+        csv += QByteArray::number(i * 13 % 4096);
+        csv += '\n';
+    }
+    return csv;
+}
+
+class tst_QUtf8StringView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void equal_data() { modes(); }
+    void equal();
+    void compareCaseInsensitive_data() { modes(); }
+    void compareCaseInsensitive();
+    void indexOf_data() { modes(); }
+    void indexOf();
+    void indexOfCaseInsensitive_data() { modes(); }
+    void indexOfCaseInsensitive();
+    void splitAndParse_data() { modes(); }
+    void splitAndParse();
+    void hash_data() { modes(); }
+    void hash();
+
+private:
+    void modes();
+};
+
+void tst_QUtf8StringView::modes()
+{
+    QTest::addColumn<Mode>("mode");
+    QTest::newRow("QUtf8StringView") << Utf8View;
+    QTest::newRow("QString") << RoundTrip;
+}
+
+void tst_QUtf8StringView::equal()
+{
+    QFETCH(Mode, mode);
+    const QByteArray log = logData();
+    const QList<QByteArray> lines = log.split('\n');
+    const QByteArray key = lines.at(lines.size() / 2);
+
+    int count = 0;
+    if (mode == Utf8View) {
+        QBENCHMARK {
+            for (int i = 0; i < lines.size(); ++i)
+                count += QUtf8StringView(lines.at(i)) == QUtf8StringView(key);
+        }
+    } else {
+        QBENCHMARK {
+            const QString k = QString::fromUtf8(key);
+            for (int i = 0; i < lines.size(); ++i)
+                count += QString::fromUtf8(lines.at(i)) == k;
+        }
+    }
+    QVERIFY(count);
+}
+
+void tst_QUtf8StringView::compareCaseInsensitive()
+{
+    QFETCH(Mode, mode);
+    const QList<QByteArray> lines = logData().split('\n');
+    const QByteArray upper = lines.at(1).toUpper();
+
+    int count = 0;
+    if (mode == Utf8View) {
+        QBENCHMARK {
+            for (int i = 0; i < lines.size(); ++i)
+                count += QUtf8StringView(lines.at(i)).compare(QUtf8StringView(upper), Qt::CaseInsensitive) == 0;
+        }
+    } else {
+        QBENCHMARK {
+            const QString u = QString::fromUtf8(upper);
+            for (int i = 0; i < lines.size(); ++i)
+                count += QString::fromUtf8(lines.at(i)).compare(u, Qt::CaseInsensitive) == 0;
+        }
+    }
+    QVERIFY(count);
+}
+
+void tst_QUtf8StringView::indexOf()
+{
+    QFETCH(Mode, mode);
+    const QByteArray log = logData();
+    const QByteArray needle("zo\xc3\xab served in 93 ms");
+
+    int index = -1;
+    if (mode == Utf8View) {
+        QBENCHMARK {
+            index = QUtf8StringView(log).indexOf(QUtf8StringView(needle));
+        }
+    } else {
+        QBENCHMARK {
+            index = QString::fromUtf8(log).indexOf(QString::fromUtf8(needle));
+        }
+    }
+    QVERIFY(index != -1);
+}
+
+void tst_QUtf8StringView::indexOfCaseInsensitive()
+{
+    QFETCH(Mode, mode);
+    const QByteArray log = logData();
+    const QByteArray needle("BJ\xc3\x96RN SERVED IN 86 MS");
+
+    int index = -1;
+    if (mode == Utf8View) {
+        QBENCHMARK {
+            index = QUtf8StringView(log).indexOf(QUtf8StringView(needle), 0, Qt::CaseInsensitive);
+        }
+    } else {
+        QBENCHMARK {
+            index = QString::fromUtf8(log).indexOf(QString::fromUtf8(needle), 0, Qt::CaseInsensitive);
+        }
+    }
+    QVERIFY(index != -1);
+}
+
+void tst_QUtf8StringView::splitAndParse()
+{
+    QFETCH(Mode, mode);
+    const QByteArray csv = csvData();
+
+    qlonglong sum = 0;
+    if (mode == Utf8View) {
+        QBENCHMARK {
+            sum = 0;
+            const QVector<QUtf8StringView> lines = QUtf8StringView(csv).split('\n', QString::SkipEmptyParts);
+            for (int i = 0; i < lines.size(); ++i) {
+                const QVector<QUtf8StringView> fields = lines.at(i).split(',');
+                sum += fields.at(2).toInt() + fields.at(3).toInt();
+            }
+        }
+    } else {
+        QBENCHMARK {
+            sum = 0;
+            const QStringList lines = QString::fromUtf8(csv).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+            for (int i = 0; i < lines.size(); ++i) {
+                const QStringList fields = lines.at(i).split(QLatin1Char(','));
+                sum += fields.at(2).toInt() + fields.at(3).toInt();
+            }
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_QUtf8StringView::hash()
+{
+    QFETCH(Mode, mode);
+    const QList<QByteArray> lines = logData().split('\n');
+
+    uint h = 0;
+    if (mode == Utf8View) {
+        QBENCHMARK {
+            for (int i = 0; i < lines.size(); ++i)
+                h += qHash(QUtf8StringView(lines.at(i)), h);
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i < lines.size(); ++i)
+                h += qHash(QString::fromUtf8(lines.at(i)), h);
+        }
+    }
+    QVERIFY(h);
+}
+
+QTEST_APPLESS_MAIN(tst_QUtf8StringView)
+
+#include "main.moc"
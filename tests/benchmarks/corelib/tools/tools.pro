@@ -2,10 +2,12 @@ TEMPLATE = subdirs
 SUBDIRS = \
         containers-associative \
         containers-sequential \
+        qbtreemap \
         qbytearray \
         qcontiguouscache \
         qcryptographichash \
         qdatetime \
+        qflathash \
         qlist \
         qlocale \
         qmap \
@@ -16,6 +18,8 @@ SUBDIRS = \
         qstring \
         qstringbuilder \
         qstringlist \
+        qtimezone \
+        qutf8stringview \
         qvector \
         qalgorithms
 